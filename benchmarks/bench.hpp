@@ -0,0 +1,71 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// Minimal timing for the benchmarks of the host-portable headers: no dependencies, one executable per benchmark
+
+#include <chrono>  // std::chrono::steady_clock
+#include <cstdint> // uint32_t, uint64_t
+#include <cstdio>  // std::printf
+
+#include "nh3api/portable/simd.hpp" // NH3API_PORTABLE_SSE2, NH3API_PORTABLE_AVX2
+#include "../tests/test.hpp"         // nh3api_test::random
+
+namespace nh3api_bench
+{
+
+using nh3api_test::random;
+
+// make the compiler assume <value> is read, so that the measured work is not optimized out
+template<class T>
+inline void keep(const T& value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+// seconds per call of <body>: it's called until at least <min_seconds> have passed, after one warm-up call
+template<class Body>
+[[nodiscard]] double seconds_per_call(Body&& body, double min_seconds = 0.25)
+{
+    using clock = ::std::chrono::steady_clock;
+    body();
+    uint64_t calls = 0;
+    const clock::time_point start = clock::now();
+    double elapsed = 0.0;
+    do
+    {
+        body();
+        ++calls;
+        elapsed = ::std::chrono::duration<double>(clock::now() - start).count();
+    }
+    while ( elapsed < min_seconds );
+
+    return elapsed / static_cast<double>(calls);
+}
+
+// one line of the results: time per call and <units> per second(e.g. MB/s, MPix/s) for <units_per_call>
+inline void report(const char* name, double seconds, double units_per_call, const char* units)
+{
+    std::printf("%-48s %12.3f us %12.1f %s\n", name, seconds * 1e6, units_per_call / seconds, units);
+}
+
+// the instruction set of the measured kernels
+inline void print_build(const char* benchmark)
+{
+    const char* const simd = NH3API_PORTABLE_AVX2 ? "AVX2" : NH3API_PORTABLE_SSE2 ? "SSE2" : "scalar";
+    std::printf("%s, %s build\n", benchmark, simd);
+}
+
+} // namespace nh3api_bench
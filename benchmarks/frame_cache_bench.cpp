@@ -0,0 +1,187 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// frame_cache: 64 creature-sized frames drawn on an 800x600 screen by decoding them every time, from the cache and mirrored
+
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <memory>  // std::shared_ptr
+#include <vector>  // std::vector
+
+#include "nh3api/portable/frame_cache.hpp" // nh3api::frame_cache, nh3api::cached_frame
+#include "bench.hpp"
+
+using nh3api::pixel_format;
+
+namespace
+{
+
+constexpr int32_t screen_width  = 800;
+constexpr int32_t screen_height = 600;
+constexpr int32_t frame_width   = 100;
+constexpr int32_t frame_height  = 130;
+constexpr size_t  frame_count   = 64;
+constexpr size_t  draws         = 2000;
+
+// a creature-like frame: an ellipse of short color runs with a shadow border, transparent around it
+std::vector<uint8_t> make_frame(nh3api_bench::random& random)
+{
+    std::vector<uint8_t> result(size_t(frame_width) * frame_height, 0);
+    uint8_t color = 8;
+    for ( int32_t y = 0; y < frame_height; ++y )
+        for ( int32_t x = 0; x < frame_width; ++x )
+        {
+            const int32_t dx = 2 * x - frame_width, dy = 2 * y - frame_height;
+            const int32_t distance = dx * dx * frame_height * frame_height / (frame_width * frame_width) + dy * dy;
+            uint8_t&      index    = result[size_t(y) * frame_width + x];
+            if ( random.below(4) == 0 )
+                color = static_cast<uint8_t>(8 + random.below(247));
+            if ( distance < frame_height * frame_height * 3 / 4 )
+                index = color;
+            else if ( distance < frame_height * frame_height )
+                index = 1;
+        }
+    return result;
+}
+
+void push_u32(std::vector<uint8_t>& data, size_t value)
+{
+    for ( uint32_t shift = 0; shift < 32; shift += 8 )
+        data.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+// def_encoding::general_rle: 32-bit row offsets, then runs of up to 256 pixels: a fill value or 0xFF and the literal bytes
+std::vector<uint8_t> encode_general_rle(const std::vector<uint8_t>& indices)
+{
+    std::vector<uint8_t> result;
+    std::vector<uint8_t> rows;
+    for ( int32_t y = 0; y < frame_height; ++y )
+    {
+        push_u32(rows, size_t(frame_height) * 4 + result.size());
+        const uint8_t* const row = indices.data() + size_t(y) * frame_width;
+        for ( int32_t x = 0; x < frame_width; )
+        {
+            int32_t run = 1;
+            while ( x + run < frame_width && run < 256 && row[x + run] == row[x] )
+                ++run;
+            if ( run >= 3 && row[x] != 0xFF )
+            {
+                result.push_back(row[x]);
+                result.push_back(static_cast<uint8_t>(run - 1));
+                x += run;
+                continue;
+            }
+
+            // literal up to the next fill run
+            int32_t length = 0;
+            while ( x + length < frame_width && length < 256
+                    && !(x + length + 2 < frame_width && row[x + length] == row[x + length + 1] && row[x + length] == row[x + length + 2]) )
+                ++length;
+            length = length == 0 ? 1 : length;
+            result.push_back(0xFF);
+            result.push_back(static_cast<uint8_t>(length - 1));
+            result.insert(result.end(), row + x, row + x + length);
+            x += length;
+        }
+    }
+    rows.insert(rows.end(), result.begin(), result.end());
+    return rows;
+}
+
+// draw position of each call: the same sequence for every variant
+struct position
+{
+    size_t  frame;
+    int32_t x;
+    int32_t y;
+};
+
+template<class Draw>
+void measure(const char* name, const std::vector<position>& positions, std::vector<uint16_t>& screen, Draw&& draw)
+{
+    const double seconds = nh3api_bench::seconds_per_call([&]()
+    {
+        for ( const position& current : positions )
+            draw(current);
+        nh3api_bench::keep(screen);
+    });
+    nh3api_bench::report(name, seconds / static_cast<double>(positions.size()), double(frame_width) * frame_height / 1e6, "MPix/s");
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("frame_cache_bench");
+    nh3api_bench::random random(16);
+
+    std::vector<std::vector<uint8_t>> data;
+    std::vector<nh3api::def_frame>    frames;
+    for ( size_t i = 0; i < frame_count; ++i )
+        data.push_back(encode_general_rle(make_frame(random)));
+    for ( const std::vector<uint8_t>& stored : data )
+    {
+        nh3api::def_frame frame;
+        frame.header.encoding       = nh3api::def_encoding::general_rle;
+        frame.header.width          = frame_width;
+        frame.header.height         = frame_height;
+        frame.header.cropped_width  = frame_width;
+        frame.header.cropped_height = frame_height;
+        frame.header.data_size      = static_cast<uint32_t>(stored.size());
+        frame.data                  = { reinterpret_cast<const std::byte*>(stored.data()), stored.size() };
+        frames.push_back(frame);
+    }
+
+    std::vector<uint16_t> palette(256);
+    for ( uint16_t& color : palette )
+        color = static_cast<uint16_t>(random.next());
+    std::vector<uint16_t>   screen(size_t(screen_width) * screen_height, 0x1234);
+    const nh3api::surface16 view { screen.data(), screen_width, screen_height, screen_width * 2 };
+
+    std::vector<position> positions(draws);
+    for ( position& current : positions )
+        current = { random.below(frame_count), static_cast<int32_t>(random.below(screen_width - frame_width)),
+                    static_cast<int32_t>(random.below(screen_height - frame_height)) };
+
+    // what CSpriteFrame::Draw does: decode the runs, then blit the indices
+    std::vector<uint8_t> indices(size_t(frame_width) * frame_height);
+    measure("decode_def_frame + blit_indices", positions, screen, [&](const position& current)
+    {
+        nh3api::decode_def_frame(frames[current.frame], indices.data(), frame_width);
+        for ( int32_t row = 0; row < frame_height; ++row )
+            nh3api::blit_indices(indices.data() + size_t(row) * frame_width, view.row(current.y + row) + current.x, frame_width, palette.data());
+    });
+
+    nh3api::frame_cache cache;
+    measure("frame_cache::get_or_decode + draw", positions, screen, [&](const position& current)
+    {
+        const nh3api::frame_cache::frame_ptr frame = cache.get_or_decode({ &frames, 0, static_cast<int32_t>(current.frame), palette.data(), 0 },
+                                                                        frames[current.frame], palette.data(), pixel_format::rgb565);
+        frame->draw(view, current.x, current.y);
+    });
+
+    std::vector<nh3api::cached_frame> decoded, mirrored;
+    for ( const nh3api::def_frame& frame : frames )
+    {
+        decoded.push_back(*nh3api::frame_cache::decode(frame, palette.data(), pixel_format::rgb565));
+        mirrored.push_back(decoded.back().mirrored());
+    }
+    measure("cached_frame::draw", positions, screen, [&](const position& current)
+    { decoded[current.frame].draw(view, current.x, current.y); });
+    measure("cached_frame::draw, mirrored()", positions, screen, [&](const position& current)
+    { mirrored[current.frame].draw(view, current.x, current.y); });
+
+    // hflip without the mirrored variant: decode, reverse the rows, build the spans
+    measure("frame_cache::decode(hflip) + draw", positions, screen, [&](const position& current)
+    {
+        const nh3api::frame_cache::frame_ptr frame = nh3api::frame_cache::decode(frames[current.frame], palette.data(), pixel_format::rgb565, {}, true);
+        frame->draw(view, current.x, current.y);
+    });
+    return 0;
+}
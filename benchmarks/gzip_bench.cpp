@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// gzip: gzip_uncompress of a saved-game-sized file, CRC-32 and Adler-32 throughput
+
+#include <cstdint> // uint8_t, uint32_t
+#include <cstdio>  // std::printf
+#include <vector>  // std::vector
+
+#include "nh3api/portable/deflate.hpp" // nh3api::zlib_compress
+#include "nh3api/portable/gzip.hpp"    // nh3api::gzip_uncompress
+#include "bench.hpp"
+
+using bytes = std::vector<std::byte>;
+
+namespace
+{
+
+// repetitive structures with small random fields, like the saved games
+bytes make_data(nh3api_bench::random& random, size_t size)
+{
+    bytes result;
+    result.reserve(size);
+    while ( result.size() < size )
+    {
+        if ( random.below(4) == 0 && result.size() > 64 )
+        {
+            const size_t distance = 1 + random.below(static_cast<uint32_t>(result.size() < 4096 ? result.size() : 4096));
+            const size_t length   = 3 + random.below(60);
+            for ( size_t i = 0; i < length; ++i )
+                result.push_back(result[result.size() - distance]);
+        }
+        else
+            result.push_back(std::byte(random.below(16)));
+    }
+    result.resize(size);
+    return result;
+}
+
+void put_u32(bytes& output, uint32_t value)
+{
+    for ( uint32_t shift = 0; shift < 32; shift += 8 )
+        output.push_back(std::byte((value >> shift) & 0xFFU));
+}
+
+// a gzip member around the deflate stream of zlib_compress(): the zlib header and the Adler-32 are replaced
+bytes make_gzip(const bytes& data)
+{
+    const bytes zlib = nh3api::zlib_compress({ data.data(), data.size() });
+    bytes result { std::byte { 0x1F }, std::byte { 0x8B }, std::byte { 8 }, std::byte { 0 }, std::byte { 0 },
+                   std::byte { 0 },    std::byte { 0 },    std::byte { 0 }, std::byte { 0 }, std::byte { 0xFF } };
+    result.insert(result.end(), zlib.begin() + 2, zlib.end() - 4);
+    put_u32(result, nh3api::crc32(data.data(), data.size()));
+    put_u32(result, static_cast<uint32_t>(data.size()));
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("gzip_bench");
+    nh3api_bench::random random(7);
+    const bytes data = make_data(random, size_t(4) << 20U);
+    const bytes file = make_gzip(data);
+    const double megabytes = static_cast<double>(data.size()) / 1e6;
+
+    bytes output;
+    const double uncompress = nh3api_bench::seconds_per_call([&]()
+    {
+        output.clear();
+        uint32_t crc = 0;
+        if ( nh3api::gzip_uncompress({ file.data(), file.size() }, output, 0, static_cast<size_t>(-1), &crc) != nh3api::inflate_status::ok )
+            output.clear();
+        nh3api_bench::keep(crc);
+    });
+    nh3api_bench::report("gzip_uncompress, 4 MB decoded", uncompress, megabytes, "MB/s(decoded)");
+    if ( output != data )
+        std::printf("gzip_uncompress: wrong output\n");
+
+    const double crc32 = nh3api_bench::seconds_per_call([&]()
+    {
+        const uint32_t crc = nh3api::crc32(data.data(), data.size());
+        nh3api_bench::keep(crc);
+    });
+    nh3api_bench::report("crc32", crc32, megabytes, "MB/s");
+
+    const double adler32 = nh3api_bench::seconds_per_call([&]()
+    {
+        const uint32_t adler = nh3api::adler32(data.data(), data.size());
+        nh3api_bench::keep(adler);
+    });
+    nh3api_bench::report("adler32", adler32, megabytes, "MB/s");
+
+    const double compress = nh3api_bench::seconds_per_call([&]()
+    {
+        const bytes packed = nh3api::zlib_compress({ data.data(), data.size() });
+        nh3api_bench::keep(packed);
+    });
+    nh3api_bench::report("zlib_compress level 6", compress, megabytes, "MB/s(input)");
+    std::printf("compressed to %.1f%%\n", 100.0 * static_cast<double>(file.size()) / static_cast<double>(data.size()));
+    return output == data ? 0 : 1;
+}
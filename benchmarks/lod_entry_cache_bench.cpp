@@ -0,0 +1,104 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// lod_entry_cache: the LRU and GDSF policies replaying a skewed synthetic trace of LOD entry requests
+
+#include <cstdint> // uint32_t, uint64_t
+#include <cstdio>  // std::printf
+#include <memory>  // std::make_shared
+#include <vector>  // std::vector
+
+#include "nh3api/portable/lod_entry_cache.hpp" // nh3api::lod_entry_cache
+#include "bench.hpp"
+
+namespace
+{
+
+struct trace_entry
+{
+    LODEntry entry;
+    // the cost of a miss: the stored size, what the game reads and inflates
+    double   cost;
+};
+
+// many small entries(cursors, buttons, small DEFs) and a few large ones(backgrounds, big DEFs)
+std::vector<trace_entry> make_entries(nh3api_bench::random& random, uint32_t count)
+{
+    std::vector<trace_entry> result(count);
+    int32_t offset = 0;
+    for ( trace_entry& current : result )
+    {
+        const uint32_t size = random.below(10) == 0 ? 200000 + random.below(800000) : 500 + random.below(20000);
+        current.entry.offset = offset;
+        current.entry.size   = size;
+        current.entry.csize  = size / 3;
+        current.cost         = static_cast<double>(current.entry.csize);
+        offset += static_cast<int32_t>(current.entry.csize);
+    }
+    return result;
+}
+
+// requests skewed towards the low ranks: u^3 puts ~46% of them into the first 10% of the entries
+std::vector<uint32_t> make_trace(nh3api_bench::random& random, uint32_t entries, size_t length)
+{
+    std::vector<uint32_t> result(length);
+    for ( uint32_t& request : result )
+    {
+        const double u = static_cast<double>(random.next()) / 4294967296.0;
+        request = static_cast<uint32_t>(u * u * u * entries);
+    }
+    return result;
+}
+
+void replay(const char* name, nh3api::cache_policy policy, size_t budget, const std::vector<trace_entry>& entries,
+            const std::vector<uint32_t>& trace)
+{
+    nh3api::lod_entry_cache cache({ budget, policy });
+    uint64_t loaded_bytes = 0;
+    const double seconds = nh3api_bench::seconds_per_call([&]()
+    {
+        cache.clear();
+        cache.reset_stats();
+        loaded_bytes = 0;
+        for ( const uint32_t request : trace )
+        {
+            const trace_entry& current = entries[request];
+            const nh3api::lod_entry_cache::blob data = cache.get_or_load(nh3api::lod_entry_cache::key_of(&entries, current.entry), [&]()
+            {
+                loaded_bytes += current.entry.csize;
+                return std::make_shared<const std::vector<std::byte>>(current.entry.size);
+            }, current.cost);
+            nh3api_bench::keep(data);
+        }
+    }, 1.0);
+
+    const nh3api::lod_entry_cache_stats stats = cache.stats();
+    nh3api_bench::report(name, seconds / static_cast<double>(trace.size()), 1.0, "requests/s");
+    std::printf("    hit rate %.1f%%, %.1f MB read and inflated, %llu evictions\n",
+                100.0 * static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses),
+                static_cast<double>(loaded_bytes) / 1e6, static_cast<unsigned long long>(stats.evictions));
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("lod_entry_cache_bench");
+    nh3api_bench::random           random(5);
+    const std::vector<trace_entry> entries = make_entries(random, 4000);
+    const std::vector<uint32_t>    trace   = make_trace(random, 4000, 200000);
+    for ( const size_t budget : { size_t(16) << 20U, size_t(64) << 20U } )
+    {
+        std::printf("budget %zu MB\n", budget >> 20U);
+        replay("lru", nh3api::cache_policy::lru, budget, entries, trace);
+        replay("gdsf", nh3api::cache_policy::gdsf, budget, entries, trace);
+    }
+    return 0;
+}
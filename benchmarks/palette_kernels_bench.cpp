@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// palette_kernels: expand_indices/blit_indices, blit_composite and convert_rgb24_to_16 against the scalar loops they replace
+
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include "nh3api/portable/palette_kernels.hpp" // nh3api::blit_indices, nh3api::blit_composite, nh3api::convert_rgb24_to_16
+#include "bench.hpp"
+
+using nh3api::composite_mode;
+using nh3api::pixel_format;
+
+namespace
+{
+
+// sprite-like indices: colors with <special_percent>% of the indices below 8(transparent, shadows, outline)
+std::vector<uint8_t> make_indices(nh3api_bench::random& random, size_t count, uint32_t special_percent)
+{
+    std::vector<uint8_t> result(count);
+    for ( uint8_t& index : result )
+        index = random.below(100) < special_percent ? static_cast<uint8_t>(random.below(8)) : static_cast<uint8_t>(8 + random.below(248));
+    return result;
+}
+
+template<class Pixel>
+std::vector<Pixel> make_pixels(nh3api_bench::random& random, size_t count)
+{
+    std::vector<Pixel> result(count);
+    for ( Pixel& pixel : result )
+        pixel = static_cast<Pixel>(random.next());
+    return result;
+}
+
+// run <kernel>(src, dst, count) over <indices> in spans of <span> pixels
+template<class Pixel, class Kernel>
+void measure_spans(const char* name, const std::vector<uint8_t>& indices, std::vector<Pixel>& pixels, size_t span, Kernel&& kernel)
+{
+    const double seconds = nh3api_bench::seconds_per_call([&]()
+    {
+        for ( size_t i = 0; i + span <= indices.size(); i += span )
+            kernel(indices.data() + i, pixels.data() + i, span);
+        nh3api_bench::keep(pixels);
+    });
+    const std::string label = std::string(name) + ", " + std::to_string(span) + " px spans";
+    nh3api_bench::report(label.c_str(), seconds, static_cast<double>(indices.size() / span * span) / 1e6, "MPix/s");
+}
+
+void bench_blit(nh3api_bench::random& random, size_t span)
+{
+    constexpr size_t              pixels    = 800 * 600;
+    const nh3api::special_indices special   {};
+    const std::vector<uint8_t>    indices   = make_indices(random, pixels, 25);
+    const std::vector<uint16_t>   palette16 = make_pixels<uint16_t>(random, 256);
+    const std::vector<uint32_t>   palette32 = make_pixels<uint32_t>(random, 256);
+    std::vector<uint16_t>         target16  = make_pixels<uint16_t>(random, pixels);
+    std::vector<uint32_t>         target32  = make_pixels<uint32_t>(random, pixels);
+
+    measure_spans("expand_indices 16-bit", indices, target16, span, [&](const uint8_t* src, uint16_t* dst, size_t count)
+    { nh3api::expand_indices(src, dst, count, palette16.data()); });
+    measure_spans("expand_indices 32-bit", indices, target32, span, [&](const uint8_t* src, uint32_t* dst, size_t count)
+    { nh3api::expand_indices(src, dst, count, palette32.data()); });
+
+    measure_spans("blit_indices 16-bit", indices, target16, span, [&](const uint8_t* src, uint16_t* dst, size_t count)
+    { nh3api::blit_indices(src, dst, count, palette16.data()); });
+    measure_spans("blit_indices 16-bit, scalar loop", indices, target16, span, [&](const uint8_t* src, uint16_t* dst, size_t count)
+    {
+        const nh3api::shade_masks16 masks = nh3api::get_shade_masks16(pixel_format::rgb565);
+        const uint8_t               any   = nh3api::palette_detail::special_mask(special);
+        for ( size_t i = 0; i < count; ++i )
+            dst[i] = (src[i] < 8 && (any & (1U << src[i]))) ? nh3api::palette_detail::shade(dst[i], src[i], special, masks) : palette16[src[i]];
+    });
+    measure_spans("blit_indices 32-bit", indices, target32, span, [&](const uint8_t* src, uint32_t* dst, size_t count)
+    { nh3api::blit_indices(src, dst, count, palette32.data()); });
+    measure_spans("blit_indices 32-bit, scalar loop", indices, target32, span, [&](const uint8_t* src, uint32_t* dst, size_t count)
+    {
+        const uint8_t any = nh3api::palette_detail::special_mask(special);
+        for ( size_t i = 0; i < count; ++i )
+            dst[i] = (src[i] < 8 && (any & (1U << src[i]))) ? nh3api::palette_detail::shade(dst[i], src[i], special) : palette32[src[i]];
+    });
+}
+
+template<composite_mode Mode>
+void bench_composite(nh3api_bench::random& random, const char* name)
+{
+    constexpr size_t                pixels    = 800 * 600;
+    constexpr size_t                span      = 64;
+    const nh3api::composite_indices special   {};
+    const nh3api::shade_masks16     masks     = nh3api::get_shade_masks16(pixel_format::rgb565);
+    const std::vector<uint8_t>      indices   = make_indices(random, pixels, 25);
+    const std::vector<uint16_t>     palette16 = make_pixels<uint16_t>(random, 256);
+    const std::vector<uint32_t>     palette32 = make_pixels<uint32_t>(random, 256);
+    std::vector<uint16_t>           target16  = make_pixels<uint16_t>(random, pixels);
+    std::vector<uint32_t>           target32  = make_pixels<uint32_t>(random, pixels);
+
+    const std::string label16 = std::string("blit_composite ") + name + " 16-bit";
+    const std::string label32 = std::string("blit_composite ") + name + " 32-bit";
+    measure_spans(label16.c_str(), indices, target16, span, [&](const uint8_t* src, uint16_t* dst, size_t count)
+    { nh3api::blit_composite(src, dst, count, palette16.data(), Mode, masks, 0xFFFF, special); });
+    measure_spans((label16 + ", scalar").c_str(), indices, target16, span, [&](const uint8_t* src, uint16_t* dst, size_t count)
+    {
+        for ( size_t i = 0; i < count; ++i )
+            dst[i] = nh3api::palette_detail::composite<Mode>(dst[i], src[i], palette16[src[i]], 0xFFFF, special, masks);
+    });
+    measure_spans(label32.c_str(), indices, target32, span, [&](const uint8_t* src, uint32_t* dst, size_t count)
+    { nh3api::blit_composite(src, dst, count, palette32.data(), Mode, 0xFFFFFFFFU, special); });
+    measure_spans((label32 + ", scalar").c_str(), indices, target32, span, [&](const uint8_t* src, uint32_t* dst, size_t count)
+    {
+        for ( size_t i = 0; i < count; ++i )
+            dst[i] = nh3api::palette_detail::composite<Mode>(dst[i], src[i], palette32[src[i]], 0xFFFFFFFFU, special);
+    });
+}
+
+// TPalette16::Convert24to16 with the layout known at compile time against its runtime-shift loop
+void bench_convert(nh3api_bench::random& random)
+{
+    std::vector<uint8_t> rgb(256 * 3);
+    for ( uint8_t& channel : rgb )
+        channel = static_cast<uint8_t>(random.next());
+    std::vector<uint16_t> palette(256);
+
+    const double compile_time = nh3api_bench::seconds_per_call([&]()
+    {
+        nh3api::convert_rgb24_to_16<nh3api::rgb565_layout>(rgb.data(), palette.data(), palette.size());
+        nh3api_bench::keep(palette);
+    });
+    nh3api_bench::report("convert_rgb24_to_16<rgb565_layout>", compile_time, 256.0 / 1e6, "Mentries/s");
+
+    // volatile: the game reads the bit counts and the shifts from ResourceManager at run time
+    volatile uint32_t bits[6] = { 5, 11, 6, 5, 5, 0 };
+    const double runtime_shift = nh3api_bench::seconds_per_call([&]()
+    {
+        const uint32_t rbits = bits[0], rshift = bits[1], gbits = bits[2], gshift = bits[3], bbits = bits[4], bshift = bits[5];
+        for ( size_t i = 0; i < palette.size(); ++i )
+            palette[i] = static_cast<uint16_t>(((rgb[i * 3 + 2] >> (8U - bbits) << bshift) | (rgb[i * 3 + 1] >> (8U - gbits) << gshift)
+                                                | (rgb[i * 3] >> (8U - rbits) << rshift)) & UINT16_MAX);
+        nh3api_bench::keep(palette);
+    });
+    nh3api_bench::report("Convert24to16 runtime-shift loop", runtime_shift, 256.0 / 1e6, "Mentries/s");
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("palette_kernels_bench");
+    nh3api_bench::random random(12);
+    for ( const size_t span : { size_t(32), size_t(800) } )
+        bench_blit(random, span);
+
+    bench_composite<composite_mode::shadow>(random, "shadow");
+    bench_composite<composite_mode::opaque>(random, "opaque");
+    bench_composite<composite_mode::alpha>(random, "alpha");
+    bench_convert(random);
+    return 0;
+}
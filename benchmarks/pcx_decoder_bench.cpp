@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// pcx_decoder: 800x600 LOD and ZSoft images decoded row by row to indices, RGB565 and ARGB
+
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <vector>  // std::vector
+
+#include "nh3api/portable/pcx_decoder.hpp" // nh3api::pcx_decoder
+#include "bench.hpp"
+
+using nh3api::pixel_format;
+
+namespace
+{
+
+constexpr uint32_t width  = 800;
+constexpr uint32_t height = 600;
+
+void put_u16(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+{
+    data[offset]     = static_cast<uint8_t>(value);
+    data[offset + 1] = static_cast<uint8_t>(value >> 8U);
+}
+
+void push_u32(std::vector<uint8_t>& data, uint32_t value)
+{
+    for ( uint32_t shift = 0; shift < 32; shift += 8 )
+        data.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+// background-like image: horizontal runs of a color with some noise
+std::vector<uint8_t> make_pixels(nh3api_bench::random& random, size_t count)
+{
+    std::vector<uint8_t> result(count);
+    uint8_t value = 0;
+    for ( uint8_t& pixel : result )
+    {
+        if ( random.below(8) == 0 )
+            value = static_cast<uint8_t>(random.next());
+        pixel = random.below(16) == 0 ? static_cast<uint8_t>(random.next()) : value;
+    }
+    return result;
+}
+
+// LOD .pcx: size, width, height, then the indices and the palette(<bytes_per_pixel> = 1) or BGR triplets(3)
+std::vector<uint8_t> encode_h3(const std::vector<uint8_t>& pixels, uint32_t bytes_per_pixel)
+{
+    std::vector<uint8_t> result;
+    push_u32(result, width * height * bytes_per_pixel);
+    push_u32(result, width);
+    push_u32(result, height);
+    result.insert(result.end(), pixels.begin(), pixels.end());
+    if ( bytes_per_pixel == 1 )
+        for ( uint32_t i = 0; i < 768; ++i )
+            result.push_back(static_cast<uint8_t>(i * 7));
+    return result;
+}
+
+// ZSoft PCX, 8-bit, RLE-encoded: runs of up to 63 bytes, single bytes below 0xC0 stored as is
+std::vector<uint8_t> encode_zsoft(const std::vector<uint8_t>& pixels)
+{
+    std::vector<uint8_t> result(128, 0);
+    result[0]  = 0x0A;
+    result[1]  = 5;
+    result[2]  = 1;
+    result[3]  = 8;
+    put_u16(result, 8, width - 1);
+    put_u16(result, 10, height - 1);
+    result[65] = 1;
+    put_u16(result, 66, width);
+    for ( uint32_t y = 0; y < height; ++y )
+    {
+        const uint8_t* const row = pixels.data() + size_t(y) * width;
+        for ( uint32_t x = 0; x < width; )
+        {
+            uint32_t run = 1;
+            while ( x + run < width && run < 63 && row[x + run] == row[x] )
+                ++run;
+            if ( run > 1 || row[x] >= 0xC0 )
+                result.push_back(static_cast<uint8_t>(0xC0 | run));
+            result.push_back(row[x]);
+            x += run;
+        }
+    }
+    result.push_back(0x0C);
+    for ( uint32_t i = 0; i < 768; ++i )
+        result.push_back(static_cast<uint8_t>(i * 5));
+    return result;
+}
+
+nh3api::span<const std::byte> as_bytes(const std::vector<uint8_t>& data)
+{ return { reinterpret_cast<const std::byte*>(data.data()), data.size() }; }
+
+// decode the whole image with <read>(decoder, row pointer)
+template<class Pixel, class Read>
+void measure(const char* name, const std::vector<uint8_t>& file, size_t row_size, Read&& read)
+{
+    std::vector<Pixel> image(row_size * height);
+    const double seconds = nh3api_bench::seconds_per_call([&]()
+    {
+        nh3api::pcx_decoder decoder(as_bytes(file));
+        for ( uint32_t y = 0; y < height; ++y )
+            read(decoder, image.data() + y * row_size);
+        nh3api_bench::keep(image);
+    });
+    nh3api_bench::report(name, seconds, width * height / 1e6, "MPix/s");
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("pcx_decoder_bench");
+    nh3api_bench::random       random(17);
+    const std::vector<uint8_t> indices = make_pixels(random, size_t(width) * height);
+    const std::vector<uint8_t> bgr     = make_pixels(random, size_t(width) * height * 3);
+    const std::vector<uint8_t> h3      = encode_h3(indices, 1);
+    const std::vector<uint8_t> h3_bgr  = encode_h3(bgr, 3);
+    const std::vector<uint8_t> zsoft   = encode_zsoft(indices);
+
+    std::vector<uint16_t> palette16(256);
+    std::vector<uint32_t> palette32(256);
+    for ( uint32_t i = 0; i < 256; ++i )
+    {
+        palette16[i] = static_cast<uint16_t>(i * 0x0101U);
+        palette32[i] = 0xFF000000U | (i * 0x010101U);
+    }
+
+    measure<uint8_t>("LOD 8-bit to indices", h3, width, [](nh3api::pcx_decoder& decoder, uint8_t* row) { decoder.read_row(row); });
+    measure<uint16_t>("LOD 8-bit to RGB565", h3, width, [&](nh3api::pcx_decoder& decoder, uint16_t* row)
+    { decoder.read_row(row, pixel_format::rgb565, palette16.data()); });
+    measure<uint32_t>("LOD 8-bit to ARGB", h3, width, [&](nh3api::pcx_decoder& decoder, uint32_t* row)
+    { decoder.read_row(row, palette32.data()); });
+    measure<uint16_t>("LOD 24-bit to RGB565", h3_bgr, width, [](nh3api::pcx_decoder& decoder, uint16_t* row)
+    { decoder.read_row(row, pixel_format::rgb565); });
+    measure<uint32_t>("LOD 24-bit to ARGB", h3_bgr, width, [](nh3api::pcx_decoder& decoder, uint32_t* row) { decoder.read_row(row); });
+    measure<uint8_t>("ZSoft RLE 8-bit to indices", zsoft, width, [](nh3api::pcx_decoder& decoder, uint8_t* row) { decoder.read_row(row); });
+    measure<uint16_t>("ZSoft RLE 8-bit to RGB565", zsoft, width, [&](nh3api::pcx_decoder& decoder, uint16_t* row)
+    { decoder.read_row(row, pixel_format::rgb565, palette16.data()); });
+    return 0;
+}
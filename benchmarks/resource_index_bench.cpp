@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// resource_index against a red-black tree keyed by 13-byte names like ResourceManager::TResourceMap
+
+#include <array>   // std::array
+#include <cstdio>  // std::printf
+#include <cstring> // std::strncmp, std::strncpy
+#include <map>     // std::map
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include "nh3api/portable/resource_index.hpp" // nh3api::resource_index
+#include "bench.hpp"
+
+namespace
+{
+
+struct resource
+{
+    int32_t id;
+};
+
+// TCacheMapKey: 13 bytes compared with strncmp
+struct tree_key
+{
+    std::array<char, 13> name {};
+
+    explicit tree_key(const std::string& text) noexcept
+    { std::strncpy(name.data(), text.c_str(), 12); }
+
+    [[nodiscard]] friend bool operator<(const tree_key& lhs, const tree_key& rhs) noexcept
+    { return std::strncmp(lhs.name.data(), rhs.name.data(), 12) < 0; }
+};
+
+// 8.3 names like the ones the game loads: CABTL01.DEF, TPMAGE.PCX...
+std::vector<std::string> make_names(nh3api_bench::random& random, size_t count)
+{
+    static constexpr const char* extensions[] = { ".DEF", ".PCX", ".WAV", ".FNT", ".TXT", ".PAL" };
+    std::vector<std::string> result;
+    while ( result.size() < count )
+    {
+        std::string name;
+        const uint32_t length = 3 + random.below(6);
+        for ( uint32_t i = 0; i < length; ++i )
+            name.push_back(i < 2 || random.below(3) != 0 ? static_cast<char>('A' + random.below(26)) : static_cast<char>('0' + random.below(10)));
+        result.push_back(name + extensions[random.below(6)]);
+    }
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("resource_index_bench");
+    nh3api_bench::random random(24);
+    for ( const size_t count : { size_t(500), size_t(5000) } )
+    {
+        const std::vector<std::string>   names = make_names(random, count);
+        std::vector<resource>            resources(names.size());
+        nh3api::resource_index<resource> index(names.size(), 0);
+        std::map<tree_key, resource*>    tree;
+        for ( size_t i = 0; i < names.size(); ++i )
+        {
+            index.insert(names[i].c_str(), &resources[i]);
+            tree.emplace(tree_key(names[i]), &resources[i]);
+        }
+
+        // 1M lookups, a tenth of them of names which are not loaded
+        std::vector<std::string> lookups;
+        for ( size_t i = 0; i < 1000000; ++i )
+            lookups.push_back(random.below(10) == 0 ? "MISSING" + std::to_string(random.below(1000)) : names[random.below(static_cast<uint32_t>(names.size()))]);
+        std::vector<tree_key> tree_lookups;
+        for ( const std::string& name : lookups )
+            tree_lookups.emplace_back(name);
+
+        const double hashed = nh3api_bench::seconds_per_call([&]()
+        {
+            size_t found = 0;
+            for ( const std::string& name : lookups )
+                found += index.find(name.c_str()) != nullptr;
+            nh3api_bench::keep(found);
+        });
+        const double sorted = nh3api_bench::seconds_per_call([&]()
+        {
+            size_t found = 0;
+            for ( const tree_key& key : tree_lookups )
+                found += tree.find(key) != tree.end();
+            nh3api_bench::keep(found);
+        });
+
+        std::printf("%zu resources\n", names.size());
+        nh3api_bench::report("resource_index::find", hashed / 1e6, 1e-6, "Mlookups/s");
+        nh3api_bench::report("std::map<TCacheMapKey>::find", sorted / 1e6, 1e-6, "Mlookups/s");
+    }
+    return 0;
+}
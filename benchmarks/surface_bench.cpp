@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// surface_kernels against their scalar references and surface_scaler at 1, 2 and 4 threads, on an 800x600 screen
+
+#include <cstdint> // uint16_t, uint32_t
+#include <string>  // std::string, std::to_string
+#include <vector>  // std::vector
+
+#include "nh3api/portable/surface_kernels.hpp" // nh3api::darken, nh3api::colorize, nh3api::fill_rect
+#include "nh3api/portable/surface_scaler.hpp"  // nh3api::surface_scaler
+#include "bench.hpp"
+
+using nh3api::pixel_format;
+
+namespace
+{
+
+constexpr int32_t screen_width  = 800;
+constexpr int32_t screen_height = 600;
+
+template<class Pixel>
+struct image
+{
+    std::vector<Pixel> pixels;
+    int32_t            width;
+    int32_t            height;
+
+    image(nh3api_bench::random& random, int32_t width_, int32_t height_)
+        : pixels(static_cast<size_t>(width_) * static_cast<size_t>(height_)), width { width_ }, height { height_ }
+    {
+        for ( Pixel& pixel : pixels )
+            pixel = static_cast<Pixel>(random.next());
+    }
+
+    [[nodiscard]] nh3api::surface_view<Pixel> view() noexcept
+    { return { pixels.data(), width, height, static_cast<int32_t>(width * sizeof(Pixel)) }; }
+};
+
+template<class Body>
+void measure_screen(const char* name, Body&& body)
+{
+    const double seconds = nh3api_bench::seconds_per_call(body);
+    nh3api_bench::report(name, seconds, screen_width * screen_height / 1e6, "MPix/s");
+}
+
+// Bitmap16Bit::Darken/Colorize/FillRect/FrameRect of a dialog-sized rectangle
+void bench_kernels(nh3api_bench::random& random)
+{
+    image<uint16_t> screen16(random, screen_width, screen_height);
+    image<uint32_t> screen32(random, screen_width, screen_height);
+    const nh3api::surface16 view16 = screen16.view();
+    const nh3api::surface32 view32 = screen32.view();
+
+    measure_screen("darken 16-bit", [&]() { nh3api::darken(view16, 0, 0, screen_width, screen_height); nh3api_bench::keep(screen16); });
+    measure_screen("darken_scalar 16-bit", [&]() { nh3api::darken_scalar(view16, 0, 0, screen_width, screen_height); nh3api_bench::keep(screen16); });
+    measure_screen("darken 32-bit", [&]() { nh3api::darken(view32, 0, 0, screen_width, screen_height); nh3api_bench::keep(screen32); });
+    measure_screen("darken_scalar 32-bit", [&]() { nh3api::darken_scalar(view32, 0, 0, screen_width, screen_height); nh3api_bench::keep(screen32); });
+
+    measure_screen("colorize 16-bit", [&]()
+    { nh3api::colorize(view16, 0, 0, screen_width, screen_height, 0.3f, 0.6f); nh3api_bench::keep(screen16); });
+    measure_screen("colorize_scalar 16-bit", [&]()
+    { nh3api::colorize_scalar(view16, 0, 0, screen_width, screen_height, 0.3f, 0.6f); nh3api_bench::keep(screen16); });
+    measure_screen("colorize 32-bit", [&]()
+    { nh3api::colorize(view32, 0, 0, screen_width, screen_height, 0.3f, 0.6f); nh3api_bench::keep(screen32); });
+    measure_screen("colorize_scalar 32-bit", [&]()
+    { nh3api::colorize_scalar(view32, 0, 0, screen_width, screen_height, 0.3f, 0.6f); nh3api_bench::keep(screen32); });
+
+    measure_screen("fill_rect 16-bit", [&]()
+    { nh3api::fill_rect(view16, 0, 0, screen_width, screen_height, uint16_t(0x1234)); nh3api_bench::keep(screen16); });
+    measure_screen("fill_rect 32-bit", [&]()
+    { nh3api::fill_rect(view32, 0, 0, screen_width, screen_height, 0xFF123456U); nh3api_bench::keep(screen32); });
+}
+
+template<class Pixel>
+void bench_scale(nh3api_bench::random& random, nh3api::scale_filter filter, const char* name, int32_t width, int32_t height)
+{
+    image<Pixel> source(random, screen_width, screen_height);
+    image<Pixel> target(random, width, height);
+    for ( const size_t threads : { size_t(1), size_t(2), size_t(4) } )
+    {
+        nh3api::surface_scaler scaler({ filter, threads });
+        const double seconds = nh3api_bench::seconds_per_call([&]()
+        {
+            scaler.scale(source.view(), target.view());
+            nh3api_bench::keep(target);
+        });
+        const std::string label = std::string(name) + (sizeof(Pixel) == 2 ? " 16-bit " : " 32-bit ") + std::to_string(width) + "x"
+                                + std::to_string(height) + ", " + std::to_string(threads) + " thread(s)";
+        nh3api_bench::report(label.c_str(), seconds, static_cast<double>(width) * height / 1e6, "MPix/s");
+    }
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_bench::print_build("surface_bench");
+    nh3api_bench::random random(15);
+    bench_kernels(random);
+
+    bench_scale<uint16_t>(random, nh3api::scale_filter::nearest, "nearest", 1600, 1200);
+    bench_scale<uint32_t>(random, nh3api::scale_filter::nearest, "nearest", 1600, 1200);
+    bench_scale<uint16_t>(random, nh3api::scale_filter::bilinear, "bilinear", 1920, 1080);
+    bench_scale<uint32_t>(random, nh3api::scale_filter::bilinear, "bilinear", 1920, 1080);
+    bench_scale<uint16_t>(random, nh3api::scale_filter::scale2x, "scale2x", 3840, 2160);
+    bench_scale<uint32_t>(random, nh3api::scale_filter::scale2x, "scale2x", 3840, 2160);
+    return 0;
+}
@@ -8,6 +8,7 @@
 
 #include "windows.hpp"
 #include "../base_manager.hpp"
+#include "../../portable/dirty_region.hpp" // nh3api::dirty_region
 
 // dialog result is stored in heroWindowManager::dialogReturn
 enum DialogReturnType : int32_t
@@ -53,6 +54,11 @@ NH3API_VIRTUAL_CLASS heroWindowManager : public baseManager
         void UpdateScreen(int32_t x, int32_t y, int32_t h, int32_t w)
         { THISCALL_5(void, 0x603190, this, x, y, h, w); }
 
+        // Present the area collected in <region> during the frame, one UpdateScreen call per disjoint rectangle /
+        // Вывести накопленную за кадр область <region>, по одному вызову UpdateScreen на каждый прямоугольник.
+        void UpdateScreen(nh3api::dirty_region& region)
+        { region.flush([this](const nh3api::dirty_rect& rect) { UpdateScreen(rect.x, rect.y, rect.height, rect.width); }); }
+
         void FadeScreen(int32_t inOut, int32_t speed, bool expect_fadein) noexcept
         { THISCALL_4(void, 0x603210, this, inOut, speed, expect_fadein); }
 
@@ -9,10 +9,11 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include "hero.hpp"    // HeroPlaceholder
-#include "objects.hpp" // map objects
-#include "quests.hpp"  // quests
-#include "terrain.hpp" // TTerrainType, type_point
+#include "../portable/terrain_planes.hpp" // nh3api::terrain_planes
+#include "hero.hpp"                       // HeroPlaceholder
+#include "objects.hpp"                    // map objects
+#include "quests.hpp"                     // quests
+#include "terrain.hpp"                    // TTerrainType, type_point
 
 NH3API_WARNING(push)
 NH3API_WARNING_GNUC_DISABLE("-Wuninitialized")
@@ -193,6 +194,34 @@ class NewfullMap
         int32_t PlaceObject(int32_t ObjectIndex, bool setExtraInfo)
         { return THISCALL_3(int32_t, 0x506170, this, ObjectIndex, setExtraInfo); }
 
+        // Copy the terrain of cellData into separate planes, see nh3api::terrain_planes /
+        // Скопировать почву карты в отдельные массивы, см. nh3api::terrain_planes.
+        void export_terrain(nh3api::terrain_planes& planes) const
+        {
+            planes.assign(Size, HasTwoLevels ? 2 : 1, true);
+            const size_t tiles = planes.tiles();
+            for ( size_t i = 0; i < tiles; ++i )
+            {
+                const NewmapCell& cell = cellData[i];
+                planes.ground_type[i]  = static_cast<uint8_t>(cell.GroundSet);
+                planes.ground_frame[i] = static_cast<uint8_t>(cell.GroundIndex);
+                planes.river_type[i]   = static_cast<uint8_t>(cell.RiverSet);
+                planes.river_frame[i]  = static_cast<uint8_t>(cell.RiverIndex);
+                planes.road_type[i]    = static_cast<uint8_t>(cell.RoadSet);
+                planes.road_frame[i]   = static_cast<uint8_t>(cell.RoadIndex);
+                planes.flags[i]        = static_cast<uint8_t>(cell.GroundFlippedHorizontal
+                                                              | (cell.GroundFlippedVertical  << 1U)
+                                                              | (cell.RiverFlippedHorizontal << 2U)
+                                                              | (cell.RiverFlippedVertical   << 3U)
+                                                              | (cell.RoadFlippedHorizontal  << 4U)
+                                                              | (cell.RoadFlippedVertical    << 5U));
+                planes.passable.set(i, cell.Passable);
+                planes.blocked.set(i, cell.IsBlocked);
+            }
+
+            planes.unpack_flags();
+        }
+
     public:
         union {
         // Map object types /
@@ -9,7 +9,8 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
-#include "ida.hpp" // abs32
+#include "hash.hpp" // tolower_constexpr
+#include "ida.hpp"  // abs32
 
 namespace nh3api
 {
@@ -290,10 +291,6 @@ inline constexpr int32_t constexpr_atoi(const char* p) noexcept
     return x;
 }
 
-// convert letter character to lowercase
-[[nodiscard]] inline constexpr char tolower_constexpr(const char c) noexcept
-{ return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c; }
-
 /*
 struct case_insensitive_traits
 {
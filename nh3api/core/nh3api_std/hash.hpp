@@ -16,6 +16,11 @@
 
 namespace nh3api
 {
+
+// convert letter character to lowercase
+[[nodiscard]] inline constexpr char tolower_constexpr(const char c) noexcept
+{ return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c; }
+
 // FNV-1a hash simple implementation
 template <typename ResultT, ResultT OffsetBasis, ResultT Prime>
 class basic_fnv1a final
@@ -78,6 +83,18 @@ class basic_fnv1a final
             this->state_ = acc;
         }
 
+        // ASCII letters are folded to lowercase, so "H3sprite" and "h3SPRITE" give the same digest
+        constexpr void update_case_insensitive(const char* const data, const size_t size) noexcept
+        {
+            result_type acc = this->state_;
+            for (size_t i = 0; i < size; ++i)
+            {
+                const size_t next = static_cast<size_t>(tolower_constexpr(data[i]));
+                acc = (acc ^ next) * Prime;
+            }
+            this->state_ = acc;
+        }
+
         [[nodiscard]] constexpr result_type digest() const noexcept
         { return this->state_; }
 };
@@ -112,6 +129,22 @@ using default_hash = basic_fnv1a<size_t, 2166136261, 16777619>;
     return hasher.digest();
 }
 
+// case-insensitive hash, matches _stricmp semantics for ASCII names(resources, LOD entries)
+[[nodiscard]] inline constexpr size_t hash_string_case_insensitive(const char* const str, size_t size) noexcept
+{
+    default_hash hasher;
+    hasher.update_case_insensitive(str, size);
+    return hasher.digest();
+}
+
+// case-insensitive hash, matches _stricmp semantics for ASCII names(resources, LOD entries)
+[[nodiscard]] inline constexpr size_t hash_string_case_insensitive(::std::string_view str) noexcept
+{
+    default_hash hasher;
+    hasher.update_case_insensitive(str.data(), str.size());
+    return hasher.digest();
+}
+
 template <size_t size>
 [[nodiscard]] inline constexpr size_t hash_string(const char (&str)[size]) noexcept
 {
@@ -0,0 +1,130 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>     // std::byte, size_t
+#include <type_traits> // std::remove_pointer_t, std::is_convertible_v
+
+#if __has_include(<span>) && ((__cplusplus >= 202002L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+#include <span>        // std::span
+#endif
+
+namespace nh3api
+{
+
+#if defined(__cpp_lib_span)
+using ::std::span;
+using ::std::as_bytes;
+using ::std::as_writable_bytes;
+#else
+
+// C++17 replacement of std::span with dynamic extent only
+template<class T>
+class span
+{
+    public:
+        using element_type    = T;
+        using value_type      = ::std::remove_cv_t<T>;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using pointer         = T*;
+        using const_pointer   = const T*;
+        using reference       = T&;
+        using const_reference = const T&;
+        using iterator        = T*;
+
+    public:
+        constexpr span() noexcept = default;
+
+        constexpr span(T* ptr, size_t count) noexcept
+            : m_data { ptr }, m_size { count }
+        {}
+
+        constexpr span(T* first, T* last) noexcept
+            : m_data { first }, m_size { static_cast<size_t>(last - first) }
+        {}
+
+        template<size_t N>
+        constexpr span(T (&arr)[N]) noexcept
+            : m_data { arr }, m_size { N }
+        {}
+
+        // any contiguous container: std::array, std::vector, exe_vector, etc.
+        template<class Container,
+                 typename = ::std::enable_if_t<
+                     ::std::is_convertible_v<::std::remove_pointer_t<decltype(::std::declval<Container&>().data())>(*)[], T(*)[]>>>
+        constexpr span(Container& container) noexcept
+            : m_data { container.data() }, m_size { static_cast<size_t>(container.size()) }
+        {}
+
+        // span<T> -> span<const T>
+        template<class U, typename = ::std::enable_if_t<::std::is_convertible_v<U(*)[], T(*)[]>>>
+        constexpr span(const span<U>& other) noexcept
+            : m_data { other.data() }, m_size { other.size() }
+        {}
+
+        constexpr span(const span&) noexcept            = default;
+        constexpr span& operator=(const span&) noexcept = default;
+
+    public:
+        [[nodiscard]] constexpr T* data() const noexcept
+        { return m_data; }
+
+        [[nodiscard]] constexpr size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] constexpr size_t size_bytes() const noexcept
+        { return m_size * sizeof(T); }
+
+        [[nodiscard]] constexpr bool empty() const noexcept
+        { return m_size == 0; }
+
+        [[nodiscard]] constexpr T* begin() const noexcept
+        { return m_data; }
+
+        [[nodiscard]] constexpr T* end() const noexcept
+        { return m_data + m_size; }
+
+        [[nodiscard]] constexpr T& operator[](size_t pos) const noexcept
+        { return m_data[pos]; }
+
+        [[nodiscard]] constexpr T& front() const noexcept
+        { return m_data[0]; }
+
+        [[nodiscard]] constexpr T& back() const noexcept
+        { return m_data[m_size - 1]; }
+
+        [[nodiscard]] constexpr span first(size_t count) const noexcept
+        { return { m_data, count }; }
+
+        [[nodiscard]] constexpr span last(size_t count) const noexcept
+        { return { m_data + (m_size - count), count }; }
+
+        [[nodiscard]] constexpr span subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const noexcept
+        { return { m_data + offset, count == static_cast<size_t>(-1) ? m_size - offset : count }; }
+
+    protected:
+        T*     m_data {nullptr};
+        size_t m_size {0};
+};
+
+template<class T>
+[[nodiscard]] inline span<const ::std::byte> as_bytes(span<T> s) noexcept
+{ return { reinterpret_cast<const ::std::byte*>(s.data()), s.size_bytes() }; }
+
+template<class T>
+[[nodiscard]] inline span<::std::byte> as_writable_bytes(span<T> s) noexcept
+{ return { reinterpret_cast<::std::byte*>(s.data()), s.size_bytes() }; }
+
+#endif // __cpp_lib_span
+
+} // namespace nh3api
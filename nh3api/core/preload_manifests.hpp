@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// Preload manifests of the game screens for nh3api::resource_preloader.
+// Not included by the other game headers: include it in the files which preload the resources
+
+#include <array>            // std::array
+#include <initializer_list> // std::initializer_list
+
+#include "../portable/preload_manifest.hpp" // nh3api::preload_entry, nh3api::preload_manifest
+#include "combat.hpp"                       // combatManager, armyGroup
+#include "resources/sounds.hpp"             // ResourceManager::GetSample
+#include "town.hpp"                         // TTownType, gDwellingType
+
+// Resources of a combat between <left> and <right> for nh3api::resource_preloader:
+// the sprites and the sounds of the creatures and, if <background> is not negative, the obstacles which may appear on it /
+// Ресурсы битвы между <left> и <right> для nh3api::resource_preloader:
+// спрайты и звуки существ и, если <background> неотрицателен, препятствия, которые могут появиться на этом поле боя.
+[[nodiscard]] inline nh3api::preload_manifest MakeCombatPreloadManifest(const armyGroup& left, const armyGroup& right, int32_t background = -1)
+{
+    nh3api::preload_manifest manifest;
+    for ( const armyGroup* const group : { &left, &right } )
+    {
+        for ( const TCreatureType type : group->type )
+        {
+            if ( type <= CREATURE_NONE || type >= MAX_COMBAT_CREATURES )
+                continue;
+
+            const TCreatureTypeTraits& traits = akCreatureTypeTraits[static_cast<size_t>(type)];
+            if ( traits.m_sprite_name )
+                manifest.add(traits.m_sprite_name, RType_creature);
+            if ( traits.cSamplePrefix == nullptr )
+                continue;
+
+            for ( const char* const suffix : { "MOVE.WAV", "ATTK.WAV", "WNCE.WAV", "DFND.WAV", "KILL.WAV" } )
+                manifest.add(traits.cSamplePrefix, suffix, RType_sfx);
+            if ( (traits.flags & CF_SHOOTING_ARMY) != 0 )
+                manifest.add(traits.cSamplePrefix, "SHOT.WAV", RType_sfx);
+        }
+    }
+
+    if ( background >= 0 && background < 32 )
+        for ( const combatManager::TObstacleInfo& obstacle : combatManager::ObstacleInfo )
+            if ( obstacle.FileName && (obstacle.backgroundMask & (1U << static_cast<uint32_t>(background))) != 0 )
+                manifest.add(obstacle.FileName, RType_sprite);
+
+    return manifest;
+}
+
+// Resources of the town screen of <townType> for nh3api::resource_preloader:
+// the background and the sprites of the dwelling creatures shown by the fort and the recruit dialogs /
+// Ресурсы экрана города <townType> для nh3api::resource_preloader:
+// фон и спрайты существ жилищ, показываемые в форте и в окне найма.
+[[nodiscard]] inline nh3api::preload_manifest MakeTownPreloadManifest(TTownType townType)
+{
+    nh3api::preload_manifest manifest;
+    if ( townType < eTownCastle || townType >= kNumTowns )
+        return manifest;
+
+    static constexpr std::array<const char*, kNumTowns> backgrounds
+    { "TBCSBACK.PCX", "TBRMBACK.PCX", "TBTWBACK.PCX", "TBINBACK.PCX", "TBNCBACK.PCX", "TBDNBACK.PCX", "TBSTBACK.PCX", "TBFRBACK.PCX", "TBELBACK.PCX" };
+    manifest.add(backgrounds[static_cast<size_t>(townType)], RType_bitmap16);
+
+    for ( const auto& level_types : gDwellingType[static_cast<size_t>(townType)] )
+        for ( const TCreatureType type : level_types )
+            if ( type > CREATURE_NONE && type < MAX_COMBAT_CREATURES && akCreatureTypeTraits[static_cast<size_t>(type)].m_sprite_name )
+                manifest.add(akCreatureTypeTraits[static_cast<size_t>(type)].m_sprite_name, RType_creature);
+
+    return manifest;
+}
+
+namespace ResourceManager
+{
+
+// Load the resource of a preload manifest entry through the cache, on the main thread(the handoff of nh3api::resource_preloader).
+// The result holds a reference: Dispose it when the screen is closed /
+// Загрузить ресурс записи списка предзагрузки через кэш, в главном потоке.
+[[nodiscard]] inline resource* GetPreloadResource(const nh3api::preload_entry& entry) noexcept
+{
+    const char* const name = entry.c_str();
+    switch ( static_cast<EResourceType>(entry.type) )
+    {
+        case RType_bitmap8:
+            return GetBitmap816(name);
+        case RType_bitmap16:
+            return GetBitmap16(name);
+        case RType_palette:
+            return GetPalette(name);
+        case RType_font:
+            return GetFont(name);
+        case RType_text:
+            return GetText(name);
+        case RType_sfx:
+            return GetSample(name);
+        case RType_sprite:
+        case RType_spritedef:
+        case RType_creature:
+        case RType_advobj:
+        case RType_hero:
+        case RType_tileset:
+        case RType_pointer:
+        case RType_interface:
+        case RType_combat_hero:
+            return GetSprite(name);
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace ResourceManager
@@ -7,10 +7,12 @@
 #pragma once
 
 #include <array>                          // std::array
+#include <cstring>                        // std::memcpy
 #include <memory>                         // std::destroy_at
 
 #include "../nh3api_std/exe_vector.hpp"   // exe_vector
 #include "../nh3api_std/exe_streambuf.hpp"
+#include "lod_format.hpp"                 // LODEntry, LODHeader
 
 NH3API_WARNING(push)
 NH3API_WARNING_GNUC_DISABLE("-Wuninitialized")
@@ -212,60 +214,6 @@ NH3API_VIRTUAL_CLASS TGzInflateBuf : public exe_streambuf
         bool m_open;
 };
 
-// LOD file entry /
-// Запись LOD-файла.
-// size = 0x20 = 32, align = 4
-struct LODEntry
-{
-    // Entry name /
-    // Название записи.
-    // offset: +0x0 = +0,  size = 0x10 = 16
-    std::array<char, 16> name {};
-
-    // Entry offset /
-    // Смещение записи
-    // offset: +0x10 = +16,  size = 0x4 = 4
-    ptrdiff_t offset {0};
-
-    // Entry uncompressed size /
-    // Размер несжатой записи.
-    // offset: +0x14 = +20,  size = 0x4 = 4
-    size_t size {0};
-
-    //
-    // offset: +0x18 = +24,  size = 0x4 = 4
-    int32_t attrib {0};
-
-    // Entry compressed size /
-    // Размер сжатой записи.
-    // offset: +0x1C = +28,  size = 0x4 = 4
-    size_t csize {0};
-};
-
-// LOD file header /
-// Заголовок LOD файла.
-// size = 0x5C = 92, align = 4
-struct LODHeader
-{
-    // offset: +0x0 = +0,  size = 0x4 = 4
-    std::array<char, 4> LOD_ID {};
-
-    // LOD File version /
-    // Версия LOD-файла.
-    // offset: +0x4 = +4,  size = 0x4 = 4
-    int32_t version {500};
-
-    // Number of entries /
-    // Количество записей.
-    // offset: +0x8 = +8,  size = 0x4 = 4
-    size_t numEntries {0};
-
-protected:
-    // offset: +0xC = +12,  size = 0x50 = 80
-    std::array<std::byte, 80> reserved {};
-
-};
-
 // LOD File /
 // LOD Файл.
 // size = 0x18C = 396, align = 4
@@ -0,0 +1,129 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// LOD archive on-disk layout.
+// This header does not depend on the game executable and can be used on any platform:
+// the structures use fixed-width types so that they keep the .exe layout on 64-bit hosts as well.
+// LOD files are little-endian.
+
+#include <array>       // std::array
+#include <cstddef>     // std::byte
+#include <cstdint>     // int32_t, uint32_t
+#include <cstring>     // strnlen
+#include <string_view> // std::string_view
+
+#include "../nh3api_std/hash.hpp" // nh3api::tolower_constexpr
+
+#pragma pack(push, 4)
+// LOD file entry /
+// Запись LOD-файла.
+// size = 0x20 = 32, align = 4
+struct LODEntry
+{
+    // Entry name /
+    // Название записи.
+    // offset: +0x0 = +0,  size = 0x10 = 16
+    std::array<char, 16> name {};
+
+    // Entry offset /
+    // Смещение записи
+    // offset: +0x10 = +16,  size = 0x4 = 4
+    int32_t offset {0};
+
+    // Entry uncompressed size /
+    // Размер несжатой записи.
+    // offset: +0x14 = +20,  size = 0x4 = 4
+    uint32_t size {0};
+
+    //
+    // offset: +0x18 = +24,  size = 0x4 = 4
+    int32_t attrib {0};
+
+    // Entry compressed size /
+    // Размер сжатой записи.
+    // offset: +0x1C = +28,  size = 0x4 = 4
+    uint32_t csize {0};
+};
+
+// LOD file header /
+// Заголовок LOD файла.
+// size = 0x5C = 92, align = 4
+struct LODHeader
+{
+    // offset: +0x0 = +0,  size = 0x4 = 4
+    std::array<char, 4> LOD_ID {};
+
+    // LOD File version /
+    // Версия LOD-файла.
+    // offset: +0x4 = +4,  size = 0x4 = 4
+    int32_t version {500};
+
+    // Number of entries /
+    // Количество записей.
+    // offset: +0x8 = +8,  size = 0x4 = 4
+    uint32_t numEntries {0};
+
+protected:
+    // offset: +0xC = +12,  size = 0x50 = 80
+    std::array<std::byte, 80> reserved {};
+
+};
+#pragma pack(pop) // 4
+
+static_assert(sizeof(LODEntry) == 0x20, "size mismatch");
+static_assert(sizeof(LODHeader) == 0x5C, "size mismatch");
+
+namespace nh3api
+{
+
+// LOD file signature ("LOD\0")
+inline constexpr std::array<char, 4> lod_signature { 'L', 'O', 'D', '\0' };
+
+// entry name without the trailing zeroes
+[[nodiscard]] inline std::string_view lod_entry_name(const LODEntry& entry) noexcept
+{ return { entry.name.data(), ::strnlen(entry.name.data(), entry.name.size()) }; }
+
+// entry data size as stored in the archive
+[[nodiscard]] inline constexpr uint32_t lod_stored_size(const LODEntry& entry) noexcept
+{ return entry.csize != 0 ? entry.csize : entry.size; }
+
+// case-insensitive name comparison with the _stricmp semantics,
+// the game looks up the LOD entries with it
+[[nodiscard]] inline constexpr int32_t lod_name_compare(std::string_view lhs, std::string_view rhs) noexcept
+{
+    const size_t length = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+    for ( size_t i = 0; i < length; ++i )
+    {
+        const uint8_t l = static_cast<uint8_t>(tolower_constexpr(lhs[i]));
+        const uint8_t r = static_cast<uint8_t>(tolower_constexpr(rhs[i]));
+        if ( l != r )
+            return l < r ? -1 : 1;
+    }
+
+    if ( lhs.size() == rhs.size() )
+        return 0;
+
+    return lhs.size() < rhs.size() ? -1 : 1;
+}
+
+[[nodiscard]] inline constexpr bool lod_name_equal(std::string_view lhs, std::string_view rhs) noexcept
+{
+    if ( lhs.size() != rhs.size() )
+        return false;
+
+    for ( size_t i = 0; i < lhs.size(); ++i )
+        if ( tolower_constexpr(lhs[i]) != tolower_constexpr(rhs[i]) )
+            return false;
+
+    return true;
+}
+
+} // namespace nh3api
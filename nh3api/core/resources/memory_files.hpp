@@ -0,0 +1,328 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// Files and stream buffers held in memory, built on the portable headers(nh3api/portable).
+// Not included by files.hpp: include it in the files which use them
+
+#include <cstring>                          // std::memcpy
+#include <utility>                          // std::move
+#include <vector>                           // std::vector
+
+#include "../nh3api_std/span.hpp"           // nh3api::span
+#include "../../portable/gzip.hpp"          // nh3api::gzip_uncompress
+#include "../../portable/memory_stream.hpp" // nh3api::memory_reader, nh3api::memory_writer
+#include "files.hpp"                        // TAbstractFile, exe_streambuf
+
+NH3API_WARNING(push)
+NH3API_WARNING_GNUC_DISABLE("-Wuninitialized")
+NH3API_WARNING_MSVC_DISABLE(26495)
+
+#pragma pack(push, 4)
+// gzip stream buffer with the in-tree inflate /
+// Поток чтения gz-файла со встроенной распаковкой.
+// Replacement for TGzInflateBuf: the source is read in large chunks(<read_chunk> bytes) instead of the exe's small buffers,
+// decoded at once with nh3api::gzip_uncompress and CRC-32 is verified with the slice-by-8/PCLMUL routine.
+// It does not stream: while decoding, the whole compressed file and the whole decoded data are held in memory.
+// The decoded data is then served from memory, so the buffer is also seekable.
+// That's fine for the saved games and the maps(a few MB), use TGzInflateBuf for the inputs which must not be held in memory.
+// Sources which are not gzip are passed through as is, like TGzInflateBuf does.
+// Wrap it into TStreamBufFile to use it instead of TGzFile.
+NH3API_VIRTUAL_CLASS t_gz_inflate_buf final : public exe_streambuf
+{
+    public:
+        static inline constexpr size_t default_read_chunk = size_t(1) << 20U;
+
+    public:
+        explicit t_gz_inflate_buf(exe_streambuf& src, size_t read_chunk = default_read_chunk)
+            : exe_streambuf(nh3api::omit_base_vftable_tag), data{}, status{nh3api::inflate_status::ok}, checksum{0}, compressed{false}
+        {
+            _Loc = nullptr;
+            std::vector<std::byte> input;
+            read_chunk = read_chunk != 0 ? read_chunk : default_read_chunk;
+            for ( size_t read = read_chunk; read == read_chunk; )
+            {
+                const size_t offset = input.size();
+                input.resize(offset + read_chunk);
+                const int32_t result = src.sgetn(reinterpret_cast<char*>(input.data() + offset), static_cast<int32_t>(read_chunk));
+                read = result > 0 ? static_cast<size_t>(result) : 0;
+                input.resize(offset + read);
+            }
+            decode(std::move(input));
+        }
+
+        // decode a file already in memory, the data is copied only if it is not compressed
+        explicit t_gz_inflate_buf(nh3api::span<const std::byte> src)
+            : exe_streambuf(nh3api::omit_base_vftable_tag), data{}, status{nh3api::inflate_status::ok}, checksum{0}, compressed{false}
+        {
+            _Loc = nullptr;
+            if ( nh3api::is_gzip(src) )
+                decode_gzip(src);
+            else
+                decode(std::vector<std::byte>(src.begin(), src.end()));
+        }
+
+        ~t_gz_inflate_buf() noexcept = default;
+        t_gz_inflate_buf(const t_gz_inflate_buf&)            = delete;
+        t_gz_inflate_buf& operator=(const t_gz_inflate_buf&) = delete;
+
+    public:
+        [[nodiscard]] bool is_compressed() const noexcept
+        { return compressed; }
+
+        // CRC-32 of the decoded data, 0 if the source is not compressed
+        [[nodiscard]] uint32_t crc() const noexcept
+        { return checksum; }
+
+        [[nodiscard]] bool is_open() const noexcept
+        { return status == nh3api::inflate_status::ok; }
+
+        // nh3api::inflate_status::ok, or the reason why the source could not be decoded(nothing can be read then)
+        [[nodiscard]] nh3api::inflate_status get_status() const noexcept
+        { return status; }
+
+        // the whole decoded data
+        [[nodiscard]] nh3api::span<const std::byte> get_data() const noexcept
+        { return { data.data(), data.size() }; }
+
+    // virtual functions
+    public:
+        void __thiscall scalar_deleting_destructor(uint8_t flag) override
+        { nh3api::scalar_deleting_destructor(this, flag); }
+
+        int32_t __thiscall showmanyc() override
+        { return gptr() < egptr() ? static_cast<int32_t>(egptr() - gptr()) : -1; }
+
+        int32_t __thiscall underflow() override
+        { return gptr() < egptr() ? static_cast<int32_t>(static_cast<uint8_t>(*gptr())) : static_cast<int32_t>(EOF); }
+
+        int32_t __thiscall uflow() override
+        {
+            const int32_t result = underflow();
+            if ( result != static_cast<int32_t>(EOF) )
+                gbump(1);
+
+            return result;
+        }
+
+        int32_t __thiscall xsgetn(char* _S, int32_t _N) override
+        {
+            const int32_t available = static_cast<int32_t>(egptr() - gptr());
+            const int32_t count     = _N < available ? _N : available;
+            if ( count <= 0 )
+                return 0;
+
+            std::memcpy(_S, gptr(), static_cast<size_t>(count));
+            gbump(count);
+            return count;
+        }
+
+        pos_type* __thiscall seekoff(pos_type* result, off_type off, exe_ios::seekdir seek, exe_ios::openmode mode) override
+        {
+            const int32_t base = seek == exe_ios::beg ? 0
+                               : seek == exe_ios::cur ? static_cast<int32_t>(gptr() - eback())
+                               : static_cast<int32_t>(data.size());
+            return seek_to(result, seek <= exe_ios::end ? base + off : -1, mode);
+        }
+
+        pos_type* __thiscall seekpos(pos_type* result, pos_type pos, exe_ios::openmode mode) override
+        { return seek_to(result, static_cast<int32_t>(pos), mode); }
+
+    protected:
+        void decode(std::vector<std::byte> input)
+        {
+            if ( nh3api::is_gzip({ input.data(), input.size() }) )
+            {
+                decode_gzip({ input.data(), input.size() });
+                return;
+            }
+
+            data = std::move(input);
+            reset_get_area();
+        }
+
+        void decode_gzip(nh3api::span<const std::byte> input)
+        {
+            compressed = true;
+            status     = nh3api::gzip_uncompress(input, data, 0, static_cast<size_t>(-1), &checksum);
+            if ( status != nh3api::inflate_status::ok )
+            {
+                checksum = 0;
+                std::vector<std::byte>().swap(data);
+            }
+
+            reset_get_area();
+        }
+
+        void reset_get_area() noexcept
+        {
+            char* const begin = reinterpret_cast<char*>(data.data());
+            setg(begin, begin, begin + data.size());
+        }
+
+        pos_type* seek_to(pos_type* result, int32_t position, exe_ios::openmode mode) noexcept
+        {
+            if ( (mode & exe_ios::in) == 0 || position < 0 || static_cast<size_t>(position) > data.size() )
+                position = -1;
+            else
+                setg(eback(), eback() + position, eback() + data.size());
+
+            *result = pos_type(position);
+            return result;
+        }
+
+    // member variables
+    protected:
+        std::vector<std::byte> data;
+        nh3api::inflate_status status;
+        uint32_t               checksum;
+        bool                   compressed;
+
+};
+
+// Read-only file over a memory block /
+// Файл только для чтения поверх области памяти.
+// Unlike t_lod_file_adapter and t_stdio_file_adapter, it has its own vftable: read() is a bounded memcpy, no system calls, no FILE or streambuf.
+// The data is not copied and must outlive the adapter: a mapped file, a cached LOD entry, a network packet, etc.
+// Allocate it with new (exe_heap) if the game is going to delete it.
+// size = 0x10 = 16, align = 4, baseclass: TAbstractFile
+class t_memory_file_adapter final : public TAbstractFile
+{
+    public:
+        // destination of read_scatter()
+        using buffer_t = nh3api::scatter_buffer;
+
+    public:
+        t_memory_file_adapter(nh3api::span<const std::byte> src) noexcept
+            : TAbstractFile(nh3api::dummy_tag), reader{src}
+        {}
+
+        t_memory_file_adapter(const void* src, size_t size) noexcept
+            : TAbstractFile(nh3api::dummy_tag), reader{src, size}
+        {}
+
+        ~t_memory_file_adapter() noexcept = default;
+        t_memory_file_adapter(const t_memory_file_adapter&)            noexcept = default;
+        t_memory_file_adapter& operator=(const t_memory_file_adapter&) noexcept = default;
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        { return reader.size(); }
+
+        [[nodiscard]] size_t tell() const noexcept
+        { return reader.tell(); }
+
+        [[nodiscard]] size_t remaining() const noexcept
+        { return reader.remaining(); }
+
+        [[nodiscard]] bool eof() const noexcept
+        { return reader.eof(); }
+
+        // seek to the absolute <offset>, clamped to the end of data
+        void seek(size_t offset) noexcept
+        { reader.seek(offset); }
+
+        // the whole data
+        [[nodiscard]] nh3api::span<const std::byte> get_data() const noexcept
+        { return reader.data(); }
+
+        // zero-copy read: view of the next <len> bytes(or less at the end of data)
+        [[nodiscard]] nh3api::span<const std::byte> read_view(size_t len) noexcept
+        { return reader.read_view(len); }
+
+        // scatter read: fill <buffers> one after another, returns the total number of bytes read
+        size_t read_scatter(nh3api::span<const buffer_t> buffers) noexcept
+        { return reader.read_scatter(buffers); }
+
+    // virtual functions
+    public:
+        void __thiscall scalar_deleting_destructor(uint8_t flag) override
+        { nh3api::scalar_deleting_destructor(this, flag); }
+
+        // returns the number of bytes read
+        int32_t __thiscall read(void* buf, size_t len) override
+        { return static_cast<int32_t>(reader.read(buf, len)); }
+
+    protected:
+        int32_t __thiscall write(const void*, size_t) override
+        { return 0; }
+
+    // member variables
+    protected:
+        // data, size and position
+        // offset: +0x4 = +4,  size = 0xC = 12
+        nh3api::memory_reader reader;
+
+};
+
+// Write-only file into a growing memory buffer /
+// Файл только для записи в расширяемый буфер в памяти.
+// The buffer is allocated on the exe heap and grows geometrically, so it can be handed over to the game code.
+// Allocate it with new (exe_heap) if the game is going to delete it.
+// size = 0x14 = 20, align = 4, baseclass: TAbstractFile
+class t_memory_write_adapter final : public TAbstractFile
+{
+    public:
+        t_memory_write_adapter() noexcept
+            : TAbstractFile(nh3api::dummy_tag), writer{}
+        {}
+
+        explicit t_memory_write_adapter(size_t reserved_size)
+            : TAbstractFile(nh3api::dummy_tag), writer{reserved_size}
+        {}
+
+        ~t_memory_write_adapter() noexcept = default;
+        t_memory_write_adapter(const t_memory_write_adapter&)            = default;
+        t_memory_write_adapter(t_memory_write_adapter&&)                 noexcept = default;
+        t_memory_write_adapter& operator=(const t_memory_write_adapter&) = default;
+        t_memory_write_adapter& operator=(t_memory_write_adapter&&)      noexcept = default;
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        { return writer.size(); }
+
+        [[nodiscard]] nh3api::span<const std::byte> get_data() const noexcept
+        { return writer.data(); }
+
+        [[nodiscard]] const exe_vector<std::byte>& get_buffer() const noexcept
+        { return writer.buffer(); }
+
+        // take the written data, the adapter becomes empty
+        [[nodiscard]] exe_vector<std::byte> release() noexcept
+        { return writer.release(); }
+
+        void clear() noexcept
+        { writer.clear(); }
+
+        void reserve(size_t new_capacity)
+        { writer.reserve(new_capacity); }
+
+    // virtual functions
+    public:
+        void __thiscall scalar_deleting_destructor(uint8_t flag) override
+        { nh3api::scalar_deleting_destructor(this, flag); }
+
+        // returns the number of bytes written
+        int32_t __thiscall write(const void* buf, size_t len) override
+        { return static_cast<int32_t>(writer.write(buf, len)); }
+
+    protected:
+        int32_t __thiscall read(void*, size_t) override
+        { return 0; }
+
+    // member variables
+    protected:
+        // offset: +0x4 = +4,  size = 0x10 = 16
+        nh3api::memory_writer<exe_vector<std::byte>> writer;
+
+};
+#pragma pack(pop) // 4
+
+NH3API_WARNING(pop)
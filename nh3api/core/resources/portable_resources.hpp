@@ -0,0 +1,166 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// The resources of the game for the portable headers(nh3api/portable).
+// Not included by resources.hpp: include it in the files which use the portable decoders and kernels
+
+#include <cstddef> // std::byte
+
+#include "../../portable/def_sprite.hpp"        // nh3api::def_frame, nh3api::decode_def_frame
+#include "../../portable/palette_animation.hpp" // nh3api::palette_animation
+#include "../../portable/palette_kernels.hpp"   // nh3api::convert_rgb24_to_16, nh3api::shade_masks16
+#include "../../portable/resource_index.hpp"    // nh3api::resource_index
+#include "../../portable/surface_kernels.hpp"   // nh3api::surface16
+#include "../../portable/text_layout.hpp"       // nh3api::bitmap_font
+#include "resources.hpp"                        // CSpriteFrame, CSprite, Bitmap16Bit, font, TPalette16
+
+namespace nh3api
+{
+
+// Frame header and data of <frame> for the portable decoder, see nh3api::decode_def_frame /
+// Заголовок и данные кадра для переносимого декодера, см. nh3api::decode_def_frame.
+[[nodiscard]] inline def_frame get_def_frame(const CSpriteFrame& frame) noexcept
+{
+    def_frame result;
+    result.header.data_size      = static_cast<uint32_t>(frame.DataSize);
+    result.header.encoding       = static_cast<def_encoding>(frame.EncodingMethod);
+    result.header.width          = frame.Width;
+    result.header.height         = frame.Height;
+    result.header.cropped_width  = frame.CroppedWidth;
+    result.header.cropped_height = frame.CroppedHeight;
+    result.header.cropped_x      = frame.CroppedX;
+    result.header.cropped_y      = frame.CroppedY;
+    result.data                  = { reinterpret_cast<const ::std::byte*>(frame.map), static_cast<size_t>(frame.DataSize) };
+    return result;
+}
+
+// CSpriteFrame::div2mask and div4mask of the current display format for nh3api::blit_composite /
+// div2mask и div4mask текущего формата экрана для nh3api::blit_composite.
+[[nodiscard]] inline shade_masks16 get_shade_masks() noexcept
+{ return { CSpriteFrame::div2mask, CSpriteFrame::div4mask }; }
+
+// Pixels of <bitmap> for the portable kernels(nh3api::fill_rect, nh3api::darken, nh3api::colorize) /
+// Пиксели для переносимых функций(nh3api::fill_rect, nh3api::darken, nh3api::colorize).
+[[nodiscard]] inline surface16 get_surface(const Bitmap16Bit& bitmap) noexcept
+{ return { bitmap.map, bitmap.Width, bitmap.Height, bitmap.Pitch }; }
+
+// Metrics and glyph pixels of <source> for the portable text layout, see nh3api::layout_text /
+// Метрики и пиксели символов для переносимой разметки текста, см. nh3api::layout_text.
+[[nodiscard]] inline bitmap_font get_bitmap_font(const font& source) noexcept
+{
+    bitmap_font result;
+    result.height   = source.fr.height;
+    result.baseline = source.fr.baseyoffset;
+    for ( size_t i = 0; i < 256; ++i )
+        result.glyphs[i] = { source.fr.abc[i].abcA, source.fr.abc[i].abcB, source.fr.abc[i].abcC, source.fr.Offset[i] };
+    result.pixels = { reinterpret_cast<const ::std::byte*>(source.Data), source.DataSize };
+    return result;
+}
+
+// Set the cycled entries of the palette of <sprite> to the precomputed phase of <tick> instead of rotating them with CSprite::ColorCycle /
+// Установить циклические цвета палитры спрайта в заранее вычисленную фазу <tick> вместо сдвига через CSprite::ColorCycle.
+// Unverified: the phases rotate each range one entry down per step(entry <begin> takes entry <begin> + 1),
+// the direction of TPalette16::Cycle(0x522E40) is assumed, not checked against the executable
+inline void color_cycle(CSprite& sprite, const palette_animation<uint16_t>& animation, uint64_t tick) noexcept
+{
+    if ( sprite.p16 )
+        animation.apply(tick, sprite.p16->Palette.data());
+}
+
+// TPalette16::Convert24to16 to a compile-time layout, e.g. nh3api::rgb565_layout /
+// TPalette16::Convert24to16 в заданный на этапе компиляции формат, например nh3api::rgb565_layout.
+template<class Layout>
+inline void convert_palette(TPalette16& p16, const TPalette24& p24) noexcept
+{ convert_rgb24_to_16<Layout>(&p24.Palette.data()->Red, p16.Palette.data(), p16.Palette.size()); }
+
+// Convert <count> palettes at once: p24[i] -> p16[i] /
+// Конвертировать <count> палитр за раз: p24[i] -> p16[i].
+template<class Layout>
+inline void convert_palettes(TPalette16* const* p16, const TPalette24* const* p24, size_t count) noexcept
+{
+    for ( size_t i = 0; i < count; ++i )
+        convert_palette<Layout>(*p16[i], *p24[i]);
+}
+
+// TPalette16::Convert24to16 with the display modes of the game(see ResourceManager::RedBits) converted by the layouts above /
+// TPalette16::Convert24to16, форматы экрана игры конвертируются через заданные на этапе компиляции форматы.
+inline void convert_palette(TPalette16& p16, const TPalette24& p24, uint32_t rbits, uint32_t rshift, uint32_t gbits, uint32_t gshift, uint32_t bbits, uint32_t bshift) noexcept
+{
+    if ( rbits == 5 && gbits == 6 && bbits == 5 && rshift == 11 && gshift == 5 && bshift == 0 )
+        return convert_palette<rgb565_layout>(p16, p24);
+    if ( rbits == 5 && gbits == 5 && bbits == 5 && rshift == 10 && gshift == 5 && bshift == 0 )
+        return convert_palette<rgb555_layout>(p16, p24);
+
+    p16.Convert24to16(p24, rbits, rshift, gbits, gshift, bbits, bshift);
+}
+
+} // namespace nh3api
+
+namespace ResourceManager
+{
+
+// Hash index mirroring GetResourceMap() /
+// Хэш-индекс, повторяющий GetResourceMap().
+// Kept in sync by OnAddToCache and OnResourceRemoved called from the hooks of AddToCache(0x5596F0) and ~resource(0x5589F0)
+[[nodiscard]] inline nh3api::resource_index<resource>& GetResourceIndex() noexcept
+{
+    static nh3api::resource_index<resource> index { 4096 };
+    return index;
+}
+
+// Call after AddToCache(r) /
+// Вызывать после AddToCache(r).
+inline void OnAddToCache(resource* r)
+{
+    if ( r )
+        GetResourceIndex().insert(r->get_Name(), r);
+}
+
+// Call before <r> leaves the cache or is destroyed /
+// Вызывать до удаления <r> из кэша или его уничтожения.
+inline void OnResourceRemoved(const resource* r) noexcept
+{
+    if ( r )
+        GetResourceIndex().erase(r->get_Name(), r);
+}
+
+// Fill the index with the resources already in the cache, e.g. when the hooks are installed after the game start /
+// Заполнить индекс ресурсами, уже находящимися в кэше.
+inline void RebuildResourceIndex()
+{
+    nh3api::resource_index<resource>& index = GetResourceIndex();
+    index.clear();
+    index.reserve(GetResourceMap().size());
+    for ( const auto& entry : GetResourceMap() )
+        index.insert(entry.first.name.data(), entry.second);
+}
+
+// GetFromCache probing the index first; a resource found only in the tree is added to the index /
+// GetFromCache с предварительным поиском в индексе.
+[[nodiscard]] inline resource* GetFromCacheFast(const char* name)
+{
+    if ( name == nullptr )
+        return nullptr;
+
+    if ( resource* const result = GetResourceIndex().find(name) )
+    {
+        result->AddRef();
+        return result;
+    }
+
+    // indexed by the name of the resource: OnResourceRemoved erases it by that name
+    resource* const result = GetFromCache(name);
+    if ( result )
+        GetResourceIndex().insert(result->get_Name(), result);
+    return result;
+}
+
+} // namespace ResourceManager
@@ -18,6 +18,7 @@
 #include "core/nh3api_std/exe_vector.hpp"
 #include "core/nh3api_std/patcher_x86.hpp"
 #include "core/resources/resources.hpp"
+#include "portable/surface_kernels.hpp" // nh3api::surface16, nh3api::surface32
 
 // Game version of HD Mod /
 // Версия игры с точки зрения HD Mod.
@@ -247,6 +248,16 @@ struct Bitmap : public ::resource
         inline void Colorize(int32_t x, int32_t y, int32_t w, int32_t h, float hue, float saturation)
         { THISCALL_7(void, 0x44E610, this, x, y, w, h, hue, saturation); }
 
+        // Pixels for the portable kernels, 16-bit mode /
+        // Пиксели для переносимых функций, 16-битный режим.
+        [[nodiscard]] nh3api::surface16 get_surface() const noexcept
+        { return { map, Width, Height, Pitch }; }
+
+        // Pixels for the portable kernels, 32-bit mode(see isHDMod32Bit) /
+        // Пиксели для переносимых функций, 32-битный режим(см. isHDMod32Bit).
+        [[nodiscard]] nh3api::surface32 get_surface32() const noexcept
+        { return { map32, Width, Height, Pitch }; }
+
         // virtual functions
     public:
         NH3API_VIRTUAL_OVERRIDE_RESOURCE(Bitmap)
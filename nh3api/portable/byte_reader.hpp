@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>     // std::byte
+#include <cstdint>     // uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>     // std::memcpy
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <type_traits> // std::is_integral_v, std::make_unsigned_t
+#include <vector>      // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+
+namespace nh3api
+{
+
+// Little endian reader of the game's file formats(maps, saved games, campaigns).
+// Reading past the end does not throw: the reader fails, returns zeroes and stays failed,
+// so a parser checks ok() once after a group of reads
+class byte_reader
+{
+    public:
+        explicit byte_reader(span<const ::std::byte> data) noexcept
+            : m_data { data }
+        {}
+
+    public:
+        // integer of sizeof(T) bytes
+        template<class T>
+        T read() noexcept
+        {
+            static_assert(::std::is_integral_v<T>, "byte_reader::read<T>: T must be an integer");
+            using unsigned_t = ::std::make_unsigned_t<T>;
+            const span<const ::std::byte> bytes = view(sizeof(T));
+            if ( bytes.empty() )
+                return T {};
+
+            unsigned_t result = 0;
+            for ( size_t i = 0; i < sizeof(T); ++i )
+                result |= static_cast<unsigned_t>(static_cast<unsigned_t>(static_cast<uint8_t>(bytes[i])) << (8 * i));
+
+            return static_cast<T>(result);
+        }
+
+        bool read_bool() noexcept
+        { return read<uint8_t>() != 0; }
+
+        // string prefixed with its 32-bit length, longer than <max_size> fails the reader
+        ::std::string read_string(size_t max_size = 1U << 16U)
+        {
+            const uint32_t size = read<uint32_t>();
+            if ( size > max_size )
+            {
+                fail();
+                return {};
+            }
+
+            const span<const ::std::byte> bytes = view(size);
+            return { reinterpret_cast<const char*>(bytes.data()), bytes.size() };
+        }
+
+        // view of the next <size> bytes, empty if there are less bytes left
+        span<const ::std::byte> view(size_t size) noexcept
+        {
+            if ( !m_ok || size > remaining() )
+            {
+                fail();
+                return {};
+            }
+
+            const span<const ::std::byte> result = m_data.subspan(m_position, size);
+            m_position += size;
+            return result;
+        }
+
+        void read(void* destination, size_t size) noexcept
+        {
+            const span<const ::std::byte> bytes = view(size);
+            if ( !bytes.empty() )
+                ::std::memcpy(destination, bytes.data(), size);
+        }
+
+        void skip(size_t size) noexcept
+        { static_cast<void>(view(size)); }
+
+        void fail() noexcept
+        {
+            m_ok       = false;
+            m_position = m_data.size();
+        }
+
+        [[nodiscard]] bool ok() const noexcept
+        { return m_ok; }
+
+        [[nodiscard]] size_t position() const noexcept
+        { return m_position; }
+
+        [[nodiscard]] size_t remaining() const noexcept
+        { return m_data.size() - m_position; }
+
+    protected:
+        span<const ::std::byte> m_data;
+        size_t                  m_position {0};
+        bool                    m_ok {true};
+
+};
+
+// Little endian writer, the counterpart of byte_reader
+class byte_writer
+{
+    public:
+        explicit byte_writer(::std::vector<::std::byte>& output) noexcept
+            : m_output { output }
+        {}
+
+    public:
+        template<class T>
+        void write(T value)
+        {
+            static_assert(::std::is_integral_v<T>, "byte_writer::write<T>: T must be an integer");
+            using unsigned_t = ::std::make_unsigned_t<T>;
+            const unsigned_t bits = static_cast<unsigned_t>(value);
+            for ( size_t i = 0; i < sizeof(T); ++i )
+                m_output.push_back(static_cast<::std::byte>(static_cast<uint8_t>(bits >> (8 * i))));
+        }
+
+        void write_bool(bool value)
+        { write<uint8_t>(value ? 1 : 0); }
+
+        void write_string(::std::string_view value)
+        {
+            write<uint32_t>(static_cast<uint32_t>(value.size()));
+            write(value.data(), value.size());
+        }
+
+        void write(const void* source, size_t size)
+        {
+            const ::std::byte* const bytes = static_cast<const ::std::byte*>(source);
+            m_output.insert(m_output.end(), bytes, bytes + size);
+        }
+
+    protected:
+        ::std::vector<::std::byte>& m_output;
+
+};
+
+} // namespace nh3api
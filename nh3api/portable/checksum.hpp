@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cstddef> // std::byte
+#include <cstdint> // uint32_t
+#include <cstring> // std::memcpy
+
+// carry-less multiplication CRC32: GCC/Clang with -mpclmul, MSVC with /arch:AVX or higher(every AVX CPU has PCLMULQDQ),
+// or define NH3API_FLAG_PCLMUL to enable it explicitly
+#if defined(__PCLMUL__) || (defined(_MSC_VER) && defined(__AVX__)) || defined(NH3API_FLAG_PCLMUL)
+    #define NH3API_CRC32_PCLMUL 1
+    #include <emmintrin.h> // SSE2
+    #include <wmmintrin.h> // _mm_clmulepi64_si128
+#else
+    #define NH3API_CRC32_PCLMUL 0
+#endif
+
+namespace nh3api
+{
+
+// Adler-32 checksum of the zlib streams(RFC 1950).
+// Pass the previous result as <adler> to continue the checksum, start with 1
+[[nodiscard]] inline uint32_t adler32(const ::std::byte* data, size_t size, uint32_t adler = 1) noexcept
+{
+    // the largest n such that 255n(n+1)/2 + (n+1)(65521-1) <= 2^32-1
+    constexpr size_t nmax = 5552;
+    uint32_t a = adler & 0xFFFFU;
+    uint32_t b = adler >> 16U;
+    while ( size != 0 )
+    {
+        size_t chunk = size < nmax ? size : nmax;
+        size -= chunk;
+        for ( ; chunk >= 8; chunk -= 8, data += 8 )
+        {
+            a += static_cast<uint8_t>(data[0]); b += a;
+            a += static_cast<uint8_t>(data[1]); b += a;
+            a += static_cast<uint8_t>(data[2]); b += a;
+            a += static_cast<uint8_t>(data[3]); b += a;
+            a += static_cast<uint8_t>(data[4]); b += a;
+            a += static_cast<uint8_t>(data[5]); b += a;
+            a += static_cast<uint8_t>(data[6]); b += a;
+            a += static_cast<uint8_t>(data[7]); b += a;
+        }
+        for ( ; chunk != 0; --chunk, ++data )
+        {
+            a += static_cast<uint8_t>(*data);
+            b += a;
+        }
+        a %= 65521U;
+        b %= 65521U;
+    }
+
+    return (b << 16U) | a;
+}
+
+namespace crc32_detail
+{
+// slice-by-8 tables of the reflected polynomial 0xEDB88320:
+// tables[k][i] is the CRC of byte i followed by k zero bytes
+inline constexpr ::std::array<::std::array<uint32_t, 256>, 8> tables = []() constexpr
+{
+    ::std::array<::std::array<uint32_t, 256>, 8> result {};
+    for ( uint32_t i = 0; i < 256; ++i )
+    {
+        uint32_t crc = i;
+        for ( uint32_t bit = 0; bit < 8; ++bit )
+            crc = (crc >> 1U) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        result[0][i] = crc;
+    }
+    for ( uint32_t i = 0; i < 256; ++i )
+        for ( size_t k = 1; k < 8; ++k )
+            result[k][i] = (result[k - 1][i] >> 8U) ^ result[0][result[k - 1][i] & 0xFFU];
+
+    return result;
+}();
+
+// <crc> is the inverted running value
+[[nodiscard]] inline uint32_t slice_by_8(const ::std::byte* data, size_t size, uint32_t crc) noexcept
+{
+    for ( ; size >= 8; size -= 8, data += 8 )
+    {
+        // little endian loads, x86 and ARM
+        uint32_t low, high;
+        ::std::memcpy(&low, data, 4);
+        ::std::memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = tables[7][low & 0xFFU] ^ tables[6][(low >> 8U) & 0xFFU] ^ tables[5][(low >> 16U) & 0xFFU] ^ tables[4][low >> 24U]
+            ^ tables[3][high & 0xFFU] ^ tables[2][(high >> 8U) & 0xFFU] ^ tables[1][(high >> 16U) & 0xFFU] ^ tables[0][high >> 24U];
+    }
+    for ( ; size != 0; --size, ++data )
+        crc = (crc >> 8U) ^ tables[0][(crc ^ static_cast<uint8_t>(*data)) & 0xFFU];
+
+    return crc;
+}
+
+#if NH3API_CRC32_PCLMUL
+// folding with PCLMULQDQ, four 128-bit lanes at a time, then a Barrett reduction
+// (Intel, "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction").
+// <size> must be a multiple of 16 and at least 64, <crc> is the inverted running value
+[[nodiscard]] inline uint32_t pclmul(const ::std::byte* data, size_t size, uint32_t crc) noexcept
+{
+    const __m128i k1k2 = _mm_set_epi64x(0x01C6E41596LL, 0x0154442BD4LL);
+    const __m128i k3k4 = _mm_set_epi64x(0x00CCAA009ELL, 0x01751997D0LL);
+    const __m128i k5k0 = _mm_set_epi64x(0, 0x0163CD6124LL);
+    const __m128i poly = _mm_set_epi64x(0x01F7011641LL, 0x01DB710641LL);
+    const __m128i mask = _mm_setr_epi32(-1, 0, -1, 0);
+
+    const auto load = [](const ::std::byte* at) noexcept
+    { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)); };
+
+    const auto fold = [](__m128i value, __m128i next, __m128i constants) noexcept
+    {
+        const __m128i low  = _mm_clmulepi64_si128(value, constants, 0x00);
+        const __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+        return _mm_xor_si128(_mm_xor_si128(high, low), next);
+    };
+
+    __m128i x1 = _mm_xor_si128(load(data), _mm_cvtsi32_si128(static_cast<int32_t>(crc)));
+    __m128i x2 = load(data + 16);
+    __m128i x3 = load(data + 32);
+    __m128i x4 = load(data + 48);
+    data += 64;
+    size -= 64;
+
+    for ( ; size >= 64; data += 64, size -= 64 )
+    {
+        x1 = fold(x1, load(data), k1k2);
+        x2 = fold(x2, load(data + 16), k1k2);
+        x3 = fold(x3, load(data + 32), k1k2);
+        x4 = fold(x4, load(data + 48), k1k2);
+    }
+
+    x1 = fold(x1, x2, k3k4);
+    x1 = fold(x1, x3, k3k4);
+    x1 = fold(x1, x4, k3k4);
+    for ( ; size >= 16; data += 16, size -= 16 )
+        x1 = fold(x1, load(data), k3k4);
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k5k0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), poly, 0x10);
+    x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), poly, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(x1, 4)));
+}
+#endif
+
+} // namespace crc32_detail
+
+// CRC-32 of the gzip streams(RFC 1952), the same as zlib's crc32().
+// Pass the previous result as <crc> to continue the checksum, start with 0
+[[nodiscard]] inline uint32_t crc32(const ::std::byte* data, size_t size, uint32_t crc = 0) noexcept
+{
+    crc = ~crc;
+#if NH3API_CRC32_PCLMUL
+    if ( size >= 64 )
+    {
+        const size_t folded = size & ~size_t(15);
+        crc   = crc32_detail::pclmul(data, folded, crc);
+        data += folded;
+        size -= folded;
+    }
+#endif
+    return ~crc32_detail::slice_by_8(data, size, crc);
+}
+
+} // namespace nh3api
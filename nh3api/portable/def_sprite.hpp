@@ -0,0 +1,399 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>         // std::array
+#include <cstddef>       // std::byte
+#include <cstdint>       // uint8_t, uint16_t, uint32_t, int32_t
+#include <cstring>       // std::memchr, std::memcpy, std::memset
+#include <string>        // std::string
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "byte_reader.hpp"             // nh3api::byte_reader
+#include "simd.hpp"                    // NH3API_PORTABLE_SSE2, NH3API_PORTABLE_AVX2
+
+namespace nh3api
+{
+
+// TEncodingMethod
+enum class def_encoding : uint32_t
+{
+    raw         = 0, // width * height bytes
+    general_rle = 1, // 32-bit row offsets, runs of up to 256 pixels, 0xFF: literal
+    tileset_rle = 2, // 16-bit row offsets, runs of up to 32 pixels, code 7: literal
+    adv_obj_rle = 3  // 16-bit offsets of the 32-pixel blocks of a row, runs of up to 32 pixels, code 7: literal
+};
+
+// Sprite frame header, stored before the frame data in the .def file. The same fields as in CSpriteFrame
+struct def_frame_header
+{
+    // CSpriteFrame::DataSize
+    uint32_t     data_size {0};
+    def_encoding encoding {def_encoding::raw};
+    // the size of the whole frame
+    int32_t      width {0};
+    int32_t      height {0};
+    // the stored part of the frame, the rest is transparent(palette index 0)
+    int32_t      cropped_width {0};
+    int32_t      cropped_height {0};
+    int32_t      cropped_x {0};
+    int32_t      cropped_y {0};
+};
+
+// Encoded frame: the header and a view of the data that follows it(CSpriteFrame::map)
+struct def_frame
+{
+    def_frame_header        header;
+    span<const ::std::byte> data;
+};
+
+// Sprite(.def) as stored in the LOD archives, the frames are views into the file data
+struct def_file
+{
+    struct group
+    {
+        int32_t               id {0};
+        // indices into def_file::frames
+        ::std::vector<size_t> frames;
+    };
+
+    // EResourceType
+    uint32_t                                   type {0};
+    int32_t                                    width {0};
+    int32_t                                    height {0};
+    // RGB
+    ::std::array<::std::array<uint8_t, 3>, 256> palette {};
+    ::std::vector<group>                       groups;
+    // unique frames, the groups may share frames
+    ::std::vector<def_frame>                   frames;
+    ::std::vector<::std::string>               names;
+};
+
+// Parse the frame header at <offset> of the .def file <data>, false if the header or its data are out of range
+inline bool read_def_frame(span<const ::std::byte> data, size_t offset, def_frame& frame)
+{
+    if ( offset > data.size() )
+        return false;
+
+    byte_reader reader(data.subspan(offset));
+    def_frame_header& header = frame.header;
+    header.data_size      = reader.read<uint32_t>();
+    header.encoding       = static_cast<def_encoding>(reader.read<uint32_t>());
+    header.width          = reader.read<int32_t>();
+    header.height         = reader.read<int32_t>();
+    header.cropped_width  = reader.read<int32_t>();
+    header.cropped_height = reader.read<int32_t>();
+    header.cropped_x      = reader.read<int32_t>();
+    header.cropped_y      = reader.read<int32_t>();
+    frame.data            = reader.view(header.data_size);
+    return reader.ok() && static_cast<uint32_t>(header.encoding) <= static_cast<uint32_t>(def_encoding::adv_obj_rle)
+           && header.cropped_width >= 0 && header.cropped_height >= 0 && header.cropped_width <= 0x7FFF && header.cropped_height <= 0x7FFF;
+}
+
+// Parse the .def file <data>. The frames referenced by several groups are stored once.
+// Returns false if the file is damaged
+inline bool read_def_file(span<const ::std::byte> data, def_file& def)
+{
+    byte_reader reader(data);
+    def.type   = reader.read<uint32_t>();
+    def.width  = reader.read<int32_t>();
+    def.height = reader.read<int32_t>();
+    const uint32_t groups = reader.read<uint32_t>();
+    reader.read(def.palette.data(), sizeof(def.palette));
+    if ( !reader.ok() || groups > 0x10000 )
+        return false;
+
+    def.groups.clear();
+    def.frames.clear();
+    def.names.clear();
+    ::std::unordered_map<uint32_t, size_t> unique;
+    for ( uint32_t i = 0; i < groups && reader.ok(); ++i )
+    {
+        def_file::group& current = def.groups.emplace_back();
+        current.id               = reader.read<int32_t>();
+        const uint32_t count = reader.read<uint32_t>();
+        reader.skip(8);
+        const span<const ::std::byte> names   = reader.view(size_t(count) * 13);
+        const span<const ::std::byte> offsets = reader.view(size_t(count) * 4);
+        if ( !reader.ok() )
+            return false;
+
+        byte_reader offset_reader(offsets);
+        for ( uint32_t j = 0; j < count; ++j )
+        {
+            const uint32_t offset = offset_reader.read<uint32_t>();
+            const auto [it, inserted] = unique.try_emplace(offset, def.frames.size());
+            if ( inserted )
+            {
+                def_frame frame;
+                if ( !read_def_frame(data, offset, frame) )
+                    return false;
+
+                const char* const name = reinterpret_cast<const char*>(names.data() + size_t(j) * 13);
+                const void* const zero = ::std::memchr(name, 0, 13);
+                def.frames.push_back(frame);
+                def.names.emplace_back(name, zero != nullptr ? static_cast<const char*>(zero) - name : 13);
+            }
+            current.frames.push_back(it->second);
+        }
+    }
+
+    return reader.ok();
+}
+
+namespace def_detail
+{
+
+// Fill <count> bytes at <target> with <value>. Up to <slack> bytes past the run may be overwritten too,
+// the decoder passes the number of bytes left in the row after the run: the next runs of the row overwrite them
+inline void fill(uint8_t* target, uint8_t value, size_t count, size_t slack) noexcept
+{
+#if NH3API_PORTABLE_AVX2
+    if ( count >= 32 )
+    {
+        const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+        size_t i = 0;
+        for ( ; i + 32 <= count; i += 32 )
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), v);
+        if ( i != count )
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + count - 32), v);
+        return;
+    }
+#endif
+#if NH3API_PORTABLE_SSE2
+    const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+    if ( count >= 16 )
+    {
+        size_t i = 0;
+        for ( ; i + 16 <= count; i += 16 )
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), v);
+        if ( i != count )
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + count - 16), v);
+        return;
+    }
+    if ( count + slack >= 16 )
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), v);
+        return;
+    }
+#else
+    static_cast<void>(slack);
+#endif
+    ::std::memset(target, value, count);
+}
+
+// Copy <count> bytes from <source> to <target>, <source_left> bytes are readable at <source>.
+// Up to <slack> bytes past the run may be overwritten, see fill()
+inline void copy(uint8_t* target, const uint8_t* source, size_t count, size_t slack, size_t source_left) noexcept
+{
+#if NH3API_PORTABLE_AVX2
+    if ( count >= 32 )
+    {
+        size_t i = 0;
+        for ( ; i + 32 <= count; i += 32 )
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i)));
+        if ( i != count )
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + count - 32),
+                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + count - 32)));
+        return;
+    }
+#endif
+#if NH3API_PORTABLE_SSE2
+    if ( count >= 16 )
+    {
+        size_t i = 0;
+        for ( ; i + 16 <= count; i += 16 )
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i)));
+        if ( i != count )
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + count - 16),
+                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + count - 16)));
+        return;
+    }
+    if ( count + slack >= 16 && source_left >= 16 )
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+        return;
+    }
+#else
+    static_cast<void>(slack);
+    static_cast<void>(source_left);
+#endif
+    ::std::memcpy(target, source, count);
+}
+
+// the scalar versions, the reference for the vectorized ones
+struct scalar_runs
+{
+    static void fill(uint8_t* target, uint8_t value, size_t count, size_t) noexcept
+    {
+        for ( size_t i = 0; i < count; ++i )
+            target[i] = value;
+    }
+
+    static void copy(uint8_t* target, const uint8_t* source, size_t count, size_t, size_t) noexcept
+    {
+        for ( size_t i = 0; i < count; ++i )
+            target[i] = source[i];
+    }
+};
+
+struct vector_runs
+{
+    static void fill(uint8_t* target, uint8_t value, size_t count, size_t slack) noexcept
+    { def_detail::fill(target, value, count, slack); }
+
+    static void copy(uint8_t* target, const uint8_t* source, size_t count, size_t slack, size_t source_left) noexcept
+    { def_detail::copy(target, source, count, slack, source_left); }
+};
+
+// Decode one row of runs starting at <position>, <end> receives the position after the row.
+// <long_runs>: a run is a code byte and a length byte(general RLE), otherwise one byte of 3-bit code and 5-bit length
+template<class Runs>
+bool decode_row(const uint8_t* data, size_t size, size_t position, uint8_t* row, size_t width,
+                bool long_runs, size_t& end) noexcept
+{
+    size_t x = 0;
+    while ( x < width )
+    {
+        uint8_t code;
+        size_t  length;
+        bool    literal;
+        if ( long_runs )
+        {
+            if ( position + 2 > size )
+                return false;
+            code    = data[position];
+            length  = size_t(data[position + 1]) + 1;
+            literal = code == 0xFF;
+            position += 2;
+        }
+        else
+        {
+            if ( position + 1 > size )
+                return false;
+            code    = static_cast<uint8_t>(data[position] >> 5U);
+            length  = size_t(data[position] & 31U) + 1;
+            literal = code == 7;
+            position += 1;
+        }
+
+        // a run which crosses the end of the row is cut
+        if ( length > width - x )
+            length = width - x;
+
+        const size_t slack = width - x - length;
+        if ( literal )
+        {
+            if ( length > size - position )
+                return false;
+            Runs::copy(row + x, data + position, length, slack, size - position);
+            position += length;
+        }
+        else
+            Runs::fill(row + x, code, length, slack);
+
+        x += length;
+    }
+
+    end = position;
+    return true;
+}
+
+template<class Runs>
+bool decode(const def_frame& frame, uint8_t* output, size_t pitch) noexcept
+{
+    const def_frame_header& header = frame.header;
+    const size_t         width  = static_cast<size_t>(header.cropped_width);
+    const size_t         height = static_cast<size_t>(header.cropped_height);
+    const uint8_t* const data   = reinterpret_cast<const uint8_t*>(frame.data.data());
+    const size_t         size   = frame.data.size();
+    if ( width == 0 || height == 0 )
+        return true;
+
+    const auto read_u16 = [data](size_t offset) { return size_t(data[offset]) | (size_t(data[offset + 1]) << 8U); };
+    size_t end = 0;
+    switch ( header.encoding )
+    {
+        case def_encoding::raw:
+            if ( width * height > size )
+                return false;
+            for ( size_t y = 0; y < height; ++y )
+                Runs::copy(output + y * pitch, data + y * width, width, 0, size - y * width);
+            return true;
+
+        case def_encoding::general_rle:
+            if ( height * 4 > size )
+                return false;
+            for ( size_t y = 0; y < height; ++y )
+            {
+                const size_t offset = read_u16(y * 4) | (read_u16(y * 4 + 2) << 16U);
+                if ( !decode_row<Runs>(data, size, offset, output + y * pitch, width, true, end) )
+                    return false;
+            }
+            return true;
+
+        case def_encoding::tileset_rle:
+            // the rows are stored one after another from the first row offset
+            if ( size < 2 )
+                return false;
+            end = read_u16(0);
+            for ( size_t y = 0; y < height; ++y )
+                if ( !decode_row<Runs>(data, size, end, output + y * pitch, width, false, end) )
+                    return false;
+            return true;
+
+        case def_encoding::adv_obj_rle:
+        {
+            // offset of the first 32-pixel block of each row
+            const size_t blocks = width / 32;
+            if ( blocks == 0 || height * blocks * 2 > size )
+                return false;
+            for ( size_t y = 0; y < height; ++y )
+                if ( !decode_row<Runs>(data, size, read_u16(y * blocks * 2), output + y * pitch, width, false, end) )
+                    return false;
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+} // namespace def_detail
+
+// Decode the stored(cropped) part of <frame> into <output> as 8-bit palette indices:
+// cropped_height rows of cropped_width bytes, <pitch> bytes apart.
+// Runs are written with SSE2/AVX2 stores when the build enables them(see simd.hpp).
+// Returns false on damaged data, <output> is partially written then
+inline bool decode_def_frame(const def_frame& frame, uint8_t* output, size_t pitch) noexcept
+{ return def_detail::decode<def_detail::vector_runs>(frame, output, pitch); }
+
+// The scalar reference decoder, the same output as decode_def_frame()
+inline bool decode_def_frame_scalar(const def_frame& frame, uint8_t* output, size_t pitch) noexcept
+{ return def_detail::decode<def_detail::scalar_runs>(frame, output, pitch); }
+
+// Decode the whole <frame>: width * height indices, the area outside of the cropped rectangle is 0(transparent)
+inline bool decode_def_frame(const def_frame& frame, ::std::vector<uint8_t>& image)
+{
+    const def_frame_header& header = frame.header;
+    if ( header.width < 0 || header.height < 0 || header.cropped_x < 0 || header.cropped_y < 0
+         || header.cropped_x + header.cropped_width > header.width || header.cropped_y + header.cropped_height > header.height )
+        return false;
+
+    image.assign(static_cast<size_t>(header.width) * static_cast<size_t>(header.height), 0);
+    const size_t offset = static_cast<size_t>(header.cropped_y) * static_cast<size_t>(header.width) + static_cast<size_t>(header.cropped_x);
+    return decode_def_frame(frame, image.data() + offset, static_cast<size_t>(header.width));
+}
+
+} // namespace nh3api
@@ -0,0 +1,612 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm> // std::sort
+#include <array>     // std::array
+#include <cstddef>   // std::byte
+#include <cstdint>   // uint8_t, uint16_t, uint32_t
+#include <cstring>   // std::memcpy
+#include <vector>    // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "checksum.hpp"                // nh3api::adler32
+
+namespace nh3api
+{
+
+namespace deflate_tables
+{
+
+inline constexpr std::array<uint16_t, 29> length_base { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+
+inline constexpr std::array<uint8_t, 29> length_extra { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+
+inline constexpr std::array<uint16_t, 30> dist_base { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                      257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+
+inline constexpr std::array<uint8_t, 30> dist_extra { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                      7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// order of the code length code lengths in the dynamic block header
+inline constexpr std::array<uint8_t, 19> clen_order { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// match length(3..258) -> length symbol index(0..28)
+inline constexpr std::array<uint8_t, 259> length_code = []() constexpr
+{
+    std::array<uint8_t, 259> result {};
+    for ( size_t code = 0; code < length_base.size(); ++code )
+        for ( size_t length = length_base[code]; length < 259 && (code + 1 == length_base.size() || length < length_base[code + 1]); ++length )
+            result[length] = static_cast<uint8_t>(code);
+
+    result[258] = 28;
+    return result;
+}();
+
+// distance(1..32768) -> distance symbol(0..29)
+[[nodiscard]] inline constexpr uint32_t dist_code(uint32_t dist) noexcept
+{
+    uint32_t code = 0;
+    while ( code + 1 < dist_base.size() && dist_base[code + 1] <= dist )
+        ++code;
+
+    return code;
+}
+
+} // namespace deflate_tables
+
+// zlib stream(RFC 1950/1951) compressor.
+// Levels follow the zlib convention: 0 stores the data, 1 is the fastest, 9 gives the best ratio.
+// Blocks are emitted as stored, fixed or dynamic Huffman blocks, whichever is the smallest.
+class zlib_deflater
+{
+    protected:
+        static inline constexpr uint32_t window_size  = 32768;
+        static inline constexpr uint32_t window_mask  = window_size - 1;
+        static inline constexpr uint32_t hash_bits    = 15;
+        static inline constexpr uint32_t min_match    = 3;
+        static inline constexpr uint32_t max_match    = 258;
+        static inline constexpr size_t   block_tokens = 16384;
+        static inline constexpr uint32_t num_lit_len  = 286;
+        static inline constexpr uint32_t num_dist     = 30;
+
+        // literal if dist == 0
+        struct token
+        {
+            uint16_t lit_len;
+            uint16_t dist;
+        };
+
+        struct level_config
+        {
+            uint32_t max_chain;
+            uint32_t nice_length;
+            bool     lazy;
+        };
+
+        static inline constexpr std::array<level_config, 10> level_configs { {
+            {    0,   0, false }, // 0: store
+            {    4,   8, false },
+            {    8,  16, false },
+            {   32,  32, false },
+            {   16,  32, true  },
+            {   32,  64, true  },
+            {  128, 128, true  }, // 6: zlib default
+            {  256, 128, true  },
+            { 1024, 258, true  },
+            { 4096, 258, true  }  // 9: best
+        } };
+
+    public:
+        explicit zlib_deflater(int32_t level = 6) noexcept
+            : m_level { level < 0 ? 6 : (level > 9 ? 9 : level) }
+        {}
+
+        // compress <input> and append the zlib stream to <output>
+        void compress(span<const ::std::byte> input, ::std::vector<::std::byte>& output)
+        {
+            m_input  = input.data();
+            m_size   = input.size();
+            m_output = &output;
+            m_bit_buffer = 0;
+            m_bit_count  = 0;
+
+            // CMF: deflate, 32K window; FLG: compression level hint + check bits
+            const uint32_t cmf    = 0x78;
+            const uint32_t flevel = m_level < 2 ? 0 : (m_level < 6 ? 1 : (m_level == 6 ? 2 : 3));
+            uint32_t       flg    = flevel << 6U;
+            flg += 31 - (((cmf << 8U) | flg) % 31);
+            output.push_back(static_cast<::std::byte>(cmf));
+            output.push_back(static_cast<::std::byte>(flg));
+
+            if ( m_level == 0 || m_size < min_match )
+                write_stored(0, m_size, true);
+            else
+                compress_blocks();
+
+            flush_bits();
+            const uint32_t adler = adler32(m_input, m_size);
+            output.push_back(static_cast<::std::byte>(adler >> 24U));
+            output.push_back(static_cast<::std::byte>(adler >> 16U));
+            output.push_back(static_cast<::std::byte>(adler >> 8U));
+            output.push_back(static_cast<::std::byte>(adler));
+        }
+
+    protected:
+        void compress_blocks()
+        {
+            const level_config config = level_configs[static_cast<size_t>(m_level)];
+            m_head.assign(size_t(1) << hash_bits, -1);
+            m_prev.assign(window_size, -1);
+            m_tokens.clear();
+            m_tokens.reserve(block_tokens + 1);
+
+            size_t block_start = 0;
+            size_t pos         = 0;
+            while ( pos < m_size )
+            {
+                uint32_t match_dist = 0;
+                uint32_t match_len  = longest_match(pos, config, match_dist);
+                insert(pos);
+
+                if ( config.lazy && match_len >= min_match && match_len < config.nice_length && pos + 1 < m_size )
+                {
+                    uint32_t next_dist = 0;
+                    if ( longest_match(pos + 1, config, next_dist) > match_len )
+                        match_len = 0; // a better match starts at the next byte
+                }
+
+                if ( match_len >= min_match )
+                {
+                    m_tokens.push_back({ static_cast<uint16_t>(match_len), static_cast<uint16_t>(match_dist) });
+                    for ( size_t i = pos + 1; i < pos + match_len; ++i )
+                        insert(i);
+                    pos += match_len;
+                }
+                else
+                {
+                    m_tokens.push_back({ static_cast<uint16_t>(static_cast<uint8_t>(m_input[pos])), 0 });
+                    ++pos;
+                }
+
+                if ( m_tokens.size() >= block_tokens )
+                {
+                    write_block(block_start, pos, pos == m_size);
+                    block_start = pos;
+                    m_tokens.clear();
+                }
+            }
+
+            if ( !m_tokens.empty() || block_start == 0 )
+                write_block(block_start, pos, true);
+        }
+
+        [[nodiscard]] uint32_t hash(size_t pos) const noexcept
+        {
+            const uint32_t value = static_cast<uint32_t>(static_cast<uint8_t>(m_input[pos]))
+                                 | (static_cast<uint32_t>(static_cast<uint8_t>(m_input[pos + 1])) << 8U)
+                                 | (static_cast<uint32_t>(static_cast<uint8_t>(m_input[pos + 2])) << 16U);
+            return (value * 2654435761U) >> (32U - hash_bits);
+        }
+
+        void insert(size_t pos) noexcept
+        {
+            if ( pos + min_match > m_size )
+                return;
+
+            const uint32_t h = hash(pos);
+            m_prev[pos & window_mask] = m_head[h];
+            m_head[h]                 = static_cast<int32_t>(pos);
+        }
+
+        uint32_t longest_match(size_t pos, const level_config& config, uint32_t& best_dist) const noexcept
+        {
+            if ( pos + min_match > m_size )
+                return 0;
+
+            const size_t         max_length = (m_size - pos) < max_match ? (m_size - pos) : max_match;
+            const ::std::byte*   current    = m_input + pos;
+            uint32_t             best_len   = min_match - 1;
+            uint32_t             chain      = config.max_chain;
+            int32_t              candidate  = m_head[hash(pos)];
+
+            while ( candidate >= 0 && chain-- != 0 )
+            {
+                const size_t dist = pos - static_cast<size_t>(candidate);
+                if ( dist == 0 || dist > window_size )
+                    break;
+
+                const ::std::byte* const match = m_input + candidate;
+                if ( match[best_len] == current[best_len] && match[0] == current[0] && match[1] == current[1] )
+                {
+                    uint32_t length = 2;
+                    while ( length < max_length && match[length] == current[length] )
+                        ++length;
+
+                    if ( length > best_len )
+                    {
+                        best_len  = length;
+                        best_dist = static_cast<uint32_t>(dist);
+                        if ( length >= config.nice_length || length == max_length )
+                            break;
+                    }
+                }
+
+                const int32_t next = m_prev[static_cast<size_t>(candidate) & window_mask];
+                if ( next >= candidate )
+                    break; // stale link from the previous window
+
+                candidate = next;
+            }
+
+            return best_len >= min_match ? best_len : 0;
+        }
+
+    protected:
+        // builds Huffman code lengths limited to <limit> bits
+        static void build_lengths(const uint32_t* freq, size_t count, uint8_t* lengths, uint32_t limit)
+        {
+            ::std::vector<uint32_t> weights(freq, freq + count);
+            ::std::vector<uint32_t> order;
+            ::std::vector<uint32_t> node_weight;
+            ::std::vector<int32_t>  parent;
+            for ( ;; )
+            {
+                order.clear();
+                for ( uint32_t i = 0; i < count; ++i )
+                {
+                    lengths[i] = 0;
+                    if ( weights[i] != 0 )
+                        order.push_back(i);
+                }
+
+                if ( order.empty() )
+                    return;
+
+                if ( order.size() == 1 )
+                {
+                    lengths[order[0]] = 1;
+                    return;
+                }
+
+                ::std::sort(order.begin(), order.end(), [&weights](uint32_t lhs, uint32_t rhs)
+                { return weights[lhs] != weights[rhs] ? weights[lhs] < weights[rhs] : lhs < rhs; });
+
+                // two-queue Huffman construction: leaves sorted by weight, internal nodes are created in weight order
+                const size_t leaves = order.size();
+                node_weight.assign(leaves * 2 - 1, 0);
+                parent.assign(leaves * 2 - 1, -1);
+                for ( size_t i = 0; i < leaves; ++i )
+                    node_weight[i] = weights[order[i]];
+
+                size_t next_leaf = 0, next_node = leaves, new_node = leaves;
+                auto pick = [&]() -> size_t
+                {
+                    if ( next_leaf < leaves && (next_node >= new_node || node_weight[next_leaf] <= node_weight[next_node]) )
+                        return next_leaf++;
+
+                    return next_node++;
+                };
+
+                for ( ; new_node < leaves * 2 - 1; ++new_node )
+                {
+                    const size_t a = pick();
+                    const size_t b = pick();
+                    node_weight[new_node] = node_weight[a] + node_weight[b];
+                    parent[a] = static_cast<int32_t>(new_node);
+                    parent[b] = static_cast<int32_t>(new_node);
+                }
+
+                // depth of every node, the root is the last one
+                ::std::vector<uint8_t> depth(leaves * 2 - 1, 0);
+                uint32_t max_depth = 0;
+                for ( size_t i = leaves * 2 - 2; i-- > 0; )
+                {
+                    depth[i]  = static_cast<uint8_t>(depth[static_cast<size_t>(parent[i])] + 1);
+                    max_depth = depth[i] > max_depth ? depth[i] : max_depth;
+                }
+
+                if ( max_depth <= limit )
+                {
+                    for ( size_t i = 0; i < leaves; ++i )
+                        lengths[order[i]] = depth[i];
+                    return;
+                }
+
+                // flatten the distribution and try again
+                for ( uint32_t& weight : weights )
+                    if ( weight != 0 )
+                        weight = (weight >> 1U) | 1U;
+            }
+        }
+
+        // canonical Huffman codes, bit-reversed for the LSB-first output
+        static void build_codes(const uint8_t* lengths, size_t count, uint16_t* codes) noexcept
+        {
+            std::array<uint16_t, 16> length_count {};
+            for ( size_t i = 0; i < count; ++i )
+                ++length_count[lengths[i]];
+            length_count[0] = 0;
+
+            std::array<uint16_t, 16> next_code {};
+            uint32_t code = 0;
+            for ( size_t bits = 1; bits < 16; ++bits )
+            {
+                code            = (code + length_count[bits - 1]) << 1U;
+                next_code[bits] = static_cast<uint16_t>(code);
+            }
+
+            for ( size_t i = 0; i < count; ++i )
+            {
+                const uint32_t length = lengths[i];
+                if ( length == 0 )
+                    continue;
+
+                uint32_t value    = next_code[length]++;
+                uint32_t reversed = 0;
+                for ( uint32_t bit = 0; bit < length; ++bit, value >>= 1U )
+                    reversed = (reversed << 1U) | (value & 1U);
+
+                codes[i] = static_cast<uint16_t>(reversed);
+            }
+        }
+
+        void put_bits(uint32_t value, uint32_t count)
+        {
+            m_bit_buffer |= static_cast<uint64_t>(value) << m_bit_count;
+            m_bit_count  += count;
+            while ( m_bit_count >= 8 )
+            {
+                m_output->push_back(static_cast<::std::byte>(m_bit_buffer & 0xFFU));
+                m_bit_buffer >>= 8U;
+                m_bit_count   -= 8;
+            }
+        }
+
+        void flush_bits()
+        {
+            if ( m_bit_count != 0 )
+                put_bits(0, 8 - m_bit_count);
+        }
+
+        void write_stored(size_t begin, size_t end, bool final)
+        {
+            do
+            {
+                const size_t length = (end - begin) < 65535 ? (end - begin) : 65535;
+                const bool   last   = final && begin + length == end;
+                put_bits(last ? 1U : 0U, 3);
+                flush_bits();
+                put_bits(static_cast<uint32_t>(length), 16);
+                put_bits(static_cast<uint32_t>(~length & 0xFFFFU), 16);
+                const size_t old_size = m_output->size();
+                m_output->resize(old_size + length);
+                if ( length != 0 )
+                    ::std::memcpy(m_output->data() + old_size, m_input + begin, length);
+                begin += length;
+            }
+            while ( begin != end );
+        }
+
+        void write_tokens(const uint16_t* lit_codes, const uint8_t* lit_lengths, const uint16_t* dist_codes, const uint8_t* dist_lengths)
+        {
+            for ( const token& current : m_tokens )
+            {
+                if ( current.dist == 0 )
+                {
+                    put_bits(lit_codes[current.lit_len], lit_lengths[current.lit_len]);
+                    continue;
+                }
+
+                const uint32_t lcode = deflate_tables::length_code[current.lit_len];
+                put_bits(lit_codes[257 + lcode], lit_lengths[257 + lcode]);
+                put_bits(current.lit_len - deflate_tables::length_base[lcode], deflate_tables::length_extra[lcode]);
+
+                const uint32_t dcode = deflate_tables::dist_code(current.dist);
+                put_bits(dist_codes[dcode], dist_lengths[dcode]);
+                put_bits(current.dist - deflate_tables::dist_base[dcode], deflate_tables::dist_extra[dcode]);
+            }
+
+            put_bits(lit_codes[256], lit_lengths[256]);
+        }
+
+        void write_block(size_t begin, size_t end, bool final)
+        {
+            std::array<uint32_t, num_lit_len> lit_freq {};
+            std::array<uint32_t, num_dist>    dist_freq {};
+            uint64_t extra_bits = 0;
+            for ( const token& current : m_tokens )
+            {
+                if ( current.dist == 0 )
+                {
+                    ++lit_freq[current.lit_len];
+                    continue;
+                }
+
+                const uint32_t lcode = deflate_tables::length_code[current.lit_len];
+                const uint32_t dcode = deflate_tables::dist_code(current.dist);
+                ++lit_freq[257 + lcode];
+                ++dist_freq[dcode];
+                extra_bits += deflate_tables::length_extra[lcode] + deflate_tables::dist_extra[dcode];
+            }
+            lit_freq[256] = 1;
+
+            // keep both codes complete: at least two symbols each
+            if ( ::std::count_if(lit_freq.begin(), lit_freq.end(), [](uint32_t f) { return f != 0; }) < 2 )
+                lit_freq[0] = lit_freq[0] ? lit_freq[0] : 1;
+            if ( dist_freq[0] == 0 )
+                dist_freq[0] = 1;
+            if ( ::std::count_if(dist_freq.begin(), dist_freq.end(), [](uint32_t f) { return f != 0; }) < 2 )
+                dist_freq[1] = 1;
+
+            std::array<uint8_t, num_lit_len> lit_lengths {};
+            std::array<uint8_t, num_dist>    dist_lengths {};
+            build_lengths(lit_freq.data(), num_lit_len, lit_lengths.data(), 15);
+            build_lengths(dist_freq.data(), num_dist, dist_lengths.data(), 15);
+
+            // code length sequence with run-length codes 16, 17, 18
+            size_t num_lit = num_lit_len;
+            while ( num_lit > 257 && lit_lengths[num_lit - 1] == 0 )
+                --num_lit;
+            size_t num_dist_used = num_dist;
+            while ( num_dist_used > 1 && dist_lengths[num_dist_used - 1] == 0 )
+                --num_dist_used;
+
+            std::array<uint8_t, num_lit_len + num_dist> all_lengths {};
+            ::std::memcpy(all_lengths.data(), lit_lengths.data(), num_lit);
+            ::std::memcpy(all_lengths.data() + num_lit, dist_lengths.data(), num_dist_used);
+            const size_t total_lengths = num_lit + num_dist_used;
+
+            struct clen_symbol
+            {
+                uint8_t symbol;
+                uint8_t extra;
+            };
+            ::std::vector<clen_symbol> clen_symbols;
+            std::array<uint32_t, 19>   clen_freq {};
+            for ( size_t i = 0; i < total_lengths; )
+            {
+                const uint8_t length = all_lengths[i];
+                size_t run = 1;
+                while ( i + run < total_lengths && all_lengths[i + run] == length )
+                    ++run;
+
+                if ( length == 0 && run >= 3 )
+                {
+                    const size_t chunk = run < 138 ? run : 138;
+                    if ( chunk >= 11 )
+                        clen_symbols.push_back({ 18, static_cast<uint8_t>(chunk - 11) });
+                    else
+                        clen_symbols.push_back({ 17, static_cast<uint8_t>(chunk - 3) });
+                    ++clen_freq[clen_symbols.back().symbol];
+                    i += chunk;
+                }
+                else if ( length != 0 && run >= 4 )
+                {
+                    clen_symbols.push_back({ length, 0 });
+                    ++clen_freq[length];
+                    const size_t chunk = (run - 1) < 6 ? (run - 1) : 6;
+                    clen_symbols.push_back({ 16, static_cast<uint8_t>(chunk - 3) });
+                    ++clen_freq[16];
+                    i += chunk + 1;
+                }
+                else
+                {
+                    clen_symbols.push_back({ length, 0 });
+                    ++clen_freq[length];
+                    ++i;
+                }
+            }
+
+            std::array<uint8_t, 19>  clen_lengths {};
+            std::array<uint16_t, 19> clen_codes {};
+            build_lengths(clen_freq.data(), 19, clen_lengths.data(), 7);
+            build_codes(clen_lengths.data(), 19, clen_codes.data());
+
+            size_t num_clen = 19;
+            while ( num_clen > 4 && clen_lengths[deflate_tables::clen_order[num_clen - 1]] == 0 )
+                --num_clen;
+
+            // block sizes in bits
+            uint64_t dynamic_bits = 3 + 5 + 5 + 4 + num_clen * 3 + extra_bits;
+            for ( const clen_symbol& current : clen_symbols )
+                dynamic_bits += clen_lengths[current.symbol] + (current.symbol == 16 ? 2 : (current.symbol == 17 ? 3 : (current.symbol == 18 ? 7 : 0)));
+
+            uint64_t fixed_bits = 3 + extra_bits;
+            for ( size_t i = 0; i < num_lit_len; ++i )
+            {
+                dynamic_bits += static_cast<uint64_t>(lit_freq[i]) * lit_lengths[i];
+                fixed_bits   += static_cast<uint64_t>(lit_freq[i]) * (i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8)));
+            }
+            for ( size_t i = 0; i < num_dist; ++i )
+            {
+                dynamic_bits += static_cast<uint64_t>(dist_freq[i]) * dist_lengths[i];
+                fixed_bits   += static_cast<uint64_t>(dist_freq[i]) * 5;
+            }
+            const uint64_t stored_bits = (end - begin + 5 * ((end - begin) / 65535 + 1)) * 8 + 7;
+
+            if ( stored_bits <= dynamic_bits && stored_bits <= fixed_bits )
+            {
+                write_stored(begin, end, final);
+                return;
+            }
+
+            if ( fixed_bits <= dynamic_bits )
+            {
+                std::array<uint8_t, 288>  fixed_lit_lengths {};
+                std::array<uint16_t, 288> fixed_lit_codes {};
+                std::array<uint8_t, 30>   fixed_dist_lengths {};
+                std::array<uint16_t, 30>  fixed_dist_codes {};
+                for ( size_t i = 0; i < 288; ++i )
+                    fixed_lit_lengths[i] = static_cast<uint8_t>(i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8)));
+                fixed_dist_lengths.fill(5);
+                build_codes(fixed_lit_lengths.data(), 288, fixed_lit_codes.data());
+                build_codes(fixed_dist_lengths.data(), 30, fixed_dist_codes.data());
+
+                put_bits(final ? 1U : 0U, 1);
+                put_bits(1, 2);
+                write_tokens(fixed_lit_codes.data(), fixed_lit_lengths.data(), fixed_dist_codes.data(), fixed_dist_lengths.data());
+                return;
+            }
+
+            std::array<uint16_t, num_lit_len> lit_codes {};
+            std::array<uint16_t, num_dist>    dist_codes {};
+            build_codes(lit_lengths.data(), num_lit_len, lit_codes.data());
+            build_codes(dist_lengths.data(), num_dist, dist_codes.data());
+
+            put_bits(final ? 1U : 0U, 1);
+            put_bits(2, 2);
+            put_bits(static_cast<uint32_t>(num_lit - 257), 5);
+            put_bits(static_cast<uint32_t>(num_dist_used - 1), 5);
+            put_bits(static_cast<uint32_t>(num_clen - 4), 4);
+            for ( size_t i = 0; i < num_clen; ++i )
+                put_bits(clen_lengths[deflate_tables::clen_order[i]], 3);
+
+            for ( const clen_symbol& current : clen_symbols )
+            {
+                put_bits(clen_codes[current.symbol], clen_lengths[current.symbol]);
+                if ( current.symbol == 16 )
+                    put_bits(current.extra, 2);
+                else if ( current.symbol == 17 )
+                    put_bits(current.extra, 3);
+                else if ( current.symbol == 18 )
+                    put_bits(current.extra, 7);
+            }
+
+            write_tokens(lit_codes.data(), lit_lengths.data(), dist_codes.data(), dist_lengths.data());
+        }
+
+    protected:
+        int32_t                     m_level;
+        const ::std::byte*          m_input {nullptr};
+        size_t                      m_size {0};
+        ::std::vector<::std::byte>* m_output {nullptr};
+        uint64_t                    m_bit_buffer {0};
+        uint32_t                    m_bit_count {0};
+        ::std::vector<int32_t>      m_head;
+        ::std::vector<int32_t>      m_prev;
+        ::std::vector<token>        m_tokens;
+
+};
+
+// compress <input> into a zlib stream
+[[nodiscard]] inline ::std::vector<::std::byte> zlib_compress(span<const ::std::byte> input, int32_t level = 6)
+{
+    ::std::vector<::std::byte> result;
+    result.reserve(input.size() / 2 + 64);
+    zlib_deflater(level).compress(input, result);
+    return result;
+}
+
+} // namespace nh3api
@@ -0,0 +1,246 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // size_t
+#include <cstdint> // int32_t, uint64_t
+#include <utility> // std::move
+#include <vector>  // std::vector
+
+namespace nh3api
+{
+
+struct dirty_rect
+{
+    int32_t x {0};
+    int32_t y {0};
+    int32_t width {0};
+    int32_t height {0};
+
+    [[nodiscard]] uint64_t area() const noexcept
+    { return static_cast<uint64_t>(width) * static_cast<uint64_t>(height); }
+};
+
+struct dirty_region_stats
+{
+    // add() calls of the frame(s) and the pixels they asked for, overlaps counted every time
+    uint64_t requests {0};
+    uint64_t requested_pixels {0};
+    // rectangles and pixels actually flushed
+    uint64_t flushed_rects {0};
+    uint64_t flushed_pixels {0};
+    uint64_t flushes {0};
+
+    // pixels which were not presented more than once thanks to the merging
+    [[nodiscard]] uint64_t saved_pixels() const noexcept
+    { return requested_pixels > flushed_pixels ? requested_pixels - flushed_pixels : 0; }
+};
+
+// Screen area to present, collected during a frame /
+// Область экрана для вывода, накопленная за кадр.
+// The area is kept as horizontal bands of disjoint x spans(the banded region of X11 and GDI),
+// so any number of overlapping requests flushes as a few disjoint rectangles and no pixel is presented twice.
+// Vertically adjacent bands with the same spans are merged, a dialog redrawn as a stack of rows flushes as one rectangle
+class dirty_region
+{
+    public:
+        // <bounds>: the screen, the requests are clipped to it.
+        // <max_rects>: a region of more rectangles is flushed as its bounding box, the cost of a present call being higher
+        explicit dirty_region(const dirty_rect& bounds, size_t max_rects = 64)
+            : m_bounds { bounds }, m_max_rects { max_rects }
+        {}
+
+    public:
+        // heroWindowManager::UpdateScreen(x, y, h, w) request
+        void add(int32_t x, int32_t y, int32_t width, int32_t height)
+        {
+            ++m_stats.requests;
+            // clip to the screen
+            const int32_t left   = x > m_bounds.x ? x : m_bounds.x;
+            const int32_t top    = y > m_bounds.y ? y : m_bounds.y;
+            const int32_t right  = x + width < m_bounds.x + m_bounds.width ? x + width : m_bounds.x + m_bounds.width;
+            const int32_t bottom = y + height < m_bounds.y + m_bounds.height ? y + height : m_bounds.y + m_bounds.height;
+            if ( left >= right || top >= bottom )
+                return;
+
+            m_stats.requested_pixels += static_cast<uint64_t>(right - left) * static_cast<uint64_t>(bottom - top);
+            split(top);
+            split(bottom);
+
+            // the bands of [top, bottom) get the span, the gaps between them get new bands
+            size_t  i          = 0;
+            int32_t y_position = top;
+            while ( i < m_bands.size() && m_bands[i].bottom <= top )
+                ++i;
+            while ( y_position < bottom )
+            {
+                if ( i < m_bands.size() && m_bands[i].top == y_position )
+                {
+                    add_span(m_bands[i].spans, left, right);
+                    y_position = m_bands[i].bottom;
+                    ++i;
+                    continue;
+                }
+
+                const int32_t gap_end = i < m_bands.size() && m_bands[i].top < bottom ? m_bands[i].top : bottom;
+                m_bands.insert(m_bands.begin() + static_cast<ptrdiff_t>(i), band { y_position, gap_end, { { left, right } } });
+                y_position = gap_end;
+                ++i;
+            }
+            coalesce();
+        }
+
+        void add(const dirty_rect& rect)
+        { add(rect.x, rect.y, rect.width, rect.height); }
+
+        // the whole screen, e.g. after a dialog is opened or closed
+        void add_all()
+        { add(m_bounds); }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return m_bands.empty(); }
+
+        // the disjoint rectangles covering the area, top to bottom and left to right
+        [[nodiscard]] ::std::vector<dirty_rect> rects() const
+        {
+            ::std::vector<dirty_rect> result;
+            for ( const band& current : m_bands )
+                for ( const span& part : current.spans )
+                    result.push_back({ part.left, current.top, part.right - part.left, current.bottom - current.top });
+
+            if ( result.size() > m_max_rects )
+            {
+                dirty_rect box    = result.front();
+                int32_t    right  = box.x + box.width;
+                int32_t    bottom = box.y + box.height;
+                for ( const dirty_rect& rect : result )
+                {
+                    right  = rect.x + rect.width > right ? rect.x + rect.width : right;
+                    bottom = rect.y + rect.height > bottom ? rect.y + rect.height : bottom;
+                    box.x  = rect.x < box.x ? rect.x : box.x;
+                }
+                box.width  = right - box.x;
+                box.height = bottom - box.y;
+                result.assign(1, box);
+            }
+            return result;
+        }
+
+        // Pass the rectangles to <present>(const dirty_rect&) once and start the next frame
+        template<class Present>
+        void flush(Present&& present)
+        {
+            if ( m_bands.empty() )
+                return;
+
+            for ( const dirty_rect& rect : rects() )
+            {
+                present(rect);
+                ++m_stats.flushed_rects;
+                m_stats.flushed_pixels += rect.area();
+            }
+            ++m_stats.flushes;
+            m_bands.clear();
+        }
+
+        // drop the collected area without presenting it
+        void clear() noexcept
+        { m_bands.clear(); }
+
+        [[nodiscard]] const dirty_rect& bounds() const noexcept
+        { return m_bounds; }
+
+        [[nodiscard]] const dirty_region_stats& stats() const noexcept
+        { return m_stats; }
+
+        void reset_stats() noexcept
+        { m_stats = dirty_region_stats {}; }
+
+    protected:
+        // [left, right)
+        struct span
+        {
+            int32_t left;
+            int32_t right;
+
+            [[nodiscard]] bool operator==(const span& other) const noexcept
+            { return left == other.left && right == other.right; }
+        };
+
+        // rows [top, bottom), the spans are sorted and do not touch each other
+        struct band
+        {
+            int32_t             top;
+            int32_t             bottom;
+            ::std::vector<span> spans;
+        };
+
+        // cut the band containing row <y> so that a band starts at <y>
+        void split(int32_t y)
+        {
+            for ( size_t i = 0; i < m_bands.size(); ++i )
+            {
+                band& current = m_bands[i];
+                if ( current.top >= y )
+                    return;
+                if ( current.bottom > y )
+                {
+                    band lower { y, current.bottom, current.spans };
+                    current.bottom = y;
+                    m_bands.insert(m_bands.begin() + static_cast<ptrdiff_t>(i + 1), ::std::move(lower));
+                    return;
+                }
+            }
+        }
+
+        // union of the sorted disjoint <spans> and [left, right)
+        static void add_span(::std::vector<span>& spans, int32_t left, int32_t right)
+        {
+            size_t first = 0;
+            while ( first < spans.size() && spans[first].right < left )
+                ++first;
+            size_t last = first;
+            while ( last < spans.size() && spans[last].left <= right )
+            {
+                left  = spans[last].left < left ? spans[last].left : left;
+                right = spans[last].right > right ? spans[last].right : right;
+                ++last;
+            }
+            spans.erase(spans.begin() + static_cast<ptrdiff_t>(first), spans.begin() + static_cast<ptrdiff_t>(last));
+            spans.insert(spans.begin() + static_cast<ptrdiff_t>(first), span { left, right });
+        }
+
+        // merge the touching bands with the same spans
+        void coalesce()
+        {
+            size_t out = 0;
+            for ( size_t i = 1; i < m_bands.size(); ++i )
+            {
+                if ( m_bands[out].bottom == m_bands[i].top && m_bands[out].spans == m_bands[i].spans )
+                    m_bands[out].bottom = m_bands[i].bottom;
+                else if ( ++out != i )
+                    m_bands[out] = ::std::move(m_bands[i]);
+            }
+            if ( !m_bands.empty() )
+                m_bands.resize(out + 1);
+        }
+
+    protected:
+        dirty_rect          m_bounds;
+        size_t              m_max_rects;
+        // sorted top to bottom, not overlapping
+        ::std::vector<band> m_bands;
+        dirty_region_stats  m_stats;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,324 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>         // std::array
+#include <cstring>       // std::memcmp, std::memcpy
+#include <filesystem>    // std::filesystem
+#include <fstream>       // std::ifstream, std::ofstream
+#include <string>        // std::string
+#include <system_error>  // std::error_code
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include "../core/nh3api_std/span.hpp"      // nh3api::span
+#include "../core/resources/lod_format.hpp" // lod_name_equal
+#include "byte_reader.hpp"                  // nh3api::byte_reader, nh3api::byte_writer
+#include "gzip.hpp"                         // nh3api::gzip_uncompress
+#include "thread_pool.hpp"                  // nh3api::thread_pool
+
+namespace nh3api
+{
+
+// Call <parse>(span<const std::byte>) with a growing decoded prefix of the file at <path> until it returns true.
+// Only the beginning of the file is read and inflated, which is what the header readers need.
+// Files which are not gzip are parsed as is. Returns false if the file can not be read or <parse> never succeeds
+// within <max_prefix_size> bytes.
+// The headers usually fit into the first few KB, the map descriptions may make them longer
+template<class Parse>
+bool parse_gzip_prefix(const ::std::filesystem::path& path, Parse&& parse, size_t max_prefix_size = size_t(1) << 20U)
+{
+    ::std::ifstream file(path, ::std::ios::binary);
+    if ( !file )
+        return false;
+
+    ::std::vector<::std::byte> input, decoded;
+    size_t input_size  = size_t(16) << 10U;
+    size_t output_size = size_t(16) << 10U;
+    bool   end_of_file = false;
+    for ( ;; )
+    {
+        if ( !end_of_file && input.size() < input_size )
+        {
+            const size_t offset = input.size();
+            input.resize(input_size);
+            file.read(reinterpret_cast<char*>(input.data() + offset), static_cast<::std::streamsize>(input_size - offset));
+            input.resize(offset + static_cast<size_t>(file.gcount()));
+            end_of_file = input.size() < input_size;
+        }
+
+        const span<const ::std::byte> prefix { input.data(), input.size() };
+        const bool     compressed = is_gzip(prefix);
+        inflate_status status     = inflate_status::ok;
+        if ( compressed )
+        {
+            decoded.clear();
+            status = gzip_uncompress(prefix, decoded, output_size, output_size);
+        }
+
+        if ( compressed ? parse(span<const ::std::byte> { decoded.data(), decoded.size() }) : parse(prefix) )
+            return true;
+
+        if ( status == inflate_status::too_large && output_size < max_prefix_size )
+            output_size *= 4;
+        else if ( (status == inflate_status::truncated || !compressed) && !end_of_file && input_size < max_prefix_size )
+            input_size *= 4;
+        else
+            return false; // damaged file or not the expected format
+    }
+}
+
+struct file_index_options
+{
+    // parsing threads, 0: one per hardware thread
+    size_t                       threads {0};
+    // scan the subdirectories too
+    bool                         recursive {false};
+    // file extensions to index, case-insensitive. Empty: the default extensions of the index
+    ::std::vector<::std::string> extensions;
+};
+
+struct file_index_stats
+{
+    size_t files {0};
+    // records taken from the index, the file size and modification time have not changed
+    size_t reused {0};
+    size_t parsed {0};
+    // files which could not be parsed
+    size_t failed {0};
+};
+
+template<class Info>
+struct file_index_record
+{
+    ::std::filesystem::path path;
+    uint64_t                file_size {0};
+    // std::filesystem::file_time_type ticks
+    int64_t                 write_time {0};
+    bool                    valid {false};
+    Info                    info;
+};
+
+// Persistent index of the file headers in a directory /
+// Постоянный индекс заголовков файлов в папке.
+// scan() parses the new and changed files on a thread pool and reuses the rest, an unchanged file costs one stat().
+// The records are persisted with save() and load() so that a rescan only touches what changed.
+// The index mirrors the last scanned directory: the records of the files which are gone are dropped.
+// Traits define:
+//   info_type;
+//   static bool parse(const std::filesystem::path&, info_type&);
+//   static void write(byte_writer&, const info_type&);
+//   static void read(byte_reader&, info_type&);
+//   static std::vector<std::string> default_extensions();
+//   static constexpr std::array<char, 8> signature; static constexpr uint32_t version;
+template<class Traits>
+class file_index
+{
+    public:
+        using info_type   = typename Traits::info_type;
+        using record_type = file_index_record<info_type>;
+
+    public:
+        explicit file_index(const file_index_options& options = {})
+            : m_options { options }
+        {
+            if ( m_options.extensions.empty() )
+                m_options.extensions = Traits::default_extensions();
+        }
+
+    public:
+        file_index_stats scan(const ::std::filesystem::path& directory)
+        {
+            file_index_stats           stats;
+            ::std::vector<record_type> found;
+            ::std::error_code          error;
+            const auto add = [this, &found](const ::std::filesystem::directory_entry& entry)
+            {
+                ::std::error_code entry_error;
+                if ( !entry.is_regular_file(entry_error) || !matches(entry.path()) )
+                    return;
+
+                record_type record;
+                record.path       = entry.path();
+                record.file_size  = entry.file_size(entry_error);
+                record.write_time = static_cast<int64_t>(entry.last_write_time(entry_error).time_since_epoch().count());
+                if ( !entry_error )
+                    found.push_back(::std::move(record));
+            };
+
+            if ( m_options.recursive )
+                for ( ::std::filesystem::recursive_directory_iterator it(directory, error), end; !error && it != end; it.increment(error) )
+                    add(*it);
+            else
+                for ( ::std::filesystem::directory_iterator it(directory, error), end; !error && it != end; it.increment(error) )
+                    add(*it);
+
+            ::std::vector<size_t> stale;
+            for ( size_t i = 0; i < found.size(); ++i )
+            {
+                const record_type* const old = find(found[i].path);
+                if ( old != nullptr && old->file_size == found[i].file_size && old->write_time == found[i].write_time )
+                {
+                    found[i].valid = old->valid;
+                    found[i].info  = old->info;
+                    ++stats.reused;
+                }
+                else
+                    stale.push_back(i);
+            }
+
+            if ( !stale.empty() )
+            {
+                thread_pool pool(m_options.threads < stale.size() ? m_options.threads : stale.size());
+                pool.parallel_for(stale.size(), [&found, &stale](size_t i)
+                {
+                    record_type& record = found[stale[i]];
+                    record.valid = Traits::parse(record.path, record.info);
+                });
+            }
+
+            for ( const size_t i : stale )
+                found[i].valid ? ++stats.parsed : ++stats.failed;
+
+            stats.files = found.size();
+            m_records   = ::std::move(found);
+            rebuild_lookup();
+            return stats;
+        }
+
+        [[nodiscard]] const ::std::vector<record_type>& records() const noexcept
+        { return m_records; }
+
+        [[nodiscard]] const record_type* find(const ::std::filesystem::path& path) const
+        {
+            const auto it = m_lookup.find(path.native());
+            return it != m_lookup.end() ? &m_records[it->second] : nullptr;
+        }
+
+        void clear() noexcept
+        {
+            m_records.clear();
+            m_lookup.clear();
+        }
+
+        // write the index to <index_path>, returns false on I/O failure
+        bool save(const ::std::filesystem::path& index_path) const
+        {
+            ::std::vector<::std::byte> data;
+            byte_writer writer(data);
+            writer.write(Traits::signature.data(), Traits::signature.size());
+            writer.write<uint32_t>(Traits::version);
+            writer.write<uint32_t>(sizeof(::std::filesystem::path::value_type));
+            writer.write<uint32_t>(static_cast<uint32_t>(m_records.size()));
+            for ( const record_type& record : m_records )
+            {
+                const auto& native = record.path.native();
+                writer.write<uint32_t>(static_cast<uint32_t>(native.size()));
+                writer.write(native.data(), native.size() * sizeof(native[0]));
+                writer.write(record.file_size);
+                writer.write(record.write_time);
+                writer.write_bool(record.valid);
+                if ( record.valid )
+                    Traits::write(writer, record.info);
+            }
+
+            ::std::ofstream file(index_path, ::std::ios::binary | ::std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(data.data()), static_cast<::std::streamsize>(data.size()));
+            return static_cast<bool>(file.flush());
+        }
+
+        // read the index written by save(), returns false and leaves the index empty if it is missing, damaged or outdated
+        bool load(const ::std::filesystem::path& index_path)
+        {
+            clear();
+            ::std::ifstream file(index_path, ::std::ios::binary | ::std::ios::ate);
+            if ( !file )
+                return false;
+
+            ::std::vector<::std::byte> raw(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            if ( !file.read(reinterpret_cast<char*>(raw.data()), static_cast<::std::streamsize>(raw.size())) )
+                return false;
+
+            byte_reader reader({ raw.data(), raw.size() });
+            const span<const ::std::byte> signature = reader.view(Traits::signature.size());
+            if ( signature.empty() || ::std::memcmp(signature.data(), Traits::signature.data(), Traits::signature.size()) != 0
+                 || reader.read<uint32_t>() != Traits::version
+                 || reader.read<uint32_t>() != sizeof(::std::filesystem::path::value_type) )
+                return false;
+
+            using native_string = ::std::filesystem::path::string_type;
+            const uint32_t count = reader.read<uint32_t>();
+            for ( uint32_t i = 0; i < count && reader.ok(); ++i )
+            {
+                record_type    record;
+                const uint32_t length = reader.read<uint32_t>();
+                // the length comes from the file: a damaged one must not allocate more than the file holds
+                if ( length > reader.remaining() / sizeof(native_string::value_type) )
+                {
+                    reader.fail();
+                    break;
+                }
+
+                const span<const ::std::byte> path = reader.view(static_cast<size_t>(length) * sizeof(native_string::value_type));
+                native_string native(path.size() / sizeof(native_string::value_type), native_string::value_type {});
+                if ( !path.empty() )
+                    ::std::memcpy(native.data(), path.data(), path.size());
+
+                record.path       = ::std::move(native);
+                record.file_size  = reader.read<uint64_t>();
+                record.write_time = reader.read<int64_t>();
+                record.valid      = reader.read_bool();
+                if ( record.valid )
+                    Traits::read(reader, record.info);
+                m_records.push_back(::std::move(record));
+            }
+
+            if ( !reader.ok() )
+            {
+                clear();
+                return false;
+            }
+
+            rebuild_lookup();
+            return true;
+        }
+
+    protected:
+        [[nodiscard]] bool matches(const ::std::filesystem::path& path) const
+        {
+            const ::std::string extension = path.extension().string();
+            for ( const ::std::string& allowed : m_options.extensions )
+                if ( lod_name_equal(extension, allowed) )
+                    return true;
+
+            return false;
+        }
+
+        void rebuild_lookup()
+        {
+            m_lookup.clear();
+            m_lookup.reserve(m_records.size());
+            for ( size_t i = 0; i < m_records.size(); ++i )
+                m_lookup.emplace(m_records[i].path.native(), i);
+        }
+
+    protected:
+        using path_lookup = ::std::unordered_map<::std::filesystem::path::string_type, size_t>;
+
+        file_index_options         m_options;
+        ::std::vector<record_type> m_records;
+        path_lookup                m_lookup;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,651 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm>     // std::reverse, std::reverse_copy
+#include <atomic>        // std::atomic
+#include <cstddef>       // size_t, ptrdiff_t
+#include <cstdint>       // uint8_t, uint16_t, int32_t, uint32_t, uint64_t
+#include <cstring>       // std::memcpy
+#include <functional>    // std::hash
+#include <iterator>      // std::next
+#include <list>          // std::list
+#include <memory>        // std::shared_ptr
+#include <mutex>         // std::mutex
+#include <set>           // std::set
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::pair, std::move
+#include <vector>        // std::vector
+
+#include "def_sprite.hpp"      // nh3api::def_frame, nh3api::decode_def_frame
+#include "palette_kernels.hpp" // nh3api::pixel_format, nh3api::special_indices, nh3api::expand_indices
+#include "surface_kernels.hpp" // nh3api::surface_view
+
+namespace nh3api
+{
+
+// identity of a decoded frame: the sprite(CSprite*), the group and the frame in it and the palette it was expanded with.
+// <palette_version> tells apart the states of a palette changed in place(e.g. TPalette16::Cycle)
+struct frame_cache_key
+{
+    const void* sprite {nullptr};
+    int32_t     seq {0};
+    int32_t     frame {0};
+    const void* palette {nullptr};
+    uint32_t    palette_version {0};
+
+    [[nodiscard]] friend bool operator==(const frame_cache_key& lhs, const frame_cache_key& rhs) noexcept
+    {
+        return lhs.sprite == rhs.sprite && lhs.seq == rhs.seq && lhs.frame == rhs.frame
+               && lhs.palette == rhs.palette && lhs.palette_version == rhs.palette_version;
+    }
+
+    [[nodiscard]] friend bool operator!=(const frame_cache_key& lhs, const frame_cache_key& rhs) noexcept
+    { return !(lhs == rhs); }
+};
+
+} // namespace nh3api
+
+// std::hash support for nh3api::frame_cache_key
+template<>
+struct std::hash<nh3api::frame_cache_key>
+{
+    [[nodiscard]] size_t operator()(const nh3api::frame_cache_key& key) const noexcept
+    {
+        uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.sprite));
+        value ^= (static_cast<uint64_t>(static_cast<uint32_t>(key.seq)) << 32U | static_cast<uint32_t>(key.frame)) * 0x9E3779B97F4A7C15ULL;
+        value ^= (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.palette)) + key.palette_version) * 0xC2B2AE3D27D4EB4FULL;
+        value ^= value >> 29U;
+        return static_cast<size_t>(value);
+    }
+};
+
+namespace nh3api
+{
+
+// Sprite frame expanded to the pixel format of the screen /
+// Кадр спрайта, преобразованный в формат пикселей экрана.
+// Each row is a list of spans: colors which are copied as is and shadows which darken the target.
+// The transparent pixels are not stored, so drawing a frame is a few memcpy calls per row
+class cached_frame
+{
+    public:
+        enum span_kind : uint8_t
+        {
+            span_color          = 0,
+            span_shadow_quarter = 1,
+            span_shadow_half    = 2,
+            // not stored
+            span_transparent    = 0xFF
+        };
+
+        struct run
+        {
+            uint16_t  x;
+            uint16_t  length;
+            span_kind kind;
+            // offset of the colors in pixels, span_color only
+            uint32_t  offset;
+        };
+
+    public:
+        cached_frame() noexcept = default;
+
+        // Build from <height> rows of <width> palette indices placed at (x, y) of a <frame_width> x <frame_height> frame,
+        // <palette> is uint16_t[256] for the 16-bit formats and uint32_t[256] for argb8888
+        cached_frame(const uint8_t* indices, int32_t x, int32_t y, int32_t width, int32_t height,
+                     int32_t frame_width, int32_t frame_height, const void* palette, pixel_format format,
+                     const special_indices& special = {})
+            : m_format { format }, m_width { frame_width }, m_height { frame_height }
+        {
+            const size_t  pixel_size = this->pixel_size();
+            const uint8_t any        = palette_detail::special_mask(special);
+            m_rows.assign(static_cast<size_t>(frame_height) + 1, 0);
+            for ( int32_t row = 0; row < frame_height; ++row )
+            {
+                m_rows[static_cast<size_t>(row)] = static_cast<uint32_t>(m_spans.size());
+                if ( row < y || row >= y + height )
+                    continue;
+
+                const uint8_t* const source = indices + static_cast<size_t>(row - y) * static_cast<size_t>(width);
+                for ( int32_t i = 0; i < width; )
+                {
+                    const span_kind kind = kind_of(source[i], special, any);
+                    int32_t         end  = i + 1;
+                    while ( end < width && end - i < 0xFFFF && kind_of(source[end], special, any) == kind )
+                        ++end;
+
+                    if ( kind != span_transparent )
+                    {
+                        const uint32_t offset = static_cast<uint32_t>(m_colors.size() / pixel_size);
+                        m_spans.push_back({ static_cast<uint16_t>(x + i), static_cast<uint16_t>(end - i), kind, offset });
+                        if ( kind == span_color )
+                        {
+                            m_colors.resize(m_colors.size() + static_cast<size_t>(end - i) * pixel_size);
+                            if ( format == pixel_format::argb8888 )
+                                expand_indices(source + i, reinterpret_cast<uint32_t*>(m_colors.data()) + offset,
+                                               static_cast<size_t>(end - i), static_cast<const uint32_t*>(palette));
+                            else
+                                expand_indices(source + i, reinterpret_cast<uint16_t*>(m_colors.data()) + offset,
+                                               static_cast<size_t>(end - i), static_cast<const uint16_t*>(palette));
+                        }
+                    }
+                    i = end;
+                }
+            }
+            m_rows.back() = static_cast<uint32_t>(m_spans.size());
+        }
+
+    public:
+        [[nodiscard]] pixel_format format() const noexcept
+        { return m_format; }
+
+        [[nodiscard]] int32_t width() const noexcept
+        { return m_width; }
+
+        [[nodiscard]] int32_t height() const noexcept
+        { return m_height; }
+
+        [[nodiscard]] size_t pixel_size() const noexcept
+        { return m_format == pixel_format::argb8888 ? 4 : 2; }
+
+        // memory taken by the frame, charged against the cache budget
+        [[nodiscard]] size_t bytes() const noexcept
+        { return sizeof(*this) + m_colors.capacity() + m_spans.capacity() * sizeof(run) + m_rows.capacity() * sizeof(uint32_t); }
+
+        // The frame mirrored horizontally: the spans of each row in reverse order, their colors reversed.
+        // Drawing it is the same forward copy as drawing the frame itself
+        [[nodiscard]] cached_frame mirrored() const
+        {
+            cached_frame result;
+            result.m_format = m_format;
+            result.m_width  = m_width;
+            result.m_height = m_height;
+            result.m_colors.resize(m_colors.size());
+            result.m_spans.reserve(m_spans.size());
+            result.m_rows.reserve(m_rows.size());
+
+            const size_t pixel_size = this->pixel_size();
+            for ( size_t row = 0; row + 1 < m_rows.size(); ++row )
+            {
+                result.m_rows.push_back(static_cast<uint32_t>(result.m_spans.size()));
+                for ( uint32_t i = m_rows[row + 1]; i-- > m_rows[row]; )
+                {
+                    run current = m_spans[i];
+                    current.x   = static_cast<uint16_t>(m_width - (current.x + current.length));
+                    if ( current.kind == span_color )
+                    {
+                        if ( pixel_size == 4 )
+                            reverse_colors<uint32_t>(result.m_colors, current);
+                        else
+                            reverse_colors<uint16_t>(result.m_colors, current);
+                    }
+                    result.m_spans.push_back(current);
+                }
+            }
+            result.m_rows.push_back(static_cast<uint32_t>(result.m_spans.size()));
+            return result;
+        }
+
+        // Draw the frame with its top left corner at (x, y) of <target>, clipped to the target.
+        // The pixel type of <target> must match format()
+        template<class Pixel>
+        void draw(const surface_view<Pixel>& target, int32_t x, int32_t y) const noexcept
+        {
+            if ( sizeof(Pixel) != pixel_size() )
+                return;
+
+            const Pixel* const  colors = reinterpret_cast<const Pixel*>(m_colors.data());
+            const shade_masks16 masks  = get_shade_masks16(m_format);
+            const int32_t first = y < 0 ? -y : 0;
+            const int32_t last  = m_height < target.height - y ? m_height : target.height - y;
+            for ( int32_t row = first; row < last; ++row )
+            {
+                Pixel* const pixels = target.row(y + row);
+                for ( uint32_t i = m_rows[static_cast<size_t>(row)]; i < m_rows[static_cast<size_t>(row) + 1]; ++i )
+                {
+                    const run&  current = m_spans[i];
+                    int32_t     begin   = x + current.x;
+                    int32_t     end     = begin + current.length;
+                    const int32_t skip  = begin < 0 ? -begin : 0;
+                    begin = begin < 0 ? 0 : begin;
+                    end   = end > target.width ? target.width : end;
+                    if ( begin >= end )
+                        continue;
+
+                    Pixel* const  out   = pixels + begin;
+                    const size_t  count = static_cast<size_t>(end - begin);
+                    if ( current.kind == span_color )
+                        ::std::memcpy(out, colors + current.offset + skip, count * sizeof(Pixel));
+                    else if constexpr ( sizeof(Pixel) == 2 )
+                    {
+                        if ( current.kind == span_shadow_half )
+                            surface_detail::darken_span(out, count, masks.div2);
+                        else
+                            for ( size_t k = 0; k < count; ++k )
+                                out[k] = static_cast<uint16_t>(out[k] - ((out[k] >> 2U) & masks.div4));
+                    }
+                    else
+                    {
+                        if ( current.kind == span_shadow_half )
+                            surface_detail::darken_span(out, count);
+                        else
+                            for ( size_t k = 0; k < count; ++k )
+                                out[k] -= (out[k] >> 2U) & 0x003F3F3FU;
+                    }
+                }
+            }
+        }
+
+    protected:
+        // the colors of <current> reversed into <target> at the same offset
+        template<class Pixel>
+        void reverse_colors(::std::vector<uint8_t>& target, const run& current) const noexcept
+        {
+            const Pixel* const source = reinterpret_cast<const Pixel*>(m_colors.data()) + current.offset;
+            ::std::reverse_copy(source, source + current.length, reinterpret_cast<Pixel*>(target.data()) + current.offset);
+        }
+
+        [[nodiscard]] static span_kind kind_of(uint8_t index, const special_indices& special, uint8_t any) noexcept
+        {
+            const uint32_t bit = index < 8 ? (any & (1U << index)) : 0U;
+            if ( bit == 0 )
+                return span_color;
+            if ( special.transparent & bit )
+                return span_transparent;
+            return (special.shadow_half & bit) ? span_shadow_half : span_shadow_quarter;
+        }
+
+    protected:
+        pixel_format            m_format {pixel_format::rgb565};
+        int32_t                 m_width {0};
+        int32_t                 m_height {0};
+        // colors of the span_color spans, packed 16-bit or 32-bit pixels
+        ::std::vector<uint8_t>  m_colors;
+        ::std::vector<run>      m_spans;
+        // m_spans[m_rows[y]] .. m_spans[m_rows[y + 1]] are the spans of row y
+        ::std::vector<uint32_t> m_rows;
+
+};
+
+struct frame_cache_options
+{
+    size_t          budget_bytes {size_t(32) << 20U};
+    special_indices special {};
+};
+
+struct frame_cache_stats
+{
+    uint64_t hits {0};
+    uint64_t misses {0};
+    uint64_t insertions {0};
+    uint64_t evictions {0};
+    // frames which could not be decoded
+    uint64_t failed {0};
+    size_t   entries {0};
+    size_t   sprites {0};
+    size_t   bytes {0};
+
+    [[nodiscard]] double hit_rate() const noexcept
+    { return hits + misses != 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0; }
+};
+
+// Byte-budgeted cache of the decoded sprite frames /
+// Кэш декодированных кадров спрайтов с ограничением по размеру.
+// When the budget is exceeded, the least recently drawn sprite gives up its least recently drawn frame,
+// so a creature animating every frame keeps its whole animation while the idle sprites are trimmed first.
+// Frames larger than the whole budget are not cached. All the member functions are thread-safe
+class frame_cache
+{
+    public:
+        using frame_ptr = ::std::shared_ptr<const cached_frame>;
+
+    public:
+        explicit frame_cache(const frame_cache_options& options = {})
+            : m_options { options }
+        {}
+
+        frame_cache(const frame_cache&)            = delete;
+        frame_cache& operator=(const frame_cache&) = delete;
+
+    public:
+        // cached frame or nullptr
+        [[nodiscard]] frame_ptr find(const frame_cache_key& key)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(key);
+            if ( it == m_entries.end() )
+            {
+                ++m_stats.misses;
+                return nullptr;
+            }
+
+            ++m_stats.hits;
+            touch(key, it->second);
+            return it->second.frame;
+        }
+
+        // cached frame or nullptr, without counting a hit or a miss nor making the frame recently used
+        [[nodiscard]] frame_ptr peek(const frame_cache_key& key) const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(key);
+            return it != m_entries.end() ? it->second.frame : nullptr;
+        }
+
+        // Cached frame or <frame> decoded and expanded with <palette>(see cached_frame), nullptr if <frame> is damaged.
+        // The decoding runs without the lock held
+        frame_ptr get_or_decode(const frame_cache_key& key, const def_frame& frame, const void* palette, pixel_format format)
+        {
+            if ( frame_ptr cached = find(key) )
+                return cached;
+
+            if ( frame_ptr decoded = decode(frame, palette, format, m_options.special) )
+                return insert(key, ::std::move(decoded));
+            return failed();
+        }
+
+        // <frame> decoded and expanded with <palette>, mirrored horizontally if <hflip>; nullptr if <frame> is damaged
+        [[nodiscard]] static frame_ptr decode(const def_frame& frame, const void* palette, pixel_format format,
+                                              const special_indices& special = {}, bool hflip = false)
+        {
+            const def_frame_header& header = frame.header;
+            if ( header.width < 0 || header.height < 0 || header.cropped_x < 0 || header.cropped_y < 0
+                 || header.cropped_width < 0 || header.cropped_height < 0
+                 || header.cropped_x + header.cropped_width > header.width || header.cropped_y + header.cropped_height > header.height )
+                return nullptr;
+
+            const size_t           width = static_cast<size_t>(header.cropped_width);
+            ::std::vector<uint8_t> indices(width * static_cast<size_t>(header.cropped_height));
+            if ( !decode_def_frame(frame, indices.data(), width) )
+                return nullptr;
+
+            int32_t x = header.cropped_x;
+            if ( hflip )
+            {
+                for ( size_t row = 0; row < indices.size(); row += width )
+                    ::std::reverse(indices.begin() + static_cast<ptrdiff_t>(row), indices.begin() + static_cast<ptrdiff_t>(row + width));
+                x = header.width - (header.cropped_x + header.cropped_width);
+            }
+            return ::std::make_shared<const cached_frame>(indices.data(), x, header.cropped_y, header.cropped_width, header.cropped_height,
+                                                          header.width, header.height, palette, format, special);
+        }
+
+        // cache <frame> for <key>. Returns the cached frame: the existing one if <key> is already cached
+        frame_ptr insert(const frame_cache_key& key, frame_ptr frame)
+        {
+            if ( !frame )
+                return nullptr;
+
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto found = m_entries.find(key);
+            if ( found != m_entries.end() )
+            {
+                touch(key, found->second);
+                return found->second.frame;
+            }
+
+            const size_t size = frame->bytes();
+            if ( size > m_options.budget_bytes )
+                return frame;
+
+            sprite_node& owner = m_sprites[key.sprite];
+            owner.frames.push_front(key);
+            m_entries.emplace(key, node { frame, size, owner.frames.begin() });
+            m_bytes += size;
+            ++m_stats.insertions;
+            touch_sprite(key.sprite, owner);
+            evict();
+            return frame;
+        }
+
+        bool erase(const frame_cache_key& key)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(key);
+            if ( it == m_entries.end() )
+                return false;
+
+            remove(it);
+            return true;
+        }
+
+        // drop every frame of <sprite>, e.g. when the CSprite is disposed
+        void erase_sprite(const void* sprite)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_sprites.find(sprite);
+            if ( it == m_sprites.end() )
+                return;
+
+            while ( !it->second.frames.empty() )
+                remove(m_entries.find(it->second.frames.back()));
+        }
+
+        // drop every frame expanded with <palette>, e.g. when it is changed or disposed
+        void erase_palette(const void* palette)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            for ( auto it = m_entries.begin(); it != m_entries.end(); )
+            {
+                auto next = ::std::next(it);
+                if ( it->first.palette == palette )
+                    remove(it);
+                it = next;
+            }
+        }
+
+        void clear()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_entries.clear();
+            m_sprites.clear();
+            m_order.clear();
+            m_bytes = 0;
+        }
+
+        void set_budget(size_t budget_bytes)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_options.budget_bytes = budget_bytes;
+            evict();
+        }
+
+        [[nodiscard]] frame_cache_options options() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_options;
+        }
+
+        [[nodiscard]] frame_cache_stats stats() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            frame_cache_stats result = m_stats;
+            result.entries = m_entries.size();
+            result.sprites = m_sprites.size();
+            result.bytes   = m_bytes;
+            return result;
+        }
+
+        void reset_stats()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_stats = frame_cache_stats {};
+        }
+
+    protected:
+        struct node
+        {
+            frame_ptr                              frame;
+            size_t                                 bytes;
+            // position in the LRU list of the sprite
+            ::std::list<frame_cache_key>::iterator position;
+        };
+
+        struct sprite_node
+        {
+            // the most recently used frame first
+            ::std::list<frame_cache_key> frames;
+            uint64_t                     tick {0};
+        };
+
+        frame_ptr failed()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            ++m_stats.failed;
+            return nullptr;
+        }
+
+        void touch(const frame_cache_key& key, node& current)
+        {
+            sprite_node& owner = m_sprites[key.sprite];
+            owner.frames.splice(owner.frames.begin(), owner.frames, current.position);
+            touch_sprite(key.sprite, owner);
+        }
+
+        void touch_sprite(const void* sprite, sprite_node& owner)
+        {
+            if ( owner.tick != 0 )
+                m_order.erase({ owner.tick, sprite });
+            owner.tick = ++m_tick;
+            m_order.insert({ owner.tick, sprite });
+        }
+
+        void remove(::std::unordered_map<frame_cache_key, node>::iterator it)
+        {
+            const auto owner = m_sprites.find(it->first.sprite);
+            owner->second.frames.erase(it->second.position);
+            if ( owner->second.frames.empty() )
+            {
+                m_order.erase({ owner->second.tick, owner->first });
+                m_sprites.erase(owner);
+            }
+            m_bytes -= it->second.bytes;
+            m_entries.erase(it);
+        }
+
+        void evict()
+        {
+            while ( m_bytes > m_options.budget_bytes && !m_order.empty() )
+            {
+                // the least recently used frame of the least recently used sprite
+                const sprite_node& victim = m_sprites.find(m_order.begin()->second)->second;
+                remove(m_entries.find(victim.frames.back()));
+                ++m_stats.evictions;
+            }
+        }
+
+    protected:
+        frame_cache_options                            m_options;
+        mutable ::std::mutex                           m_mutex;
+        ::std::unordered_map<frame_cache_key, node>    m_entries;
+        ::std::unordered_map<const void*, sprite_node> m_sprites;
+        // sprites by the last use
+        ::std::set<::std::pair<uint64_t, const void*>> m_order;
+        size_t                                         m_bytes {0};
+        uint64_t                                       m_tick {0};
+        frame_cache_stats                              m_stats;
+
+};
+
+struct mirrored_frame_stats
+{
+    // the mirrored frames kept: hits are the flipped draws served without decoding
+    frame_cache_stats cache;
+    // frames mirrored from a frame of the forward cache and frames decoded in the mirrored order
+    uint64_t          from_forward {0};
+    uint64_t          decoded {0};
+};
+
+// Horizontally mirrored frames for the flipped draws(the hflip argument of CSprite::Draw*) /
+// Отражённые по горизонтали кадры для отрисовки с hflip.
+// The first flipped draw of a frame mirrors it once: from the forward frame if <forward> has it cached, else by decoding
+// the frame and reversing its rows. The later flipped draws reuse it with the same forward copies as the unflipped ones.
+// The mirrored frames have their own budget, so left-facing creatures do not push the forward frames out. Thread-safe
+class mirrored_frame_store
+{
+    public:
+        using frame_ptr = frame_cache::frame_ptr;
+
+    public:
+        // <forward>: the cache of the unflipped frames to mirror from, optional, must outlive the store
+        explicit mirrored_frame_store(const frame_cache_options& options = { size_t(16) << 20U }, frame_cache* forward = nullptr)
+            : m_frames { options }, m_forward { forward }
+        {}
+
+        mirrored_frame_store(const mirrored_frame_store&)            = delete;
+        mirrored_frame_store& operator=(const mirrored_frame_store&) = delete;
+
+    public:
+        // <frame> mirrored horizontally, see frame_cache::get_or_decode. <key> is the key of the unflipped frame
+        frame_ptr get_or_mirror(const frame_cache_key& key, const def_frame& frame, const void* palette, pixel_format format)
+        {
+            if ( frame_ptr cached = m_frames.find(key) )
+                return cached;
+
+            if ( m_forward )
+            {
+                if ( frame_ptr forward = m_forward->peek(key) )
+                {
+                    m_from_forward.fetch_add(1, ::std::memory_order_relaxed);
+                    return m_frames.insert(key, ::std::make_shared<const cached_frame>(forward->mirrored()));
+                }
+            }
+
+            frame_ptr mirrored = frame_cache::decode(frame, palette, format, m_frames.options().special, true);
+            if ( !mirrored )
+                return nullptr;
+            m_decoded.fetch_add(1, ::std::memory_order_relaxed);
+            return m_frames.insert(key, ::std::move(mirrored));
+        }
+
+        // cached mirrored frame or nullptr
+        [[nodiscard]] frame_ptr find(const frame_cache_key& key)
+        { return m_frames.find(key); }
+
+        void erase_sprite(const void* sprite)
+        { m_frames.erase_sprite(sprite); }
+
+        void erase_palette(const void* palette)
+        { m_frames.erase_palette(palette); }
+
+        void clear()
+        { m_frames.clear(); }
+
+        void set_budget(size_t budget_bytes)
+        { m_frames.set_budget(budget_bytes); }
+
+        [[nodiscard]] mirrored_frame_stats stats() const
+        {
+            mirrored_frame_stats result;
+            result.cache        = m_frames.stats();
+            result.from_forward = m_from_forward.load(::std::memory_order_relaxed);
+            result.decoded      = m_decoded.load(::std::memory_order_relaxed);
+            return result;
+        }
+
+        void reset_stats()
+        {
+            m_frames.reset_stats();
+            m_from_forward.store(0, ::std::memory_order_relaxed);
+            m_decoded.store(0, ::std::memory_order_relaxed);
+        }
+
+    protected:
+        frame_cache             m_frames;
+        frame_cache*            m_forward;
+        ::std::atomic<uint64_t> m_from_forward {0};
+        ::std::atomic<uint64_t> m_decoded {0};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // std::byte
+#include <cstdint> // uint8_t, uint32_t
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "checksum.hpp"                // nh3api::crc32
+#include "inflate.hpp"                 // nh3api::zlib_inflater
+
+namespace nh3api
+{
+
+// saved games(.GM1, .CGM, ...), maps(.h3m) and campaigns(.h3c) are gzip files
+[[nodiscard]] inline bool is_gzip(span<const ::std::byte> input) noexcept
+{ return input.size() >= 2 && input[0] == ::std::byte { 0x1F } && input[1] == ::std::byte { 0x8B }; }
+
+// size of the gzip member header(RFC 1952) at the beginning of <input>, 0 if it is truncated or invalid
+[[nodiscard]] inline size_t gzip_header_size(span<const ::std::byte> input) noexcept
+{
+    constexpr uint32_t fhcrc = 0x02, fextra = 0x04, fname = 0x08, fcomment = 0x10;
+    if ( input.size() < 10 || !is_gzip(input) || input[2] != ::std::byte { 8 } )
+        return 0;
+
+    const uint32_t flags = static_cast<uint8_t>(input[3]);
+    if ( (flags & 0xE0U) != 0 )
+        return 0; // reserved flags
+
+    size_t size = 10;
+    if ( (flags & fextra) != 0 )
+    {
+        if ( input.size() < size + 2 )
+            return 0;
+        size += 2 + (static_cast<uint8_t>(input[size]) | (static_cast<size_t>(static_cast<uint8_t>(input[size + 1])) << 8U));
+    }
+
+    for ( const uint32_t zero_terminated : { fname, fcomment } )
+    {
+        if ( (flags & zero_terminated) == 0 )
+            continue;
+        while ( size < input.size() && input[size] != ::std::byte { 0 } )
+            ++size;
+        ++size; // terminator
+    }
+
+    if ( (flags & fhcrc) != 0 )
+        size += 2;
+
+    return size <= input.size() ? size : 0;
+}
+
+// decode a gzip file and append the result to <output>, CRC-32 and the size of every member are verified.
+// Concatenated members are decoded one after another, the data after the last member is ignored.
+// <size_hint> is the expected size of the output, by default it is taken from the trailer of the file.
+// If the output exceeds <max_output>, too_large is returned and <output> keeps the decoded prefix(up to 258 bytes short of the limit),
+// which is enough to read the header of a saved game or a map without decoding the whole file.
+// On success <crc>, if not null, receives CRC-32 of the decoded data: the verified trailer value for a single member,
+// which is what the game writes, so the data is not checksummed twice
+[[nodiscard]] inline inflate_status gzip_uncompress(span<const ::std::byte> input, ::std::vector<::std::byte>& output,
+                                                    size_t size_hint = 0, size_t max_output = static_cast<size_t>(-1),
+                                                    uint32_t* crc = nullptr)
+{
+    const auto load_u32 = [](const ::std::byte* at) noexcept
+    {
+        return  static_cast<uint32_t>(static_cast<uint8_t>(at[0]))
+             | (static_cast<uint32_t>(static_cast<uint8_t>(at[1])) << 8U)
+             | (static_cast<uint32_t>(static_cast<uint8_t>(at[2])) << 16U)
+             | (static_cast<uint32_t>(static_cast<uint8_t>(at[3])) << 24U);
+    };
+
+    if ( size_hint == 0 && input.size() >= 18 )
+    {
+        // ISIZE of the last member, deflate can not expand the data more than ~1032 times
+        size_hint = load_u32(input.data() + input.size() - 4);
+        if ( size_hint / 1032 > input.size() )
+            size_hint = 0;
+    }
+
+    const size_t  start      = output.size();
+    zlib_inflater inflater;
+    size_t        members    = 0;
+    uint32_t      stored_crc = 0;
+    do
+    {
+        const size_t header = gzip_header_size(input);
+        if ( header == 0 )
+            return input.size() < 10 ? inflate_status::truncated : inflate_status::bad_data;
+
+        const size_t   member  = output.size();
+        const size_t   decoded = member - start;
+        inflate_status status  = inflater.inflate(input.subspan(header), output,
+                                                  size_hint > decoded ? size_hint - decoded : 0,
+                                                  max_output - decoded);
+        if ( status != inflate_status::ok )
+            return status;
+
+        const size_t trailer = header + inflater.consumed();
+        if ( input.size() < trailer + 8 )
+            return inflate_status::truncated;
+
+        if ( crc32(output.data() + member, output.size() - member) != load_u32(input.data() + trailer)
+             || static_cast<uint32_t>(output.size() - member) != load_u32(input.data() + trailer + 4) )
+            return inflate_status::bad_data;
+
+        ++members;
+        stored_crc = load_u32(input.data() + trailer);
+        input      = input.subspan(trailer + 8);
+    }
+    while ( is_gzip(input) );
+
+    if ( crc != nullptr )
+        *crc = members == 1 ? stored_crc : crc32(output.data() + start, output.size() - start);
+
+    return inflate_status::ok;
+}
+
+} // namespace nh3api
@@ -0,0 +1,293 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cstdint> // int8_t, uint8_t, uint16_t, int32_t, uint32_t
+#include <string>  // std::string
+
+#include "byte_reader.hpp" // nh3api::byte_reader, nh3api::byte_writer
+
+namespace nh3api
+{
+
+// CMapHeaderData::iVersion
+enum class h3m_format : int32_t
+{
+    roe = 0x0E, // Restoration of Erathia
+    ab  = 0x15, // Armageddon's Blade
+    sod = 0x1C, // Shadow of Death
+    wog = 0x33  // In the Wake of Gods, the header is the same as in SoD
+};
+
+// CMapHeaderData::TPlayerSlotAttributes as stored in the map file
+struct h3m_player
+{
+    bool                     can_be_human {false};
+    bool                     can_be_computer {false};
+    int8_t                   ai_strategy {0};
+    // bit i: TTownType i can be picked
+    uint16_t                 legal_alignments {0};
+    bool                     random_alignment {false};
+    bool                     has_main_town {false};
+    bool                     generate_hero {false};
+    // x, y, z
+    ::std::array<uint8_t, 3> main_town {};
+    bool                     random_hero {false};
+    // THeroID, -1: none
+    int32_t                  hero_id {-1};
+    int32_t                  hero_portrait {-1};
+    ::std::string            hero_name;
+
+    [[nodiscard]] bool is_playable() const noexcept
+    { return can_be_human || can_be_computer; }
+};
+
+// The part of the map file read by the scenario selection dialog(NewSMapHeader),
+// read_h3m_header() stops before the allowed artifacts
+struct h3m_header
+{
+    int32_t                     version {0};
+    // CMapHeaderData::IsPlayable
+    bool                        playable {false};
+    int32_t                     size {0};
+    bool                        two_levels {false};
+    ::std::string               name;
+    ::std::string               description;
+    // EGameDifficulty
+    int8_t                      difficulty {0};
+    // 0: no limit
+    uint8_t                     max_hero_level {0};
+    ::std::array<h3m_player, 8> players {};
+    // EVictoryConditionType, ELossConditionType, -1: none
+    int8_t                      victory_condition {-1};
+    int8_t                      loss_condition {-1};
+    uint8_t                     num_teams {0};
+    ::std::array<uint8_t, 8>    teams {};
+
+    [[nodiscard]] int32_t num_players() const noexcept
+    {
+        int32_t result = 0;
+        for ( const h3m_player& player : players )
+            result += player.is_playable();
+        return result;
+    }
+
+    [[nodiscard]] int32_t num_human_players() const noexcept
+    {
+        int32_t result = 0;
+        for ( const h3m_player& player : players )
+            result += player.can_be_human;
+        return result;
+    }
+};
+
+// parse the header of a decoded map file(or the map header of a saved game) at the position of <reader>.
+// Returns false on truncated data or an unsupported format(e.g. HotA), the reader is left failed then
+inline bool read_h3m_header(byte_reader& reader, h3m_header& header)
+{
+    header.version = reader.read<int32_t>();
+    const h3m_format format = static_cast<h3m_format>(header.version);
+    if ( format != h3m_format::roe && format != h3m_format::ab && format != h3m_format::sod && format != h3m_format::wog )
+    {
+        reader.fail();
+        return false;
+    }
+
+    const bool roe = format == h3m_format::roe;
+    const bool sod = format == h3m_format::sod || format == h3m_format::wog;
+    header.playable       = reader.read_bool();
+    header.size           = reader.read<int32_t>();
+    header.two_levels     = reader.read_bool();
+    header.name           = reader.read_string();
+    header.description    = reader.read_string();
+    header.difficulty     = reader.read<int8_t>();
+    header.max_hero_level = roe ? 0 : reader.read<uint8_t>();
+
+    for ( h3m_player& player : header.players )
+    {
+        player                 = h3m_player {};
+        player.can_be_human    = reader.read_bool();
+        player.can_be_computer = reader.read_bool();
+        if ( !player.is_playable() )
+        {
+            reader.skip(roe ? 6 : (sod ? 13 : 12));
+            continue;
+        }
+
+        player.ai_strategy = reader.read<int8_t>();
+        if ( sod )
+            reader.skip(1); // alignments are set explicitly
+        player.legal_alignments = roe ? reader.read<uint8_t>() : reader.read<uint16_t>();
+        player.random_alignment = reader.read_bool();
+        player.has_main_town    = reader.read_bool();
+        if ( player.has_main_town )
+        {
+            if ( !roe )
+            {
+                player.generate_hero = reader.read_bool();
+                reader.skip(1); // town type, unused
+            }
+            else
+                player.generate_hero = true;
+
+            reader.read(player.main_town.data(), player.main_town.size());
+        }
+
+        player.random_hero = reader.read_bool();
+        const uint8_t hero = reader.read<uint8_t>();
+        if ( hero != 0xFF )
+        {
+            const uint8_t portrait = reader.read<uint8_t>();
+            player.hero_id         = hero;
+            player.hero_portrait   = portrait != 0xFF ? portrait : -1;
+            player.hero_name       = reader.read_string();
+        }
+
+        if ( !roe )
+        {
+            reader.skip(1); // placeholders
+            const uint8_t heroes = reader.read<uint8_t>();
+            reader.skip(3);
+            for ( uint32_t i = 0; i < heroes && reader.ok(); ++i )
+            {
+                reader.skip(1); // hero id
+                static_cast<void>(reader.read_string());
+            }
+        }
+    }
+
+    header.victory_condition = reader.read<int8_t>();
+    if ( header.victory_condition != -1 )
+    {
+        reader.skip(2); // normal victory allowed, applies to computer
+        switch ( header.victory_condition )
+        {
+            case 0:  reader.skip(roe ? 1 : 2); break;       // artifact
+            case 1:  reader.skip((roe ? 1 : 2) + 4); break; // creature, amount
+            case 2:  reader.skip(1 + 4); break;             // resource, amount
+            case 3:  reader.skip(3 + 2); break;             // town, hall and castle levels
+            case 4:
+            case 5:
+            case 6:
+            case 7:  reader.skip(3); break;                 // location
+            case 8:
+            case 9:  break;
+            case 10: reader.skip(1 + 3); break;             // artifact, town
+            default: reader.fail(); break;
+        }
+    }
+
+    header.loss_condition = reader.read<int8_t>();
+    switch ( header.loss_condition )
+    {
+        case -1: break;
+        case 0:
+        case 1:  reader.skip(3); break; // town or hero location
+        case 2:  reader.skip(2); break; // days
+        default: reader.fail(); break;
+    }
+
+    header.num_teams = reader.read<uint8_t>();
+    header.teams.fill(0);
+    if ( header.num_teams != 0 )
+        reader.read(header.teams.data(), header.teams.size());
+
+    reader.skip(roe ? 16 : 20); // available heroes bitset
+    if ( !roe )
+    {
+        // campaign hero placeholders
+        const uint32_t placeholders = reader.read<uint32_t>();
+        if ( placeholders > 256 )
+            reader.fail();
+        reader.skip(placeholders);
+    }
+    if ( sod )
+    {
+        // heroes with custom names or portraits(NewSMapHeader::heroPlayerSetups)
+        const uint8_t setups = reader.read<uint8_t>();
+        for ( uint32_t i = 0; i < setups && reader.ok(); ++i )
+        {
+            reader.skip(2); // hero id, portrait
+            static_cast<void>(reader.read_string());
+            reader.skip(1); // players
+        }
+    }
+
+    return reader.ok();
+}
+
+// compact serialization of a parsed header for the on-disk indices
+inline void write_h3m_header(byte_writer& writer, const h3m_header& header)
+{
+    writer.write(header.version);
+    writer.write_bool(header.playable);
+    writer.write(header.size);
+    writer.write_bool(header.two_levels);
+    writer.write_string(header.name);
+    writer.write_string(header.description);
+    writer.write(header.difficulty);
+    writer.write(header.max_hero_level);
+    for ( const h3m_player& player : header.players )
+    {
+        writer.write_bool(player.can_be_human);
+        writer.write_bool(player.can_be_computer);
+        writer.write(player.ai_strategy);
+        writer.write(player.legal_alignments);
+        writer.write_bool(player.random_alignment);
+        writer.write_bool(player.has_main_town);
+        writer.write_bool(player.generate_hero);
+        writer.write(player.main_town.data(), player.main_town.size());
+        writer.write_bool(player.random_hero);
+        writer.write(player.hero_id);
+        writer.write(player.hero_portrait);
+        writer.write_string(player.hero_name);
+    }
+    writer.write(header.victory_condition);
+    writer.write(header.loss_condition);
+    writer.write(header.num_teams);
+    writer.write(header.teams.data(), header.teams.size());
+}
+
+inline bool load_h3m_header(byte_reader& reader, h3m_header& header)
+{
+    header.version        = reader.read<int32_t>();
+    header.playable       = reader.read_bool();
+    header.size           = reader.read<int32_t>();
+    header.two_levels     = reader.read_bool();
+    header.name           = reader.read_string();
+    header.description    = reader.read_string();
+    header.difficulty     = reader.read<int8_t>();
+    header.max_hero_level = reader.read<uint8_t>();
+    for ( h3m_player& player : header.players )
+    {
+        player.can_be_human     = reader.read_bool();
+        player.can_be_computer  = reader.read_bool();
+        player.ai_strategy      = reader.read<int8_t>();
+        player.legal_alignments = reader.read<uint16_t>();
+        player.random_alignment = reader.read_bool();
+        player.has_main_town    = reader.read_bool();
+        player.generate_hero    = reader.read_bool();
+        reader.read(player.main_town.data(), player.main_town.size());
+        player.random_hero      = reader.read_bool();
+        player.hero_id          = reader.read<int32_t>();
+        player.hero_portrait    = reader.read<int32_t>();
+        player.hero_name        = reader.read_string();
+    }
+    header.victory_condition = reader.read<int8_t>();
+    header.loss_condition    = reader.read<int8_t>();
+    header.num_teams         = reader.read<uint8_t>();
+    reader.read(header.teams.data(), header.teams.size());
+    return reader.ok();
+}
+
+} // namespace nh3api
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm>   // std::stable_sort
+#include <array>       // std::array
+#include <filesystem>  // std::filesystem
+#include <functional>  // std::less
+#include <numeric>     // std::iota
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "byte_reader.hpp"             // nh3api::byte_reader
+#include "file_index.hpp"              // nh3api::file_index, nh3api::parse_gzip_prefix
+#include "h3m_header.hpp"              // nh3api::h3m_header
+
+namespace nh3api
+{
+
+// Read the header of the map at <path>, only the beginning of the file is read and inflated
+inline bool read_h3m_file(const ::std::filesystem::path& path, h3m_header& header)
+{
+    return parse_gzip_prefix(path, [&header](span<const ::std::byte> data)
+    {
+        byte_reader reader(data);
+        return read_h3m_header(reader, header);
+    });
+}
+
+// file_index traits of the maps
+struct h3m_traits
+{
+    using info_type = h3m_header;
+
+    static inline constexpr ::std::array<char, 8> signature { 'N', 'H', '3', 'M', 'I', 'D', 'X', '\0' };
+    static inline constexpr uint32_t              version = 1;
+
+    [[nodiscard]] static ::std::vector<::std::string> default_extensions()
+    { return { ".h3m" }; }
+
+    static bool parse(const ::std::filesystem::path& path, h3m_header& header)
+    { return read_h3m_file(path, header); }
+
+    static void write(byte_writer& writer, const h3m_header& header)
+    { write_h3m_header(writer, header); }
+
+    static void read(byte_reader& reader, h3m_header& header)
+    { load_h3m_header(reader, header); }
+};
+
+// Index of the maps in a directory, see file_index
+using h3m_index  = file_index<h3m_traits>;
+using h3m_record = h3m_index::record_type;
+
+// Map list as a structure of arrays /
+// Список карт в виде структуры массивов.
+// One row per valid map, the columns are contiguous so that sorting and filtering touch only the columns they need.
+// The names are views into the index records and are valid until the next scan() or load() of the index
+struct h3m_header_table
+{
+    // row -> index in h3m_index::records()
+    ::std::vector<uint32_t>           record;
+    ::std::vector<::std::string_view> name;
+    ::std::vector<int32_t>            version;
+    // CMapHeaderData::Size
+    ::std::vector<int32_t>            map_size;
+    ::std::vector<uint8_t>            two_levels;
+    ::std::vector<int8_t>             difficulty;
+    ::std::vector<uint8_t>            max_hero_level;
+    ::std::vector<uint8_t>            players;
+    ::std::vector<uint8_t>            human_players;
+    ::std::vector<uint8_t>            num_teams;
+    ::std::vector<int8_t>             victory_condition;
+    ::std::vector<int8_t>             loss_condition;
+
+    [[nodiscard]] size_t rows() const noexcept
+    { return record.size(); }
+
+    // rows ordered by <column>, ties keep the order of <rows>(all the rows by default)
+    template<class T, class Less = ::std::less<>>
+    [[nodiscard]] ::std::vector<uint32_t> order_by(const ::std::vector<T>& column, Less less = {}, ::std::vector<uint32_t> rows = {}) const
+    {
+        if ( rows.empty() )
+        {
+            rows.resize(record.size());
+            ::std::iota(rows.begin(), rows.end(), 0U);
+        }
+
+        ::std::stable_sort(rows.begin(), rows.end(), [&column, &less](uint32_t lhs, uint32_t rhs)
+        { return less(column[lhs], column[rhs]); });
+        return rows;
+    }
+
+    // rows for which <predicate>(row) is true
+    template<class Predicate>
+    [[nodiscard]] ::std::vector<uint32_t> rows_where(Predicate&& predicate) const
+    {
+        ::std::vector<uint32_t> result;
+        for ( uint32_t row = 0; row < record.size(); ++row )
+            if ( predicate(row) )
+                result.push_back(row);
+
+        return result;
+    }
+};
+
+[[nodiscard]] inline h3m_header_table make_h3m_header_table(const h3m_index& index)
+{
+    const ::std::vector<h3m_record>& records = index.records();
+    h3m_header_table table;
+    const auto reserve = [&records](auto&... columns) { (columns.reserve(records.size()), ...); };
+    reserve(table.record, table.name, table.version, table.map_size, table.two_levels, table.difficulty, table.max_hero_level,
+            table.players, table.human_players, table.num_teams, table.victory_condition, table.loss_condition);
+
+    for ( uint32_t i = 0; i < records.size(); ++i )
+    {
+        if ( !records[i].valid )
+            continue;
+
+        const h3m_header& header = records[i].info;
+        table.record.push_back(i);
+        table.name.push_back(header.name);
+        table.version.push_back(header.version);
+        table.map_size.push_back(header.size);
+        table.two_levels.push_back(header.two_levels);
+        table.difficulty.push_back(header.difficulty);
+        table.max_hero_level.push_back(header.max_hero_level);
+        table.players.push_back(static_cast<uint8_t>(header.num_players()));
+        table.human_players.push_back(static_cast<uint8_t>(header.num_human_players()));
+        table.num_teams.push_back(header.num_teams);
+        table.victory_condition.push_back(header.victory_condition);
+        table.loss_condition.push_back(header.loss_condition);
+    }
+
+    return table;
+}
+
+} // namespace nh3api
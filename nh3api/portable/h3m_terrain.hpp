@@ -0,0 +1,134 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>    // std::byte
+#include <cstdint>    // uint8_t, uint16_t, uint32_t
+#include <filesystem> // std::filesystem
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "byte_reader.hpp"             // nh3api::byte_reader
+#include "file_index.hpp"              // nh3api::parse_gzip_prefix
+#include "h3m_header.hpp"              // nh3api::h3m_header, nh3api::read_h3m_header
+#include "terrain_planes.hpp"          // nh3api::terrain_planes
+
+namespace nh3api
+{
+
+namespace h3m_detail
+{
+
+// skip the map sections between the header and the terrain: the allowed artifacts, spells and skills,
+// the rumors and the predefined heroes
+inline bool skip_to_terrain(byte_reader& reader, const h3m_header& header)
+{
+    const h3m_format format = static_cast<h3m_format>(header.version);
+    const bool       roe    = format == h3m_format::roe;
+    const bool       sod    = format == h3m_format::sod || format == h3m_format::wog;
+
+    reader.skip(31); // reserved
+    if ( !roe )
+        reader.skip(sod ? 18 : 17); // allowed artifacts bitset
+    if ( sod )
+        reader.skip(9 + 4); // allowed spells and secondary skills bitsets
+
+    const uint32_t rumors = reader.read<uint32_t>();
+    for ( uint32_t i = 0; i < rumors && reader.ok(); ++i )
+    {
+        static_cast<void>(reader.read_string()); // name
+        static_cast<void>(reader.read_string()); // text
+    }
+
+    if ( !sod )
+        return reader.ok();
+
+    // predefined hero settings, one per hero type
+    constexpr uint32_t heroes = 156;
+    for ( uint32_t i = 0; i < heroes && reader.ok(); ++i )
+    {
+        if ( !reader.read_bool() )
+            continue;
+
+        if ( reader.read_bool() )
+            reader.skip(4); // experience
+        if ( reader.read_bool() )
+        {
+            const uint32_t skills = reader.read<uint32_t>();
+            if ( skills > 28 )
+                reader.fail();
+            reader.skip(skills * 2); // skill, level
+        }
+        if ( reader.read_bool() )
+        {
+            reader.skip(19 * 2); // equipped artifacts
+            const uint16_t backpack = reader.read<uint16_t>();
+            reader.skip(size_t(backpack) * 2);
+        }
+        if ( reader.read_bool() )
+            static_cast<void>(reader.read_string()); // biography
+        reader.skip(1); // sex
+        if ( reader.read_bool() )
+            reader.skip(9); // spells
+        if ( reader.read_bool() )
+            reader.skip(4); // primary skills
+    }
+
+    return reader.ok();
+}
+
+} // namespace h3m_detail
+
+// Decode the terrain of a map into <planes>. <reader> must be positioned right after the header,
+// that is read_h3m_header(reader, header) has just succeeded.
+// Returns false on truncated data, the planes are left allocated then
+inline bool read_h3m_terrain(byte_reader& reader, const h3m_header& header, terrain_planes& planes)
+{
+    if ( header.size <= 0 || header.size > 1024 || !h3m_detail::skip_to_terrain(reader, header) )
+        return false;
+
+    planes.assign(header.size, header.two_levels ? 2 : 1);
+    const size_t tiles = planes.tiles();
+    const span<const ::std::byte> data = reader.view(tiles * 7);
+    if ( data.empty() )
+        return false;
+
+    // 7 bytes per tile, split into the planes in one pass
+    const uint8_t* const source = reinterpret_cast<const uint8_t*>(data.data());
+    for ( size_t i = 0; i < tiles; ++i )
+    {
+        const uint8_t* const tile = source + i * 7;
+        planes.ground_type[i]  = tile[0];
+        planes.ground_frame[i] = tile[1];
+        planes.river_type[i]   = tile[2];
+        planes.river_frame[i]  = tile[3];
+        planes.road_type[i]    = tile[4];
+        planes.road_frame[i]   = tile[5];
+        planes.flags[i]        = tile[6];
+    }
+
+    planes.unpack_flags();
+    return true;
+}
+
+// Decode the header and the terrain of the map at <path>, the objects that follow the terrain are not read
+inline bool read_h3m_terrain_file(const ::std::filesystem::path& path, terrain_planes& planes, h3m_header& header)
+{
+    // 252x252x2 terrain alone is 889 KB
+    constexpr size_t max_prefix_size = size_t(4) << 20U;
+    return parse_gzip_prefix(path, [&planes, &header](span<const ::std::byte> data)
+    {
+        byte_reader reader(data);
+        return read_h3m_header(reader, header) && read_h3m_terrain(reader, header, planes);
+    }, max_prefix_size);
+}
+
+} // namespace nh3api
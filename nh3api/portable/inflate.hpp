@@ -0,0 +1,451 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cstddef> // std::byte
+#include <cstdint> // uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring> // std::memcpy
+#include <utility> // std::pair
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "checksum.hpp"                // nh3api::adler32
+#include "deflate.hpp"                 // nh3api::deflate_tables
+
+namespace nh3api
+{
+
+enum class inflate_status : int32_t
+{
+    ok        = 0,
+    truncated = 1, // the input ends in the middle of the stream
+    bad_data  = 2, // invalid stream or checksum mismatch
+    too_large = 3  // the output exceeds the limit
+};
+
+// Raw deflate(RFC 1951) decoder.
+// Huffman codes up to <fast_bits> long are decoded with a single table lookup,
+// the rare longer codes are decoded bit by bit from the canonical code counts.
+class zlib_inflater
+{
+    protected:
+        static inline constexpr uint32_t fast_bits = 10;
+        static inline constexpr uint32_t max_bits  = 15;
+
+        struct huffman
+        {
+            // (symbol << 4) | length, 0 if the code is longer than fast_bits
+            std::array<uint16_t, 1U << fast_bits> fast {};
+            std::array<uint16_t, max_bits + 1>    count {};
+            std::array<uint16_t, 288>             symbol {};
+        };
+
+    public:
+        // decode a raw deflate stream from <input> and append the result to <output>.
+        // <size_hint> is the expected size of the output, e.g. LODEntry::size.
+        // consumed() returns the number of input bytes used by the stream
+        inflate_status inflate(span<const ::std::byte> input, ::std::vector<::std::byte>& output,
+                               size_t size_hint = 0, size_t max_output = static_cast<size_t>(-1))
+        {
+            m_input      = input.data();
+            m_size       = input.size();
+            m_position   = 0;
+            m_bit_buffer = 0;
+            m_bit_count  = 0;
+            m_consumed   = 0;
+
+            const size_t start = output.size();
+            size_t       capacity = size_hint != 0 ? size_hint : (input.size() * 4 + 64);
+            if ( capacity > max_output )
+                capacity = max_output;
+            output.resize(start + capacity);
+
+            size_t         written = 0;
+            inflate_status status  = inflate_status::ok;
+            bool           final   = false;
+            while ( !final && status == inflate_status::ok )
+            {
+                final = bits(1) != 0;
+                const uint32_t type = bits(2);
+                if ( type == 0 )
+                    status = stored_block(output, start, written, max_output);
+                else if ( type == 1 )
+                    status = huffman_block(fixed_tables().first, fixed_tables().second, output, start, written, max_output);
+                else if ( type == 2 )
+                {
+                    status = read_dynamic_tables();
+                    if ( status == inflate_status::ok )
+                        status = huffman_block(m_lit_len, m_dist, output, start, written, max_output);
+                }
+                else
+                    status = inflate_status::bad_data;
+
+                // the zero padding past the end of a cut stream may decode as an invalid code
+                if ( (status == inflate_status::ok || status == inflate_status::bad_data) && overrun() )
+                    status = inflate_status::truncated;
+            }
+
+            output.resize(start + written);
+            m_consumed = m_position - m_bit_count / 8;
+            return status;
+        }
+
+        [[nodiscard]] size_t consumed() const noexcept
+        { return m_consumed; }
+
+    protected:
+        // the bit reader pads the input with zeroes, the stream is truncated if it has used them
+        [[nodiscard]] bool overrun() const noexcept
+        { return m_position - m_bit_count / 8 > m_size; }
+
+        void refill() noexcept
+        {
+            while ( m_bit_count <= 56 )
+            {
+                const uint64_t value = m_position < m_size ? static_cast<uint8_t>(m_input[m_position]) : 0;
+                m_bit_buffer |= value << m_bit_count;
+                m_bit_count  += 8;
+                ++m_position;
+            }
+        }
+
+        uint32_t bits(uint32_t count) noexcept
+        {
+            if ( m_bit_count < count )
+                refill();
+
+            const uint32_t result = static_cast<uint32_t>(m_bit_buffer & ((uint64_t(1) << count) - 1));
+            m_bit_buffer >>= count;
+            m_bit_count   -= count;
+            return result;
+        }
+
+        // returns false if the lengths do not form a valid prefix code.
+        // Incomplete codes are accepted only if they have a single code, like zlib does
+        static bool build(huffman& table, const uint8_t* lengths, uint32_t count) noexcept
+        {
+            table.count.fill(0);
+            table.fast.fill(0);
+            for ( uint32_t i = 0; i < count; ++i )
+                ++table.count[lengths[i]];
+            table.count[0] = 0;
+
+            int32_t left = 1;
+            for ( uint32_t length = 1; length <= max_bits; ++length )
+            {
+                left = (left << 1) - table.count[length];
+                if ( left < 0 )
+                    return false; // over-subscribed
+            }
+
+            uint32_t used = 0;
+            for ( uint32_t length = 1; length <= max_bits; ++length )
+                used += table.count[length];
+            if ( left > 0 && used > 1 )
+                return false; // incomplete
+
+            std::array<uint16_t, max_bits + 2> offsets {};
+            for ( uint32_t length = 1; length <= max_bits; ++length )
+                offsets[length + 1] = static_cast<uint16_t>(offsets[length] + table.count[length]);
+
+            for ( uint32_t i = 0; i < count; ++i )
+                if ( lengths[i] != 0 )
+                    table.symbol[offsets[lengths[i]]++] = static_cast<uint16_t>(i);
+
+            // fast table: canonical codes in the LSB-first bit order
+            uint32_t code  = 0;
+            uint32_t index = 0;
+            for ( uint32_t length = 1; length <= fast_bits; ++length )
+            {
+                for ( uint32_t i = 0; i < table.count[length]; ++i, ++code, ++index )
+                {
+                    uint32_t reversed = 0;
+                    for ( uint32_t bit = 0, value = code; bit < length; ++bit, value >>= 1U )
+                        reversed = (reversed << 1U) | (value & 1U);
+
+                    const uint16_t entry = static_cast<uint16_t>((table.symbol[index] << 4U) | length);
+                    for ( uint32_t fill = reversed; fill < table.fast.size(); fill += 1U << length )
+                        table.fast[fill] = entry;
+                }
+                code <<= 1U;
+            }
+
+            return true;
+        }
+
+        // returns -1 on invalid code
+        int32_t decode(const huffman& table) noexcept
+        {
+            if ( m_bit_count < max_bits )
+                refill();
+
+            const uint16_t entry = table.fast[m_bit_buffer & ((1U << fast_bits) - 1)];
+            if ( entry != 0 )
+            {
+                const uint32_t length = entry & 0xFU;
+                m_bit_buffer >>= length;
+                m_bit_count   -= length;
+                return entry >> 4U;
+            }
+
+            // long code: walk the canonical code counts
+            int32_t code = 0, first = 0, index = 0;
+            for ( uint32_t length = 1; length <= max_bits; ++length )
+            {
+                code |= static_cast<int32_t>(m_bit_buffer & 1U);
+                m_bit_buffer >>= 1U;
+                --m_bit_count;
+
+                const int32_t count = table.count[length];
+                if ( code - first < count )
+                    return table.symbol[static_cast<size_t>(index + code - first)];
+
+                index += count;
+                first  = (first + count) << 1;
+                code <<= 1;
+            }
+
+            return -1;
+        }
+
+        static const ::std::pair<huffman, huffman>& fixed_tables() noexcept
+        {
+            static const ::std::pair<huffman, huffman> tables = []()
+            {
+                ::std::pair<huffman, huffman> result;
+                std::array<uint8_t, 288> lengths {};
+                for ( size_t i = 0; i < 288; ++i )
+                    lengths[i] = static_cast<uint8_t>(i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8)));
+                build(result.first, lengths.data(), 288);
+
+                // distance codes 30 and 31 complete the code but never occur in valid data
+                lengths.fill(5);
+                build(result.second, lengths.data(), 32);
+                return result;
+            }();
+            return tables;
+        }
+
+        inflate_status read_dynamic_tables() noexcept
+        {
+            const uint32_t num_lit_len = bits(5) + 257;
+            const uint32_t num_dist    = bits(5) + 1;
+            const uint32_t num_clen    = bits(4) + 4;
+            if ( num_lit_len > 286 || num_dist > 30 )
+                return inflate_status::bad_data;
+
+            std::array<uint8_t, 19> clen_lengths {};
+            for ( uint32_t i = 0; i < num_clen; ++i )
+                clen_lengths[deflate_tables::clen_order[i]] = static_cast<uint8_t>(bits(3));
+
+            huffman clen;
+            if ( !build(clen, clen_lengths.data(), 19) )
+                return inflate_status::bad_data;
+
+            std::array<uint8_t, 286 + 30> lengths {};
+            for ( uint32_t i = 0; i < num_lit_len + num_dist; )
+            {
+                const int32_t symbol = decode(clen);
+                if ( symbol < 0 )
+                    return inflate_status::bad_data;
+
+                if ( symbol < 16 )
+                {
+                    lengths[i++] = static_cast<uint8_t>(symbol);
+                    continue;
+                }
+
+                uint8_t  value  = 0;
+                uint32_t repeat = 0;
+                if ( symbol == 16 )
+                {
+                    if ( i == 0 )
+                        return inflate_status::bad_data;
+                    value  = lengths[i - 1];
+                    repeat = 3 + bits(2);
+                }
+                else if ( symbol == 17 )
+                    repeat = 3 + bits(3);
+                else
+                    repeat = 11 + bits(7);
+
+                if ( i + repeat > num_lit_len + num_dist )
+                    return inflate_status::bad_data;
+
+                for ( ; repeat != 0; --repeat )
+                    lengths[i++] = value;
+            }
+
+            if ( lengths[256] == 0 )
+                return inflate_status::bad_data; // no end of block code
+
+            if ( !build(m_lit_len, lengths.data(), num_lit_len) || !build(m_dist, lengths.data() + num_lit_len, num_dist) )
+                return inflate_status::bad_data;
+
+            return overrun() ? inflate_status::truncated : inflate_status::ok;
+        }
+
+        static bool reserve(::std::vector<::std::byte>& output, size_t start, size_t needed, size_t max_output)
+        {
+            if ( needed > max_output )
+                return false;
+
+            if ( start + needed > output.size() )
+            {
+                size_t capacity = (output.size() - start) * 2;
+                capacity = capacity < needed ? needed : capacity;
+                capacity = capacity > max_output ? max_output : capacity;
+                output.resize(start + capacity);
+            }
+
+            return true;
+        }
+
+        inflate_status stored_block(::std::vector<::std::byte>& output, size_t start, size_t& written, size_t max_output)
+        {
+            // skip to the byte boundary and give the buffered whole bytes back to the input
+            bits(m_bit_count % 8);
+            m_position  -= m_bit_count / 8;
+            m_bit_buffer = 0;
+            m_bit_count  = 0;
+            if ( m_position + 4 > m_size )
+                return inflate_status::truncated;
+
+            const uint32_t length  = static_cast<uint8_t>(m_input[m_position]) | (static_cast<uint32_t>(static_cast<uint8_t>(m_input[m_position + 1])) << 8U);
+            const uint32_t nlength = static_cast<uint8_t>(m_input[m_position + 2]) | (static_cast<uint32_t>(static_cast<uint8_t>(m_input[m_position + 3])) << 8U);
+            m_position += 4;
+            if ( length != (~nlength & 0xFFFFU) )
+                return inflate_status::bad_data;
+            if ( m_position + length > m_size )
+                return inflate_status::truncated;
+            if ( !reserve(output, start, written + length, max_output) )
+                return inflate_status::too_large;
+
+            if ( length != 0 )
+                ::std::memcpy(output.data() + start + written, m_input + m_position, length);
+            written    += length;
+            m_position += length;
+            return inflate_status::ok;
+        }
+
+        inflate_status huffman_block(const huffman& lit_len, const huffman& dist, ::std::vector<::std::byte>& output,
+                                     size_t start, size_t& written, size_t max_output)
+        {
+            ::std::byte* out      = output.data() + start;
+            size_t       capacity = output.size() - start;
+            for ( ;; )
+            {
+                const int32_t symbol = decode(lit_len);
+                if ( symbol < 256 )
+                {
+                    if ( symbol < 0 )
+                        return inflate_status::bad_data;
+                    if ( overrun() )
+                        return inflate_status::truncated;
+
+                    if ( written == capacity )
+                    {
+                        if ( !reserve(output, start, written + 1, max_output) )
+                            return inflate_status::too_large;
+                        out      = output.data() + start;
+                        capacity = output.size() - start;
+                    }
+                    out[written++] = static_cast<::std::byte>(symbol);
+                    continue;
+                }
+
+                if ( symbol == 256 )
+                    return inflate_status::ok;
+
+                const uint32_t length_symbol = static_cast<uint32_t>(symbol) - 257;
+                if ( length_symbol >= deflate_tables::length_base.size() )
+                    return inflate_status::bad_data;
+
+                const uint32_t length      = deflate_tables::length_base[length_symbol] + bits(deflate_tables::length_extra[length_symbol]);
+                const int32_t  dist_symbol = decode(dist);
+                if ( dist_symbol < 0 || static_cast<uint32_t>(dist_symbol) >= deflate_tables::dist_base.size() )
+                    return inflate_status::bad_data;
+
+                const uint32_t distance = deflate_tables::dist_base[dist_symbol] + bits(deflate_tables::dist_extra[dist_symbol]);
+                if ( distance > written )
+                    return inflate_status::bad_data;
+                if ( overrun() )
+                    return inflate_status::truncated;
+
+                if ( written + length > capacity )
+                {
+                    if ( !reserve(output, start, written + length, max_output) )
+                        return inflate_status::too_large;
+                    out      = output.data() + start;
+                    capacity = output.size() - start;
+                }
+
+                ::std::byte*       target = out + written;
+                const ::std::byte* source = target - distance;
+                if ( distance >= length )
+                    ::std::memcpy(target, source, length);
+                else
+                    for ( uint32_t i = 0; i < length; ++i )
+                        target[i] = source[i]; // overlapping copy repeats the pattern
+
+                written += length;
+            }
+        }
+
+    protected:
+        const ::std::byte* m_input {nullptr};
+        size_t             m_size {0};
+        size_t             m_position {0};
+        uint64_t           m_bit_buffer {0};
+        uint32_t           m_bit_count {0};
+        size_t             m_consumed {0};
+        huffman            m_lit_len;
+        huffman            m_dist;
+
+};
+
+// decode a zlib stream(RFC 1950) and append the result to <output>, the Adler-32 checksum is verified.
+// <size_hint> is the expected size of the output, e.g. LODEntry::size
+[[nodiscard]] inline inflate_status zlib_uncompress(span<const ::std::byte> input, ::std::vector<::std::byte>& output,
+                                                    size_t size_hint = 0, size_t max_output = static_cast<size_t>(-1))
+{
+    if ( input.size() < 2 )
+        return inflate_status::truncated;
+
+    const uint32_t cmf = static_cast<uint8_t>(input[0]);
+    const uint32_t flg = static_cast<uint8_t>(input[1]);
+    // deflate with a window up to 32K, no preset dictionary
+    if ( (cmf & 0x0FU) != 8 || (cmf >> 4U) > 7 || ((cmf << 8U) | flg) % 31 != 0 || (flg & 0x20U) != 0 )
+        return inflate_status::bad_data;
+
+    const size_t   start = output.size();
+    zlib_inflater  inflater;
+    inflate_status status = inflater.inflate(input.subspan(2), output, size_hint, max_output);
+    if ( status != inflate_status::ok )
+        return status;
+
+    const size_t trailer = 2 + inflater.consumed();
+    if ( input.size() < trailer + 4 )
+        return inflate_status::truncated;
+
+    const uint32_t expected = (static_cast<uint32_t>(static_cast<uint8_t>(input[trailer])) << 24U)
+                            | (static_cast<uint32_t>(static_cast<uint8_t>(input[trailer + 1])) << 16U)
+                            | (static_cast<uint32_t>(static_cast<uint8_t>(input[trailer + 2])) << 8U)
+                            |  static_cast<uint32_t>(static_cast<uint8_t>(input[trailer + 3]));
+    if ( adler32(output.data() + start, output.size() - start) != expected )
+        return inflate_status::bad_data;
+
+    return inflate_status::ok;
+}
+
+} // namespace nh3api
@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <atomic>      // std::atomic
+#include <cstring>     // std::memcpy
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#include "../core/nh3api_std/span.hpp"        // nh3api::span
+#include "../core/resources/lod_format.hpp"   // LODHeader, LODEntry
+#include "mapped_file.hpp"                    // nh3api::mapped_file
+#include "name_index.hpp"                     // nh3api::name_index
+
+namespace nh3api
+{
+
+// Read-only LOD archive(H3sprite.lod, H3bitmap.lod, etc.) /
+// LOD архив только для чтения.
+// Unlike LODFile, it does not need the game executable:
+// the archive is memory-mapped, entries are looked up in O(1) through a case-insensitive hash index
+// and the entry data is returned as a view into the mapping without copying.
+// Entries which point outside of the file are kept in the table but have no data.
+class lod_archive
+{
+    public:
+        lod_archive() noexcept = default;
+
+        explicit lod_archive(const char* const path)
+        { open(path); }
+
+        lod_archive(const lod_archive&)                = delete;
+        lod_archive& operator=(const lod_archive&)     = delete;
+        lod_archive(lod_archive&&) noexcept            = default;
+        lod_archive& operator=(lod_archive&&) noexcept = default;
+        ~lod_archive() noexcept                        = default;
+
+    public:
+        // map <path> and read its entry table, returns false if the file can't be mapped or it is not a LOD archive
+        bool open(const char* const path)
+        {
+            close();
+            m_generation = next_generation();
+            if ( !m_file.open(path) )
+                return false;
+
+            if ( !read_table() )
+            {
+                close();
+                return false;
+            }
+
+            return true;
+        }
+
+        void close() noexcept
+        {
+            m_generation = next_generation();
+            m_file.close();
+            m_header = LODHeader {};
+            m_entries.clear();
+            m_index.clear();
+        }
+
+        [[nodiscard]] bool is_open() const noexcept
+        { return m_file.is_open(); }
+
+        // changes on every open() and close() and is unique in the process: the entries of a reopened archive,
+        // or of another archive at the same address, do not match the cached data of the previous one
+        [[nodiscard]] uint64_t generation() const noexcept
+        { return m_generation; }
+
+        [[nodiscard]] const LODHeader& header() const noexcept
+        { return m_header; }
+
+        // number of entries
+        [[nodiscard]] size_t size() const noexcept
+        { return m_entries.size(); }
+
+        // entry table in the file order
+        [[nodiscard]] span<const LODEntry> entries() const noexcept
+        { return { m_entries.data(), m_entries.size() }; }
+
+        // the whole mapped file
+        [[nodiscard]] span<const ::std::byte> bytes() const noexcept
+        { return m_file.bytes(); }
+
+        // find entry by name(case-insensitive), returns nullptr if there is no such entry
+        [[nodiscard]] const LODEntry* find(::std::string_view name) const noexcept
+        {
+            const uint32_t index = m_index.find(name, entry_name_of { this });
+            return index != name_index::npos ? &m_entries[index] : nullptr;
+        }
+
+        [[nodiscard]] bool exist(::std::string_view name) const noexcept
+        { return find(name) != nullptr; }
+
+        // position of <entry> in the entry table
+        [[nodiscard]] size_t index_of(const LODEntry& entry) const noexcept
+        { return static_cast<size_t>(&entry - m_entries.data()); }
+
+        // entry data as it is stored in the archive: zlib stream if the entry is compressed, raw data otherwise
+        [[nodiscard]] span<const ::std::byte> stored_data(const LODEntry& entry) const noexcept
+        {
+            const size_t offset      = static_cast<uint32_t>(entry.offset);
+            const size_t stored_size = lod_stored_size(entry);
+            if ( entry.offset < 0 || offset > m_file.size() || stored_size > m_file.size() - offset )
+                return {};
+
+            return { m_file.data() + offset, stored_size };
+        }
+
+        [[nodiscard]] span<const ::std::byte> stored_data(::std::string_view name) const noexcept
+        {
+            const LODEntry* const entry = find(name);
+            return entry ? stored_data(*entry) : span<const ::std::byte> {};
+        }
+
+        [[nodiscard]] static bool is_compressed(const LODEntry& entry) noexcept
+        { return entry.csize != 0; }
+
+    protected:
+        struct entry_name_of
+        {
+            const lod_archive* archive;
+
+            [[nodiscard]] ::std::string_view operator()(uint32_t index) const noexcept
+            { return lod_entry_name(archive->m_entries[index]); }
+        };
+
+        bool read_table()
+        {
+            const span<const ::std::byte> file = m_file.bytes();
+            if ( file.size() < sizeof(LODHeader) )
+                return false;
+
+            ::std::memcpy(&m_header, file.data(), sizeof(LODHeader));
+            if ( m_header.LOD_ID != lod_signature )
+                return false;
+
+            const size_t num_entries = m_header.numEntries;
+            if ( num_entries > (file.size() - sizeof(LODHeader)) / sizeof(LODEntry) )
+                return false;
+
+            m_entries.resize(num_entries);
+            if ( num_entries != 0 )
+                ::std::memcpy(m_entries.data(), file.data() + sizeof(LODHeader), num_entries * sizeof(LODEntry));
+
+            m_index.reserve(num_entries);
+            for ( size_t i = 0; i < num_entries; ++i )
+            {
+                // the game terminates the names inside 16 chars, do the same for damaged tables
+                m_entries[i].name.back() = '\0';
+                // duplicate names: the first entry wins
+                m_index.insert(lod_entry_name(m_entries[i]), static_cast<uint32_t>(i), entry_name_of { this });
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] static uint64_t next_generation() noexcept
+        {
+            static ::std::atomic<uint64_t> counter { 0 };
+            return ++counter;
+        }
+
+    protected:
+        mapped_file             m_file;
+        LODHeader               m_header {};
+        ::std::vector<LODEntry> m_entries;
+        name_index              m_index;
+        uint64_t                m_generation {0};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,304 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>       // std::byte
+#include <cstdint>       // int32_t, uint32_t, uint64_t
+#include <functional>    // std::hash
+#include <iterator>      // std::next
+#include <memory>        // std::shared_ptr
+#include <mutex>         // std::mutex
+#include <set>           // std::set
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include "../core/resources/lod_format.hpp" // LODEntry
+
+namespace nh3api
+{
+
+// identity of a LOD entry: the archive, its open generation(see lod_archive::generation) and the location of the stored data.
+// The generation tells apart the same archive object reopened after the file has changed and another archive at a reused address
+struct lod_entry_key
+{
+    const void* archive {nullptr};
+    uint64_t    generation {0};
+    int32_t     offset {0};
+    uint32_t    csize {0};
+
+    [[nodiscard]] friend bool operator==(const lod_entry_key& lhs, const lod_entry_key& rhs) noexcept
+    {
+        return lhs.archive == rhs.archive && lhs.generation == rhs.generation && lhs.offset == rhs.offset
+            && lhs.csize == rhs.csize;
+    }
+
+    [[nodiscard]] friend bool operator!=(const lod_entry_key& lhs, const lod_entry_key& rhs) noexcept
+    { return !(lhs == rhs); }
+};
+
+} // namespace nh3api
+
+// std::hash support for nh3api::lod_entry_key
+template<>
+struct std::hash<nh3api::lod_entry_key>
+{
+    [[nodiscard]] size_t operator()(const nh3api::lod_entry_key& key) const noexcept
+    {
+        uint64_t value = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.archive)) ^ (key.generation * 0xC2B2AE3D27D4EB4FULL);
+        value ^= (static_cast<uint64_t>(static_cast<uint32_t>(key.offset)) << 32U | key.csize) * 0x9E3779B97F4A7C15ULL;
+        value ^= value >> 29U;
+        return static_cast<size_t>(value);
+    }
+};
+
+namespace nh3api
+{
+
+enum class cache_policy : int32_t
+{
+    // evict the least recently used entry
+    lru  = 0,
+    // Greedy-Dual-Size-Frequency: evict the entry with the lowest (clock + frequency * cost / size),
+    // keeps the small, often used entries(cursors, buttons) in favour of the large ones
+    gdsf = 1
+};
+
+struct lod_entry_cache_options
+{
+    size_t       budget_bytes {size_t(64) << 20U};
+    cache_policy policy {cache_policy::lru};
+};
+
+struct lod_entry_cache_stats
+{
+    uint64_t hits {0};
+    uint64_t misses {0};
+    uint64_t insertions {0};
+    uint64_t evictions {0};
+    size_t   entries {0};
+    size_t   bytes {0};
+};
+
+// Byte-budgeted cache of the decompressed LOD entries /
+// Кэш распакованных записей LOD архивов с ограничением по размеру.
+// The entries are keyed by (archive, generation, offset, csize), so the same data is shared
+// no matter which name or which LODFile slot it was requested through.
+// Entries larger than the whole budget are not cached. All the member functions are thread-safe.
+class lod_entry_cache
+{
+    public:
+        using blob = ::std::shared_ptr<const ::std::vector<::std::byte>>;
+
+    public:
+        explicit lod_entry_cache(const lod_entry_cache_options& options = {})
+            : m_options { options }
+        {}
+
+        lod_entry_cache(const lod_entry_cache&)            = delete;
+        lod_entry_cache& operator=(const lod_entry_cache&) = delete;
+
+    public:
+        [[nodiscard]] static lod_entry_key key_of(const void* archive, const LODEntry& entry, uint64_t generation = 0) noexcept
+        { return { archive, generation, entry.offset, entry.csize }; }
+
+        // cached data or nullptr
+        [[nodiscard]] blob find(const lod_entry_key& key)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(key);
+            if ( it == m_entries.end() )
+            {
+                ++m_stats.misses;
+                return nullptr;
+            }
+
+            ++m_stats.hits;
+            touch(it->first, it->second);
+            return it->second.data;
+        }
+
+        // unlike find(), does not count as a hit or a miss and does not refresh the entry
+        [[nodiscard]] bool contains(const lod_entry_key& key) const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_entries.find(key) != m_entries.end();
+        }
+
+        // cache <data> for <key>, <cost> is the price of reproducing the data(e.g. its compressed size), used by GDSF.
+        // Returns the cached data: the existing one if <key> is already cached
+        blob insert(const lod_entry_key& key, blob data, double cost = 1.0)
+        {
+            if ( !data )
+                return nullptr;
+
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto found = m_entries.find(key);
+            if ( found != m_entries.end() )
+            {
+                touch(found->first, found->second);
+                return found->second.data;
+            }
+
+            if ( data->size() > m_options.budget_bytes )
+                return data;
+
+            node& added = m_entries.emplace(key, node { data, cost, 0, 0.0, 0 }).first->second;
+            m_bytes += data->size();
+            ++m_stats.insertions;
+            touch(key, added);
+            evict();
+            return data;
+        }
+
+        // cached data or the result of <load>() which is cached then.
+        // <load> runs without the lock held and returns blob(nullptr on failure)
+        template<class Load>
+        blob get_or_load(const lod_entry_key& key, Load&& load, double cost = 1.0)
+        {
+            if ( blob cached = find(key) )
+                return cached;
+
+            return insert(key, load(), cost);
+        }
+
+        bool erase(const lod_entry_key& key)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            const auto it = m_entries.find(key);
+            if ( it == m_entries.end() )
+                return false;
+
+            remove(it);
+            return true;
+        }
+
+        // drop every entry of <archive>, e.g. when it is closed
+        void erase_archive(const void* archive)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            for ( auto it = m_entries.begin(); it != m_entries.end(); )
+            {
+                auto next = ::std::next(it);
+                if ( it->first.archive == archive )
+                    remove(it);
+                it = next;
+            }
+        }
+
+        void clear()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_entries.clear();
+            m_order.clear();
+            m_bytes = 0;
+            m_clock = 0.0;
+        }
+
+        void set_budget(size_t budget_bytes)
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_options.budget_bytes = budget_bytes;
+            evict();
+        }
+
+        [[nodiscard]] lod_entry_cache_options options() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_options;
+        }
+
+        [[nodiscard]] lod_entry_cache_stats stats() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            lod_entry_cache_stats result = m_stats;
+            result.entries = m_entries.size();
+            result.bytes   = m_bytes;
+            return result;
+        }
+
+        void reset_stats()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_stats = lod_entry_cache_stats {};
+        }
+
+    protected:
+        struct node
+        {
+            blob     data;
+            double   cost;
+            uint64_t frequency;
+            double   priority;
+            uint64_t tick;
+        };
+
+        // eviction order: the lowest priority first, then the least recently used
+        struct order_key
+        {
+            double        priority;
+            uint64_t      tick;
+            lod_entry_key key;
+
+            [[nodiscard]] bool operator<(const order_key& other) const noexcept
+            { return priority != other.priority ? priority < other.priority : tick < other.tick; }
+        };
+
+        void touch(const lod_entry_key& key, node& current)
+        {
+            if ( current.frequency != 0 )
+                m_order.erase({ current.priority, current.tick, key });
+
+            ++current.frequency;
+            current.tick = ++m_tick;
+            if ( m_options.policy == cache_policy::gdsf )
+            {
+                const double size = current.data->empty() ? 1.0 : static_cast<double>(current.data->size());
+                current.priority  = m_clock + static_cast<double>(current.frequency) * current.cost / size;
+            }
+            else
+                current.priority = 0.0; // the tick alone gives the LRU order
+
+            m_order.insert({ current.priority, current.tick, key });
+        }
+
+        void remove(::std::unordered_map<lod_entry_key, node>::iterator it)
+        {
+            m_order.erase({ it->second.priority, it->second.tick, it->first });
+            m_bytes -= it->second.data->size();
+            m_entries.erase(it);
+        }
+
+        void evict()
+        {
+            while ( m_bytes > m_options.budget_bytes && !m_order.empty() )
+            {
+                const order_key victim = *m_order.begin();
+                // GDSF ages the remaining entries by raising the clock to the evicted priority
+                m_clock = victim.priority;
+                remove(m_entries.find(victim.key));
+                ++m_stats.evictions;
+            }
+        }
+
+    protected:
+        lod_entry_cache_options                   m_options;
+        mutable ::std::mutex                      m_mutex;
+        ::std::unordered_map<lod_entry_key, node> m_entries;
+        ::std::set<order_key>                     m_order;
+        size_t                                    m_bytes {0};
+        uint64_t                                  m_tick {0};
+        double                                    m_clock {0.0};
+        lod_entry_cache_stats                     m_stats;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,211 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm>          // std::sort
+#include <condition_variable> // std::condition_variable
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <string_view>        // std::string_view
+#include <unordered_set>      // std::unordered_set
+#include <vector>             // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "inflate.hpp"                 // nh3api::zlib_uncompress
+#include "lod_archive.hpp"             // nh3api::lod_archive
+#include "lod_entry_cache.hpp"         // nh3api::lod_entry_cache
+#include "thread_pool.hpp"             // nh3api::thread_pool
+
+namespace nh3api
+{
+
+struct lod_prefetcher_options
+{
+    // decompression threads, 0: one per hardware thread
+    size_t       threads {0};
+    // budget and policy of the prefetcher's own cache, unused if the cache is shared
+    size_t       cache_bytes {size_t(64) << 20U};
+    cache_policy policy {cache_policy::lru};
+};
+
+struct lod_prefetcher_stats
+{
+    // get() served from the cache
+    uint64_t hits {0};
+    // get() which had to wait for a prefetch in flight
+    uint64_t waits {0};
+    // get() decoded on the calling thread
+    uint64_t misses {0};
+    // entries queued by prefetch()
+    uint64_t prefetched {0};
+};
+
+// Batched decompression of LOD entries /
+// Пакетная распаковка записей LOD архива.
+// prefetch() reads the compressed data of a batch of entries in the file offset order,
+// so that the disk sees sequential reads instead of seeks, and inflates the entries on the worker threads.
+// get() returns the decoded entry from the cache, waits for it if the entry is still being decoded
+// or decodes it on the calling thread if it was not prefetched.
+// The decoded entries go into lod_entry_cache, either the prefetcher's own or one shared with other users.
+// The archive must outlive the prefetcher. All the member functions are thread-safe.
+class lod_prefetcher
+{
+    public:
+        using blob = lod_entry_cache::blob;
+
+    public:
+        explicit lod_prefetcher(const lod_archive& archive, const lod_prefetcher_options& options = {})
+            : m_archive { archive },
+              m_own_cache { ::std::make_unique<lod_entry_cache>(lod_entry_cache_options { options.cache_bytes, options.policy }) },
+              m_cache { *m_own_cache },
+              m_pool { options.threads }
+        {}
+
+        // use <cache> shared with the other archives or loaders, it must outlive the prefetcher
+        lod_prefetcher(const lod_archive& archive, lod_entry_cache& cache, const lod_prefetcher_options& options = {})
+            : m_archive { archive }, m_cache { cache }, m_pool { options.threads }
+        {}
+
+        lod_prefetcher(const lod_prefetcher&)            = delete;
+        lod_prefetcher& operator=(const lod_prefetcher&) = delete;
+
+        ~lod_prefetcher() noexcept
+        { m_pool.wait(); }
+
+    public:
+        // queue <names> for decoding, unknown names and the entries already cached or in flight are skipped.
+        // Returns the number of queued entries
+        size_t prefetch(span<const char* const> names)
+        {
+            ::std::vector<const LODEntry*> batch;
+            batch.reserve(names.size());
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                for ( const char* const name : names )
+                {
+                    const LODEntry* const entry = name ? m_archive.find(name) : nullptr;
+                    if ( entry == nullptr || m_pending.count(entry) != 0 || m_cache.contains(key_of(*entry)) )
+                        continue;
+
+                    m_pending.insert(entry);
+                    batch.push_back(entry);
+                }
+                m_stats.prefetched += batch.size();
+            }
+
+            // sequential reads: stage the compressed data in the file order, inflate in parallel
+            ::std::sort(batch.begin(), batch.end(), [](const LODEntry* lhs, const LODEntry* rhs)
+            { return lhs->offset < rhs->offset; });
+
+            for ( const LODEntry* const entry : batch )
+            {
+                const span<const ::std::byte> stored = m_archive.stored_data(*entry);
+                ::std::vector<::std::byte>    staged(stored.begin(), stored.end());
+                m_pool.submit([this, entry, staged = ::std::move(staged)]()
+                {
+                    insert(*entry, decode(*entry, { staged.data(), staged.size() }));
+                    {
+                        ::std::lock_guard<::std::mutex> lock(m_mutex);
+                        m_pending.erase(entry);
+                    }
+                    m_ready.notify_all();
+                });
+            }
+
+            return batch.size();
+        }
+
+        // decoded entry, nullptr if there is no such entry or its data is damaged
+        [[nodiscard]] blob get(::std::string_view name)
+        {
+            const LODEntry* const entry = m_archive.find(name);
+            return entry ? get(*entry) : nullptr;
+        }
+
+        [[nodiscard]] blob get(const LODEntry& entry)
+        {
+            {
+                ::std::unique_lock<::std::mutex> lock(m_mutex);
+                if ( m_pending.count(&entry) != 0 )
+                {
+                    ++m_stats.waits;
+                    m_ready.wait(lock, [this, &entry]() { return m_pending.count(&entry) == 0; });
+                }
+            }
+
+            if ( blob cached = m_cache.find(key_of(entry)) )
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                ++m_stats.hits;
+                return cached;
+            }
+
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                ++m_stats.misses;
+            }
+            return insert(entry, decode(entry, m_archive.stored_data(entry)));
+        }
+
+        // block until every prefetched entry is decoded
+        void wait()
+        { m_pool.wait(); }
+
+        // drop the decoded entries of the archive, the entries in flight stay
+        void clear()
+        { m_cache.erase_archive(&m_archive); }
+
+        [[nodiscard]] lod_entry_cache& cache() noexcept
+        { return m_cache; }
+
+        [[nodiscard]] lod_prefetcher_stats stats() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+    protected:
+        [[nodiscard]] lod_entry_key key_of(const LODEntry& entry) const noexcept
+        { return lod_entry_cache::key_of(&m_archive, entry, m_archive.generation()); }
+
+        [[nodiscard]] static blob decode(const LODEntry& entry, span<const ::std::byte> stored)
+        {
+            if ( stored.size() != lod_stored_size(entry) )
+                return nullptr; // the entry points outside of the file
+
+            auto result = ::std::make_shared<::std::vector<::std::byte>>();
+            if ( !lod_archive::is_compressed(entry) )
+                result->assign(stored.begin(), stored.end());
+            else if ( zlib_uncompress(stored, *result, entry.size, entry.size) != inflate_status::ok || result->size() != entry.size )
+                return nullptr;
+
+            return result;
+        }
+
+        // the inflate cost is roughly proportional to the compressed size
+        blob insert(const LODEntry& entry, blob data)
+        { return m_cache.insert(key_of(entry), ::std::move(data), static_cast<double>(lod_stored_size(entry))); }
+
+    protected:
+        const lod_archive&                    m_archive;
+        ::std::unique_ptr<lod_entry_cache>    m_own_cache;
+        lod_entry_cache&                      m_cache;
+        mutable ::std::mutex                  m_mutex;
+        ::std::condition_variable             m_ready;
+        ::std::unordered_set<const LODEntry*> m_pending;
+        lod_prefetcher_stats                  m_stats;
+        // the last member: the workers are joined before the rest of the members are destroyed
+        thread_pool                           m_pool;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,297 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm>     // std::sort
+#include <cstdio>        // std::fopen, std::fwrite, std::fclose
+#include <cstring>       // std::memcmp, std::memcpy
+#include <numeric>       // std::iota
+#include <string_view>   // std::string_view
+#include <unordered_map> // std::unordered_multimap
+#include <vector>        // std::vector
+
+#include "../core/nh3api_std/hash.hpp"        // nh3api::basic_fnv1a
+#include "../core/nh3api_std/span.hpp"        // nh3api::span
+#include "../core/resources/lod_format.hpp"   // LODHeader, LODEntry
+#include "deflate.hpp"                        // nh3api::zlib_compress
+#include "name_index.hpp"                     // nh3api::name_index
+#include "thread_pool.hpp"                    // nh3api::thread_pool
+
+namespace nh3api
+{
+
+struct lod_writer_options
+{
+    // LODHeader::version
+    int32_t  version {LODHeader {}.version};
+    // compression threads, 0: one per hardware thread
+    size_t   threads {0};
+    // zlib compression level 0..9
+    int32_t  level {6};
+    // store identical payloads only once, the entries share the data
+    bool     deduplicate {false};
+    // minimal size of the entry table,
+    // the original archives reserve a table of 10000 entries so that they can be patched in place
+    uint32_t table_entries {10000};
+};
+
+struct lod_writer_stats
+{
+    size_t   entries {0};
+    // entries which are stored compressed
+    size_t   compressed_entries {0};
+    // entries which share the data with a previous one
+    size_t   duplicate_entries {0};
+    uint64_t input_bytes {0};
+    // payload bytes written after compression and deduplication
+    uint64_t stored_bytes {0};
+    uint64_t file_bytes {0};
+};
+
+// LOD archive writer /
+// Запись LOD архива.
+// Entries are compressed in parallel on a thread pool,
+// the archive is written in a deterministic order regardless of the thread count:
+// the entry table and the data are sorted by name the way the game expects for its binary search(LODFile::Find).
+// Entries which do not get smaller are stored uncompressed(csize = 0).
+class lod_writer
+{
+    public:
+        explicit lod_writer(const lod_writer_options& options = {})
+            : m_options { options }
+        {}
+
+    public:
+        // add entry with the data owned by the writer.
+        // Returns false if <name> is empty, longer than 15 characters or already added(case-insensitive)
+        bool add(::std::string_view name, ::std::vector<::std::byte> data, int32_t attrib = 0, bool compress = true)
+        {
+            if ( !add_entry(name, attrib, compress) )
+                return false;
+
+            pending_entry& entry = m_entries.back();
+            entry.owned = ::std::move(data);
+            entry.data  = { entry.owned.data(), entry.owned.size() };
+            return true;
+        }
+
+        // add entry with the data owned by the caller, <data> must stay valid until write()
+        bool add_view(::std::string_view name, span<const ::std::byte> data, int32_t attrib = 0, bool compress = true)
+        {
+            if ( !add_entry(name, attrib, compress) )
+                return false;
+
+            m_entries.back().data = data;
+            return true;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_entries.size(); }
+
+        void clear() noexcept
+        {
+            m_entries.clear();
+            m_index.clear();
+            m_stats = lod_writer_stats {};
+        }
+
+        // statistics of the last write()
+        [[nodiscard]] const lod_writer_stats& stats() const noexcept
+        { return m_stats; }
+
+        // compress the entries and write the archive to <path>, returns false on I/O failure
+        bool write(const char* const path)
+        {
+            m_stats = lod_writer_stats {};
+            if ( path == nullptr || m_entries.size() > static_cast<size_t>(INT32_MAX) / sizeof(LODEntry) )
+                return false;
+
+            ::std::vector<uint32_t> order(m_entries.size());
+            ::std::iota(order.begin(), order.end(), 0U);
+            ::std::sort(order.begin(), order.end(), [this](uint32_t lhs, uint32_t rhs)
+            { return lod_name_compare(lod_entry_name(m_entries[lhs].header), lod_entry_name(m_entries[rhs].header)) < 0; });
+
+            thread_pool pool(m_options.threads);
+            if ( m_options.deduplicate )
+                find_duplicates(pool, order);
+
+            pool.parallel_for(m_entries.size(), [this](size_t i)
+            {
+                pending_entry& entry = m_entries[i];
+                entry.packed.clear();
+                if ( !entry.compress || entry.duplicate_of != no_duplicate || entry.data.empty() || m_options.level == 0 )
+                    return;
+
+                entry.packed = zlib_compress(entry.data, m_options.level);
+                if ( entry.packed.size() >= entry.data.size() )
+                    ::std::vector<::std::byte>().swap(entry.packed); // stored uncompressed
+            });
+
+            return write_file(path, order);
+        }
+
+    protected:
+        static inline constexpr uint32_t no_duplicate = UINT32_MAX;
+
+        struct pending_entry
+        {
+            LODEntry                   header {};
+            span<const ::std::byte>    data;
+            ::std::vector<::std::byte> owned;
+            ::std::vector<::std::byte> packed;
+            bool                       compress {true};
+            uint32_t                   duplicate_of {no_duplicate};
+        };
+
+        struct entry_name_of
+        {
+            const lod_writer* writer;
+
+            [[nodiscard]] ::std::string_view operator()(uint32_t index) const noexcept
+            { return lod_entry_name(writer->m_entries[index].header); }
+        };
+
+        bool add_entry(::std::string_view name, int32_t attrib, bool compress)
+        {
+            if ( name.empty() || name.size() >= LODEntry {}.name.size() || name.find('\0') != ::std::string_view::npos )
+                return false;
+
+            pending_entry entry;
+            ::std::memcpy(entry.header.name.data(), name.data(), name.size());
+            entry.header.attrib = attrib;
+            entry.compress      = compress;
+            m_entries.push_back(::std::move(entry));
+
+            const uint32_t index = static_cast<uint32_t>(m_entries.size() - 1);
+            if ( m_index.insert(name, index, entry_name_of { this }) != index )
+            {
+                m_entries.pop_back();
+                return false;
+            }
+
+            return true;
+        }
+
+        // mark every entry whose payload equals the payload of an earlier entry(in the archive order)
+        void find_duplicates(thread_pool& pool, const ::std::vector<uint32_t>& order)
+        {
+            ::std::vector<uint64_t> hashes(m_entries.size());
+            pool.parallel_for(m_entries.size(), [this, &hashes](size_t i)
+            {
+                basic_fnv1a<uint64_t, 14695981039346656037ULL, 1099511628211ULL> hasher;
+                const span<const ::std::byte> data = m_entries[i].data;
+                hasher.update(reinterpret_cast<const char*>(data.data()), data.size());
+                hashes[i] = hasher.digest();
+            });
+
+            ::std::unordered_multimap<uint64_t, uint32_t> unique_payloads;
+            unique_payloads.reserve(m_entries.size());
+            for ( const uint32_t i : order )
+            {
+                pending_entry& entry = m_entries[i];
+                entry.duplicate_of   = no_duplicate;
+
+                const auto range = unique_payloads.equal_range(hashes[i]);
+                for ( auto it = range.first; it != range.second; ++it )
+                {
+                    const pending_entry& other = m_entries[it->second];
+                    if ( other.compress == entry.compress && other.data.size() == entry.data.size()
+                         && (entry.data.empty() || ::std::memcmp(other.data.data(), entry.data.data(), entry.data.size()) == 0) )
+                    {
+                        entry.duplicate_of = it->second;
+                        break;
+                    }
+                }
+
+                if ( entry.duplicate_of == no_duplicate )
+                    unique_payloads.emplace(hashes[i], i);
+            }
+        }
+
+        bool write_file(const char* const path, const ::std::vector<uint32_t>& order)
+        {
+            const size_t table_entries = m_entries.size() > m_options.table_entries ? m_entries.size() : m_options.table_entries;
+            uint64_t     offset        = sizeof(LODHeader) + table_entries * sizeof(LODEntry);
+
+            // data layout in the archive order
+            for ( const uint32_t i : order )
+            {
+                pending_entry& entry = m_entries[i];
+                ++m_stats.entries;
+                m_stats.input_bytes += entry.data.size();
+                if ( entry.duplicate_of != no_duplicate )
+                {
+                    const LODEntry& original = m_entries[entry.duplicate_of].header;
+                    entry.header.offset = original.offset;
+                    entry.header.size   = original.size;
+                    entry.header.csize  = original.csize;
+                    ++m_stats.duplicate_entries;
+                    m_stats.compressed_entries += entry.header.csize != 0;
+                    continue;
+                }
+
+                const size_t stored_size = entry.packed.empty() ? entry.data.size() : entry.packed.size();
+                if ( offset + stored_size > static_cast<uint64_t>(INT32_MAX) )
+                    return false; // offsets are signed 32-bit
+
+                entry.header.offset = static_cast<int32_t>(offset);
+                entry.header.size   = static_cast<uint32_t>(entry.data.size());
+                entry.header.csize  = static_cast<uint32_t>(entry.packed.size());
+                offset             += stored_size;
+                m_stats.stored_bytes       += stored_size;
+                m_stats.compressed_entries += !entry.packed.empty();
+            }
+
+            LODHeader header {};
+            header.LOD_ID     = lod_signature;
+            header.version    = m_options.version;
+            header.numEntries = static_cast<uint32_t>(m_entries.size());
+
+            ::std::vector<LODEntry> table(table_entries);
+            for ( size_t i = 0; i < order.size(); ++i )
+                table[i] = m_entries[order[i]].header;
+
+            ::std::FILE* const file = ::std::fopen(path, "wb");
+            if ( file == nullptr )
+                return false;
+
+            bool result = ::std::fwrite(&header, sizeof(header), 1, file) == 1
+                       && ::std::fwrite(table.data(), sizeof(LODEntry), table.size(), file) == table.size();
+
+            for ( size_t i = 0; result && i < order.size(); ++i )
+            {
+                const pending_entry& entry = m_entries[order[i]];
+                if ( entry.duplicate_of != no_duplicate )
+                    continue;
+
+                const span<const ::std::byte> stored = entry.packed.empty() ? entry.data
+                                                                            : span<const ::std::byte> { entry.packed.data(), entry.packed.size() };
+                if ( !stored.empty() )
+                    result = ::std::fwrite(stored.data(), 1, stored.size(), file) == stored.size();
+            }
+
+            result = (::std::fclose(file) == 0) && result;
+            if ( result )
+                m_stats.file_bytes = offset;
+
+            return result;
+        }
+
+    protected:
+        lod_writer_options           m_options;
+        ::std::vector<pending_entry> m_entries;
+        name_index                   m_index;
+        lod_writer_stats             m_stats;
+
+};
+
+} // namespace nh3api
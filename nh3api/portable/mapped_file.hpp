@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // std::byte
+#include <utility> // std::exchange
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h> // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+    #include <fcntl.h>    // open
+    #include <sys/mman.h> // mmap, munmap
+    #include <sys/stat.h> // fstat
+    #include <unistd.h>   // close
+#endif
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+
+namespace nh3api
+{
+
+// Read-only memory-mapped file.
+// Empty files are opened successfully but have no data.
+class mapped_file
+{
+    public:
+        mapped_file() noexcept = default;
+
+        explicit mapped_file(const char* const path) noexcept
+        { open(path); }
+
+        mapped_file(const mapped_file&)            = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        mapped_file(mapped_file&& other) noexcept
+            : m_data { ::std::exchange(other.m_data, nullptr) },
+              m_size { ::std::exchange(other.m_size, 0) },
+              m_open { ::std::exchange(other.m_open, false) }
+        {}
+
+        mapped_file& operator=(mapped_file&& other) noexcept
+        {
+            if ( this != &other )
+            {
+                close();
+                m_data = ::std::exchange(other.m_data, nullptr);
+                m_size = ::std::exchange(other.m_size, 0);
+                m_open = ::std::exchange(other.m_open, false);
+            }
+
+            return *this;
+        }
+
+        ~mapped_file() noexcept
+        { close(); }
+
+    public:
+        // map the whole file into memory, returns false on failure
+        bool open(const char* const path) noexcept
+        {
+            close();
+            if ( path == nullptr )
+                return false;
+
+        #ifdef _WIN32
+            const HANDLE file = ::CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+
+            LARGE_INTEGER file_size {};
+            if ( !::GetFileSizeEx(file, &file_size) || static_cast<unsigned long long>(file_size.QuadPart) > static_cast<size_t>(-1) )
+            {
+                ::CloseHandle(file);
+                return false;
+            }
+
+            m_size = static_cast<size_t>(file_size.QuadPart);
+            if ( m_size != 0 )
+            {
+                const HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if ( mapping != nullptr )
+                {
+                    m_data = static_cast<const ::std::byte*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    ::CloseHandle(mapping); // the view keeps the mapping alive
+                }
+            }
+            ::CloseHandle(file);
+        #else
+            const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            if ( fd < 0 )
+                return false;
+
+            struct stat file_stat {};
+            if ( ::fstat(fd, &file_stat) != 0 || file_stat.st_size < 0 )
+            {
+                ::close(fd);
+                return false;
+            }
+
+            m_size = static_cast<size_t>(file_stat.st_size);
+            if ( m_size != 0 )
+            {
+                void* const ptr = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if ( ptr != MAP_FAILED )
+                    m_data = static_cast<const ::std::byte*>(ptr);
+            }
+            ::close(fd); // the mapping keeps the file alive
+        #endif
+
+            if ( m_size != 0 && m_data == nullptr )
+            {
+                m_size = 0;
+                return false;
+            }
+
+            m_open = true;
+            return true;
+        }
+
+        void close() noexcept
+        {
+            if ( m_data != nullptr )
+            {
+            #ifdef _WIN32
+                ::UnmapViewOfFile(m_data);
+            #else
+                ::munmap(const_cast<::std::byte*>(m_data), m_size);
+            #endif
+            }
+
+            m_data = nullptr;
+            m_size = 0;
+            m_open = false;
+        }
+
+        [[nodiscard]] bool is_open() const noexcept
+        { return m_open; }
+
+        [[nodiscard]] const ::std::byte* data() const noexcept
+        { return m_data; }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] span<const ::std::byte> bytes() const noexcept
+        { return { m_data, m_size }; }
+
+    protected:
+        const ::std::byte* m_data {nullptr};
+        size_t             m_size {0};
+        bool               m_open {false};
+
+};
+
+} // namespace nh3api
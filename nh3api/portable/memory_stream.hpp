@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // std::byte, size_t
+#include <cstring> // std::memcpy
+#include <utility> // std::exchange
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+
+namespace nh3api
+{
+
+// destination of memory_reader::read_scatter()
+struct scatter_buffer
+{
+    void*  data;
+    size_t size;
+};
+
+// Sequential reader of a memory block, the data is not copied and must outlive the reader /
+// Последовательное чтение области памяти.
+// The state of t_memory_file_adapter
+class memory_reader
+{
+    public:
+        memory_reader() noexcept = default;
+
+        explicit memory_reader(span<const ::std::byte> src) noexcept
+            : m_data { src.data() }, m_size { src.size() }
+        {}
+
+        memory_reader(const void* src, size_t size) noexcept
+            : m_data { static_cast<const ::std::byte*>(src) }, m_size { size }
+        {}
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] size_t tell() const noexcept
+        { return m_position; }
+
+        [[nodiscard]] size_t remaining() const noexcept
+        { return m_size - m_position; }
+
+        [[nodiscard]] bool eof() const noexcept
+        { return m_position == m_size; }
+
+        // seek to the absolute <offset>, clamped to the end of data
+        void seek(size_t offset) noexcept
+        { m_position = offset < m_size ? offset : m_size; }
+
+        // the whole data
+        [[nodiscard]] span<const ::std::byte> data() const noexcept
+        { return { m_data, m_size }; }
+
+        // zero-copy read: view of the next <length> bytes(or less at the end of data)
+        [[nodiscard]] span<const ::std::byte> read_view(size_t length) noexcept
+        {
+            length = length < remaining() ? length : remaining();
+            const span<const ::std::byte> result { m_data + m_position, length };
+            m_position += length;
+            return result;
+        }
+
+        // copy the next <length> bytes(or less at the end of data) to <output>, returns the number of bytes read
+        size_t read(void* output, size_t length) noexcept
+        {
+            const span<const ::std::byte> chunk = read_view(length);
+            if ( !chunk.empty() )
+                ::std::memcpy(output, chunk.data(), chunk.size());
+            return chunk.size();
+        }
+
+        // scatter read: fill <buffers> one after another, returns the total number of bytes read
+        size_t read_scatter(span<const scatter_buffer> buffers) noexcept
+        {
+            size_t total = 0;
+            for ( const scatter_buffer& buffer : buffers )
+            {
+                const size_t count = read(buffer.data, buffer.size);
+                total += count;
+                if ( count != buffer.size )
+                    break;
+            }
+            return total;
+        }
+
+    protected:
+        const ::std::byte* m_data {nullptr};
+        size_t             m_size {0};
+        size_t             m_position {0};
+
+};
+
+// Appending writer into a growing byte container(std::vector<std::byte>, exe_vector<std::byte>) /
+// Запись в конец расширяемого буфера байтов.
+// The state of t_memory_write_adapter
+template<class Container = ::std::vector<::std::byte>>
+class memory_writer
+{
+    public:
+        memory_writer() = default;
+
+        explicit memory_writer(size_t reserved_size)
+        { m_buffer.reserve(reserved_size); }
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        { return m_buffer.size(); }
+
+        [[nodiscard]] span<const ::std::byte> data() const noexcept
+        { return { m_buffer.data(), m_buffer.size() }; }
+
+        [[nodiscard]] const Container& buffer() const noexcept
+        { return m_buffer; }
+
+        // take the written data, the writer becomes empty
+        [[nodiscard]] Container release() noexcept
+        { return ::std::exchange(m_buffer, Container {}); }
+
+        void clear() noexcept
+        { m_buffer.clear(); }
+
+        void reserve(size_t new_capacity)
+        { m_buffer.reserve(new_capacity); }
+
+        // append <length> bytes of <input>, returns the number of bytes written
+        size_t write(const void* input, size_t length)
+        {
+            const ::std::byte* const source = static_cast<const ::std::byte*>(input);
+            m_buffer.insert(m_buffer.end(), source, source + length);
+            return length;
+        }
+
+    protected:
+        Container m_buffer;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,192 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstdint>     // uint32_t
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#include "../core/nh3api_std/hash.hpp"        // nh3api::hash_string_case_insensitive
+#include "../core/resources/lod_format.hpp"   // nh3api::lod_name_equal
+
+namespace nh3api
+{
+
+// Open addressing(linear probing) hash index of case-insensitive names.
+// The index keeps only the 32-bit name hashes and the user values(usually indices into a table of names),
+// the caller passes <name_of> functor which returns the name of a value to resolve the hash collisions.
+// Lookup costs one hash of the name plus, on average, a single name comparison.
+class name_index
+{
+    public:
+        static inline constexpr uint32_t npos = UINT32_MAX;
+
+    protected:
+        struct slot
+        {
+            uint32_t hash  {0};
+            uint32_t value {npos};
+        };
+
+    public:
+        name_index() noexcept = default;
+
+        explicit name_index(size_t expected_count)
+        { reserve(expected_count); }
+
+    public:
+        [[nodiscard]] static uint32_t hash(::std::string_view name) noexcept
+        { return static_cast<uint32_t>(hash_string_case_insensitive(name)); }
+
+        // prepare for <expected_count> names without rehashing
+        void reserve(size_t expected_count)
+        {
+            size_t capacity = 16;
+            while ( capacity < expected_count * 2 )
+                capacity *= 2;
+
+            if ( capacity > m_slots.size() )
+                rehash(capacity);
+        }
+
+        void clear() noexcept
+        {
+            for ( slot& current : m_slots )
+                current = slot {};
+
+            m_size = 0;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return m_size == 0; }
+
+        // insert <value> for <name> unless the name is already present.
+        // returns the value stored for <name>
+        template<class NameOf>
+        uint32_t insert(::std::string_view name, uint32_t value, NameOf&& name_of)
+        {
+            if ( (m_size + 1) * 2 > m_slots.size() )
+                rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+
+            const uint32_t name_hash = hash(name);
+            const size_t   mask      = m_slots.size() - 1;
+            for ( size_t i = name_hash & mask;; i = (i + 1) & mask )
+            {
+                slot& current = m_slots[i];
+                if ( current.value == npos )
+                {
+                    current = { name_hash, value };
+                    ++m_size;
+                    return value;
+                }
+
+                if ( current.hash == name_hash && lod_name_equal(name_of(current.value), name) )
+                    return current.value;
+            }
+        }
+
+        // insert <value> for <name> or replace the stored value
+        template<class NameOf>
+        void insert_or_assign(::std::string_view name, uint32_t value, NameOf&& name_of)
+        {
+            const size_t position = find_position(name, name_of);
+            if ( position != no_position )
+                m_slots[position].value = value;
+            else
+                insert(name, value, name_of);
+        }
+
+        // returns npos if <name> is not present
+        template<class NameOf>
+        [[nodiscard]] uint32_t find(::std::string_view name, NameOf&& name_of) const noexcept
+        {
+            const size_t position = find_position(name, name_of);
+            return position != no_position ? m_slots[position].value : npos;
+        }
+
+        // remove <name>, returns false if it was not present
+        template<class NameOf>
+        bool erase(::std::string_view name, NameOf&& name_of) noexcept
+        {
+            size_t hole = find_position(name, name_of);
+            if ( hole == no_position )
+                return false;
+
+            // backward shift deletion: no tombstones, probe sequences stay short
+            const size_t mask = m_slots.size() - 1;
+            for ( size_t i = (hole + 1) & mask; m_slots[i].value != npos; i = (i + 1) & mask )
+            {
+                const size_t home = m_slots[i].hash & mask;
+                // move the slot into the hole if its home position is not in (hole, i]
+                if ( ((i - home) & mask) >= ((i - hole) & mask) )
+                {
+                    m_slots[hole] = m_slots[i];
+                    hole          = i;
+                }
+            }
+
+            m_slots[hole] = slot {};
+            --m_size;
+            return true;
+        }
+
+    protected:
+        static inline constexpr size_t no_position = static_cast<size_t>(-1);
+
+        template<class NameOf>
+        [[nodiscard]] size_t find_position(::std::string_view name, NameOf& name_of) const noexcept
+        {
+            if ( m_size == 0 )
+                return no_position;
+
+            const uint32_t name_hash = hash(name);
+            const size_t   mask      = m_slots.size() - 1;
+            for ( size_t i = name_hash & mask;; i = (i + 1) & mask )
+            {
+                const slot& current = m_slots[i];
+                if ( current.value == npos )
+                    return no_position;
+
+                if ( current.hash == name_hash && lod_name_equal(name_of(current.value), name) )
+                    return i;
+            }
+        }
+
+        void rehash(size_t capacity)
+        {
+            ::std::vector<slot> old_slots(capacity);
+            old_slots.swap(m_slots);
+
+            const size_t mask = m_slots.size() - 1;
+            for ( const slot& current : old_slots )
+            {
+                if ( current.value == npos )
+                    continue;
+
+                size_t i = current.hash & mask;
+                while ( m_slots[i].value != npos )
+                    i = (i + 1) & mask;
+
+                m_slots[i] = current;
+            }
+        }
+
+    protected:
+        ::std::vector<slot> m_slots;
+        size_t              m_size {0};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,165 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring> // std::memcpy, std::memmove
+#include <numeric> // std::gcd
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+
+namespace nh3api
+{
+
+// Palette entries [first, last] rotated by <step> entries per tick, the arguments of CSprite::ColorCycle(begin, end, step)
+struct palette_cycle_range
+{
+    uint8_t first {0};
+    uint8_t last {0};
+    uint8_t step {1};
+
+    [[nodiscard]] friend bool operator==(const palette_cycle_range& lhs, const palette_cycle_range& rhs) noexcept
+    { return lhs.first == rhs.first && lhs.last == rhs.last && lhs.step == rhs.step; }
+
+    // ticks until the range is back to its initial order
+    [[nodiscard]] uint32_t period() const noexcept
+    {
+        const uint32_t size = last >= first ? uint32_t(last) - first + 1U : 1U;
+        return size / ::std::gcd(size, static_cast<uint32_t>(step % size == 0 ? size : step % size));
+    }
+};
+
+// The water and the lava of the adventure map(TPalette16::Cycle calls of the terrain and the objects)
+inline constexpr palette_cycle_range adventure_cycle_ranges[] = { { 229, 240, 1 }, { 242, 253, 1 } };
+
+// All the phases of a cycling palette, computed once /
+// Все фазы циклически сдвигаемой палитры, вычисленные заранее.
+// Phase t is the base palette after t ticks of TPalette16::Cycle over every range:
+// entry first + i of a range holds the base entry first + (i + t * step) mod size.
+// The direction of the rotation is assumed, it is not verified against TPalette16::Cycle(0x522E40).
+// The phases repeat after the least common multiple of the periods of the ranges.
+// Pixel is uint16_t for TPalette16 and uint32_t for the 32-bit palettes
+template<class Pixel>
+class palette_animation
+{
+    public:
+        palette_animation(const Pixel* base, span<const palette_cycle_range> ranges)
+            : m_ranges { ranges.begin(), ranges.end() }
+        {
+            ::std::memcpy(m_base, base, sizeof(m_base));
+            uint64_t phases = 1;
+            for ( const palette_cycle_range& range : ranges )
+            {
+                phases = phases / ::std::gcd(phases, static_cast<uint64_t>(range.period())) * range.period();
+                // coprime ranges with a period too long to keep: no phases, see palette_at()
+                if ( phases > max_phases )
+                    return;
+            }
+            m_phases = static_cast<size_t>(phases);
+
+            m_palettes.resize(m_phases * 256);
+            for ( size_t phase = 0; phase < m_phases; ++phase )
+                palette_at(phase, m_palettes.data() + phase * 256);
+        }
+
+    public:
+        // the period of the whole palette in ticks, 0 if it is longer than max_phases and the phases were not computed
+        [[nodiscard]] size_t phases() const noexcept
+        { return m_phases; }
+
+        // 256 entries of the palette after <tick> ticks, nullptr if phases() == 0
+        [[nodiscard]] const Pixel* palette(uint64_t tick) const noexcept
+        { return m_phases ? m_palettes.data() + static_cast<size_t>(tick % m_phases) * 256 : nullptr; }
+
+        // write the palette after <tick> ticks to <output>(256 entries), works with any period
+        void palette_at(uint64_t tick, Pixel* output) const noexcept
+        {
+            ::std::memcpy(output, m_base, sizeof(m_base));
+            for ( const palette_cycle_range& range : m_ranges )
+            {
+                if ( range.last < range.first )
+                    continue;
+                const size_t size  = size_t(range.last) - range.first + 1;
+                const size_t shift = static_cast<size_t>((tick % size) * range.step % size);
+                // two copies instead of the per-entry modulo
+                ::std::memcpy(output + range.first, m_base + range.first + shift, (size - shift) * sizeof(Pixel));
+                ::std::memcpy(output + range.first + (size - shift), m_base + range.first, shift * sizeof(Pixel));
+            }
+        }
+
+        // bring the cycled entries of <palette>(a copy of the base palette) to the phase of <tick>, the other entries are left as they are
+        void apply(uint64_t tick, Pixel* palette) const noexcept
+        {
+            const Pixel* phase = this->palette(tick);
+            for ( const palette_cycle_range& range : m_ranges )
+            {
+                if ( range.last < range.first )
+                    continue;
+                const size_t size = size_t(range.last) - range.first + 1;
+                if ( phase )
+                {
+                    ::std::memcpy(palette + range.first, phase + range.first, size * sizeof(Pixel));
+                    continue;
+                }
+                const size_t shift = static_cast<size_t>((tick % size) * range.step % size);
+                ::std::memcpy(palette + range.first, m_base + range.first + shift, (size - shift) * sizeof(Pixel));
+                ::std::memcpy(palette + range.first + (size - shift), m_base + range.first, shift * sizeof(Pixel));
+            }
+        }
+
+        // the palette of phase 0
+        [[nodiscard]] const Pixel* base() const noexcept
+        { return m_base; }
+
+        [[nodiscard]] const ::std::vector<palette_cycle_range>& ranges() const noexcept
+        { return m_ranges; }
+
+        // memory taken by the phases
+        [[nodiscard]] size_t bytes() const noexcept
+        { return m_palettes.size() * sizeof(Pixel); }
+
+        // the reference: the palette after <tick> ticks rotated one tick at a time, in the direction assumed for TPalette16::Cycle
+        static void cycle_reference(const Pixel* base, span<const palette_cycle_range> ranges, uint64_t tick, Pixel* output)
+        {
+            ::std::memcpy(output, base, 256 * sizeof(Pixel));
+            for ( uint64_t t = 0; t < tick; ++t )
+                for ( const palette_cycle_range& range : ranges )
+                {
+                    if ( range.last < range.first )
+                        continue;
+                    const size_t size = size_t(range.last) - range.first + 1;
+                    for ( uint32_t s = 0; s < range.step % size; ++s )
+                    {
+                        // one entry down: the first entry takes the second one, the last takes the first
+                        const Pixel first = output[range.first];
+                        ::std::memmove(output + range.first, output + range.first + 1, (size - 1) * sizeof(Pixel));
+                        output[range.last] = first;
+                    }
+                }
+        }
+
+    public:
+        // 4096 palettes: 2 MB of 16-bit, 4 MB of 32-bit entries
+        static inline constexpr uint64_t max_phases = 4096;
+
+    protected:
+        Pixel                              m_base[256];
+        ::std::vector<palette_cycle_range> m_ranges;
+        size_t                             m_phases {0};
+        // m_phases palettes of 256 entries
+        ::std::vector<Pixel>               m_palettes;
+
+};
+
+} // namespace nh3api
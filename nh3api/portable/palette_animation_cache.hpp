@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>       // size_t
+#include <cstdint>       // uint8_t, uint64_t
+#include <cstring>       // std::memcmp
+#include <iterator>      // std::next
+#include <memory>        // std::shared_ptr, std::make_shared
+#include <mutex>         // std::mutex
+#include <unordered_map> // std::unordered_multimap
+#include <vector>        // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "palette_animation.hpp"       // nh3api::palette_animation, nh3api::palette_cycle_range
+
+namespace nh3api
+{
+
+// Shared palette animations /
+// Общие анимации палитр.
+// The sprites with the same palette and the same cycle ranges(all the water of a map) get the same palette_animation:
+// the phases are computed once, and each tick is a pointer switch instead of a palette rotation per sprite.
+// The palettes are identified by their contents. All the member functions are thread-safe
+template<class Pixel>
+class palette_animation_cache
+{
+    public:
+        using animation_ptr = ::std::shared_ptr<const palette_animation<Pixel>>;
+
+    public:
+        palette_animation_cache() = default;
+
+        palette_animation_cache(const palette_animation_cache&)            = delete;
+        palette_animation_cache& operator=(const palette_animation_cache&) = delete;
+
+    public:
+        // the animation of <base>(256 entries) over <ranges>, made on the first request
+        animation_ptr get(const Pixel* base, span<const palette_cycle_range> ranges)
+        {
+            const uint64_t hash = hash_of(base, ranges);
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            auto [first, last] = m_entries.equal_range(hash);
+            for ( ; first != last; ++first )
+            {
+                const animation_ptr& current = first->second;
+                if ( ::std::memcmp(current->base(), base, 256 * sizeof(Pixel)) == 0 && same_ranges(current->ranges(), ranges) )
+                {
+                    ++m_hits;
+                    return current;
+                }
+            }
+
+            ++m_misses;
+            animation_ptr result = ::std::make_shared<const palette_animation<Pixel>>(base, ranges);
+            m_entries.emplace(hash, result);
+            return result;
+        }
+
+        // drop the animations which are not used outside of the cache
+        void trim()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            for ( auto it = m_entries.begin(); it != m_entries.end(); )
+                it = it->second.use_count() == 1 ? m_entries.erase(it) : ::std::next(it);
+        }
+
+        void clear()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_entries.clear();
+        }
+
+        [[nodiscard]] size_t size() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_entries.size();
+        }
+
+        // get() calls which found an existing animation and which made a new one
+        [[nodiscard]] uint64_t hits() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_hits;
+        }
+
+        [[nodiscard]] uint64_t misses() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_misses;
+        }
+
+    protected:
+        // FNV-1a of the palette and the ranges
+        [[nodiscard]] static uint64_t hash_of(const Pixel* base, span<const palette_cycle_range> ranges) noexcept
+        {
+            uint64_t   value = 0xCBF29CE484222325ULL;
+            const auto add   = [&value](const void* data, size_t size) noexcept
+            {
+                for ( size_t i = 0; i < size; ++i )
+                    value = (value ^ static_cast<const uint8_t*>(data)[i]) * 0x100000001B3ULL;
+            };
+            add(base, 256 * sizeof(Pixel));
+            for ( const palette_cycle_range& range : ranges )
+                add(&range, sizeof(range));
+            return value;
+        }
+
+        [[nodiscard]] static bool same_ranges(const ::std::vector<palette_cycle_range>& lhs, span<const palette_cycle_range> rhs) noexcept
+        {
+            if ( lhs.size() != rhs.size() )
+                return false;
+            for ( size_t i = 0; i < lhs.size(); ++i )
+                if ( !(lhs[i] == rhs[i]) )
+                    return false;
+            return true;
+        }
+
+    protected:
+        mutable ::std::mutex                               m_mutex;
+        ::std::unordered_multimap<uint64_t, animation_ptr> m_entries;
+        uint64_t                                           m_hits {0};
+        uint64_t                                           m_misses {0};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,542 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <cstring> // std::memcpy
+
+#include "simd.hpp" // NH3API_PORTABLE_SSE2, NH3API_PORTABLE_AVX2
+
+namespace nh3api
+{
+
+// Destination pixel layouts of the palette kernels
+enum class pixel_format : uint32_t
+{
+    rgb565   = 0, // TPalette16 of a 16-bit display mode
+    rgb555   = 1, // TPalette16 of a 15-bit display mode
+    argb8888 = 2  // 32-bit palettes of the HD renderers
+};
+
+// The palette indices below 8 which are not colors in the sprites(DEF convention):
+// bit i of a mask selects index i.
+// 0 is transparent, 1 is the shadow border, 4 is the shadow body; 5-7 are the selection outline and are drawn as colors by default
+struct special_indices
+{
+    // the destination pixel is kept
+    uint8_t transparent {0x01};
+    // the destination pixel is darkened by a quarter
+    uint8_t shadow_quarter {0x02};
+    // the destination pixel is darkened by half
+    uint8_t shadow_half {0x10};
+};
+
+// CSpriteFrame::div2mask and div4mask of a 16-bit format: (pixel >> 1) & div2 is the pixel at half brightness
+struct shade_masks16
+{
+    uint16_t div2;
+    uint16_t div4;
+};
+
+[[nodiscard]] constexpr shade_masks16 get_shade_masks16(pixel_format format) noexcept
+{ return format == pixel_format::rgb555 ? shade_masks16 { 0x3DEF, 0x1CE7 } : shade_masks16 { 0x7BEF, 0x39E7 }; }
+
+// 24-bit palette to 32-bit ARGB, alpha 0xFF
+inline void make_argb_palette(const ::std::array<::std::array<uint8_t, 3>, 256>& rgb, uint32_t* palette) noexcept
+{
+    for ( size_t i = 0; i < 256; ++i )
+        palette[i] = 0xFF000000U | (uint32_t(rgb[i][0]) << 16U) | (uint32_t(rgb[i][1]) << 8U) | rgb[i][2];
+}
+
+namespace palette_detail
+{
+
+inline uint16_t shade(uint16_t pixel, uint8_t index, const special_indices& special, shade_masks16 masks) noexcept
+{
+    const uint32_t bit = 1U << index;
+    if ( special.transparent & bit )
+        return pixel;
+    if ( special.shadow_half & bit )
+        return static_cast<uint16_t>((pixel >> 1U) & masks.div2);
+    return static_cast<uint16_t>(pixel - ((pixel >> 2U) & masks.div4));
+}
+
+inline uint32_t shade(uint32_t pixel, uint8_t index, const special_indices& special) noexcept
+{
+    const uint32_t bit = 1U << index;
+    if ( special.transparent & bit )
+        return pixel;
+    if ( special.shadow_half & bit )
+        return ((pixel >> 1U) & 0x007F7F7FU) | (pixel & 0xFF000000U);
+    return pixel - ((pixel >> 2U) & 0x003F3F3FU);
+}
+
+[[nodiscard]] inline uint8_t special_mask(const special_indices& special) noexcept
+{ return static_cast<uint8_t>(special.transparent | special.shadow_quarter | special.shadow_half); }
+
+#if NH3API_PORTABLE_SSE2
+// A set of indices below 8 as the broadcast lane values to compare with, built once per span
+template<size_t LaneBits>
+class index_set
+{
+    public:
+        explicit index_set(uint8_t mask) noexcept
+        {
+            for ( uint32_t i = 0; i < 8; ++i )
+                if ( mask & (1U << i) )
+                    m_values[m_count++] = LaneBits == 16 ? _mm_set1_epi16(static_cast<short>(i)) : _mm_set1_epi32(static_cast<int>(i));
+        }
+
+        // lanes of <indices> which are in the set
+        [[nodiscard]] __m128i contains(__m128i indices) const noexcept
+        {
+            __m128i result = _mm_setzero_si128();
+            for ( uint32_t i = 0; i < m_count; ++i )
+                result = _mm_or_si128(result, LaneBits == 16 ? _mm_cmpeq_epi16(indices, m_values[i]) : _mm_cmpeq_epi32(indices, m_values[i]));
+            return result;
+        }
+
+    protected:
+        __m128i  m_values[8];
+        uint32_t m_count {0};
+
+};
+
+inline __m128i select(__m128i mask, __m128i if_set, __m128i if_clear) noexcept
+{ return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear)); }
+#endif
+
+} // namespace palette_detail
+
+// dst[i] = palette[src[i]]
+inline void expand_indices(const uint8_t* src, uint16_t* dst, size_t count, const uint16_t* palette) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    // SSE2 has no gather: 8 independent loads, one store
+    for ( ; i + 8 <= count; i += 8 )
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_setr_epi16(static_cast<short>(palette[src[i]]),     static_cast<short>(palette[src[i + 1]]),
+                                        static_cast<short>(palette[src[i + 2]]), static_cast<short>(palette[src[i + 3]]),
+                                        static_cast<short>(palette[src[i + 4]]), static_cast<short>(palette[src[i + 5]]),
+                                        static_cast<short>(palette[src[i + 6]]), static_cast<short>(palette[src[i + 7]])));
+#endif
+    for ( ; i < count; ++i )
+        dst[i] = palette[src[i]];
+}
+
+// dst[i] = palette[src[i]]
+inline void expand_indices(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t* palette) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_AVX2
+    const int* const table = reinterpret_cast<const int*>(palette);
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_i32gather_epi32(table, indices, 4));
+    }
+#elif NH3API_PORTABLE_SSE2
+    for ( ; i + 4 <= count; i += 4 )
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                         _mm_setr_epi32(static_cast<int>(palette[src[i]]),     static_cast<int>(palette[src[i + 1]]),
+                                        static_cast<int>(palette[src[i + 2]]), static_cast<int>(palette[src[i + 3]])));
+#endif
+    for ( ; i < count; ++i )
+        dst[i] = palette[src[i]];
+}
+
+// Draw a span of sprite indices over 16-bit pixels: the colors are looked up in <palette>,
+// the transparent indices keep <dst>, the shadow indices darken it(see special_indices)
+inline void blit_indices(const uint8_t* src, uint16_t* dst, size_t count, const uint16_t* palette,
+                         pixel_format format = pixel_format::rgb565, const special_indices& special = {}) noexcept
+{
+    const shade_masks16 masks = get_shade_masks16(format);
+    const uint8_t       any   = palette_detail::special_mask(special);
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i eight = _mm_set1_epi16(8);
+    const __m128i div2  = _mm_set1_epi16(static_cast<short>(masks.div2));
+    const __m128i div4  = _mm_set1_epi16(static_cast<short>(masks.div4));
+    const palette_detail::index_set<16> transparent_set(special.transparent), half_set(special.shadow_half), quarter_set(special.shadow_quarter);
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const __m128i colors = _mm_setr_epi16(static_cast<short>(palette[src[i]]),     static_cast<short>(palette[src[i + 1]]),
+                                              static_cast<short>(palette[src[i + 2]]), static_cast<short>(palette[src[i + 3]]),
+                                              static_cast<short>(palette[src[i + 4]]), static_cast<short>(palette[src[i + 5]]),
+                                              static_cast<short>(palette[src[i + 6]]), static_cast<short>(palette[src[i + 7]]));
+        const __m128i indices = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+        // the opaque runs, the most of a sprite, skip the blending
+        if ( any == 0 || _mm_movemask_epi8(_mm_cmplt_epi16(indices, eight)) == 0 )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), colors);
+            continue;
+        }
+
+        const __m128i background  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i half        = _mm_and_si128(_mm_srli_epi16(background, 1), div2);
+        const __m128i quarter     = _mm_sub_epi16(background, _mm_and_si128(_mm_srli_epi16(background, 2), div4));
+        // the same precedence as the scalar loop: transparent, half, quarter
+        __m128i       result      = palette_detail::select(quarter_set.contains(indices), quarter, colors);
+        result = palette_detail::select(half_set.contains(indices), half, result);
+        result = palette_detail::select(transparent_set.contains(indices), background, result);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+#endif
+    for ( ; i < count; ++i )
+    {
+        const uint8_t index = src[i];
+        dst[i] = (index < 8 && (any & (1U << index))) ? palette_detail::shade(dst[i], index, special, masks) : palette[index];
+    }
+}
+
+// Draw a span of sprite indices over 32-bit pixels, see the 16-bit blit_indices(). The shadows keep the alpha of <dst>
+inline void blit_indices(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t* palette,
+                         const special_indices& special = {}) noexcept
+{
+    const uint8_t any = palette_detail::special_mask(special);
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i eight = _mm_set1_epi32(8);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+    const __m128i div2  = _mm_set1_epi32(0x007F7F7F);
+    const __m128i div4  = _mm_set1_epi32(0x003F3F3F);
+    const palette_detail::index_set<32> transparent_set(special.transparent), half_set(special.shadow_half), quarter_set(special.shadow_quarter);
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        const __m128i colors = _mm_setr_epi32(static_cast<int>(palette[src[i]]),     static_cast<int>(palette[src[i + 1]]),
+                                              static_cast<int>(palette[src[i + 2]]), static_cast<int>(palette[src[i + 3]]));
+        uint32_t packed;
+        ::std::memcpy(&packed, src + i, sizeof(packed));
+        const __m128i indices = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(packed)), zero), zero);
+        if ( any == 0 || _mm_movemask_epi8(_mm_cmplt_epi32(indices, eight)) == 0 )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), colors);
+            continue;
+        }
+
+        const __m128i background = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i half       = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(background, 1), div2), _mm_and_si128(background, alpha));
+        const __m128i quarter    = _mm_sub_epi32(background, _mm_and_si128(_mm_srli_epi32(background, 2), div4));
+        // the same precedence as the scalar loop: transparent, half, quarter
+        __m128i       result     = palette_detail::select(quarter_set.contains(indices), quarter, colors);
+        result = palette_detail::select(half_set.contains(indices), half, result);
+        result = palette_detail::select(transparent_set.contains(indices), background, result);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+#endif
+    for ( ; i < count; ++i )
+    {
+        const uint8_t index = src[i];
+        dst[i] = (index < 8 && (any & (1U << index))) ? palette_detail::shade(dst[i], index, special) : palette[index];
+    }
+}
+
+// The palette indices below 8 of the adventure map objects and the creatures for blit_composite():
+// 1 and 7 are the shadow border, 4 and 6 the shadow body, 5 the selection outline
+struct composite_indices
+{
+    // the destination pixel is kept
+    uint8_t transparent {0x01};
+    // the destination pixel is darkened by a quarter(div4mask)
+    uint8_t shadow_quarter {0x82};
+    // the destination pixel is darkened by half(div2mask)
+    uint8_t shadow_half {0x50};
+    // the pixel is the outline color, or kept by composite_shadow()
+    uint8_t outline {0x20};
+};
+
+// How the color indices(8 and above) of a span are composited
+enum class composite_mode : uint32_t
+{
+    shadow = 0, // CSpriteFrame::DrawAdvObjShadowImpl: only the shadow indices are drawn
+    opaque = 1, // CSpriteFrame::DrawAdvObjImpl, DrawCreature: the palette color
+    alpha  = 2  // CSpriteFrame::DrawHeroAlpha, DrawSpellEffect(alpha = true): half the palette color and half the destination
+};
+
+namespace palette_detail
+{
+
+// the scalar reference of the composite_* kernels
+template<composite_mode Mode>
+inline uint16_t composite(uint16_t pixel, uint8_t index, uint16_t color, uint16_t outline, const composite_indices& special, shade_masks16 masks) noexcept
+{
+    if ( index < 8 )
+    {
+        const uint32_t bit = 1U << index;
+        if ( special.transparent & bit )
+            return pixel;
+        if ( special.shadow_half & bit )
+            return static_cast<uint16_t>((pixel >> 1U) & masks.div2);
+        if ( special.shadow_quarter & bit )
+            return static_cast<uint16_t>(pixel - ((pixel >> 2U) & masks.div4));
+        if ( special.outline & bit )
+            return Mode == composite_mode::shadow ? pixel : outline;
+    }
+    if constexpr ( Mode == composite_mode::shadow )
+        return pixel;
+    else if constexpr ( Mode == composite_mode::alpha )
+        return static_cast<uint16_t>(((color >> 1U) & masks.div2) + ((pixel >> 1U) & masks.div2));
+    else
+        return color;
+}
+
+// the 32-bit shadows and the blending keep the alpha of the destination
+template<composite_mode Mode>
+inline uint32_t composite(uint32_t pixel, uint8_t index, uint32_t color, uint32_t outline, const composite_indices& special) noexcept
+{
+    if ( index < 8 )
+    {
+        const uint32_t bit = 1U << index;
+        if ( special.transparent & bit )
+            return pixel;
+        if ( special.shadow_half & bit )
+            return ((pixel >> 1U) & 0x007F7F7FU) | (pixel & 0xFF000000U);
+        if ( special.shadow_quarter & bit )
+            return pixel - ((pixel >> 2U) & 0x003F3F3FU);
+        if ( special.outline & bit )
+            return Mode == composite_mode::shadow ? pixel : outline;
+    }
+    if constexpr ( Mode == composite_mode::shadow )
+        return pixel;
+    else if constexpr ( Mode == composite_mode::alpha )
+        return (((color >> 1U) & 0x007F7F7FU) + ((pixel >> 1U) & 0x007F7F7FU)) | (pixel & 0xFF000000U);
+    else
+        return color;
+}
+
+template<composite_mode Mode>
+void composite_span(const uint8_t* src, uint16_t* dst, size_t count, const uint16_t* palette, uint16_t outline,
+                    const composite_indices& special, shade_masks16 masks) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    const __m128i zero          = _mm_setzero_si128();
+    const __m128i eight         = _mm_set1_epi16(8);
+    const __m128i div2          = _mm_set1_epi16(static_cast<short>(masks.div2));
+    const __m128i div4          = _mm_set1_epi16(static_cast<short>(masks.div4));
+    const __m128i outline_color = _mm_set1_epi16(static_cast<short>(outline));
+    const index_set<16> transparent_set(special.transparent), half_set(special.shadow_half), quarter_set(special.shadow_quarter),
+                        outline_set(Mode == composite_mode::shadow ? 0 : special.outline);
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        const __m128i indices = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+        const bool    special_lanes = _mm_movemask_epi8(_mm_cmplt_epi16(indices, eight)) != 0;
+        // the shadow pass leaves the colors alone: most of the spans are not touched at all
+        if ( Mode == composite_mode::shadow && !special_lanes )
+            continue;
+
+        __m128i result = zero;
+        if constexpr ( Mode != composite_mode::shadow )
+            result = _mm_setr_epi16(static_cast<short>(palette[src[i]]),     static_cast<short>(palette[src[i + 1]]),
+                                    static_cast<short>(palette[src[i + 2]]), static_cast<short>(palette[src[i + 3]]),
+                                    static_cast<short>(palette[src[i + 4]]), static_cast<short>(palette[src[i + 5]]),
+                                    static_cast<short>(palette[src[i + 6]]), static_cast<short>(palette[src[i + 7]]));
+        if ( Mode == composite_mode::opaque && !special_lanes )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+            continue;
+        }
+
+        const __m128i background = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i half       = _mm_and_si128(_mm_srli_epi16(background, 1), div2);
+        if constexpr ( Mode == composite_mode::shadow )
+            result = background;
+        else if constexpr ( Mode == composite_mode::alpha )
+            result = _mm_add_epi16(_mm_and_si128(_mm_srli_epi16(result, 1), div2), half);
+        if ( special_lanes )
+        {
+            // the same precedence as the scalar reference: transparent, half, quarter, outline
+            const __m128i quarter = _mm_sub_epi16(background, _mm_and_si128(_mm_srli_epi16(background, 2), div4));
+            result = select(outline_set.contains(indices), outline_color, result);
+            result = select(quarter_set.contains(indices), quarter, result);
+            result = select(half_set.contains(indices), half, result);
+            result = select(transparent_set.contains(indices), background, result);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+#endif
+    for ( ; i < count; ++i )
+        dst[i] = composite<Mode>(dst[i], src[i], Mode == composite_mode::shadow ? uint16_t(0) : palette[src[i]], outline, special, masks);
+}
+
+template<composite_mode Mode>
+void composite_span(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t* palette, uint32_t outline,
+                    const composite_indices& special) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    const __m128i zero          = _mm_setzero_si128();
+    const __m128i alpha         = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+    const __m128i div2          = _mm_set1_epi32(0x007F7F7F);
+    const __m128i div4          = _mm_set1_epi32(0x003F3F3F);
+    const __m128i outline_color = _mm_set1_epi32(static_cast<int>(outline));
+    const index_set<32> transparent_set(special.transparent), half_set(special.shadow_half), quarter_set(special.shadow_quarter),
+                        outline_set(Mode == composite_mode::shadow ? 0 : special.outline);
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        uint32_t packed;
+        ::std::memcpy(&packed, src + i, sizeof(packed));
+        // a byte below 8 is a zero byte of packed & 0xF8F8F8F8
+        const uint32_t high_bits     = packed & 0xF8F8F8F8U;
+        const bool     special_lanes = ((high_bits - 0x01010101U) & ~high_bits & 0x80808080U) != 0;
+        if ( Mode == composite_mode::shadow && !special_lanes )
+            continue;
+
+        __m128i result = zero;
+        if constexpr ( Mode != composite_mode::shadow )
+            result = _mm_setr_epi32(static_cast<int>(palette[src[i]]),     static_cast<int>(palette[src[i + 1]]),
+                                    static_cast<int>(palette[src[i + 2]]), static_cast<int>(palette[src[i + 3]]));
+        if ( Mode == composite_mode::opaque && !special_lanes )
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+            continue;
+        }
+
+        const __m128i background = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+        const __m128i half       = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(background, 1), div2), _mm_and_si128(background, alpha));
+        if constexpr ( Mode == composite_mode::shadow )
+            result = background;
+        else if constexpr ( Mode == composite_mode::alpha )
+            result = _mm_add_epi32(_mm_and_si128(_mm_srli_epi32(result, 1), div2), half);
+        if ( special_lanes )
+        {
+            const __m128i indices = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(packed)), zero), zero);
+            const __m128i quarter = _mm_sub_epi32(background, _mm_and_si128(_mm_srli_epi32(background, 2), div4));
+            result = select(outline_set.contains(indices), outline_color, result);
+            result = select(quarter_set.contains(indices), quarter, result);
+            result = select(half_set.contains(indices), half, result);
+            result = select(transparent_set.contains(indices), background, result);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), result);
+    }
+#endif
+    for ( ; i < count; ++i )
+        dst[i] = composite<Mode>(dst[i], src[i], Mode == composite_mode::shadow ? 0U : palette[src[i]], outline, special);
+}
+
+} // namespace palette_detail
+
+// Draw a span of sprite indices over 16-bit pixels the way the game's sprite drawers do, see composite_mode.
+// <masks> are CSpriteFrame::div2mask and div4mask(get_shade_masks16() of the display format),
+// <outline> is the color of the selection outline indices.
+// <palette> is not read by composite_mode::shadow and may be nullptr
+inline void blit_composite(const uint8_t* src, uint16_t* dst, size_t count, const uint16_t* palette, composite_mode mode,
+                           shade_masks16 masks, uint16_t outline = 0, const composite_indices& special = {}) noexcept
+{
+    switch ( mode )
+    {
+        case composite_mode::shadow:
+            palette_detail::composite_span<composite_mode::shadow>(src, dst, count, palette, outline, special, masks);
+            break;
+        case composite_mode::opaque:
+            palette_detail::composite_span<composite_mode::opaque>(src, dst, count, palette, outline, special, masks);
+            break;
+        case composite_mode::alpha:
+            palette_detail::composite_span<composite_mode::alpha>(src, dst, count, palette, outline, special, masks);
+            break;
+    }
+}
+
+// Draw a span of sprite indices over 32-bit pixels, see the 16-bit blit_composite(). The shadows and the blending keep the alpha of <dst>
+inline void blit_composite(const uint8_t* src, uint32_t* dst, size_t count, const uint32_t* palette, composite_mode mode,
+                           uint32_t outline = 0, const composite_indices& special = {}) noexcept
+{
+    switch ( mode )
+    {
+        case composite_mode::shadow:
+            palette_detail::composite_span<composite_mode::shadow>(src, dst, count, palette, outline, special);
+            break;
+        case composite_mode::opaque:
+            palette_detail::composite_span<composite_mode::opaque>(src, dst, count, palette, outline, special);
+            break;
+        case composite_mode::alpha:
+            palette_detail::composite_span<composite_mode::alpha>(src, dst, count, palette, outline, special);
+            break;
+    }
+}
+
+// Compile-time 16-bit pixel layout: the bit count and the shift of each channel, see TPalette16::Convert24to16
+template<uint32_t RBits, uint32_t RShift, uint32_t GBits, uint32_t GShift, uint32_t BBits, uint32_t BShift>
+struct rgb16_layout
+{
+    static_assert(RBits <= 8 && GBits <= 8 && BBits <= 8 && RBits + RShift <= 16 && GBits + GShift <= 16 && BBits + BShift <= 16,
+                  "rgb16_layout: the channels must fit into 16 bits");
+
+    static inline constexpr uint32_t red_bits    = RBits;
+    static inline constexpr uint32_t red_shift   = RShift;
+    static inline constexpr uint32_t green_bits  = GBits;
+    static inline constexpr uint32_t green_shift = GShift;
+    static inline constexpr uint32_t blue_bits   = BBits;
+    static inline constexpr uint32_t blue_shift  = BShift;
+
+    // the high bits of each channel, the same truncation as the game
+    [[nodiscard]] static constexpr uint16_t pack(uint8_t red, uint8_t green, uint8_t blue) noexcept
+    {
+        return static_cast<uint16_t>((uint32_t(red) >> (8U - RBits) << RShift) | (uint32_t(green) >> (8U - GBits) << GShift)
+                                     | (uint32_t(blue) >> (8U - BBits) << BShift));
+    }
+};
+
+using rgb565_layout = rgb16_layout<5, 11, 6, 5, 5, 0>;
+using rgb555_layout = rgb16_layout<5, 10, 5, 5, 5, 0>;
+using bgr565_layout = rgb16_layout<5, 0, 6, 5, 5, 11>;
+using bgr555_layout = rgb16_layout<5, 0, 5, 5, 5, 10>;
+
+// Convert <count> RGB triplets(TRGB) at <rgb> to the 16-bit <Layout>, 8 entries per iteration
+template<class Layout>
+void convert_rgb24_to_16(const uint8_t* rgb, uint16_t* output, size_t count) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_SSE2
+    // each 32-bit lane holds R | G << 8 | B << 16 and the next byte, the last entries are done by the scalar loop
+    // so that the 4-byte loads never read past the palette
+    const auto load = [rgb](size_t entry) noexcept
+    {
+        int32_t value;
+        ::std::memcpy(&value, rgb + entry * 3, sizeof(value));
+        return value;
+    };
+    const auto convert4 = [](__m128i entries) noexcept
+    {
+        const __m128i red   = _mm_and_si128(_mm_srli_epi32(entries, 8 - Layout::red_bits), _mm_set1_epi32((1 << Layout::red_bits) - 1));
+        const __m128i green = _mm_and_si128(_mm_srli_epi32(entries, 16 - Layout::green_bits), _mm_set1_epi32((1 << Layout::green_bits) - 1));
+        const __m128i blue  = _mm_and_si128(_mm_srli_epi32(entries, 24 - Layout::blue_bits), _mm_set1_epi32((1 << Layout::blue_bits) - 1));
+        const __m128i pixel = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(red, Layout::red_shift), _mm_slli_epi32(green, Layout::green_shift)),
+                                           _mm_slli_epi32(blue, Layout::blue_shift));
+        // bias for the signed saturating pack
+        return _mm_sub_epi32(pixel, _mm_set1_epi32(0x8000));
+    };
+    for ( ; i + 9 <= count; i += 8 )
+    {
+        const __m128i low  = convert4(_mm_setr_epi32(load(i), load(i + 1), load(i + 2), load(i + 3)));
+        const __m128i high = convert4(_mm_setr_epi32(load(i + 4), load(i + 5), load(i + 6), load(i + 7)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_xor_si128(_mm_packs_epi32(low, high), _mm_set1_epi16(static_cast<short>(0x8000))));
+    }
+#endif
+    for ( ; i < count; ++i )
+        output[i] = Layout::pack(rgb[i * 3], rgb[i * 3 + 1], rgb[i * 3 + 2]);
+}
+
+// Convert <count> 256-entry palettes in one call: sources[k] -> outputs[k], e.g. all the player color variants
+template<class Layout>
+void convert_rgb24_to_16(const uint8_t* const* sources, uint16_t* const* outputs, size_t count) noexcept
+{
+    for ( size_t k = 0; k < count; ++k )
+        convert_rgb24_to_16<Layout>(sources[k], outputs[k], 256);
+}
+
+} // namespace nh3api
@@ -0,0 +1,386 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cstddef> // std::byte, size_t
+#include <cstdint> // uint8_t, uint16_t, int32_t, uint32_t
+#include <cstring> // std::memcpy, std::memset
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "palette_kernels.hpp"         // nh3api::pixel_format, nh3api::expand_indices, nh3api::convert_rgb24_to_16
+
+namespace nh3api
+{
+
+enum class pcx_container : uint32_t
+{
+    // the .pcx of the LOD archives: size, width and height, then the pixels(and the palette of the indexed images)
+    h3    = 0,
+    // ZSoft PCX with the run-length encoded scanlines
+    zsoft = 1
+};
+
+enum class pcx_kind : uint32_t
+{
+    // 8-bit palette indices, Bitmap816
+    indexed = 0,
+    // 24-bit color, Bitmap24Bit
+    rgb     = 1
+};
+
+struct pcx_info
+{
+    pcx_container                                container {pcx_container::h3};
+    pcx_kind                                     kind {pcx_kind::indexed};
+    int32_t                                      width {0};
+    int32_t                                      height {0};
+    // the palette of an indexed image, TPalette24 order(red, green, blue)
+    ::std::array<::std::array<uint8_t, 3>, 256> palette {};
+};
+
+namespace pcx_detail
+{
+
+// size of the ZSoft header, the encoded scanlines follow it
+inline constexpr size_t zsoft_header_size = 128;
+
+[[nodiscard]] inline uint32_t load_u16(const ::std::byte* data) noexcept
+{ return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U); }
+
+[[nodiscard]] inline uint32_t load_u32(const ::std::byte* data) noexcept
+{ return load_u16(data) | (load_u16(data + 2) << 16U); }
+
+} // namespace pcx_detail
+
+// Row by row .pcx decoder /
+// Построчный декодер .pcx изображений.
+// Reads the images of the LOD archives(Bitmap816, Bitmap24Bit content) and the ZSoft PCX files(8-bit with a palette or 24-bit in 3 planes).
+// Only one row of the encoded planes is buffered, the rows are written straight into the buffers of the caller.
+// The decoder does not copy <data>, it must outlive the decoder
+class pcx_decoder
+{
+    public:
+        explicit pcx_decoder(span<const ::std::byte> data)
+            : m_data { data }
+        { m_ok = parse(); }
+
+    public:
+        // false if the header or the palette are damaged
+        [[nodiscard]] bool ok() const noexcept
+        { return m_ok; }
+
+        [[nodiscard]] const pcx_info& info() const noexcept
+        { return m_info; }
+
+        // the next row to be decoded
+        [[nodiscard]] int32_t row() const noexcept
+        { return m_row; }
+
+        // Decode the next row of an indexed image into <width> palette indices
+        bool read_row(uint8_t* indices) noexcept
+        {
+            if ( m_info.kind != pcx_kind::indexed )
+                return false;
+
+            return next_row(indices);
+        }
+
+        // Decode the next row into <width> RGB triplets(TRGB), the indexed images are expanded with their palette
+        bool read_row_rgb(uint8_t* rgb) noexcept
+        {
+            if ( m_info.kind == pcx_kind::indexed )
+            {
+                if ( !next_row(m_line.data()) )
+                    return false;
+                for ( int32_t i = 0; i < m_info.width; ++i )
+                    ::std::memcpy(rgb + i * 3, m_info.palette[m_line[static_cast<size_t>(i)]].data(), 3);
+                return true;
+            }
+
+            return next_row(rgb);
+        }
+
+        // Decode the next row into <width> 16-bit pixels.
+        // <palette>: uint16_t[256] of the indexed image(e.g. TPalette16::Palette), ignored for the 24-bit ones
+        bool read_row(uint16_t* pixels, pixel_format format, const uint16_t* palette = nullptr) noexcept
+        {
+            const size_t width = static_cast<size_t>(m_info.width);
+            if ( m_info.kind == pcx_kind::indexed )
+            {
+                if ( palette == nullptr || !next_row(m_line.data()) )
+                    return false;
+                expand_indices(m_line.data(), pixels, width, palette);
+                return true;
+            }
+
+            // the rows of the LOD images are stored as blue, green, red: converted in place with the swapped layouts
+            if ( const uint8_t* const bgr = next_h3_bgr_row() )
+            {
+                if ( format == pixel_format::rgb555 )
+                    convert_rgb24_to_16<bgr555_layout>(bgr, pixels, width);
+                else
+                    convert_rgb24_to_16<bgr565_layout>(bgr, pixels, width);
+                return true;
+            }
+
+            if ( !next_row(m_line.data()) )
+                return false;
+            if ( format == pixel_format::rgb555 )
+                convert_rgb24_to_16<rgb555_layout>(m_line.data(), pixels, width);
+            else
+                convert_rgb24_to_16<rgb565_layout>(m_line.data(), pixels, width);
+            return true;
+        }
+
+        // Decode the next row into <width> 32-bit ARGB pixels with alpha 0xFF.
+        // <palette>: uint32_t[256] of the indexed image(see make_argb_palette), ignored for the 24-bit ones
+        bool read_row(uint32_t* pixels, const uint32_t* palette = nullptr) noexcept
+        {
+            const size_t width = static_cast<size_t>(m_info.width);
+            if ( m_info.kind == pcx_kind::indexed )
+            {
+                if ( palette == nullptr || !next_row(m_line.data()) )
+                    return false;
+                expand_indices(m_line.data(), pixels, width, palette);
+                return true;
+            }
+
+            if ( const uint8_t* const bgr = next_h3_bgr_row() )
+            {
+                for ( size_t i = 0; i < width; ++i )
+                    pixels[i] = 0xFF000000U | (uint32_t(bgr[i * 3 + 2]) << 16U) | (uint32_t(bgr[i * 3 + 1]) << 8U) | bgr[i * 3];
+                return true;
+            }
+
+            if ( !next_row(m_line.data()) )
+                return false;
+            for ( size_t i = 0; i < width; ++i )
+                pixels[i] = 0xFF000000U | (uint32_t(m_line[i * 3]) << 16U) | (uint32_t(m_line[i * 3 + 1]) << 8U) | m_line[i * 3 + 2];
+            return true;
+        }
+
+    protected:
+        bool parse()
+        {
+            if ( m_data.size() >= pcx_detail::zsoft_header_size && static_cast<uint8_t>(m_data[0]) == 0x0A
+                 && static_cast<uint8_t>(m_data[2]) <= 1 && static_cast<uint8_t>(m_data[3]) == 8 )
+                return parse_zsoft();
+
+            return parse_h3();
+        }
+
+        bool parse_h3()
+        {
+            if ( m_data.size() < 12 )
+                return false;
+
+            const uint32_t size   = pcx_detail::load_u32(m_data.data());
+            const uint32_t width  = pcx_detail::load_u32(m_data.data() + 4);
+            const uint32_t height = pcx_detail::load_u32(m_data.data() + 8);
+            if ( width == 0 || height == 0 || width > 0x8000 || height > 0x8000 || size > m_data.size() - 12 )
+                return false;
+
+            const size_t pixels = size_t(width) * height;
+            m_info.container    = pcx_container::h3;
+            m_info.width        = static_cast<int32_t>(width);
+            m_info.height       = static_cast<int32_t>(height);
+            m_position          = 12;
+            if ( size == pixels )
+            {
+                if ( m_data.size() - 12 - size < 768 )
+                    return false;
+                m_info.kind = pcx_kind::indexed;
+                ::std::memcpy(m_info.palette.data(), m_data.data() + 12 + size, 768);
+                m_line.resize(width);
+                return true;
+            }
+            if ( size == pixels * 3 )
+            {
+                m_info.kind = pcx_kind::rgb;
+                m_line.resize(size_t(width) * 3);
+                return true;
+            }
+            return false;
+        }
+
+        bool parse_zsoft()
+        {
+            const ::std::byte* const header = m_data.data();
+            const uint32_t x_min  = pcx_detail::load_u16(header + 4);
+            const uint32_t y_min  = pcx_detail::load_u16(header + 6);
+            const uint32_t x_max  = pcx_detail::load_u16(header + 8);
+            const uint32_t y_max  = pcx_detail::load_u16(header + 10);
+            const uint32_t planes = static_cast<uint8_t>(header[65]);
+            m_bytes_per_line      = pcx_detail::load_u16(header + 66);
+            m_encoded             = static_cast<uint8_t>(header[2]) == 1;
+            if ( x_max < x_min || y_max < y_min || (planes != 1 && planes != 3) || m_bytes_per_line < x_max - x_min + 1 )
+                return false;
+
+            m_info.container = pcx_container::zsoft;
+            m_info.kind      = planes == 1 ? pcx_kind::indexed : pcx_kind::rgb;
+            m_info.width     = static_cast<int32_t>(x_max - x_min + 1);
+            m_info.height    = static_cast<int32_t>(y_max - y_min + 1);
+            m_planes         = planes;
+            m_position       = pcx_detail::zsoft_header_size;
+            m_end            = m_data.size();
+            if ( planes == 1 )
+            {
+                // the 256-color palette follows the 0x0C marker at the end of the file
+                if ( m_data.size() < pcx_detail::zsoft_header_size + 769 || static_cast<uint8_t>(m_data[m_data.size() - 769]) != 0x0C )
+                    return false;
+                ::std::memcpy(m_info.palette.data(), m_data.data() + m_data.size() - 768, 768);
+                m_end = m_data.size() - 769;
+            }
+            m_scanline.resize(size_t(m_bytes_per_line) * planes);
+            m_line.resize(size_t(m_info.width) * (planes == 1 ? 1 : 3));
+            return true;
+        }
+
+        // the next stored row of a 24-bit LOD image, nullptr for the other images
+        const uint8_t* next_h3_bgr_row() noexcept
+        {
+            if ( !m_ok || m_row >= m_info.height || m_info.container != pcx_container::h3 || m_info.kind != pcx_kind::rgb )
+                return nullptr;
+
+            const uint8_t* const result = reinterpret_cast<const uint8_t*>(m_data.data()) + m_position;
+            m_position += static_cast<size_t>(m_info.width) * 3;
+            ++m_row;
+            return result;
+        }
+
+        // <output>: width indices or width * 3 RGB bytes
+        bool next_row(uint8_t* output) noexcept
+        {
+            if ( !m_ok || m_row >= m_info.height )
+                return false;
+
+            const size_t width = static_cast<size_t>(m_info.width);
+            if ( m_info.container == pcx_container::h3 )
+            {
+                if ( m_info.kind == pcx_kind::indexed )
+                    ::std::memcpy(output, m_data.data() + m_position, width);
+                else // stored as blue, green, red
+                    for ( size_t i = 0; i < width; ++i )
+                    {
+                        const ::std::byte* const source = m_data.data() + m_position + i * 3;
+                        output[i * 3]     = static_cast<uint8_t>(source[2]);
+                        output[i * 3 + 1] = static_cast<uint8_t>(source[1]);
+                        output[i * 3 + 2] = static_cast<uint8_t>(source[0]);
+                    }
+                m_position += m_info.kind == pcx_kind::indexed ? width : width * 3;
+                ++m_row;
+                return true;
+            }
+
+            // the indexed rows are decoded in place when the padding fits in the output, i.e. never for the 24-bit ones
+            uint8_t* const scanline = m_planes == 1 && m_bytes_per_line == width ? output : m_scanline.data();
+            if ( !decode_scanline(scanline, size_t(m_bytes_per_line) * m_planes) )
+            {
+                m_ok = false;
+                return false;
+            }
+
+            if ( m_planes == 1 )
+            {
+                if ( scanline != output )
+                    ::std::memcpy(output, scanline, width);
+            }
+            else // red, green and blue planes to triplets
+                for ( size_t i = 0; i < width; ++i )
+                {
+                    output[i * 3]     = scanline[i];
+                    output[i * 3 + 1] = scanline[m_bytes_per_line + i];
+                    output[i * 3 + 2] = scanline[2 * size_t(m_bytes_per_line) + i];
+                }
+            ++m_row;
+            return true;
+        }
+
+        // Run-length decoding of <size> bytes: 0xC0 | count, value or a literal byte below 0xC0.
+        // A run which crosses the end of the scanline is continued in the next one, as some encoders do
+        bool decode_scanline(uint8_t* target, size_t size) noexcept
+        {
+            if ( !m_encoded )
+            {
+                if ( m_end - m_position < size )
+                    return false;
+                ::std::memcpy(target, m_data.data() + m_position, size);
+                m_position += size;
+                return true;
+            }
+
+            const uint8_t* const data = reinterpret_cast<const uint8_t*>(m_data.data());
+            size_t filled = 0;
+            if ( m_pending != 0 )
+            {
+                const size_t count = m_pending < size ? m_pending : size;
+                ::std::memset(target, m_pending_value, count);
+                m_pending -= count;
+                filled     = count;
+            }
+
+            while ( filled < size )
+            {
+                if ( m_position >= m_end )
+                    return false;
+
+                // literals: the longest stretch of bytes below 0xC0 is copied at once
+                size_t literals = 0;
+                const size_t limit = (size - filled) < (m_end - m_position) ? (size - filled) : (m_end - m_position);
+                while ( literals < limit && data[m_position + literals] < 0xC0 )
+                    ++literals;
+                if ( literals != 0 )
+                {
+                    ::std::memcpy(target + filled, data + m_position, literals);
+                    filled     += literals;
+                    m_position += literals;
+                    continue;
+                }
+
+                if ( m_end - m_position < 2 )
+                    return false;
+                const size_t  count = data[m_position] & 0x3FU;
+                const uint8_t value = data[m_position + 1];
+                m_position += 2;
+                const size_t  fits  = count < size - filled ? count : size - filled;
+                ::std::memset(target + filled, value, fits);
+                filled         += fits;
+                m_pending       = count - fits;
+                m_pending_value = value;
+            }
+            return true;
+        }
+
+    protected:
+        span<const ::std::byte> m_data;
+        pcx_info                m_info;
+        bool                    m_ok {false};
+        int32_t                 m_row {0};
+        size_t                  m_position {0};
+        // end of the encoded scanlines(the palette of the ZSoft indexed images follows)
+        size_t                  m_end {0};
+        bool                    m_encoded {false};
+        uint32_t                m_planes {1};
+        uint32_t                m_bytes_per_line {0};
+        // the rest of a run continued in the next scanline
+        size_t                  m_pending {0};
+        uint8_t                 m_pending_value {0};
+        // one encoded scanline of all the planes
+        ::std::vector<uint8_t>  m_scanline;
+        // one row of indices or RGB triplets for the converting reads
+        ::std::vector<uint8_t>  m_line;
+
+};
+
+} // namespace nh3api
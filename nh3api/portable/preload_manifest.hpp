@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef>     // size_t
+#include <cstdint>     // int32_t
+#include <cstring>     // std::memcpy
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "resource_index.hpp"          // nh3api::resource_name
+
+namespace nh3api
+{
+
+// A resource to load: its name and its type(EResourceType of the game)
+struct preload_entry
+{
+    resource_name name {};
+    int32_t       type {0};
+
+    [[nodiscard]] const char* c_str() const noexcept
+    { return name.data(); }
+
+    [[nodiscard]] friend bool operator==(const preload_entry& lhs, const preload_entry& rhs) noexcept
+    { return lhs.type == rhs.type && lhs.name == rhs.name; }
+};
+
+// The resources a screen is going to load, without duplicates, in the order they were added /
+// Ресурсы, которые загрузит экран, без повторов, в порядке добавления.
+class preload_manifest
+{
+    public:
+        preload_manifest() = default;
+
+    public:
+        // false for an empty name, a name longer than 12 characters or a duplicate
+        bool add(::std::string_view name, int32_t type)
+        {
+            if ( name.empty() || name.size() >= sizeof(resource_name) )
+                return false;
+
+            preload_entry entry;
+            ::std::memcpy(entry.name.data(), name.data(), name.size());
+            entry.type = type;
+            for ( const preload_entry& current : m_entries )
+                if ( current == entry )
+                    return false;
+
+            m_entries.push_back(entry);
+            return true;
+        }
+
+        // <prefix> + <suffix>, e.g. the sounds of a creature: "PIKE" + "MOVE.WAV"
+        bool add(::std::string_view prefix, ::std::string_view suffix, int32_t type)
+        {
+            ::std::string name { prefix };
+            name += suffix;
+            return add(name, type);
+        }
+
+        void append(const preload_manifest& other)
+        {
+            for ( const preload_entry& entry : other.m_entries )
+                add(entry.c_str(), entry.type);
+        }
+
+        [[nodiscard]] span<const preload_entry> entries() const noexcept
+        { return { m_entries.data(), m_entries.size() }; }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_entries.size(); }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return m_entries.empty(); }
+
+        void clear() noexcept
+        { m_entries.clear(); }
+
+    protected:
+        ::std::vector<preload_entry> m_entries;
+
+};
+
+} // namespace nh3api
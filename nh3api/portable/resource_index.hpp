@@ -0,0 +1,254 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <chrono>  // std::chrono::steady_clock
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <cstring> // std::strncmp, std::memcpy
+#include <vector>  // std::vector
+
+#include "../core/nh3api_std/hash.hpp" // nh3api::hash_string
+
+namespace nh3api
+{
+
+// Name of a cached resource: up to 12 characters and the terminating zero(ResourceManager::TCacheMapKey, resource::Name)
+using resource_name = ::std::array<char, 13>;
+
+struct resource_index_stats
+{
+    uint64_t lookups {0};
+    uint64_t hits {0};
+    // slots visited by the lookups, probes / lookups is the average probe length
+    uint64_t probes {0};
+    uint64_t insertions {0};
+    uint64_t erasures {0};
+    // the timed lookups(one in timing_interval) and their total time, the two clock reads included
+    uint64_t timed_lookups {0};
+    uint64_t timed_nanoseconds {0};
+    size_t   entries {0};
+    size_t   capacity {0};
+
+    [[nodiscard]] double hit_rate() const noexcept
+    { return lookups != 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0; }
+
+    [[nodiscard]] double average_probes() const noexcept
+    { return lookups != 0 ? static_cast<double>(probes) / static_cast<double>(lookups) : 0.0; }
+
+    [[nodiscard]] double average_lookup_nanoseconds() const noexcept
+    { return timed_lookups != 0 ? static_cast<double>(timed_nanoseconds) / static_cast<double>(timed_lookups) : 0.0; }
+};
+
+// Open addressing(linear probing) index of resource names /
+// Хэш-индекс имён ресурсов с открытой адресацией.
+// Mirrors a name -> Value* map(ResourceManager::TResourceMap) for lookups in one hash and, on average, one name comparison
+// instead of a red-black tree descent. The names are compared up to the terminating zero, case-sensitive, like the tree keys,
+// and the longer names are cut to 12 characters like TCacheMapKey does; the hash is the one of std::hash<ResourceManager::TCacheMapKey>.
+// The index does not own the values: the owner erases them before they are destroyed. Not thread-safe
+template<class Value>
+class resource_index
+{
+    protected:
+        struct slot
+        {
+            resource_name name {};
+            uint32_t      hash {0};
+            Value*        value {nullptr};
+        };
+
+    public:
+        // <timing_interval>: one lookup in <timing_interval> is timed, 0 disables the timing
+        explicit resource_index(size_t expected_count = 0, uint32_t timing_interval = 256)
+            : m_timing_interval { timing_interval }
+        { reserve(expected_count); }
+
+    public:
+        [[nodiscard]] static uint32_t hash(const char* name) noexcept
+        { return static_cast<uint32_t>(hash_string(name, length(name))); }
+
+        // prepare for <expected_count> names without rehashing
+        void reserve(size_t expected_count)
+        {
+            size_t capacity = 16;
+            while ( capacity < expected_count * 2 )
+                capacity *= 2;
+
+            if ( capacity > m_slots.size() )
+                rehash(capacity);
+        }
+
+        // map <name> to <value>, replacing the previous value
+        void insert(const char* name, Value* value)
+        {
+            if ( value == nullptr )
+                return;
+            if ( (m_size + 1) * 2 > m_slots.size() )
+                rehash(m_slots.size() * 2);
+
+            const uint32_t name_hash = hash(name);
+            const size_t   mask      = m_slots.size() - 1;
+            for ( size_t i = name_hash & mask;; i = (i + 1) & mask )
+            {
+                slot& current = m_slots[i];
+                if ( current.value == nullptr )
+                {
+                    current.name.fill('\0');
+                    ::std::memcpy(current.name.data(), name, length(name));
+                    current.hash  = name_hash;
+                    current.value = value;
+                    ++m_size;
+                    ++m_stats.insertions;
+                    return;
+                }
+                if ( current.hash == name_hash && equal(current.name.data(), name) )
+                {
+                    current.value = value;
+                    return;
+                }
+            }
+        }
+
+        // value of <name> or nullptr
+        [[nodiscard]] Value* find(const char* name)
+        {
+            ++m_stats.lookups;
+            if ( m_timing_interval == 0 || m_stats.lookups % m_timing_interval != 0 )
+                return find_untimed(name);
+
+            const auto   start  = ::std::chrono::steady_clock::now();
+            Value* const result = find_untimed(name);
+            m_stats.timed_nanoseconds += static_cast<uint64_t>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(::std::chrono::steady_clock::now() - start).count());
+            ++m_stats.timed_lookups;
+            return result;
+        }
+
+        // remove <name>; if <value> is not nullptr, only while <name> still maps to <value>
+        bool erase(const char* name, const Value* value = nullptr)
+        {
+            const size_t hole = position(name);
+            if ( hole == no_position || (value != nullptr && m_slots[hole].value != value) )
+                return false;
+
+            // backward shift deletion: no tombstones, the probe sequences stay short
+            const size_t mask  = m_slots.size() - 1;
+            size_t       empty = hole;
+            for ( size_t i = (hole + 1) & mask; m_slots[i].value != nullptr; i = (i + 1) & mask )
+            {
+                const size_t home = m_slots[i].hash & mask;
+                if ( ((i - home) & mask) >= ((i - empty) & mask) )
+                {
+                    m_slots[empty] = m_slots[i];
+                    empty          = i;
+                }
+            }
+            m_slots[empty] = slot {};
+            --m_size;
+            ++m_stats.erasures;
+            return true;
+        }
+
+        void clear() noexcept
+        {
+            for ( slot& current : m_slots )
+                current = slot {};
+            m_size = 0;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] bool empty() const noexcept
+        { return m_size == 0; }
+
+        [[nodiscard]] resource_index_stats stats() const noexcept
+        {
+            resource_index_stats result = m_stats;
+            result.entries  = m_size;
+            result.capacity = m_slots.size();
+            return result;
+        }
+
+        void reset_stats() noexcept
+        { m_stats = resource_index_stats {}; }
+
+    protected:
+        static inline constexpr size_t no_position = SIZE_MAX;
+
+        // the longest name the tree keeps: TCacheMapKey cuts the longer names to their first 12 characters
+        static inline constexpr size_t max_length = sizeof(resource_name) - 1;
+
+        [[nodiscard]] static size_t length(const char* name) noexcept
+        {
+            size_t result = 0;
+            while ( result < max_length && name[result] != '\0' )
+                ++result;
+            return result;
+        }
+
+        [[nodiscard]] static bool equal(const char* lhs, const char* rhs) noexcept
+        { return ::std::strncmp(lhs, rhs, max_length) == 0; }
+
+        [[nodiscard]] Value* find_untimed(const char* name) noexcept
+        {
+            const size_t found = position(name);
+            if ( found == no_position )
+                return nullptr;
+            ++m_stats.hits;
+            return m_slots[found].value;
+        }
+
+        [[nodiscard]] size_t position(const char* name) noexcept
+        {
+            if ( m_size == 0 )
+                return no_position;
+
+            const uint32_t name_hash = hash(name);
+            const size_t   mask      = m_slots.size() - 1;
+            for ( size_t i = name_hash & mask;; i = (i + 1) & mask )
+            {
+                ++m_stats.probes;
+                const slot& current = m_slots[i];
+                if ( current.value == nullptr )
+                    return no_position;
+                if ( current.hash == name_hash && equal(current.name.data(), name) )
+                    return i;
+            }
+        }
+
+        void rehash(size_t capacity)
+        {
+            ::std::vector<slot> old_slots(capacity);
+            old_slots.swap(m_slots);
+            const size_t mask = capacity - 1;
+            for ( const slot& current : old_slots )
+            {
+                if ( current.value == nullptr )
+                    continue;
+                size_t i = current.hash & mask;
+                while ( m_slots[i].value != nullptr )
+                    i = (i + 1) & mask;
+                m_slots[i] = current;
+            }
+        }
+
+    protected:
+        // power of two, at most half full
+        ::std::vector<slot>  m_slots;
+        size_t               m_size {0};
+        uint32_t             m_timing_interval;
+        resource_index_stats m_stats;
+
+};
+
+} // namespace nh3api
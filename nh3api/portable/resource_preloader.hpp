@@ -0,0 +1,302 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <chrono>             // std::chrono::steady_clock
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <deque>              // std::deque
+#include <functional>         // std::function
+#include <mutex>              // std::mutex
+#include <string>             // std::string
+#include <unordered_map>      // std::unordered_map
+#include <utility>            // std::move, std::pair
+
+#include "preload_manifest.hpp" // nh3api::preload_entry, nh3api::preload_manifest
+#include "thread_pool.hpp"      // nh3api::thread_pool
+
+namespace nh3api
+{
+
+struct resource_preloader_options
+{
+    // loading threads, 0: one per hardware thread
+    size_t threads {2};
+};
+
+struct resource_preloader_stats
+{
+    // entries queued by request() and the ones skipped as already staged or in flight
+    uint64_t requested {0};
+    uint64_t skipped {0};
+    // loader calls which succeeded and failed
+    uint64_t loaded {0};
+    uint64_t failed {0};
+    // staged entries passed to the main thread and the ones dropped by cancel()
+    uint64_t handed_off {0};
+    uint64_t discarded {0};
+    // time spent in the loader on the worker threads
+    uint64_t load_nanoseconds {0};
+    // time the main thread blocked in finish() for the entries still in flight
+    uint64_t wait_nanoseconds {0};
+};
+
+// Background loading of the resources of an upcoming screen /
+// Фоновая загрузка ресурсов следующего экрана.
+// request() queues a manifest, the worker threads call the loader on its entries: the loader reads and decodes a resource
+// into a Staged object and returns false if it failed. The loaded objects wait in the staging area until the main thread
+// takes them at a safe point with pump()(within a count or time budget) or finish()(everything, waiting for the entries in flight).
+// cancel() drops the staged entries and the results of the loads in flight, e.g. when the player declines the combat;
+// an entry requested again while its cancelled load is still in flight gets the result of that load.
+// The loader runs concurrently with itself and with the main thread. All the member functions are thread-safe,
+// the handoff callbacks are called on the calling thread without the lock held
+template<class Staged>
+class resource_preloader
+{
+    public:
+        using loader_type = ::std::function<bool(const preload_entry&, Staged&)>;
+
+    public:
+        explicit resource_preloader(loader_type loader, const resource_preloader_options& options = {})
+            : m_loader { ::std::move(loader) }, m_pool { options.threads }
+        {}
+
+        resource_preloader(const resource_preloader&)            = delete;
+        resource_preloader& operator=(const resource_preloader&) = delete;
+
+        ~resource_preloader() noexcept
+        { cancel(); m_pool.wait(); }
+
+    public:
+        // queue the entries of <manifest> which are neither staged nor in flight, returns the number of queued entries
+        size_t request(const preload_manifest& manifest)
+        {
+            size_t queued = 0;
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            for ( const preload_entry& entry : manifest.entries() )
+            {
+                const auto [it, inserted] = m_known.try_emplace(key_of(entry), m_generation);
+                if ( !inserted && it->second == m_generation )
+                {
+                    ++m_stats.skipped;
+                    continue;
+                }
+
+                ++queued;
+                if ( !inserted )
+                {
+                    // in flight since before cancel(): its result is wanted again, no second load
+                    it->second = m_generation;
+                    continue;
+                }
+
+                ++m_in_flight;
+                m_pool.submit([this, entry]() { load(entry); });
+            }
+            m_stats.requested += queued;
+            return queued;
+        }
+
+        // pass at most <max_count> staged entries to <handoff>(const preload_entry&, Staged&&), in the order they were loaded.
+        // Returns the number of entries passed
+        template<class Handoff>
+        size_t pump(Handoff&& handoff, size_t max_count = SIZE_MAX)
+        {
+            size_t count = 0;
+            while ( count < max_count && pop_one(handoff) )
+                ++count;
+            return count;
+        }
+
+        // pass the staged entries to <handoff> until <budget> is spent, at least one if any is staged
+        template<class Handoff>
+        size_t pump_for(Handoff&& handoff, ::std::chrono::microseconds budget)
+        {
+            const auto deadline = ::std::chrono::steady_clock::now() + budget;
+            size_t     count    = 0;
+            while ( pop_one(handoff) )
+            {
+                ++count;
+                if ( ::std::chrono::steady_clock::now() >= deadline )
+                    break;
+            }
+            return count;
+        }
+
+        // wait for the entries in flight and pass everything staged to <handoff>, the screen is about to use the resources
+        template<class Handoff>
+        size_t finish(Handoff&& handoff)
+        {
+            size_t count = pump(handoff);
+            {
+                const auto                       start = ::std::chrono::steady_clock::now();
+                ::std::unique_lock<::std::mutex> lock(m_mutex);
+                if ( m_in_flight != 0 )
+                {
+                    m_loaded.wait(lock, [this]() { return m_in_flight == 0; });
+                    m_stats.wait_nanoseconds += elapsed_since(start);
+                }
+            }
+            return count + pump(handoff);
+        }
+
+        // drop the staged entries and the results of the loads in flight, the queued loads which did not start are skipped.
+        // <discard>(const preload_entry&, Staged&&) releases the staged objects, if they need it
+        template<class Discard>
+        void cancel(Discard&& discard)
+        {
+            ::std::deque<::std::pair<preload_entry, Staged>> dropped;
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                ++m_generation;
+                dropped.swap(m_staged);
+                m_stats.discarded += dropped.size();
+                // the entries in flight stay known with the old generation until their loads return
+                for ( const auto& [entry, staged] : dropped )
+                    m_known.erase(key_of(entry));
+            }
+            for ( auto& [entry, staged] : dropped )
+                discard(static_cast<const preload_entry&>(entry), ::std::move(staged));
+        }
+
+        void cancel()
+        { cancel([](const preload_entry&, Staged&&) noexcept {}); }
+
+        // block until no load is in flight
+        void wait()
+        {
+            ::std::unique_lock<::std::mutex> lock(m_mutex);
+            m_loaded.wait(lock, [this]() { return m_in_flight == 0; });
+        }
+
+        [[nodiscard]] size_t in_flight() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_in_flight;
+        }
+
+        [[nodiscard]] size_t staged() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_staged.size();
+        }
+
+        [[nodiscard]] resource_preloader_stats stats() const
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            return m_stats;
+        }
+
+        void reset_stats()
+        {
+            ::std::lock_guard<::std::mutex> lock(m_mutex);
+            m_stats = resource_preloader_stats {};
+        }
+
+    protected:
+        [[nodiscard]] static ::std::string key_of(const preload_entry& entry)
+        {
+            ::std::string result { entry.c_str() };
+            result += '\0';
+            result.append(reinterpret_cast<const char*>(&entry.type), sizeof(entry.type));
+            return result;
+        }
+
+        [[nodiscard]] static uint64_t elapsed_since(::std::chrono::steady_clock::time_point start) noexcept
+        { return static_cast<uint64_t>(::std::chrono::duration_cast<::std::chrono::nanoseconds>(::std::chrono::steady_clock::now() - start).count()); }
+
+        // worker thread. The entry is wanted while its generation in m_known is the current one:
+        // cancel() makes it unwanted, a request() after the cancel() makes it wanted again
+        void load(const preload_entry& entry)
+        {
+            const ::std::string key    = key_of(entry);
+            bool                tried  = false;
+            bool                loaded = false;
+            Staged              staged {};
+            uint64_t            spent  = 0;
+            for ( ;; )
+            {
+                {
+                    ::std::lock_guard<::std::mutex> lock(m_mutex);
+                    const auto it     = m_known.find(key);
+                    const bool wanted = it->second == m_generation;
+                    if ( tried || !wanted )
+                    {
+                        m_stats.load_nanoseconds += spent;
+                        if ( !wanted )
+                        {
+                            // cancelled: nobody waits for the result
+                            m_known.erase(it);
+                            m_stats.discarded += loaded ? 1 : 0;
+                        }
+                        else if ( loaded )
+                        {
+                            m_staged.emplace_back(entry, ::std::move(staged));
+                            ++m_stats.loaded;
+                        }
+                        else
+                        {
+                            // not staged: a later request() may try again
+                            m_known.erase(it);
+                            ++m_stats.failed;
+                        }
+                        --m_in_flight;
+                        break;
+                    }
+                }
+
+                const auto start = ::std::chrono::steady_clock::now();
+                loaded           = m_loader(entry, staged);
+                spent            = elapsed_since(start);
+                tried            = true;
+            }
+            m_loaded.notify_all();
+        }
+
+        template<class Handoff>
+        bool pop_one(Handoff& handoff)
+        {
+            preload_entry entry;
+            Staged        staged {};
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                if ( m_staged.empty() )
+                    return false;
+
+                entry  = m_staged.front().first;
+                staged = ::std::move(m_staged.front().second);
+                m_staged.pop_front();
+                m_known.erase(key_of(entry));
+                ++m_stats.handed_off;
+            }
+            handoff(static_cast<const preload_entry&>(entry), ::std::move(staged));
+            return true;
+        }
+
+    protected:
+        loader_type                                      m_loader;
+        mutable ::std::mutex                             m_mutex;
+        ::std::condition_variable                        m_loaded;
+        // names staged or in flight and the generation which requested them
+        ::std::unordered_map<::std::string, uint64_t>    m_known;
+        ::std::deque<::std::pair<preload_entry, Staged>> m_staged;
+        size_t                                           m_in_flight {0};
+        // incremented by cancel(), the results of the older generations are dropped
+        uint64_t                                         m_generation {0};
+        resource_preloader_stats                         m_stats;
+        // the last member: the workers are joined before the rest of the members are destroyed
+        thread_pool                                      m_pool;
+
+};
+
+} // namespace nh3api
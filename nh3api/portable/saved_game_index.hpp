@@ -0,0 +1,159 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>      // std::array
+#include <cstring>    // std::memcmp, std::strlen
+#include <filesystem> // std::filesystem
+#include <string>     // std::string
+#include <vector>     // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "byte_reader.hpp"             // nh3api::byte_reader, nh3api::byte_writer
+#include "file_index.hpp"              // nh3api::file_index, nh3api::parse_gzip_prefix
+#include "h3m_header.hpp"              // nh3api::h3m_header
+
+namespace nh3api
+{
+
+// The fields of SavedGameHeader shown by the save browsers
+struct saved_game_info
+{
+    int32_t                  version {0};
+    int32_t                  game_version {0};
+    h3m_header               map;
+    // SGameSetupOptions::difficulty, EGameDifficulty
+    int8_t                   difficulty {0};
+    // SGameSetupOptions::alignment, TTownType
+    ::std::array<int32_t, 8> alignment {};
+    // SGameSetupOptions::cFilename
+    ::std::string            map_file;
+    bool                     campaign_game {false};
+    // the fields below are stored after the campaign progress and are not read for the campaign games
+    bool                     has_players {false};
+    int16_t                  difficulty_rating {0};
+    ::std::array<bool, 8>    human_player {};
+    ::std::array<bool, 8>    dead_player {};
+    int32_t                  current_player {-1};
+};
+
+// Parse SavedGameHeader at the beginning of a decoded saved game.
+// The header is stored member by member: id "H3SVG", version, game version, the map header in the map file format,
+// SGameSetupOptions as is, campaign flag, then the campaign progress, file name and the player state.
+// Returns false if <data> is not a saved game or ends too early
+inline bool read_saved_game_header(span<const ::std::byte> data, saved_game_info& info)
+{
+    constexpr size_t setup_options_size = 0x1CC; // sizeof(SGameSetupOptions)
+    byte_reader      reader(data);
+    const span<const ::std::byte> id = reader.view(8);
+    if ( id.empty() || ::std::memcmp(id.data(), "H3SVG", 5) != 0 )
+        return false;
+
+    info              = saved_game_info {};
+    info.version      = reader.read<int32_t>();
+    info.game_version = reader.read<int32_t>();
+    if ( !read_h3m_header(reader, info.map) )
+        return false;
+
+    byte_reader setup(reader.view(setup_options_size));
+    setup.skip(16); // color, handicap
+    for ( int32_t& alignment : info.alignment )
+        alignment = setup.read<int32_t>();
+    setup.skip(8); // playerPos
+    info.difficulty = setup.read<int8_t>();
+    const span<const ::std::byte> file_name = setup.view(251);
+    if ( !reader.ok() || !setup.ok() )
+        return false;
+
+    info.map_file.assign(reinterpret_cast<const char*>(file_name.data()), file_name.size());
+    info.map_file.resize(::std::strlen(info.map_file.c_str()));
+    info.campaign_game = reader.read_bool();
+    if ( info.campaign_game )
+        return reader.ok();
+
+    static_cast<void>(reader.read_string()); // file name
+    info.difficulty_rating = reader.read<int16_t>();
+    reader.skip(4); // numDeadPlayers
+    for ( bool& dead : info.dead_player )
+        dead = reader.read_bool();
+    for ( bool& human : info.human_player )
+        human = reader.read<int32_t>() != 0;
+    info.current_player = reader.read<int32_t>();
+    info.has_players    = reader.ok();
+    return reader.ok();
+}
+
+// Read SavedGameHeader of the saved game at <path>, only the beginning of the file is read and inflated
+inline bool read_saved_game_file(const ::std::filesystem::path& path, saved_game_info& info)
+{
+    return parse_gzip_prefix(path, [&info](span<const ::std::byte> data)
+    { return read_saved_game_header(data, info); });
+}
+
+// file_index traits of the saved games
+struct saved_game_traits
+{
+    using info_type = saved_game_info;
+
+    static inline constexpr ::std::array<char, 8> signature { 'N', 'H', '3', 'S', 'G', 'I', 'D', 'X' };
+    static inline constexpr uint32_t              version = 1;
+
+    [[nodiscard]] static ::std::vector<::std::string> default_extensions()
+    { return { ".gm1", ".gm2", ".gm3", ".gm4", ".gm5", ".gm6", ".gm7", ".gm8", ".cgm" }; }
+
+    static bool parse(const ::std::filesystem::path& path, saved_game_info& info)
+    { return read_saved_game_file(path, info); }
+
+    static void write(byte_writer& writer, const saved_game_info& info)
+    {
+        writer.write(info.version);
+        writer.write(info.game_version);
+        write_h3m_header(writer, info.map);
+        writer.write(info.difficulty);
+        for ( const int32_t alignment : info.alignment )
+            writer.write(alignment);
+        writer.write_string(info.map_file);
+        writer.write_bool(info.campaign_game);
+        writer.write_bool(info.has_players);
+        writer.write(info.difficulty_rating);
+        for ( const bool human : info.human_player )
+            writer.write_bool(human);
+        for ( const bool dead : info.dead_player )
+            writer.write_bool(dead);
+        writer.write(info.current_player);
+    }
+
+    static void read(byte_reader& reader, saved_game_info& info)
+    {
+        info.version      = reader.read<int32_t>();
+        info.game_version = reader.read<int32_t>();
+        load_h3m_header(reader, info.map);
+        info.difficulty = reader.read<int8_t>();
+        for ( int32_t& alignment : info.alignment )
+            alignment = reader.read<int32_t>();
+        info.map_file          = reader.read_string();
+        info.campaign_game     = reader.read_bool();
+        info.has_players       = reader.read_bool();
+        info.difficulty_rating = reader.read<int16_t>();
+        for ( bool& human : info.human_player )
+            human = reader.read_bool();
+        for ( bool& dead : info.dead_player )
+            dead = reader.read_bool();
+        info.current_player = reader.read<int32_t>();
+    }
+};
+
+// Index of the saved games in a directory, see file_index
+using saved_game_index  = file_index<saved_game_traits>;
+using saved_game_record = saved_game_index::record_type;
+
+} // namespace nh3api
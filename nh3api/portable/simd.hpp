@@ -0,0 +1,29 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+// Instruction sets available to the portable image kernels, chosen at compile time:
+// SSE2 is the baseline on x86-64 and with /arch:SSE2(MSVC x86) or -msse2, AVX2 needs /arch:AVX2 or -mavx2.
+// Define NH3API_FLAG_NO_SIMD to build the scalar code only
+#if !defined(NH3API_FLAG_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP == 2))
+    #define NH3API_PORTABLE_SSE2 1
+    #include <emmintrin.h> // SSE2
+#else
+    #define NH3API_PORTABLE_SSE2 0
+#endif
+
+#if NH3API_PORTABLE_SSE2 && defined(__AVX2__)
+    #define NH3API_PORTABLE_AVX2 1
+    #include <immintrin.h> // AVX2
+#else
+    #define NH3API_PORTABLE_AVX2 0
+#endif
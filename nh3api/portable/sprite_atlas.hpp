@@ -0,0 +1,357 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm> // std::stable_sort
+#include <atomic>    // std::atomic
+#include <chrono>    // std::chrono::steady_clock
+#include <cstdint>   // uint8_t, uint16_t, int16_t, uint32_t, uint64_t
+#include <cstring>   // std::memset
+#include <numeric>   // std::iota
+#include <vector>    // std::vector
+
+#include "def_sprite.hpp"  // nh3api::def_frame, nh3api::def_file, nh3api::decode_def_frame
+#include "thread_pool.hpp" // nh3api::thread_pool
+
+namespace nh3api
+{
+
+// Position of a frame in the atlas
+struct atlas_frame
+{
+    // the cropped image: page index and the rectangle in the page
+    uint16_t page {0};
+    uint16_t x {0};
+    uint16_t y {0};
+    uint16_t width {0};
+    uint16_t height {0};
+    // the whole frame(CSpriteFrame::Width, Height)
+    uint16_t frame_width {0};
+    uint16_t frame_height {0};
+    // the position of the cropped image in the frame(CSpriteFrame::CroppedX, CroppedY)
+    int16_t  offset_x {0};
+    int16_t  offset_y {0};
+    // the same for the mirrored frame: the page rectangle is drawn right to left starting at this offset
+    int16_t  hflip_offset_x {0};
+    // transparent rows below the cropped image(Height - CroppedY - CroppedHeight), the creatures are aligned by their bottom
+    int16_t  bottom_margin {0};
+};
+
+struct sprite_atlas_options
+{
+    uint32_t page_width {2048};
+    uint32_t page_height {2048};
+    // empty pixels around each frame, 1 or more keeps the filtering upscalers from bleeding into the neighbours
+    uint32_t padding {0};
+    // decoding threads, 0: one per hardware thread, 1: the calling thread only
+    size_t   threads {0};
+};
+
+struct sprite_atlas_report
+{
+    size_t   frames {0};
+    size_t   pages {0};
+    // frames which could not be decoded, they are left transparent
+    size_t   failed {0};
+    // pixels of the cropped frames
+    uint64_t frame_pixels {0};
+    // pixels of the pages up to the highest used row of each page
+    uint64_t used_page_pixels {0};
+    double   pack_seconds {0.0};
+    double   decode_seconds {0.0};
+
+    // share of the used page area covered by frames, 1.0 is a perfect packing
+    [[nodiscard]] double efficiency() const noexcept
+    { return used_page_pixels != 0 ? static_cast<double>(frame_pixels) / static_cast<double>(used_page_pixels) : 1.0; }
+};
+
+// Sprite frames decoded into a few 8-bit pages /
+// Кадры спрайтов, декодированные в несколько 8-битных страниц.
+// Each page is a contiguous page_width * page_height block of palette indices, 0 is transparent.
+// A page is trimmed to its highest used row, so the pages may have different heights
+struct sprite_atlas
+{
+    struct page
+    {
+        uint32_t               height {0};
+        ::std::vector<uint8_t> pixels;
+    };
+
+    uint32_t                   page_width {0};
+    ::std::vector<page>        pages;
+    // in the order of sprite_atlas_builder::add()
+    ::std::vector<atlas_frame> frames;
+
+    // the first pixel of the cropped image of <frame>, the rows are page_width bytes apart
+    [[nodiscard]] const uint8_t* pixels(const atlas_frame& frame) const noexcept
+    { return pages[frame.page].pixels.data() + size_t(frame.y) * page_width + frame.x; }
+};
+
+namespace atlas_detail
+{
+
+// Skyline bottom-left packer: the top edge of the placed rectangles as a list of horizontal segments
+class skyline
+{
+    public:
+        skyline(uint32_t width, uint32_t height)
+            : m_width { width }, m_height { height }, m_nodes { { 0, 0, width } }
+        {}
+
+    public:
+        // find a place for a <width> x <height> rectangle with the lowest top edge, false if it does not fit
+        bool insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+        {
+            size_t   best       = m_nodes.size();
+            uint32_t best_top   = UINT32_MAX;
+            uint32_t best_width = UINT32_MAX;
+            for ( size_t i = 0; i < m_nodes.size(); ++i )
+            {
+                uint32_t top = 0;
+                if ( !fits(i, width, height, top) )
+                    continue;
+                if ( top + height < best_top || (top + height == best_top && m_nodes[i].width < best_width) )
+                {
+                    best       = i;
+                    best_top   = top + height;
+                    best_width = m_nodes[i].width;
+                    y          = top;
+                }
+            }
+
+            if ( best == m_nodes.size() )
+                return false;
+
+            x = m_nodes[best].x;
+            add(best, x, y + height, width);
+            if ( y + height > m_used_height )
+                m_used_height = y + height;
+            return true;
+        }
+
+        [[nodiscard]] uint32_t used_height() const noexcept
+        { return m_used_height; }
+
+    protected:
+        struct node
+        {
+            uint32_t x;
+            uint32_t y;
+            uint32_t width;
+        };
+
+        // the rectangle placed at node <i> rests on the highest segment under it
+        bool fits(size_t i, uint32_t width, uint32_t height, uint32_t& top) const noexcept
+        {
+            if ( m_nodes[i].x + width > m_width )
+                return false;
+
+            top = 0;
+            for ( uint32_t left = width; left > 0; ++i )
+            {
+                top = m_nodes[i].y > top ? m_nodes[i].y : top;
+                if ( top + height > m_height )
+                    return false;
+                left -= m_nodes[i].width < left ? m_nodes[i].width : left;
+            }
+            return true;
+        }
+
+        void add(size_t i, uint32_t x, uint32_t y, uint32_t width)
+        {
+            m_nodes.insert(m_nodes.begin() + static_cast<ptrdiff_t>(i), node { x, y, width });
+            // cut the segments now covered by the new one
+            for ( size_t next = i + 1; next < m_nodes.size(); )
+            {
+                const uint32_t end = x + width;
+                if ( m_nodes[next].x >= end )
+                    break;
+
+                const uint32_t shrink = end - m_nodes[next].x;
+                if ( m_nodes[next].width <= shrink )
+                {
+                    m_nodes.erase(m_nodes.begin() + static_cast<ptrdiff_t>(next));
+                    continue;
+                }
+                m_nodes[next].x     += shrink;
+                m_nodes[next].width -= shrink;
+                break;
+            }
+
+            // merge the neighbours of the same height
+            for ( size_t j = 0; j + 1 < m_nodes.size(); )
+            {
+                if ( m_nodes[j].y == m_nodes[j + 1].y )
+                {
+                    m_nodes[j].width += m_nodes[j + 1].width;
+                    m_nodes.erase(m_nodes.begin() + static_cast<ptrdiff_t>(j + 1));
+                }
+                else
+                    ++j;
+            }
+        }
+
+    protected:
+        uint32_t            m_width;
+        uint32_t            m_height;
+        uint32_t            m_used_height {0};
+        ::std::vector<node> m_nodes;
+
+};
+
+} // namespace atlas_detail
+
+// Collects frames of one or more sprites and packs them into a sprite_atlas.
+// The frames are views into the sprite data(def_file, CSpriteFrame::get_def_frame()), which must outlive build()
+class sprite_atlas_builder
+{
+    public:
+        explicit sprite_atlas_builder(const sprite_atlas_options& options = {})
+            : m_options { options }
+        {}
+
+    public:
+        // returns the index of the frame in sprite_atlas::frames
+        size_t add(const def_frame& frame)
+        {
+            m_frames.push_back(frame);
+            return m_frames.size() - 1;
+        }
+
+        // add def.frames, returns the atlas index of def.frames[0]: def.frames[i] becomes sprite_atlas::frames[result + i].
+        // read_def_file() stores the frames shared by the groups once; the frames are not compared with the ones added before,
+        // adding the same sprite twice stores its frames twice
+        size_t add(const def_file& def)
+        {
+            const size_t first = m_frames.size();
+            m_frames.insert(m_frames.end(), def.frames.begin(), def.frames.end());
+            return first;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_frames.size(); }
+
+        void clear() noexcept
+        { m_frames.clear(); }
+
+        // Pack and decode the added frames into <atlas>.
+        // A frame larger than the page gets a page of its own
+        void build(sprite_atlas& atlas, sprite_atlas_report* report = nullptr) const
+        {
+            using clock = ::std::chrono::steady_clock;
+            const clock::time_point start = clock::now();
+            const uint32_t padding = m_options.padding;
+
+            atlas.page_width = m_options.page_width;
+            atlas.pages.clear();
+            atlas.frames.assign(m_frames.size(), atlas_frame {});
+            for ( const def_frame& frame : m_frames )
+                if ( static_cast<uint32_t>(frame.header.cropped_width) + padding * 2 > atlas.page_width )
+                    atlas.page_width = static_cast<uint32_t>(frame.header.cropped_width) + padding * 2;
+
+            // the tallest frames first, the usual order for the skyline packers
+            ::std::vector<size_t> order(m_frames.size());
+            ::std::iota(order.begin(), order.end(), size_t(0));
+            ::std::stable_sort(order.begin(), order.end(), [this](size_t lhs, size_t rhs)
+            {
+                const def_frame_header& a = m_frames[lhs].header;
+                const def_frame_header& b = m_frames[rhs].header;
+                return a.cropped_height != b.cropped_height ? a.cropped_height > b.cropped_height : a.cropped_width > b.cropped_width;
+            });
+
+            ::std::vector<atlas_detail::skyline> skylines;
+            uint64_t frame_pixels = 0;
+            for ( const size_t i : order )
+            {
+                const def_frame_header& header = m_frames[i].header;
+                atlas_frame&            placed = atlas.frames[i];
+                placed.width          = static_cast<uint16_t>(header.cropped_width);
+                placed.height         = static_cast<uint16_t>(header.cropped_height);
+                placed.frame_width    = static_cast<uint16_t>(header.width);
+                placed.frame_height   = static_cast<uint16_t>(header.height);
+                placed.offset_x       = static_cast<int16_t>(header.cropped_x);
+                placed.offset_y       = static_cast<int16_t>(header.cropped_y);
+                placed.hflip_offset_x = static_cast<int16_t>(header.width - header.cropped_x - header.cropped_width);
+                placed.bottom_margin  = static_cast<int16_t>(header.height - header.cropped_y - header.cropped_height);
+                if ( placed.width == 0 || placed.height == 0 )
+                    continue;
+
+                frame_pixels += uint64_t(placed.width) * placed.height;
+                const uint32_t width  = placed.width + padding * 2;
+                const uint32_t height = placed.height + padding * 2;
+                uint32_t x = 0, y = 0;
+                size_t   page = 0;
+                while ( page < skylines.size() && !skylines[page].insert(width, height, x, y) )
+                    ++page;
+                if ( page == skylines.size() )
+                {
+                    skylines.emplace_back(atlas.page_width, height > m_options.page_height ? height : m_options.page_height);
+                    skylines.back().insert(width, height, x, y);
+                }
+
+                placed.page = static_cast<uint16_t>(page);
+                placed.x    = static_cast<uint16_t>(x + padding);
+                placed.y    = static_cast<uint16_t>(y + padding);
+            }
+
+            atlas.pages.resize(skylines.size());
+            uint64_t used_page_pixels = 0;
+            for ( size_t page = 0; page < skylines.size(); ++page )
+            {
+                atlas.pages[page].height = skylines[page].used_height();
+                atlas.pages[page].pixels.assign(size_t(atlas.page_width) * atlas.pages[page].height, 0);
+                used_page_pixels += uint64_t(atlas.page_width) * atlas.pages[page].height;
+            }
+
+            const clock::time_point packed = clock::now();
+            ::std::atomic<size_t>   failed {0};
+            const auto decode = [this, &atlas, &failed](size_t i)
+            {
+                const atlas_frame& placed = atlas.frames[i];
+                if ( placed.width == 0 || placed.height == 0 )
+                    return;
+                uint8_t* const pixels = atlas.pages[placed.page].pixels.data() + size_t(placed.y) * atlas.page_width + placed.x;
+                if ( !decode_def_frame(m_frames[i], pixels, atlas.page_width) )
+                {
+                    // a damaged frame stays transparent, the rows written before the error are cleared
+                    for ( size_t row = 0; row < placed.height; ++row )
+                        ::std::memset(pixels + row * atlas.page_width, 0, placed.width);
+                    failed.fetch_add(1, ::std::memory_order_relaxed);
+                }
+            };
+
+            // the frames occupy disjoint rectangles, so they are decoded in parallel
+            if ( m_options.threads == 1 || m_frames.size() < 64 )
+                for ( size_t i = 0; i < m_frames.size(); ++i )
+                    decode(i);
+            else
+                thread_pool(m_options.threads).parallel_for(m_frames.size(), decode);
+
+            if ( report != nullptr )
+            {
+                report->frames           = m_frames.size();
+                report->pages            = atlas.pages.size();
+                report->failed           = failed.load();
+                report->frame_pixels     = frame_pixels;
+                report->used_page_pixels = used_page_pixels;
+                report->pack_seconds     = ::std::chrono::duration<double>(packed - start).count();
+                report->decode_seconds   = ::std::chrono::duration<double>(clock::now() - packed).count();
+            }
+        }
+
+    protected:
+        sprite_atlas_options     m_options;
+        ::std::vector<def_frame> m_frames;
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,452 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>   // std::array
+#include <cmath>   // std::fmod, std::fabs
+#include <cstddef> // size_t, ptrdiff_t
+#include <cstdint> // uint8_t, uint16_t, uint32_t, int32_t
+
+#include "palette_kernels.hpp" // nh3api::pixel_format, nh3api::get_shade_masks16, nh3api::rgb565_layout
+#include "simd.hpp"            // NH3API_PORTABLE_SSE2, NH3API_PORTABLE_AVX2
+
+namespace nh3api
+{
+
+// View of the pixels of a bitmap(Bitmap16Bit::map, HD::Bitmap::map32), <pitch> is in bytes like Bitmap16Bit::Pitch
+template<class Pixel>
+struct surface_view
+{
+    Pixel*  pixels {nullptr};
+    int32_t width {0};
+    int32_t height {0};
+    int32_t pitch {0};
+
+    [[nodiscard]] Pixel* row(int32_t y) const noexcept
+    { return reinterpret_cast<Pixel*>(reinterpret_cast<uint8_t*>(pixels) + static_cast<ptrdiff_t>(y) * pitch); }
+};
+
+using surface16 = surface_view<uint16_t>;
+using surface32 = surface_view<uint32_t>;
+
+namespace surface_detail
+{
+
+// clip the rectangle to the surface, false if nothing is left
+template<class Pixel>
+bool clip(const surface_view<Pixel>& surface, int32_t& x, int32_t& y, int32_t& w, int32_t& h) noexcept
+{
+    if ( x < 0 )
+    {
+        w += x;
+        x  = 0;
+    }
+    if ( y < 0 )
+    {
+        h += y;
+        y  = 0;
+    }
+    if ( w > surface.width - x )
+        w = surface.width - x;
+    if ( h > surface.height - y )
+        h = surface.height - y;
+    return w > 0 && h > 0;
+}
+
+template<class Pixel>
+void fill_span(Pixel* target, size_t count, Pixel color) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_AVX2
+    const __m256i wide = sizeof(Pixel) == 2 ? _mm256_set1_epi16(static_cast<short>(color)) : _mm256_set1_epi32(static_cast<int>(color));
+    for ( ; i + 32 / sizeof(Pixel) <= count; i += 32 / sizeof(Pixel) )
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), wide);
+#endif
+#if NH3API_PORTABLE_SSE2
+    const __m128i value = sizeof(Pixel) == 2 ? _mm_set1_epi16(static_cast<short>(color)) : _mm_set1_epi32(static_cast<int>(color));
+    for ( ; i + 16 / sizeof(Pixel) <= count; i += 16 / sizeof(Pixel) )
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), value);
+#endif
+    for ( ; i < count; ++i )
+        target[i] = color;
+}
+
+// half brightness, the alpha of the 32-bit pixels is kept
+[[nodiscard]] constexpr uint16_t darken_pixel(uint16_t pixel, uint16_t div2) noexcept
+{ return static_cast<uint16_t>((pixel >> 1U) & div2); }
+
+[[nodiscard]] constexpr uint32_t darken_pixel(uint32_t pixel) noexcept
+{ return ((pixel >> 1U) & 0x007F7F7FU) | (pixel & 0xFF000000U); }
+
+inline void darken_span(uint16_t* target, size_t count, uint16_t div2) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_AVX2
+    const __m256i wide_mask = _mm256_set1_epi16(static_cast<short>(div2));
+    for ( ; i + 16 <= count; i += 16 )
+    {
+        __m256i* const pixels = reinterpret_cast<__m256i*>(target + i);
+        _mm256_storeu_si256(pixels, _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256(pixels), 1), wide_mask));
+    }
+#endif
+#if NH3API_PORTABLE_SSE2
+    const __m128i mask = _mm_set1_epi16(static_cast<short>(div2));
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        __m128i* const pixels = reinterpret_cast<__m128i*>(target + i);
+        _mm_storeu_si128(pixels, _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128(pixels), 1), mask));
+    }
+#endif
+    for ( ; i < count; ++i )
+        target[i] = darken_pixel(target[i], div2);
+}
+
+inline void darken_span(uint32_t* target, size_t count) noexcept
+{
+    size_t i = 0;
+#if NH3API_PORTABLE_AVX2
+    const __m256i wide_color = _mm256_set1_epi32(0x007F7F7F);
+    const __m256i wide_alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+    for ( ; i + 8 <= count; i += 8 )
+    {
+        __m256i* const pixels = reinterpret_cast<__m256i*>(target + i);
+        const __m256i  value  = _mm256_loadu_si256(pixels);
+        _mm256_storeu_si256(pixels, _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(value, 1), wide_color), _mm256_and_si256(value, wide_alpha)));
+    }
+#endif
+#if NH3API_PORTABLE_SSE2
+    const __m128i color = _mm_set1_epi32(0x007F7F7F);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000U));
+    for ( ; i + 4 <= count; i += 4 )
+    {
+        __m128i* const pixels = reinterpret_cast<__m128i*>(target + i);
+        const __m128i  value  = _mm_loadu_si128(pixels);
+        _mm_storeu_si128(pixels, _mm_or_si128(_mm_and_si128(_mm_srli_epi32(value, 1), color), _mm_and_si128(value, alpha)));
+    }
+#endif
+    for ( ; i < count; ++i )
+        target[i] = darken_pixel(target[i]);
+}
+
+// 5 or 6 bits to 8 bits, the top bits are repeated so that the maximum maps to 255
+[[nodiscard]] constexpr uint32_t expand5(uint32_t value) noexcept
+{ return (value << 3U) | (value >> 2U); }
+
+[[nodiscard]] constexpr uint32_t expand6(uint32_t value) noexcept
+{ return (value << 2U) | (value >> 4U); }
+
+// brightness(HSV value) of a 16-bit pixel
+[[nodiscard]] constexpr uint32_t value16(uint16_t pixel, pixel_format format) noexcept
+{
+    const uint32_t red   = format == pixel_format::rgb555 ? expand5((pixel >> 10U) & 31U) : expand5(pixel >> 11U);
+    const uint32_t green = format == pixel_format::rgb555 ? expand5((pixel >> 5U) & 31U) : expand6((pixel >> 5U) & 63U);
+    const uint32_t blue  = expand5(pixel & 31U);
+    const uint32_t max   = red > green ? red : green;
+    return max > blue ? max : blue;
+}
+
+[[nodiscard]] constexpr uint32_t value32(uint32_t pixel) noexcept
+{
+    const uint32_t red   = (pixel >> 16U) & 0xFFU;
+    const uint32_t green = (pixel >> 8U) & 0xFFU;
+    const uint32_t blue  = pixel & 0xFFU;
+    const uint32_t max   = red > green ? red : green;
+    return max > blue ? max : blue;
+}
+
+} // namespace surface_detail
+
+// HSV(hue in degrees, saturation in [0, 1], value in [0, 255]) to 8-bit RGB, rounded to nearest
+inline void hsv_to_rgb8(float hue, float saturation, uint32_t value, uint8_t& red, uint8_t& green, uint8_t& blue) noexcept
+{
+    hue = ::std::fmod(hue, 360.0F);
+    if ( hue < 0.0F )
+        hue += 360.0F;
+    saturation = saturation < 0.0F ? 0.0F : (saturation > 1.0F ? 1.0F : saturation);
+
+    const float v      = static_cast<float>(value);
+    const float chroma = v * saturation;
+    const float sector = hue / 60.0F;
+    const float x      = chroma * (1.0F - ::std::fabs(::std::fmod(sector, 2.0F) - 1.0F));
+    const float m      = v - chroma;
+    float r = 0.0F, g = 0.0F, b = 0.0F;
+    switch ( static_cast<int32_t>(sector) )
+    {
+        case 0:  r = chroma; g = x;      break;
+        case 1:  r = x;      g = chroma; break;
+        case 2:  g = chroma; b = x;      break;
+        case 3:  g = x;      b = chroma; break;
+        case 4:  r = x;      b = chroma; break;
+        default: r = chroma; b = x;      break;
+    }
+    red   = static_cast<uint8_t>(r + m + 0.5F);
+    green = static_cast<uint8_t>(g + m + 0.5F);
+    blue  = static_cast<uint8_t>(b + m + 0.5F);
+}
+
+// hue in degrees and saturation in [0, 1] of an 8-bit RGB color
+inline void rgb8_to_hue_saturation(uint8_t red, uint8_t green, uint8_t blue, float& hue, float& saturation) noexcept
+{
+    const float r = red, g = green, b = blue;
+    const float max   = r > g ? (r > b ? r : b) : (g > b ? g : b);
+    const float min   = r < g ? (r < b ? r : b) : (g < b ? g : b);
+    const float delta = max - min;
+    saturation = max > 0.0F ? delta / max : 0.0F;
+    if ( delta == 0.0F )
+        hue = 0.0F;
+    else if ( max == r )
+        hue = 60.0F * ::std::fmod((g - b) / delta + 6.0F, 6.0F);
+    else if ( max == g )
+        hue = 60.0F * ((b - r) / delta + 2.0F);
+    else
+        hue = 60.0F * ((r - g) / delta + 4.0F);
+}
+
+// Fill the rectangle with <color>, clipped to the surface
+template<class Pixel>
+void fill_rect(const surface_view<Pixel>& surface, int32_t x, int32_t y, int32_t w, int32_t h, Pixel color) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    for ( int32_t row = y; row < y + h; ++row )
+        surface_detail::fill_span(surface.row(row) + x, static_cast<size_t>(w), color);
+}
+
+// Draw the 1 pixel outline of the rectangle, clipped to the surface
+template<class Pixel>
+void frame_rect(const surface_view<Pixel>& surface, int32_t x, int32_t y, int32_t w, int32_t h, Pixel color) noexcept
+{
+    if ( w <= 0 || h <= 0 )
+        return;
+
+    fill_rect(surface, x, y, w, 1, color);
+    if ( h > 1 )
+        fill_rect(surface, x, y + h - 1, w, 1, color);
+    if ( h > 2 )
+    {
+        fill_rect(surface, x, y + 1, 1, h - 2, color);
+        if ( w > 1 )
+            fill_rect(surface, x + w - 1, y + 1, 1, h - 2, color);
+    }
+}
+
+// Halve the brightness of the rectangle(the shade behind the dialogs)
+inline void darken(const surface16& surface, int32_t x, int32_t y, int32_t w, int32_t h, pixel_format format = pixel_format::rgb565) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    const uint16_t div2 = get_shade_masks16(format).div2;
+    for ( int32_t row = y; row < y + h; ++row )
+        surface_detail::darken_span(surface.row(row) + x, static_cast<size_t>(w), div2);
+}
+
+inline void darken(const surface32& surface, int32_t x, int32_t y, int32_t w, int32_t h) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    for ( int32_t row = y; row < y + h; ++row )
+        surface_detail::darken_span(surface.row(row) + x, static_cast<size_t>(w));
+}
+
+// The reference of the vectorized darken(): one pixel at a time
+inline void darken_scalar(const surface16& surface, int32_t x, int32_t y, int32_t w, int32_t h, pixel_format format = pixel_format::rgb565) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    const uint16_t div2 = get_shade_masks16(format).div2;
+    for ( int32_t row = y; row < y + h; ++row )
+        for ( int32_t column = x; column < x + w; ++column )
+            surface.row(row)[column] = surface_detail::darken_pixel(surface.row(row)[column], div2);
+}
+
+inline void darken_scalar(const surface32& surface, int32_t x, int32_t y, int32_t w, int32_t h) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    for ( int32_t row = y; row < y + h; ++row )
+        for ( int32_t column = x; column < x + w; ++column )
+            surface.row(row)[column] = surface_detail::darken_pixel(surface.row(row)[column]);
+}
+
+// Halve the brightness of the pixels whose <mask> byte is not 0,
+// <mask> covers the rectangle starting at (x, y) and its rows are <mask_pitch> bytes apart
+template<class Pixel>
+void darken_masked(const surface_view<Pixel>& surface, int32_t x, int32_t y, int32_t w, int32_t h,
+                   const uint8_t* mask, int32_t mask_pitch, pixel_format format = pixel_format::rgb565) noexcept
+{
+    const int32_t x0 = x, y0 = y;
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    const uint16_t div2 = get_shade_masks16(format).div2;
+    for ( int32_t row = y; row < y + h; ++row )
+    {
+        Pixel* const         pixels = surface.row(row);
+        const uint8_t* const bits   = mask + static_cast<ptrdiff_t>(row - y0) * mask_pitch - x0;
+        for ( int32_t column = x; column < x + w; ++column )
+        {
+            if ( bits[column] == 0 )
+                continue;
+            if constexpr ( sizeof(Pixel) == 2 )
+                pixels[column] = surface_detail::darken_pixel(pixels[column], div2);
+            else
+                pixels[column] = surface_detail::darken_pixel(pixels[column]);
+        }
+    }
+}
+
+// Recolor the rectangle to <hue>(degrees) and <saturation>([0, 1]), keeping the brightness of each pixel.
+// The result of a pixel depends on its brightness only, so a 256-entry table is built once per call
+// and the per-pixel work is the maximum of the channels and a table load
+class colorize_table
+{
+    public:
+        colorize_table(float hue, float saturation, pixel_format format)
+        {
+            for ( uint32_t value = 0; value < 256; ++value )
+            {
+                uint8_t red, green, blue;
+                hsv_to_rgb8(hue, saturation, value, red, green, blue);
+                if ( format == pixel_format::argb8888 )
+                    m_colors[value] = (uint32_t(red) << 16U) | (uint32_t(green) << 8U) | blue;
+                else if ( format == pixel_format::rgb555 )
+                    m_colors[value] = rgb555_layout::pack(red, green, blue);
+                else
+                    m_colors[value] = rgb565_layout::pack(red, green, blue);
+            }
+        }
+
+    public:
+        [[nodiscard]] uint32_t operator[](uint32_t value) const noexcept
+        { return m_colors[value]; }
+
+    protected:
+        ::std::array<uint32_t, 256> m_colors {};
+
+};
+
+inline void colorize(const surface16& surface, int32_t x, int32_t y, int32_t w, int32_t h, float hue, float saturation,
+                     pixel_format format = pixel_format::rgb565) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    const colorize_table table(hue, saturation, format);
+    for ( int32_t row = y; row < y + h; ++row )
+    {
+        uint16_t* const pixels = surface.row(row) + x;
+        int32_t         i      = 0;
+#if NH3API_PORTABLE_SSE2
+        // the channels expanded to 8 bits and their maximum for 8 pixels at once
+        const bool    rgb555    = format == pixel_format::rgb555;
+        const __m128i mask5     = _mm_set1_epi16(31);
+        const __m128i mask_g    = _mm_set1_epi16(rgb555 ? 31 : 63);
+        alignas(16) uint16_t values[8];
+        for ( ; i + 8 <= w; i += 8 )
+        {
+            const __m128i source = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+            const __m128i red    = rgb555 ? _mm_and_si128(_mm_srli_epi16(source, 10), mask5) : _mm_srli_epi16(source, 11);
+            const __m128i green  = _mm_and_si128(_mm_srli_epi16(source, 5), mask_g);
+            const __m128i blue   = _mm_and_si128(source, mask5);
+            const __m128i red8   = _mm_or_si128(_mm_slli_epi16(red, 3), _mm_srli_epi16(red, 2));
+            const __m128i blue8  = _mm_or_si128(_mm_slli_epi16(blue, 3), _mm_srli_epi16(blue, 2));
+            const __m128i green8 = rgb555 ? _mm_or_si128(_mm_slli_epi16(green, 3), _mm_srli_epi16(green, 2))
+                                          : _mm_or_si128(_mm_slli_epi16(green, 2), _mm_srli_epi16(green, 4));
+            _mm_store_si128(reinterpret_cast<__m128i*>(values), _mm_max_epi16(_mm_max_epi16(red8, green8), blue8));
+            for ( int32_t k = 0; k < 8; ++k )
+                pixels[i + k] = static_cast<uint16_t>(table[values[k]]);
+        }
+#endif
+        for ( ; i < w; ++i )
+            pixels[i] = static_cast<uint16_t>(table[surface_detail::value16(pixels[i], format)]);
+    }
+}
+
+inline void colorize(const surface32& surface, int32_t x, int32_t y, int32_t w, int32_t h, float hue, float saturation) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    const colorize_table table(hue, saturation, pixel_format::argb8888);
+    for ( int32_t row = y; row < y + h; ++row )
+    {
+        uint32_t* const pixels = surface.row(row) + x;
+        int32_t         i      = 0;
+#if NH3API_PORTABLE_AVX2
+        const __m256i byte_mask = _mm256_set1_epi32(0xFF);
+        const __m256i alpha     = _mm256_set1_epi32(static_cast<int>(0xFF000000U));
+        const int* const colors = reinterpret_cast<const int*>(&table);
+        for ( ; i + 8 <= w; i += 8 )
+        {
+            __m256i* const target = reinterpret_cast<__m256i*>(pixels + i);
+            const __m256i  source = _mm256_loadu_si256(target);
+            const __m256i  value  = _mm256_max_epu8(_mm256_max_epu8(_mm256_and_si256(_mm256_srli_epi32(source, 16), byte_mask),
+                                                                     _mm256_and_si256(_mm256_srli_epi32(source, 8), byte_mask)),
+                                                    _mm256_and_si256(source, byte_mask));
+            _mm256_storeu_si256(target, _mm256_or_si256(_mm256_i32gather_epi32(colors, value, 4), _mm256_and_si256(source, alpha)));
+        }
+#endif
+        for ( ; i < w; ++i )
+            pixels[i] = table[surface_detail::value32(pixels[i])] | (pixels[i] & 0xFF000000U);
+    }
+}
+
+// Colorize with the hue and the saturation of a 16-bit <color>
+inline void colorize(const surface16& surface, int32_t x, int32_t y, int32_t w, int32_t h, uint16_t color,
+                     pixel_format format = pixel_format::rgb565) noexcept
+{
+    const bool rgb555 = format == pixel_format::rgb555;
+    float hue, saturation;
+    rgb8_to_hue_saturation(static_cast<uint8_t>(surface_detail::expand5(rgb555 ? (color >> 10U) & 31U : color >> 11U)),
+                           static_cast<uint8_t>(rgb555 ? surface_detail::expand5((color >> 5U) & 31U) : surface_detail::expand6((color >> 5U) & 63U)),
+                           static_cast<uint8_t>(surface_detail::expand5(color & 31U)), hue, saturation);
+    colorize(surface, x, y, w, h, hue, saturation, format);
+}
+
+// The reference of the table-driven colorize(): HSV conversion of every pixel
+inline void colorize_scalar(const surface16& surface, int32_t x, int32_t y, int32_t w, int32_t h, float hue, float saturation,
+                            pixel_format format = pixel_format::rgb565) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    for ( int32_t row = y; row < y + h; ++row )
+        for ( int32_t column = x; column < x + w; ++column )
+        {
+            uint16_t& pixel = surface.row(row)[column];
+            uint8_t   red, green, blue;
+            hsv_to_rgb8(hue, saturation, surface_detail::value16(pixel, format), red, green, blue);
+            pixel = format == pixel_format::rgb555 ? rgb555_layout::pack(red, green, blue) : rgb565_layout::pack(red, green, blue);
+        }
+}
+
+inline void colorize_scalar(const surface32& surface, int32_t x, int32_t y, int32_t w, int32_t h, float hue, float saturation) noexcept
+{
+    if ( !surface_detail::clip(surface, x, y, w, h) )
+        return;
+
+    for ( int32_t row = y; row < y + h; ++row )
+        for ( int32_t column = x; column < x + w; ++column )
+        {
+            uint32_t& pixel = surface.row(row)[column];
+            uint8_t   red, green, blue;
+            hsv_to_rgb8(hue, saturation, surface_detail::value32(pixel), red, green, blue);
+            pixel = (pixel & 0xFF000000U) | (uint32_t(red) << 16U) | (uint32_t(green) << 8U) | blue;
+        }
+}
+
+} // namespace nh3api
@@ -0,0 +1,494 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, int32_t, uint32_t, int64_t
+#include <cstring> // std::memcpy
+#include <memory>  // std::unique_ptr
+#include <utility> // std::swap
+#include <vector>  // std::vector
+
+#include "palette_kernels.hpp" // nh3api::pixel_format
+#include "simd.hpp"            // NH3API_PORTABLE_SSE2
+#include "surface_kernels.hpp" // nh3api::surface_view, nh3api::surface16, nh3api::surface32
+#include "thread_pool.hpp"     // nh3api::thread_pool
+
+namespace nh3api
+{
+
+enum class scale_filter : uint32_t
+{
+    nearest  = 0, // nearest neighbour, exact pixel blocks at integer factors
+    bilinear = 1, // 8-bit fixed point weights, pixel centers aligned
+    scale2x  = 2  // Scale2x(AdvMAME2x) passes while the image fits twice into the target, nearest neighbour for the rest
+};
+
+struct scaler_options
+{
+    scale_filter filter {scale_filter::nearest};
+    // pool threads, 0: one per hardware thread, 1: the calling thread only
+    size_t threads {0};
+    // target rows per band: the unit of work of a thread, the rows of a band share the filtered source rows
+    int32_t band_rows {64};
+};
+
+namespace scale_detail
+{
+
+// source row or column of target <i>, pixel centers aligned: integer factors repeat each pixel exactly <factor> times
+[[nodiscard]] inline int32_t nearest_position(int32_t i, int32_t source, int32_t target) noexcept
+{ return static_cast<int32_t>(((2 * int64_t(i) + 1) * source) / (2 * int64_t(target))); }
+
+// the two source rows or columns around target <i> and the weight of the second one, 0..255
+inline void bilinear_position(int32_t i, int32_t source, int32_t target, int32_t& first, int32_t& second, uint16_t& weight) noexcept
+{
+    int64_t position = ((2 * int64_t(i) + 1) * source * 256) / (2 * int64_t(target)) - 128;
+    if ( position < 0 )
+        position = 0;
+    first  = static_cast<int32_t>(position >> 8);
+    weight = static_cast<uint16_t>(position & 255);
+    if ( first >= source - 1 )
+    {
+        first  = source - 1;
+        weight = 0;
+    }
+    second = first + 1 < source ? first + 1 : first;
+}
+
+// (a * (256 - weight) + b * weight + 128) >> 8, a and b are 8-bit or smaller channels
+[[nodiscard]] inline uint16_t lerp(uint32_t a, uint32_t b, uint32_t weight) noexcept
+{ return static_cast<uint16_t>((a * (256U - weight) + b * weight + 128U) >> 8U); }
+
+#if NH3API_PORTABLE_SSE2
+// the same for 8 lanes: the result fits 16 bits, so the wrapping arithmetic is exact
+inline __m128i lerp(__m128i a, __m128i b, __m128i weight) noexcept
+{ return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(a, 8), _mm_mullo_epi16(_mm_sub_epi16(b, a), weight)), _mm_set1_epi16(128)), 8); }
+
+template<class Pixel>
+inline __m128i equal(__m128i lhs, __m128i rhs) noexcept
+{ return sizeof(Pixel) == 2 ? _mm_cmpeq_epi16(lhs, rhs) : _mm_cmpeq_epi32(lhs, rhs); }
+
+inline __m128i select(__m128i mask, __m128i if_set, __m128i if_clear) noexcept
+{ return _mm_or_si128(_mm_and_si128(mask, if_set), _mm_andnot_si128(mask, if_clear)); }
+#endif
+
+// Channel layout of the bilinear filter: a row filtered horizontally holds 16-bit channel values
+template<class Pixel>
+struct channels;
+
+// 16-bit: three planes(red, green, blue) of <width> values in the native bit depth
+template<>
+struct channels<uint16_t>
+{
+    static inline constexpr size_t count = 3;
+
+    uint32_t red_shift;
+    uint16_t green_mask;
+
+    explicit channels(pixel_format format) noexcept
+        : red_shift { format == pixel_format::rgb555 ? 10U : 11U }, green_mask { static_cast<uint16_t>(format == pixel_format::rgb555 ? 0x1F : 0x3F) }
+    {}
+
+    void filter_row(const uint16_t* source, const int32_t* first, const int32_t* second, const uint16_t* weight, uint16_t* output, int32_t width) const noexcept
+    {
+        uint16_t* red   = output;
+        uint16_t* green = output + width;
+        uint16_t* blue  = output + 2 * width;
+        int32_t   x     = 0;
+    #if NH3API_PORTABLE_SSE2
+        const __m128i five  = _mm_set1_epi16(0x1F);
+        const __m128i gmask = _mm_set1_epi16(static_cast<short>(green_mask));
+        const __m128i rsh   = _mm_cvtsi32_si128(static_cast<int>(red_shift));
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            const __m128i a = _mm_setr_epi16(static_cast<short>(source[first[x]]),     static_cast<short>(source[first[x + 1]]),
+                                             static_cast<short>(source[first[x + 2]]), static_cast<short>(source[first[x + 3]]),
+                                             static_cast<short>(source[first[x + 4]]), static_cast<short>(source[first[x + 5]]),
+                                             static_cast<short>(source[first[x + 6]]), static_cast<short>(source[first[x + 7]]));
+            const __m128i b = _mm_setr_epi16(static_cast<short>(source[second[x]]),     static_cast<short>(source[second[x + 1]]),
+                                             static_cast<short>(source[second[x + 2]]), static_cast<short>(source[second[x + 3]]),
+                                             static_cast<short>(source[second[x + 4]]), static_cast<short>(source[second[x + 5]]),
+                                             static_cast<short>(source[second[x + 6]]), static_cast<short>(source[second[x + 7]]));
+            const __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weight + x));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(red + x), lerp(_mm_and_si128(_mm_srl_epi16(a, rsh), five), _mm_and_si128(_mm_srl_epi16(b, rsh), five), w));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(green + x), lerp(_mm_and_si128(_mm_srli_epi16(a, 5), gmask), _mm_and_si128(_mm_srli_epi16(b, 5), gmask), w));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(blue + x), lerp(_mm_and_si128(a, five), _mm_and_si128(b, five), w));
+        }
+    #endif
+        for ( ; x < width; ++x )
+        {
+            const uint32_t a = source[first[x]];
+            const uint32_t b = source[second[x]];
+            red[x]   = lerp((a >> red_shift) & 0x1FU, (b >> red_shift) & 0x1FU, weight[x]);
+            green[x] = lerp((a >> 5U) & green_mask, (b >> 5U) & green_mask, weight[x]);
+            blue[x]  = lerp(a & 0x1FU, b & 0x1FU, weight[x]);
+        }
+    }
+
+    void blend_rows(const uint16_t* upper, const uint16_t* lower, uint16_t weight, uint16_t* target, int32_t width) const noexcept
+    {
+        int32_t x = 0;
+    #if NH3API_PORTABLE_SSE2
+        const __m128i w   = _mm_set1_epi16(static_cast<short>(weight));
+        const __m128i rsh = _mm_cvtsi32_si128(static_cast<int>(red_shift));
+        const auto    row = [](const uint16_t* plane, int32_t at) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(plane + at)); };
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            const __m128i red   = lerp(row(upper, x), row(lower, x), w);
+            const __m128i green = lerp(row(upper + width, x), row(lower + width, x), w);
+            const __m128i blue  = lerp(row(upper + 2 * width, x), row(lower + 2 * width, x), w);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + x), _mm_or_si128(_mm_or_si128(_mm_sll_epi16(red, rsh), _mm_slli_epi16(green, 5)), blue));
+        }
+    #endif
+        for ( ; x < width; ++x )
+            target[x] = static_cast<uint16_t>((lerp(upper[x], lower[x], weight) << red_shift)
+                                              | (lerp(upper[width + x], lower[width + x], weight) << 5U)
+                                              | lerp(upper[2 * width + x], lower[2 * width + x], weight));
+    }
+};
+
+// 32-bit: the four bytes of each pixel as 16-bit values, interleaved
+template<>
+struct channels<uint32_t>
+{
+    static inline constexpr size_t count = 4;
+
+    explicit channels(pixel_format) noexcept
+    {}
+
+    void filter_row(const uint32_t* source, const int32_t* first, const int32_t* second, const uint16_t* weight, uint16_t* output, int32_t width) const noexcept
+    {
+        int32_t x = 0;
+    #if NH3API_PORTABLE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        for ( ; x + 4 <= width; x += 4 )
+        {
+            const __m128i a = _mm_setr_epi32(static_cast<int>(source[first[x]]),     static_cast<int>(source[first[x + 1]]),
+                                             static_cast<int>(source[first[x + 2]]), static_cast<int>(source[first[x + 3]]));
+            const __m128i b = _mm_setr_epi32(static_cast<int>(source[second[x]]),     static_cast<int>(source[second[x + 1]]),
+                                             static_cast<int>(source[second[x + 2]]), static_cast<int>(source[second[x + 3]]));
+            // the weight of each pixel for its four channels
+            const __m128i w  = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(weight + x));
+            const __m128i wl = _mm_unpacklo_epi16(w, w);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4 * x),
+                             lerp(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi32(wl, wl)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + 4 * x + 8),
+                             lerp(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi32(wl, wl)));
+        }
+    #endif
+        for ( ; x < width; ++x )
+        {
+            const uint32_t a = source[first[x]];
+            const uint32_t b = source[second[x]];
+            for ( uint32_t channel = 0; channel < 4; ++channel )
+                output[4 * x + channel] = lerp((a >> (channel * 8U)) & 0xFFU, (b >> (channel * 8U)) & 0xFFU, weight[x]);
+        }
+    }
+
+    void blend_rows(const uint16_t* upper, const uint16_t* lower, uint16_t weight, uint32_t* target, int32_t width) const noexcept
+    {
+        int32_t x = 0;
+    #if NH3API_PORTABLE_SSE2
+        const __m128i w = _mm_set1_epi16(static_cast<short>(weight));
+        for ( ; x + 4 <= width; x += 4 )
+        {
+            const __m128i low  = lerp(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + 4 * x)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + 4 * x)), w);
+            const __m128i high = lerp(_mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + 4 * x + 8)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + 4 * x + 8)), w);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + x), _mm_packus_epi16(low, high));
+        }
+    #endif
+        for ( ; x < width; ++x )
+        {
+            uint32_t pixel = 0;
+            for ( uint32_t channel = 0; channel < 4; ++channel )
+                pixel |= uint32_t(lerp(upper[4 * x + channel], lower[4 * x + channel], weight)) << (channel * 8U);
+            target[x] = pixel;
+        }
+    }
+};
+
+// one row of Scale2x: <above>, <row>, <below> of <width> pixels to two rows of 2 * <width>
+template<class Pixel>
+void scale2x_row(const Pixel* above, const Pixel* row, const Pixel* below, Pixel* top, Pixel* bottom, int32_t width) noexcept
+{
+    // E0 E1     B
+    // E2 E3   D E F
+    //           H
+    const auto pixel = [&](int32_t x) noexcept
+    {
+        const Pixel b = above[x];
+        const Pixel d = row[x > 0 ? x - 1 : 0];
+        const Pixel e = row[x];
+        const Pixel f = row[x + 1 < width ? x + 1 : x];
+        const Pixel h = below[x];
+        if ( b != h && d != f )
+        {
+            top[2 * x]        = d == b ? d : e;
+            top[2 * x + 1]    = b == f ? f : e;
+            bottom[2 * x]     = d == h ? d : e;
+            bottom[2 * x + 1] = h == f ? f : e;
+        }
+        else
+        {
+            top[2 * x] = top[2 * x + 1] = bottom[2 * x] = bottom[2 * x + 1] = e;
+        }
+    };
+
+    if ( width <= 0 )
+        return;
+    pixel(0);
+    int32_t x = 1;
+#if NH3API_PORTABLE_SSE2
+    constexpr int32_t lanes = 16 / sizeof(Pixel);
+    const auto load = [](const Pixel* at) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)); };
+    const auto store_pair = [](Pixel* at, __m128i first, __m128i second) noexcept
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(at), sizeof(Pixel) == 2 ? _mm_unpacklo_epi16(first, second) : _mm_unpacklo_epi32(first, second));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(at) + 1, sizeof(Pixel) == 2 ? _mm_unpackhi_epi16(first, second) : _mm_unpackhi_epi32(first, second));
+    };
+    for ( ; x + lanes < width; x += lanes )
+    {
+        const __m128i b = load(above + x);
+        const __m128i d = load(row + x - 1);
+        const __m128i e = load(row + x);
+        const __m128i f = load(row + x + 1);
+        const __m128i h = load(below + x);
+        // b != h && d != f
+        const __m128i edge = _mm_andnot_si128(_mm_or_si128(equal<Pixel>(b, h), equal<Pixel>(d, f)), _mm_set1_epi32(-1));
+        store_pair(top + 2 * x, select(_mm_and_si128(edge, equal<Pixel>(d, b)), d, e), select(_mm_and_si128(edge, equal<Pixel>(b, f)), f, e));
+        store_pair(bottom + 2 * x, select(_mm_and_si128(edge, equal<Pixel>(d, h)), d, e), select(_mm_and_si128(edge, equal<Pixel>(h, f)), f, e));
+    }
+#endif
+    for ( ; x < width; ++x )
+        pixel(x);
+}
+
+// one row of the nearest neighbour filter
+template<class Pixel>
+void nearest_row(const Pixel* source, const int32_t* columns, Pixel* target, int32_t width, int32_t factor) noexcept
+{
+    int32_t x = 0;
+    if ( factor == 1 )
+    {
+        ::std::memcpy(target, source, static_cast<size_t>(width) * sizeof(Pixel));
+        return;
+    }
+    if ( factor == 2 )
+    {
+    #if NH3API_PORTABLE_SSE2
+        constexpr int32_t lanes = 16 / sizeof(Pixel);
+        for ( ; x + 2 * lanes <= width; x += 2 * lanes )
+        {
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + x / 2));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + x), sizeof(Pixel) == 2 ? _mm_unpacklo_epi16(pixels, pixels) : _mm_unpacklo_epi32(pixels, pixels));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + x) + 1, sizeof(Pixel) == 2 ? _mm_unpackhi_epi16(pixels, pixels) : _mm_unpackhi_epi32(pixels, pixels));
+        }
+    #endif
+    }
+    else if ( factor > 2 )
+    {
+        // blocks of <factor> pixels
+        for ( ; x + factor <= width; x += factor )
+        {
+            const Pixel pixel = source[x / factor];
+            for ( int32_t i = 0; i < factor; ++i )
+                target[x + i] = pixel;
+        }
+    }
+    for ( ; x < width; ++x )
+        target[x] = source[columns[x]];
+}
+
+} // namespace scale_detail
+
+// Scaling of whole surfaces, e.g. the 800x600 game screen to the window /
+// Масштабирование поверхностей целиком, например экрана игры 800x600 до размера окна.
+// The target is processed in bands of rows spread over the pool threads; within a band the filtered source rows
+// are reused by all the target rows which need them, a 4K row(15 KB of 32-bit pixels) fitting the L1/L2 caches.
+// The results do not depend on the instruction set nor the number of threads.
+// One scale() call at a time: the scaler owns its intermediate buffers
+class surface_scaler
+{
+    public:
+        explicit surface_scaler(const scaler_options& options = {})
+            : m_options { options }
+        {
+            if ( m_options.band_rows <= 0 )
+                m_options.band_rows = 64;
+            if ( m_options.threads != 1 )
+                m_pool = ::std::make_unique<thread_pool>(m_options.threads);
+        }
+
+    public:
+        // scale the whole <source> to the whole <target>, <format> is the layout of the 16-bit pixels(bilinear filter only)
+        void scale(const surface16& source, const surface16& target, pixel_format format = pixel_format::rgb565)
+        { scale_impl(source, target, format); }
+
+        void scale(const surface32& source, const surface32& target)
+        { scale_impl(source, target, pixel_format::argb8888); }
+
+        [[nodiscard]] const scaler_options& options() const noexcept
+        { return m_options; }
+
+    protected:
+        template<class Pixel>
+        void scale_impl(const surface_view<Pixel>& source, const surface_view<Pixel>& target, pixel_format format)
+        {
+            if ( source.width <= 0 || source.height <= 0 || target.width <= 0 || target.height <= 0 )
+                return;
+
+            switch ( m_options.filter )
+            {
+                case scale_filter::bilinear:
+                    bilinear(source, target, format);
+                    break;
+                case scale_filter::scale2x:
+                    scale2x(source, target);
+                    break;
+                case scale_filter::nearest:
+                default:
+                    nearest(source, target);
+                    break;
+            }
+        }
+
+        // call <fn>(first, last) for the bands of [0, rows)
+        template<class F>
+        void for_bands(int32_t rows, int32_t band_rows, F&& fn)
+        {
+            const size_t bands = static_cast<size_t>((rows + band_rows - 1) / band_rows);
+            const auto   band  = [&](size_t i)
+            {
+                const int32_t first = static_cast<int32_t>(i) * band_rows;
+                fn(first, first + band_rows < rows ? first + band_rows : rows);
+            };
+            if ( m_pool && bands > 1 )
+                m_pool->parallel_for(bands, band);
+            else
+                for ( size_t i = 0; i < bands; ++i )
+                    band(i);
+        }
+
+        template<class Pixel>
+        void nearest(const surface_view<Pixel>& source, const surface_view<Pixel>& target)
+        {
+            ::std::vector<int32_t> columns(static_cast<size_t>(target.width));
+            for ( int32_t x = 0; x < target.width; ++x )
+                columns[static_cast<size_t>(x)] = scale_detail::nearest_position(x, source.width, target.width);
+            const int32_t factor = target.width % source.width == 0 ? target.width / source.width : 0;
+
+            for_bands(target.height, m_options.band_rows, [&](int32_t first, int32_t last)
+            {
+                int32_t previous = -1;
+                for ( int32_t y = first; y < last; ++y )
+                {
+                    const int32_t source_y = scale_detail::nearest_position(y, source.height, target.height);
+                    // the repeated rows are copies of the row above
+                    if ( source_y == previous )
+                        ::std::memcpy(target.row(y), target.row(y - 1), static_cast<size_t>(target.width) * sizeof(Pixel));
+                    else
+                        scale_detail::nearest_row(source.row(source_y), columns.data(), target.row(y), target.width, factor);
+                    previous = source_y;
+                }
+            });
+        }
+
+        template<class Pixel>
+        void bilinear(const surface_view<Pixel>& source, const surface_view<Pixel>& target, pixel_format format)
+        {
+            const size_t width = static_cast<size_t>(target.width);
+            ::std::vector<int32_t>  first(width), second(width);
+            ::std::vector<uint16_t> weight(width);
+            for ( int32_t x = 0; x < target.width; ++x )
+                scale_detail::bilinear_position(x, source.width, target.width, first[size_t(x)], second[size_t(x)], weight[size_t(x)]);
+
+            const scale_detail::channels<Pixel> layout(format);
+            const size_t row_size = scale_detail::channels<Pixel>::count * width;
+            for_bands(target.height, m_options.band_rows, [&](int32_t band_first, int32_t band_last)
+            {
+                // the two source rows filtered horizontally, swapped as the band moves down
+                ::std::vector<uint16_t> rows(2 * row_size);
+                uint16_t* upper       = rows.data();
+                uint16_t* lower       = rows.data() + row_size;
+                int32_t   upper_index = -1;
+                int32_t   lower_index = -1;
+                for ( int32_t y = band_first; y < band_last; ++y )
+                {
+                    int32_t  top, bottom;
+                    uint16_t wy;
+                    scale_detail::bilinear_position(y, source.height, target.height, top, bottom, wy);
+                    if ( top == lower_index )
+                    {
+                        ::std::swap(upper, lower);
+                        upper_index = lower_index;
+                        lower_index = -1;
+                    }
+                    if ( top != upper_index )
+                    {
+                        layout.filter_row(source.row(top), first.data(), second.data(), weight.data(), upper, target.width);
+                        upper_index = top;
+                    }
+                    if ( bottom != lower_index )
+                    {
+                        layout.filter_row(source.row(bottom), first.data(), second.data(), weight.data(), lower, target.width);
+                        lower_index = bottom;
+                    }
+                    layout.blend_rows(upper, lower, wy, target.row(y), target.width);
+                }
+            });
+        }
+
+        template<class Pixel>
+        void scale2x(const surface_view<Pixel>& source, const surface_view<Pixel>& target)
+        {
+            surface_view<Pixel> current = source;
+            size_t              buffer  = 0;
+            while ( 2 * current.width <= target.width && 2 * current.height <= target.height )
+            {
+                surface_view<Pixel> next;
+                if ( 2 * current.width == target.width && 2 * current.height == target.height )
+                {
+                    next = target;
+                }
+                else
+                {
+                    ::std::vector<uint8_t>& storage = m_buffers[buffer];
+                    buffer ^= 1U;
+                    storage.resize(size_t(4) * size_t(current.width) * size_t(current.height) * sizeof(Pixel));
+                    next = { reinterpret_cast<Pixel*>(storage.data()), 2 * current.width, 2 * current.height, static_cast<int32_t>(2 * current.width * sizeof(Pixel)) };
+                }
+
+                // the bands are in source rows, each one makes two target rows
+                const int32_t band_rows = m_options.band_rows / 2 > 0 ? m_options.band_rows / 2 : 1;
+                for_bands(current.height, band_rows, [&current, &next](int32_t first, int32_t last)
+                {
+                    for ( int32_t y = first; y < last; ++y )
+                        scale_detail::scale2x_row(current.row(y > 0 ? y - 1 : 0), current.row(y), current.row(y + 1 < current.height ? y + 1 : y),
+                                                  next.row(2 * y), next.row(2 * y + 1), current.width);
+                });
+                current = next;
+                if ( current.pixels == target.pixels )
+                    return;
+            }
+            nearest(current, target);
+        }
+
+    protected:
+        scaler_options                 m_options;
+        ::std::unique_ptr<thread_pool> m_pool;
+        // the Scale2x passes before the last one
+        ::std::vector<uint8_t>         m_buffers[2];
+
+};
+
+} // namespace nh3api
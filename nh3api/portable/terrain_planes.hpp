@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <cstdint>          // uint8_t, uint64_t
+#include <initializer_list> // std::initializer_list
+#include <vector>           // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+
+namespace nh3api
+{
+
+// One bit per map tile, packed into 64-bit words so that a whole row of a 144x144 map is 3 words
+class bit_plane
+{
+    public:
+        bit_plane() noexcept = default;
+
+        explicit bit_plane(size_t size)
+            : m_words((size + 63) / 64), m_size { size }
+        {}
+
+    public:
+        void assign(size_t size)
+        {
+            m_words.assign((size + 63) / 64, 0);
+            m_size = size;
+        }
+
+        [[nodiscard]] bool test(size_t i) const noexcept
+        { return (m_words[i / 64] >> (i % 64)) & 1U; }
+
+        void set(size_t i, bool value = true) noexcept
+        {
+            const uint64_t mask = uint64_t(1) << (i % 64);
+            m_words[i / 64] = value ? (m_words[i / 64] | mask) : (m_words[i / 64] & ~mask);
+        }
+
+        // number of the set bits
+        [[nodiscard]] size_t count() const noexcept
+        {
+            size_t result = 0;
+            for ( uint64_t word : m_words )
+                for ( ; word != 0; word &= word - 1 )
+                    ++result;
+
+            return result;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        { return m_size; }
+
+        [[nodiscard]] span<const uint64_t> words() const noexcept
+        { return { m_words.data(), m_words.size() }; }
+
+        [[nodiscard]] span<uint64_t> words() noexcept
+        { return { m_words.data(), m_words.size() }; }
+
+    protected:
+        ::std::vector<uint64_t> m_words;
+        size_t                  m_size {0};
+
+};
+
+// Bits of the 7th terrain byte of a map tile, the same order as NewmapCell flip bitfields
+enum h3m_tile_flag : uint8_t
+{
+    H3M_TILE_GROUND_FLIPPED_HORIZONTAL = 0x01,
+    H3M_TILE_GROUND_FLIPPED_VERTICAL   = 0x02,
+    H3M_TILE_RIVER_FLIPPED_HORIZONTAL  = 0x04,
+    H3M_TILE_RIVER_FLIPPED_VERTICAL    = 0x08,
+    H3M_TILE_ROAD_FLIPPED_HORIZONTAL   = 0x10,
+    H3M_TILE_ROAD_FLIPPED_VERTICAL     = 0x20
+};
+
+// Map terrain as a structure of arrays /
+// Почва карты в виде структуры массивов.
+// Each plane holds size * size * levels tiles in the order of NewfullMap::cellData: x + size * (y + z * size),
+// so a level is a contiguous block of a plane and a whole-map scan over one attribute reads only that attribute.
+// passable and blocked are known to the game only after the objects are placed,
+// they are filled by the export from NewfullMap and left empty by read_h3m_terrain()
+struct terrain_planes
+{
+    int32_t                size {0};
+    int32_t                levels {0};
+    // TTerrainType
+    ::std::vector<uint8_t> ground_type;
+    ::std::vector<uint8_t> ground_frame;
+    // river type, 0: none
+    ::std::vector<uint8_t> river_type;
+    ::std::vector<uint8_t> river_frame;
+    // road type, 0: none
+    ::std::vector<uint8_t> road_type;
+    ::std::vector<uint8_t> road_frame;
+    // h3m_tile_flag bits as stored in the map file
+    ::std::vector<uint8_t> flags;
+    bit_plane              ground_flipped_horizontal;
+    bit_plane              ground_flipped_vertical;
+    bit_plane              river_flipped_horizontal;
+    bit_plane              river_flipped_vertical;
+    bit_plane              road_flipped_horizontal;
+    bit_plane              road_flipped_vertical;
+    bit_plane              passable;
+    bit_plane              blocked;
+
+    [[nodiscard]] size_t tiles() const noexcept
+    { return static_cast<size_t>(size) * static_cast<size_t>(size) * static_cast<size_t>(levels); }
+
+    [[nodiscard]] size_t level_tiles() const noexcept
+    { return static_cast<size_t>(size) * static_cast<size_t>(size); }
+
+    [[nodiscard]] size_t index(int32_t x, int32_t y, int32_t z) const noexcept
+    { return static_cast<size_t>(x) + static_cast<size_t>(size) * (static_cast<size_t>(y) + static_cast<size_t>(z) * static_cast<size_t>(size)); }
+
+    // the tiles of <z> in the byte plane <plane>
+    [[nodiscard]] span<const uint8_t> level(const ::std::vector<uint8_t>& plane, int32_t z) const noexcept
+    { return { plane.data() + static_cast<size_t>(z) * level_tiles(), level_tiles() }; }
+
+    // resize the planes for a map of <map_size> x <map_size> x <map_levels> tiles,
+    // <with_state>: allocate passable and blocked too
+    void assign(int32_t map_size, int32_t map_levels, bool with_state = false)
+    {
+        size   = map_size;
+        levels = map_levels;
+        const size_t count = tiles();
+        for ( ::std::vector<uint8_t>* plane : { &ground_type, &ground_frame, &river_type, &river_frame, &road_type, &road_frame, &flags } )
+            plane->assign(count, 0);
+        for ( bit_plane* plane : { &ground_flipped_horizontal, &ground_flipped_vertical, &river_flipped_horizontal,
+                                   &river_flipped_vertical, &road_flipped_horizontal, &road_flipped_vertical } )
+            plane->assign(count);
+        passable.assign(with_state ? count : 0);
+        blocked.assign(with_state ? count : 0);
+    }
+
+    // fill the flip bit planes from the flags plane
+    void unpack_flags() noexcept
+    {
+        bit_plane* const planes[6] { &ground_flipped_horizontal, &ground_flipped_vertical, &river_flipped_horizontal,
+                                     &river_flipped_vertical, &road_flipped_horizontal, &road_flipped_vertical };
+        const size_t count = flags.size();
+        for ( size_t bit = 0; bit < 6; ++bit )
+        {
+            const span<uint64_t> words = planes[bit]->words();
+            for ( size_t word = 0; word < words.size(); ++word )
+            {
+                // gather 64 tiles at once, the inner loop has no dependencies between the iterations
+                const size_t first = word * 64;
+                const size_t last  = first + 64 < count ? first + 64 : count;
+                uint64_t     bits  = 0;
+                for ( size_t i = first; i < last; ++i )
+                    bits |= uint64_t((flags[i] >> bit) & 1U) << (i - first);
+                words[word] = bits;
+            }
+        }
+    }
+};
+
+} // namespace nh3api
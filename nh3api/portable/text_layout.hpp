@@ -0,0 +1,443 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <array>         // std::array
+#include <cstddef>       // std::byte, size_t
+#include <cstdint>       // uint8_t, int16_t, int32_t, uint32_t, uint64_t
+#include <functional>    // std::hash
+#include <list>          // std::list
+#include <memory>        // std::shared_ptr
+#include <string>        // std::string
+#include <string_view>   // std::string_view
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+
+#include "../core/nh3api_std/span.hpp" // nh3api::span
+#include "surface_kernels.hpp"         // nh3api::surface_view
+
+namespace nh3api
+{
+
+// Bitmap font as stored in the .fnt files: font::TFontSpec followed by the glyph pixels(font::Data).
+// Glyph c is font.height rows of glyphs[c].b bytes at pixels[glyphs[c].offset]: 0 is transparent, 1 is the shadow, the rest is the text color
+struct bitmap_font
+{
+    // font::TFontSpec::myABC and TFontSpec::Offset
+    struct glyph
+    {
+        int32_t  a {0};
+        int32_t  b {0};
+        int32_t  c {0};
+        uint32_t offset {0};
+
+        // pen advance
+        [[nodiscard]] int32_t width() const noexcept
+        { return a + b + c; }
+    };
+
+    int32_t                  height {0};
+    int32_t                  baseline {0};
+    ::std::array<glyph, 256> glyphs {};
+    span<const ::std::byte>  pixels;
+
+    [[nodiscard]] int32_t width(uint8_t character) const noexcept
+    { return glyphs[character].width(); }
+
+    // true if the pixels of <character> are inside pixels
+    [[nodiscard]] bool has_pixels(uint8_t character) const noexcept
+    {
+        const glyph& current = glyphs[character];
+        return current.b > 0 && height > 0 && current.offset <= pixels.size()
+               && static_cast<size_t>(current.b) * static_cast<size_t>(height) <= pixels.size() - current.offset;
+    }
+};
+
+namespace text_detail
+{
+
+inline constexpr size_t font_header_size = 0x1020; // sizeof(font::TFontSpec)
+
+[[nodiscard]] inline uint32_t load_u32(const ::std::byte* data) noexcept
+{
+    return static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U)
+           | (static_cast<uint32_t>(data[2]) << 16U) | (static_cast<uint32_t>(data[3]) << 24U);
+}
+
+} // namespace text_detail
+
+// Parse the .fnt file <data>, the glyph pixels are a view into <data>
+inline bool read_font_file(span<const ::std::byte> data, bitmap_font& font) noexcept
+{
+    if ( data.size() < text_detail::font_header_size )
+        return false;
+
+    font.height   = static_cast<uint8_t>(data[5]);
+    font.baseline = static_cast<int8_t>(data[6]);
+    for ( size_t i = 0; i < 256; ++i )
+    {
+        bitmap_font::glyph& current = font.glyphs[i];
+        current.a      = static_cast<int32_t>(text_detail::load_u32(data.data() + 32 + i * 12));
+        current.b      = static_cast<int32_t>(text_detail::load_u32(data.data() + 36 + i * 12));
+        current.c      = static_cast<int32_t>(text_detail::load_u32(data.data() + 40 + i * 12));
+        current.offset = text_detail::load_u32(data.data() + 3104 + i * 4);
+    }
+    font.pixels = data.subspan(text_detail::font_header_size);
+    return true;
+}
+
+// font::EJustify, the horizontal part
+enum class text_align : uint32_t
+{
+    left   = 0,
+    center = 1,
+    right  = 2
+};
+
+// Line of the laid out text: bytes [begin, end) of the string
+struct text_line
+{
+    uint32_t begin {0};
+    uint32_t end {0};
+    int32_t  x {0};
+    int32_t  width {0};
+};
+
+// Glyph to draw: the top left corner of its pixels relative to the text box
+struct text_glyph
+{
+    int16_t x {0};
+    int16_t y {0};
+    uint8_t character {0};
+    // inside {} of the game strings
+    bool    highlighted {false};
+};
+
+struct text_layout
+{
+    ::std::vector<text_line>  lines;
+    ::std::vector<text_glyph> glyphs;
+    // the widest line and the height of all the lines
+    int32_t                   width {0};
+    int32_t                   height {0};
+};
+
+// Break <text> into lines of at most <box_width> pixels and place its glyphs, the same rules as font::FillLinesVector:
+// '\n' ends a line, the lines are wrapped between the words, a word wider than the box is broken between its characters,
+// '{' and '}' turn the highlighting on and off and take no space. <box_width> <= 0: no wrapping, aligned to the widest line
+inline void layout_text(const bitmap_font& font, ::std::string_view text, int32_t box_width, text_align align, text_layout& layout)
+{
+    layout.lines.clear();
+    layout.glyphs.clear();
+    layout.width = 0;
+
+    const auto advance = [&font](char character) noexcept
+    { return character == '{' || character == '}' ? 0 : font.width(static_cast<uint8_t>(character)); };
+
+    const size_t size  = text.size();
+    size_t       begin = 0;
+    for ( ;; )
+    {
+        // add the words while they fit: <position> and <width> are the end of the last word added
+        size_t  position = begin;
+        int32_t width    = 0;
+        size_t  next     = size;
+        bool    last     = false;
+        for ( ;; )
+        {
+            if ( position == size || text[position] == '\n' )
+            {
+                last = position == size;
+                next = position + 1;
+                break;
+            }
+
+            // the spaces before the word, then the word
+            size_t  end   = position;
+            int32_t added = width;
+            while ( end < size && text[end] == ' ' )
+                added += advance(text[end++]);
+            while ( end < size && text[end] != ' ' && text[end] != '\n' )
+                added += advance(text[end++]);
+
+            if ( box_width <= 0 || added <= box_width )
+            {
+                position = end;
+                width    = added;
+                continue;
+            }
+
+            if ( position == begin )
+            {
+                // the first word of the line is wider than the box: as many characters as fit, at least one
+                do
+                    width += advance(text[position++]);
+                while ( position < end && width + advance(text[position]) <= box_width );
+                next = position;
+                last = next == size;
+                break;
+            }
+
+            // wrap before the word, the spaces at the wrap are dropped
+            next = position;
+            while ( next < size && text[next] == ' ' )
+                ++next;
+            if ( next < size && text[next] == '\n' )
+                ++next;
+            last = next == size;
+            break;
+        }
+
+        layout.lines.push_back({ static_cast<uint32_t>(begin), static_cast<uint32_t>(position), 0, width });
+        layout.width = width > layout.width ? width : layout.width;
+        if ( last )
+            break;
+        begin = next;
+    }
+
+    // alignment and the glyph positions, the highlighting goes on across the lines
+    const int32_t area        = box_width > 0 ? box_width : layout.width;
+    bool          highlighted = false;
+    for ( size_t index = 0; index < layout.lines.size(); ++index )
+    {
+        text_line& line = layout.lines[index];
+        line.x = align == text_align::center ? (area - line.width) / 2 : (align == text_align::right ? area - line.width : 0);
+
+        int32_t       pen = line.x;
+        const int32_t y   = static_cast<int32_t>(index) * font.height;
+        for ( uint32_t i = line.begin; i < line.end; ++i )
+        {
+            const char character = text[i];
+            if ( character == '{' || character == '}' )
+            {
+                highlighted = character == '{';
+                continue;
+            }
+
+            const bitmap_font::glyph& current = font.glyphs[static_cast<uint8_t>(character)];
+            if ( current.b > 0 )
+                layout.glyphs.push_back({ static_cast<int16_t>(pen + current.a), static_cast<int16_t>(y), static_cast<uint8_t>(character), highlighted });
+            pen += current.width();
+        }
+    }
+    layout.height = static_cast<int32_t>(layout.lines.size()) * font.height;
+}
+
+struct text_layout_cache_stats
+{
+    uint64_t hits {0};
+    uint64_t misses {0};
+    uint64_t evictions {0};
+    size_t   entries {0};
+
+    [[nodiscard]] double hit_rate() const noexcept
+    { return hits + misses != 0 ? static_cast<double>(hits) / static_cast<double>(hits + misses) : 0.0; }
+};
+
+// Layouts of the recently drawn strings, keyed by (font, string, box width, alignment) /
+// Кэш разметки недавно нарисованных строк.
+// The hover texts and the scroll lists lay out the same strings every frame: a hit is one hash lookup.
+// The least recently used layout is dropped beyond <max_entries>. Not thread-safe, meant for the UI thread
+class text_layout_cache
+{
+    public:
+        using layout_ptr = ::std::shared_ptr<const text_layout>;
+
+    public:
+        explicit text_layout_cache(size_t max_entries = 1024)
+            : m_max_entries { max_entries != 0 ? max_entries : 1 }
+        {}
+
+        text_layout_cache(const text_layout_cache&)            = delete;
+        text_layout_cache& operator=(const text_layout_cache&) = delete;
+
+    public:
+        layout_ptr get(const bitmap_font& font, ::std::string_view text, int32_t box_width, text_align align = text_align::left)
+        {
+            const lookup_key lookup { &font, text, box_width, align };
+            const auto found = m_entries.find(lookup);
+            if ( found != m_entries.end() )
+            {
+                ++m_stats.hits;
+                m_order.splice(m_order.begin(), m_order, found->second);
+                return found->second->layout;
+            }
+
+            ++m_stats.misses;
+            auto result = ::std::make_shared<text_layout>();
+            layout_text(font, text, box_width, align, *result);
+            m_order.push_front({ ::std::string(text), &font, box_width, align, result });
+            const node& added = m_order.front();
+            m_entries.emplace(lookup_key { added.font, added.text, added.box_width, added.align }, m_order.begin());
+            while ( m_order.size() > m_max_entries )
+            {
+                const node& victim = m_order.back();
+                m_entries.erase(lookup_key { victim.font, victim.text, victim.box_width, victim.align });
+                m_order.pop_back();
+                ++m_stats.evictions;
+            }
+            return result;
+        }
+
+        // drop the layouts of <font>, e.g. when it is disposed
+        void erase_font(const bitmap_font& font)
+        {
+            for ( auto it = m_order.begin(); it != m_order.end(); )
+            {
+                if ( it->font == &font )
+                {
+                    m_entries.erase(lookup_key { it->font, it->text, it->box_width, it->align });
+                    it = m_order.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+
+        void clear()
+        {
+            m_entries.clear();
+            m_order.clear();
+        }
+
+        [[nodiscard]] text_layout_cache_stats stats() const noexcept
+        {
+            text_layout_cache_stats result = m_stats;
+            result.entries = m_order.size();
+            return result;
+        }
+
+        void reset_stats() noexcept
+        { m_stats = text_layout_cache_stats {}; }
+
+    protected:
+        struct node
+        {
+            ::std::string      text;
+            const bitmap_font* font;
+            int32_t            box_width;
+            text_align         align;
+            layout_ptr         layout;
+        };
+
+        // the text is a view of node::text, or of the argument of get() while looking up
+        struct lookup_key
+        {
+            const bitmap_font* font;
+            ::std::string_view text;
+            int32_t            box_width;
+            text_align         align;
+
+            [[nodiscard]] bool operator==(const lookup_key& other) const noexcept
+            { return font == other.font && box_width == other.box_width && align == other.align && text == other.text; }
+        };
+
+        struct lookup_hash
+        {
+            [[nodiscard]] size_t operator()(const lookup_key& key) const noexcept
+            {
+                uint64_t value = ::std::hash<::std::string_view>{}(key.text);
+                value ^= (static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key.font))
+                          + (static_cast<uint64_t>(static_cast<uint32_t>(key.box_width)) << 2U) + static_cast<uint32_t>(key.align)) * 0x9E3779B97F4A7C15ULL;
+                value ^= value >> 29U;
+                return static_cast<size_t>(value);
+            }
+        };
+
+    protected:
+        size_t                                                                       m_max_entries;
+        // the most recently used first
+        ::std::list<node>                                                            m_order;
+        ::std::unordered_map<lookup_key, ::std::list<node>::iterator, lookup_hash> m_entries;
+        text_layout_cache_stats                                                      m_stats;
+
+};
+
+// Glyphs of a font rasterized in one color scheme(font::TColor) /
+// Символы шрифта, заранее отрисованные в одной цветовой схеме(font::TColor).
+// The pixels are resolved to the text and the shadow colors once,
+// drawing a glyph only copies its opaque pixels
+template<class Pixel>
+class glyph_atlas
+{
+    public:
+        glyph_atlas(const bitmap_font& font, Pixel text, Pixel shadow)
+            : m_height { font.height }
+        {
+            for ( size_t character = 0; character < 256; ++character )
+            {
+                if ( !font.has_pixels(static_cast<uint8_t>(character)) )
+                    continue;
+
+                const bitmap_font::glyph& current = font.glyphs[character];
+                const size_t              size    = static_cast<size_t>(current.b) * static_cast<size_t>(font.height);
+                m_entries[character] = { static_cast<uint32_t>(m_pixels.size()), current.b };
+                for ( size_t i = 0; i < size; ++i )
+                {
+                    const uint8_t value = static_cast<uint8_t>(font.pixels[current.offset + i]);
+                    m_pixels.push_back(value == 1 ? shadow : text);
+                    m_mask.push_back(value != 0 ? 0xFF : 0);
+                }
+            }
+        }
+
+    public:
+        // Draw <character> with the top left corner of its pixels at (x, y), clipped to <target>
+        void draw(const surface_view<Pixel>& target, int32_t x, int32_t y, uint8_t character) const noexcept
+        {
+            const entry& current = m_entries[character];
+            if ( current.width <= 0 )
+                return;
+
+            const int32_t left   = x < 0 ? -x : 0;
+            const int32_t right  = current.width < target.width - x ? current.width : target.width - x;
+            const int32_t top    = y < 0 ? -y : 0;
+            const int32_t bottom = m_height < target.height - y ? m_height : target.height - y;
+            for ( int32_t row = top; row < bottom; ++row )
+            {
+                const size_t         start  = current.offset + static_cast<size_t>(row) * static_cast<size_t>(current.width);
+                const Pixel* const   pixels = m_pixels.data() + start;
+                const uint8_t* const mask   = m_mask.data() + start;
+                Pixel* const         out    = target.row(y + row) + x;
+                for ( int32_t column = left; column < right; ++column )
+                    if ( mask[column] != 0 )
+                        out[column] = pixels[column];
+            }
+        }
+
+        // Draw <layout> with its box at (x, y), the highlighted glyphs are taken from <highlight> if it is given
+        void draw(const surface_view<Pixel>& target, int32_t x, int32_t y, const text_layout& layout,
+                  const glyph_atlas* highlight = nullptr) const noexcept
+        {
+            for ( const text_glyph& glyph : layout.glyphs )
+                (glyph.highlighted && highlight != nullptr ? highlight : this)->draw(target, x + glyph.x, y + glyph.y, glyph.character);
+        }
+
+        [[nodiscard]] int32_t height() const noexcept
+        { return m_height; }
+
+    protected:
+        struct entry
+        {
+            uint32_t offset {0};
+            int32_t  width {0};
+        };
+
+    protected:
+        int32_t                  m_height {0};
+        ::std::array<entry, 256> m_entries {};
+        ::std::vector<Pixel>     m_pixels;
+        ::std::vector<uint8_t>   m_mask;
+
+};
+
+} // namespace nh3api
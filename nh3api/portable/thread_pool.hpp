@@ -0,0 +1,210 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <deque>              // std::deque
+#include <exception>          // std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <functional>         // std::function
+#include <memory>             // std::shared_ptr, std::make_shared
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <utility>            // std::forward, std::move
+#include <vector>             // std::vector
+
+// C++ exceptions are enabled: parallel_for() passes the exceptions of its function to the calling thread
+#if !defined(NH3API_FLAG_NO_CPP_EXCEPTIONS) && (defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND))
+    #define NH3API_PORTABLE_EXCEPTIONS 1
+#else
+    #define NH3API_PORTABLE_EXCEPTIONS 0
+#endif
+
+namespace nh3api
+{
+
+// Fixed-size pool of worker threads with a FIFO task queue.
+// The tasks of submit() must not throw: an exception escaping a task terminates the program
+class thread_pool
+{
+    public:
+        // <thread_count> == 0: one thread per hardware thread
+        explicit thread_pool(size_t thread_count = 0)
+        {
+            if ( thread_count == 0 )
+                thread_count = ::std::thread::hardware_concurrency();
+            if ( thread_count == 0 )
+                thread_count = 1;
+
+            m_workers.reserve(thread_count);
+            for ( size_t i = 0; i < thread_count; ++i )
+                m_workers.emplace_back([this]() { worker_loop(); });
+        }
+
+        thread_pool(const thread_pool&)            = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+
+        ~thread_pool() noexcept
+        {
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_task_ready.notify_all();
+            for ( ::std::thread& worker : m_workers )
+                worker.join();
+        }
+
+    public:
+        [[nodiscard]] size_t size() const noexcept
+        { return m_workers.size(); }
+
+        // queue <task> for execution
+        template<class F>
+        void submit(F&& task)
+        {
+            {
+                ::std::lock_guard<::std::mutex> lock(m_mutex);
+                m_tasks.emplace_back(::std::forward<F>(task));
+                ++m_pending;
+            }
+            m_task_ready.notify_one();
+        }
+
+        // block until every submitted task has finished
+        void wait()
+        {
+            ::std::unique_lock<::std::mutex> lock(m_mutex);
+            m_all_done.wait(lock, [this]() { return m_pending == 0; });
+        }
+
+        // call <fn>(i) for i in [0, count) on the calling thread and the pool threads, return when every call has returned.
+        // Indices are handed out one by one, so uneven work items balance themselves.
+        // Waits only for its own calls: other tasks may run meanwhile, and a pool task may call parallel_for() too.
+        // The first exception thrown by <fn> stops handing out indices and is rethrown here
+        template<class F>
+        void parallel_for(size_t count, F&& fn)
+        {
+            if ( count == 0 )
+                return;
+
+            // the helpers which did not start before the calling thread finished may outlive this call
+            const auto   state   = ::std::make_shared<parallel_state>();
+            const size_t helpers = count - 1 < size() ? count - 1 : size();
+            for ( size_t i = 0; i < helpers; ++i )
+            {
+                submit([state, &fn, count]()
+                {
+                    {
+                        ::std::lock_guard<::std::mutex> lock(state->mutex);
+                        if ( state->closed )
+                            return;
+                        ++state->active;
+                    }
+                    run_indices(*state, fn, count);
+                    {
+                        ::std::lock_guard<::std::mutex> lock(state->mutex);
+                        --state->active;
+                    }
+                    state->idle.notify_all();
+                });
+            }
+
+            run_indices(*state, fn, count);
+            {
+                ::std::unique_lock<::std::mutex> lock(state->mutex);
+                state->closed = true;
+                state->idle.wait(lock, [&state]() { return state->active == 0; });
+            }
+        #if NH3API_PORTABLE_EXCEPTIONS
+            if ( state->error )
+                ::std::rethrow_exception(state->error);
+        #endif
+        }
+
+    protected:
+        struct parallel_state
+        {
+            ::std::atomic<size_t>     next {0};
+            ::std::atomic<bool>       failed {false};
+            ::std::mutex              mutex;
+            ::std::condition_variable idle;
+            // helpers running the indices, no helper starts once the call is closed
+            size_t                    active {0};
+            bool                      closed {false};
+            ::std::exception_ptr      error;
+        };
+
+        template<class F>
+        static void run_indices(parallel_state& state, F& fn, size_t count)
+        {
+            for ( size_t index = state.next.fetch_add(1, ::std::memory_order_relaxed);
+                  index < count && !state.failed.load(::std::memory_order_relaxed);
+                  index = state.next.fetch_add(1, ::std::memory_order_relaxed) )
+            {
+            #if NH3API_PORTABLE_EXCEPTIONS
+                try
+                {
+                    fn(index);
+                }
+                catch ( ... )
+                {
+                    ::std::lock_guard<::std::mutex> lock(state.mutex);
+                    if ( !state.error )
+                        state.error = ::std::current_exception();
+                    state.failed.store(true, ::std::memory_order_relaxed);
+                }
+            #else
+                fn(index);
+            #endif
+            }
+        }
+
+        void worker_loop()
+        {
+            for ( ;; )
+            {
+                ::std::function<void()> task;
+                {
+                    ::std::unique_lock<::std::mutex> lock(m_mutex);
+                    m_task_ready.wait(lock, [this]() { return m_stop || !m_tasks.empty(); });
+                    if ( m_tasks.empty() )
+                        return; // stopped and drained
+
+                    task = ::std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+
+                task();
+
+                bool all_done = false;
+                {
+                    ::std::lock_guard<::std::mutex> lock(m_mutex);
+                    all_done = --m_pending == 0;
+                }
+                if ( all_done )
+                    m_all_done.notify_all();
+            }
+        }
+
+    protected:
+        ::std::vector<::std::thread>          m_workers;
+        ::std::deque<::std::function<void()>> m_tasks;
+        ::std::mutex                          m_mutex;
+        ::std::condition_variable             m_task_ready;
+        ::std::condition_variable             m_all_done;
+        size_t                                m_pending {0};
+        bool                                  m_stop {false};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,480 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// This header does not depend on the game executable and can be used on any platform
+
+#include <algorithm>    // std::sort
+#include <cstdio>       // std::fopen, std::fread, std::fclose
+#include <filesystem>   // std::filesystem
+#include <iterator>     // std::make_move_iterator
+#include <memory>       // std::unique_ptr
+#include <string>       // std::string
+#include <string_view>  // std::string_view
+#include <system_error> // std::error_code
+#include <utility>      // std::pair
+#include <vector>       // std::vector
+
+#include "inflate.hpp"         // nh3api::zlib_uncompress
+#include "lod_archive.hpp"     // nh3api::lod_archive
+#include "lod_entry_cache.hpp" // nh3api::lod_entry_cache
+#include "name_index.hpp"      // nh3api::name_index
+
+namespace nh3api
+{
+
+enum class vfs_source : int32_t
+{
+    directory = 0, // loose files
+    archive   = 1, // LOD archive
+    overrides = 2  // explicit name -> file mapping, e.g. HD Mod FileTree results
+};
+
+// resolved resource.
+// The names, the paths and the archive entry point into the vfs: they become invalid after refresh() and remove_layer()
+struct vfs_entry
+{
+    vfs_source         source;
+    uint32_t           layer;
+    ::std::string_view name;
+    // file path for the loose files and the overrides, archive path for the LOD entries
+    ::std::string_view path;
+    // LOD entries only
+    const lod_archive* archive;
+    const LODEntry*    lod_entry;
+};
+
+// Layered virtual file system /
+// Многоуровневая виртуальная файловая система.
+// Merges loose directories, LOD archives and name overrides into one case-insensitive name index:
+// a lookup is a single hash probe instead of walking every source in turn like GetLODFile + HD::FileTree::FindPath do.
+// The layer with the highest priority wins, of the layers with equal priority the one added later wins.
+// refresh() rescans only the directories and archives which changed on disk
+// and re-resolves only the names of those layers.
+class vfs
+{
+    public:
+        static inline constexpr uint32_t invalid_layer = UINT32_MAX;
+
+    public:
+        vfs() noexcept = default;
+        vfs(const vfs&)                = delete;
+        vfs& operator=(const vfs&)     = delete;
+        vfs(vfs&&) noexcept            = default;
+        vfs& operator=(vfs&&) noexcept = default;
+        ~vfs() noexcept                = default;
+
+    public:
+        // add the files of <directory>, returns the layer id or invalid_layer if it is not a directory
+        uint32_t add_directory(const ::std::filesystem::path& directory, int32_t priority = 0, bool recursive = false)
+        {
+            ::std::error_code error;
+            if ( !::std::filesystem::is_directory(directory, error) )
+                return invalid_layer;
+
+            layer& added    = new_layer(vfs_source::directory, directory, priority);
+            added.recursive = recursive;
+            scan(added);
+            return merge_new_layer(added);
+        }
+
+        // add the entries of LOD archive, returns the layer id or invalid_layer if it can't be opened
+        uint32_t add_archive(const ::std::filesystem::path& path, int32_t priority = 0)
+        {
+            layer& added  = new_layer(vfs_source::archive, path, priority);
+            added.archive = ::std::make_unique<lod_archive>();
+            scan(added);
+            if ( !added.archive->is_open() )
+            {
+                m_layers.pop_back();
+                --m_next_order;
+                return invalid_layer;
+            }
+
+            return merge_new_layer(added);
+        }
+
+        // add explicit (name, file path) pairs
+        uint32_t add_overrides(const ::std::vector<::std::pair<::std::string, ::std::string>>& files, int32_t priority = 0)
+        {
+            layer& added = new_layer(vfs_source::overrides, {}, priority);
+            for ( const auto& [name, path] : files )
+                add_name(added, name, path);
+
+            return merge_new_layer(added);
+        }
+
+        // remove the layer, the names it provided fall back to the lower layers
+        bool remove_layer(uint32_t id)
+        {
+            if ( id >= m_layers.size() || !m_layers[id] )
+                return false;
+
+            const ::std::vector<::std::string> names = layer_names(*m_layers[id]);
+            detach(*m_layers[id]);
+            m_layers[id].reset();
+            resolve(names);
+            return true;
+        }
+
+        // rescan the directories and archives changed on disk since the last scan, returns true if any layer changed
+        bool refresh()
+        {
+            bool changed = false;
+            for ( auto& current : m_layers )
+                if ( current && current->source != vfs_source::overrides && current->stamp != stamp_of(*current) )
+                    changed |= rescan(*current);
+
+            return changed;
+        }
+
+        // unconditionally rescan layer <id>
+        bool refresh(uint32_t id)
+        {
+            if ( id >= m_layers.size() || !m_layers[id] || m_layers[id]->source == vfs_source::overrides )
+                return false;
+
+            return rescan(*m_layers[id]);
+        }
+
+        // number of unique names
+        [[nodiscard]] size_t size() const noexcept
+        { return m_index.size(); }
+
+        [[nodiscard]] bool exist(::std::string_view name) const noexcept
+        { return m_index.find(name, record_name_of { this }) != name_index::npos; }
+
+        // resolve <name>, returns false if no layer has it
+        [[nodiscard]] bool find(::std::string_view name, vfs_entry& result) const noexcept
+        {
+            const uint32_t found = m_index.find(name, record_name_of { this });
+            if ( found == name_index::npos )
+                return false;
+
+            const record& current = m_records[found];
+            const layer&  owner   = *m_layers[current.layer];
+            result.source    = owner.source;
+            result.layer     = current.layer;
+            result.name      = name_of(owner, current.local);
+            result.archive   = owner.archive.get();
+            result.lod_entry = owner.archive ? &owner.archive->entries()[current.local] : nullptr;
+            result.path      = owner.archive ? ::std::string_view { owner.path } : ::std::string_view { owner.files[current.local] };
+            return true;
+        }
+
+        // read the resource into <output>, LOD entries are decompressed.
+        // Returns false if there is no such resource or it can't be read
+        bool read(::std::string_view name, ::std::vector<::std::byte>& output) const
+        {
+            vfs_entry entry {};
+            output.clear();
+            if ( !find(name, entry) )
+                return false;
+
+            if ( entry.archive != nullptr )
+            {
+                const span<const ::std::byte> stored = entry.archive->stored_data(*entry.lod_entry);
+                if ( stored.size() != lod_stored_size(*entry.lod_entry) )
+                    return false;
+
+                if ( !lod_archive::is_compressed(*entry.lod_entry) )
+                {
+                    output.assign(stored.begin(), stored.end());
+                    return true;
+                }
+
+                return zlib_uncompress(stored, output, entry.lod_entry->size, entry.lod_entry->size) == inflate_status::ok;
+            }
+
+            ::std::FILE* const file = ::std::fopen(::std::string { entry.path }.c_str(), "rb");
+            if ( file == nullptr )
+                return false;
+
+            bool result = true;
+            for ( ::std::byte buffer[4096];; )
+            {
+                const size_t read = ::std::fread(buffer, 1, sizeof(buffer), file);
+                output.insert(output.end(), buffer, buffer + read);
+                if ( read != sizeof(buffer) )
+                {
+                    result = ::std::ferror(file) == 0;
+                    break;
+                }
+            }
+
+            ::std::fclose(file);
+            return result;
+        }
+
+        // read the resource through <cache>: LOD entries are decompressed once and shared, loose files are read every time
+        [[nodiscard]] lod_entry_cache::blob read(::std::string_view name, lod_entry_cache& cache) const
+        {
+            vfs_entry entry {};
+            if ( !find(name, entry) )
+                return nullptr;
+
+            auto load = [this, name]() -> lod_entry_cache::blob
+            {
+                auto result = ::std::make_shared<::std::vector<::std::byte>>();
+                return read(name, *result) ? result : nullptr;
+            };
+
+            if ( entry.archive == nullptr )
+                return load();
+
+            const lod_entry_key key = lod_entry_cache::key_of(entry.archive, *entry.lod_entry, entry.archive->generation());
+            return cache.get_or_load(key, load, static_cast<double>(lod_stored_size(*entry.lod_entry)));
+        }
+
+    protected:
+        // modification times of the scanned directories or the archive
+        using file_stamps = ::std::vector<::std::filesystem::file_time_type>;
+
+        struct layer
+        {
+            vfs_source                     source;
+            ::std::string                  path;
+            int32_t                        priority {0};
+            // insertion order, breaks the priority ties
+            uint32_t                       order {0};
+            uint32_t                       id {0};
+            bool                           recursive {false};
+            // directories and overrides: names and file paths
+            ::std::vector<::std::string>   names;
+            ::std::vector<::std::string>   files;
+            ::std::unique_ptr<lod_archive> archive;
+            // layer-local name -> position in names or in the archive table
+            name_index                     index;
+            file_stamps                    stamp;
+        };
+
+        // merged index value: winning layer and the position inside it
+        struct record
+        {
+            uint32_t layer;
+            uint32_t local;
+        };
+
+        struct record_name_of
+        {
+            const vfs* self;
+
+            [[nodiscard]] ::std::string_view operator()(uint32_t index) const noexcept
+            {
+                const record& current = self->m_records[index];
+                return name_of(*self->m_layers[current.layer], current.local);
+            }
+        };
+
+        struct local_name_of
+        {
+            const layer* owner;
+
+            [[nodiscard]] ::std::string_view operator()(uint32_t index) const noexcept
+            { return name_of(*owner, index); }
+        };
+
+        [[nodiscard]] static ::std::string_view name_of(const layer& owner, uint32_t local) noexcept
+        { return owner.archive ? lod_entry_name(owner.archive->entries()[local]) : ::std::string_view { owner.names[local] }; }
+
+        [[nodiscard]] static ::std::vector<::std::string> layer_names(const layer& owner)
+        {
+            ::std::vector<::std::string> result;
+            const size_t count = owner.archive ? owner.archive->size() : owner.names.size();
+            result.reserve(count);
+            for ( uint32_t i = 0; i < count; ++i )
+                result.emplace_back(name_of(owner, i));
+
+            return result;
+        }
+
+        [[nodiscard]] static bool outranks(const layer& lhs, const layer& rhs) noexcept
+        { return lhs.priority != rhs.priority ? lhs.priority > rhs.priority : lhs.order > rhs.order; }
+
+        layer& new_layer(vfs_source source, const ::std::filesystem::path& path, int32_t priority)
+        {
+            auto added      = ::std::make_unique<layer>();
+            added->source   = source;
+            added->path     = path.string();
+            added->priority = priority;
+            added->order    = m_next_order++;
+            added->id       = static_cast<uint32_t>(m_layers.size());
+            m_layers.push_back(::std::move(added));
+            return *m_layers.back();
+        }
+
+        static void add_name(layer& owner, ::std::string name, ::std::string file)
+        {
+            const uint32_t local = static_cast<uint32_t>(owner.names.size());
+            owner.names.push_back(::std::move(name));
+            if ( owner.index.insert(owner.names.back(), local, local_name_of { &owner }) != local )
+                owner.names.pop_back(); // duplicate name: the first one wins
+            else
+                owner.files.push_back(::std::move(file));
+        }
+
+        [[nodiscard]] static file_stamps stamp_of(const layer& owner)
+        {
+            file_stamps       result;
+            ::std::error_code error;
+            result.push_back(::std::filesystem::last_write_time(owner.path, error));
+            if ( owner.source == vfs_source::directory && owner.recursive )
+            {
+                for ( ::std::filesystem::recursive_directory_iterator it(owner.path, error), end; !error && it != end; it.increment(error) )
+                    if ( it->is_directory(error) )
+                        result.push_back(it->last_write_time(error));
+            }
+
+            return result;
+        }
+
+        // (re)build the layer-local name table from the disk
+        static void scan(layer& owner)
+        {
+            owner.stamp = stamp_of(owner);
+            owner.index.clear();
+            owner.names.clear();
+            owner.files.clear();
+            if ( owner.source == vfs_source::archive )
+            {
+                if ( !owner.archive->open(owner.path.c_str()) )
+                    return;
+
+                // the archive has its own index, keep only the layer-local names
+                const span<const LODEntry> entries = owner.archive->entries();
+                owner.index.reserve(entries.size());
+                for ( uint32_t i = 0; i < entries.size(); ++i )
+                    owner.index.insert(lod_entry_name(entries[i]), i, local_name_of { &owner });
+                return;
+            }
+
+            // sorted, so that the duplicates found by the recursive scan resolve the same way on every platform
+            ::std::vector<::std::filesystem::path> paths;
+            ::std::error_code error;
+            if ( owner.recursive )
+            {
+                for ( ::std::filesystem::recursive_directory_iterator it(owner.path, error), end; !error && it != end; it.increment(error) )
+                    if ( it->is_regular_file(error) )
+                        paths.push_back(it->path());
+            }
+            else
+            {
+                for ( ::std::filesystem::directory_iterator it(owner.path, error), end; !error && it != end; it.increment(error) )
+                    if ( it->is_regular_file(error) )
+                        paths.push_back(it->path());
+            }
+            ::std::sort(paths.begin(), paths.end());
+
+            owner.index.reserve(paths.size());
+            for ( const ::std::filesystem::path& path : paths )
+                add_name(owner, path.filename().string(), path.string());
+        }
+
+        // index every name of the new layer which outranks the current winner
+        uint32_t merge_new_layer(const layer& added)
+        {
+            const size_t count = added.archive ? added.archive->size() : added.names.size();
+            m_index.reserve(m_index.size() + count);
+            for ( uint32_t local = 0; local < count; ++local )
+            {
+                // skip the names shadowed inside the layer
+                const ::std::string_view name = name_of(added, local);
+                if ( added.index.find(name, local_name_of { &added }) != local )
+                    continue;
+
+                const uint32_t found = m_index.find(name, record_name_of { this });
+                if ( found == name_index::npos )
+                    m_index.insert(name, new_record({ added.id, local }), record_name_of { this });
+                else if ( outranks(added, *m_layers[m_records[found].layer]) )
+                    m_records[found] = { added.id, local };
+            }
+
+            return added.id;
+        }
+
+        uint32_t new_record(record value)
+        {
+            if ( !m_free_records.empty() )
+            {
+                const uint32_t index = m_free_records.back();
+                m_free_records.pop_back();
+                m_records[index] = value;
+                return index;
+            }
+
+            m_records.push_back(value);
+            return static_cast<uint32_t>(m_records.size() - 1);
+        }
+
+        // remove the names won by <owner> from the merged index, while the layer names are still valid
+        void detach(const layer& owner)
+        {
+            const size_t count = owner.archive ? owner.archive->size() : owner.names.size();
+            for ( uint32_t local = 0; local < count; ++local )
+            {
+                const ::std::string_view name  = name_of(owner, local);
+                const uint32_t           found = m_index.find(name, record_name_of { this });
+                if ( found != name_index::npos && m_records[found].layer == owner.id )
+                {
+                    m_index.erase(name, record_name_of { this });
+                    m_free_records.push_back(found);
+                }
+            }
+        }
+
+        // find the winning layer of each name in <names> from scratch
+        void resolve(const ::std::vector<::std::string>& names)
+        {
+            ::std::vector<const layer*> ranked;
+            for ( const auto& current : m_layers )
+                if ( current )
+                    ranked.push_back(current.get());
+            ::std::sort(ranked.begin(), ranked.end(), [](const layer* lhs, const layer* rhs) { return outranks(*lhs, *rhs); });
+
+            for ( const ::std::string& name : names )
+            {
+                for ( const layer* const candidate : ranked )
+                {
+                    const uint32_t local = candidate->index.find(name, local_name_of { candidate });
+                    if ( local == name_index::npos )
+                        continue;
+
+                    const uint32_t found = m_index.find(name, record_name_of { this });
+                    if ( found == name_index::npos )
+                        m_index.insert(name, new_record({ candidate->id, local }), record_name_of { this });
+                    else
+                        m_records[found] = { candidate->id, local };
+                    break;
+                }
+            }
+        }
+
+        bool rescan(layer& owner)
+        {
+            ::std::vector<::std::string> names = layer_names(owner);
+            detach(owner);
+            scan(owner);
+
+            ::std::vector<::std::string> added = layer_names(owner);
+            names.insert(names.end(), ::std::make_move_iterator(added.begin()), ::std::make_move_iterator(added.end()));
+            resolve(names);
+            return true;
+        }
+
+    protected:
+        ::std::vector<::std::unique_ptr<layer>> m_layers;
+        ::std::vector<record>                   m_records;
+        ::std::vector<uint32_t>                 m_free_records;
+        name_index                              m_index;
+        uint32_t                                m_next_order {0};
+
+};
+
+} // namespace nh3api
@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// decode_def_frame against decode_def_frame_scalar on random frames of every encoding, intact and damaged
+
+#include <cstdint> // uint8_t, uint32_t
+#include <cstring> // std::memcmp
+#include <vector>  // std::vector
+
+#include "nh3api/portable/def_sprite.hpp" // nh3api::decode_def_frame
+#include "test.hpp"
+
+using nh3api::def_encoding;
+
+namespace
+{
+
+// bytes past each row, the decoders must not touch them
+constexpr size_t  row_padding = 40;
+constexpr uint8_t guard       = 0xA5;
+
+void put_u16(std::vector<uint8_t>& data, size_t offset, size_t value)
+{
+    data[offset]     = static_cast<uint8_t>(value);
+    data[offset + 1] = static_cast<uint8_t>(value >> 8U);
+}
+
+// one row of runs of <width> pixels: long runs are a code byte and a length byte(0xFF: literal),
+// short ones a byte of 3-bit code and 5-bit length(7: literal)
+void encode_row(nh3api_test::random& random, std::vector<uint8_t>& data, size_t width, bool long_runs)
+{
+    // short and long runs, the vector stores only matter for the long ones
+    const uint32_t max_length = long_runs ? 256 : 32;
+    for ( size_t x = 0; x < width; )
+    {
+        size_t length = random.below(4) == 0 ? 1 + random.below(max_length) : 1 + random.below(8);
+        if ( length > width - x )
+            length = width - x;
+
+        const bool literal = random.below(3) == 0;
+        if ( long_runs )
+        {
+            data.push_back(literal ? 0xFF : static_cast<uint8_t>(random.below(255)));
+            data.push_back(static_cast<uint8_t>(length - 1));
+        }
+        else
+            data.push_back(static_cast<uint8_t>(((literal ? 7U : random.below(7)) << 5U) | (length - 1)));
+
+        if ( literal )
+            for ( size_t i = 0; i < length; ++i )
+                data.push_back(static_cast<uint8_t>(random.next()));
+        x += length;
+    }
+}
+
+std::vector<uint8_t> encode_frame(nh3api_test::random& random, def_encoding encoding, size_t width, size_t height)
+{
+    std::vector<uint8_t> data;
+    switch ( encoding )
+    {
+        case def_encoding::raw:
+            for ( size_t i = 0; i < width * height; ++i )
+                data.push_back(static_cast<uint8_t>(random.next()));
+            break;
+
+        case def_encoding::general_rle:
+            data.resize(height * 4);
+            for ( size_t y = 0; y < height; ++y )
+            {
+                put_u16(data, y * 4, data.size() & 0xFFFFU);
+                put_u16(data, y * 4 + 2, data.size() >> 16U);
+                encode_row(random, data, width, true);
+            }
+            break;
+
+        case def_encoding::tileset_rle:
+            data.resize(2);
+            put_u16(data, 0, 2);
+            for ( size_t y = 0; y < height; ++y )
+                encode_row(random, data, width, false);
+            break;
+
+        case def_encoding::adv_obj_rle:
+        {
+            const size_t blocks = width / 32;
+            data.resize(height * blocks * 2);
+            for ( size_t y = 0; y < height; ++y )
+            {
+                // only the offset of the first block of a row is used
+                put_u16(data, y * blocks * 2, data.size());
+                encode_row(random, data, width, false);
+            }
+            break;
+        }
+    }
+    return data;
+}
+
+// decode <data> with both decoders, the results and the decoded pixels must be the same
+void compare(const nh3api::def_frame_header& header, const std::vector<uint8_t>& data, bool intact)
+{
+    nh3api::def_frame frame;
+    frame.header = header;
+    frame.data   = { reinterpret_cast<const std::byte*>(data.data()), data.size() };
+
+    const size_t         width  = static_cast<size_t>(header.cropped_width);
+    const size_t         pitch  = width + row_padding;
+    std::vector<uint8_t> vector(pitch * static_cast<size_t>(header.cropped_height) + row_padding, guard);
+    std::vector<uint8_t> scalar(vector);
+    const bool vector_result = nh3api::decode_def_frame(frame, vector.data(), pitch);
+    const bool scalar_result = nh3api::decode_def_frame_scalar(frame, scalar.data(), pitch);
+    NH3API_CHECK(vector_result == scalar_result);
+    if ( intact )
+        NH3API_CHECK(vector_result);
+
+    // a failed decode leaves the output partially written, the rows may differ in the bytes the later runs would overwrite
+    if ( vector_result && scalar_result )
+        NH3API_CHECK(std::memcmp(vector.data(), scalar.data(), vector.size()) == 0);
+
+    bool padding_intact = true;
+    for ( size_t y = 0; y < static_cast<size_t>(header.cropped_height); ++y )
+        for ( size_t x = width; x < pitch; ++x )
+            padding_intact = padding_intact && vector[y * pitch + x] == guard && scalar[y * pitch + x] == guard;
+    NH3API_CHECK(padding_intact);
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_test::random random(0x4E48334445463131ULL);
+    constexpr def_encoding encodings[] = { def_encoding::raw, def_encoding::general_rle, def_encoding::tileset_rle, def_encoding::adv_obj_rle };
+    for ( int iteration = 0; iteration < 2000; ++iteration )
+    {
+        const def_encoding encoding = encodings[iteration % 4];
+        nh3api::def_frame_header header;
+        header.encoding = encoding;
+        // adv_obj_rle stores whole 32-pixel blocks
+        header.cropped_width  = static_cast<int32_t>(encoding == def_encoding::adv_obj_rle ? 32 * (1 + random.below(8)) : 1 + random.below(300));
+        header.cropped_height = static_cast<int32_t>(1 + random.below(24));
+        header.width          = header.cropped_width;
+        header.height         = header.cropped_height;
+
+        std::vector<uint8_t> data = encode_frame(random, encoding, static_cast<size_t>(header.cropped_width), static_cast<size_t>(header.cropped_height));
+        header.data_size = static_cast<uint32_t>(data.size());
+        compare(header, data, true);
+
+        // damaged copies: random bytes changed, then cut
+        for ( int damage = 0; damage < 4; ++damage )
+        {
+            std::vector<uint8_t> damaged = data;
+            const uint32_t changes = 1 + random.below(8);
+            for ( uint32_t i = 0; i < changes && !damaged.empty(); ++i )
+                damaged[random.below(static_cast<uint32_t>(damaged.size()))] = static_cast<uint8_t>(random.next());
+            if ( damage % 2 == 1 )
+                damaged.resize(random.below(static_cast<uint32_t>(damaged.size()) + 1));
+            compare(header, damaged, false);
+        }
+    }
+
+    return nh3api_test::result("def_decoder_test");
+}
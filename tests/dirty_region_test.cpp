@@ -0,0 +1,170 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// dirty_region: rects() disjoint and covering exactly the clipped requests, the merging of stacked rows, the bounding box and the flush stats
+
+#include <cstdint> // uint8_t, int32_t, uint64_t
+#include <vector>  // std::vector
+
+#include "nh3api/portable/dirty_region.hpp" // nh3api::dirty_region
+#include "test.hpp"
+
+using nh3api::dirty_rect;
+
+namespace
+{
+
+constexpr dirty_rect screen { 0, 0, 80, 60 };
+
+// marks of the pixels of the screen, one per pixel
+class coverage
+{
+    public:
+        coverage()
+            : m_marks(size_t(screen.width) * size_t(screen.height), 0)
+        {}
+
+        // the requested rectangle clipped to the screen
+        void fill(int32_t x, int32_t y, int32_t width, int32_t height)
+        {
+            for ( int32_t row = y; row < y + height; ++row )
+                for ( int32_t column = x; column < x + width; ++column )
+                    if ( column >= 0 && column < screen.width && row >= 0 && row < screen.height )
+                        m_marks[index(column, row)] = 1;
+        }
+
+        // counts the marks of the rectangle, false if it leaves the screen
+        bool count(const dirty_rect& rect)
+        {
+            if ( rect.width <= 0 || rect.height <= 0 || rect.x < 0 || rect.y < 0 || rect.x + rect.width > screen.width
+                 || rect.y + rect.height > screen.height )
+                return false;
+            for ( int32_t row = rect.y; row < rect.y + rect.height; ++row )
+                for ( int32_t column = rect.x; column < rect.x + rect.width; ++column )
+                    ++m_marks[index(column, row)];
+            return true;
+        }
+
+        const std::vector<uint8_t>& marks() const noexcept
+        { return m_marks; }
+
+    protected:
+        static size_t index(int32_t x, int32_t y) noexcept
+        { return size_t(y) * size_t(screen.width) + size_t(x); }
+
+        std::vector<uint8_t> m_marks;
+};
+
+// random requests, some of them across or outside the screen: every requested pixel is covered by exactly one rectangle
+void test_random(uint64_t seed)
+{
+    nh3api_test::random random(seed);
+    size_t mismatches = 0;
+    for ( size_t i = 0; i < 300; ++i )
+    {
+        nh3api::dirty_region region(screen, 1000);
+        coverage requested;
+        const size_t count = 1 + random.below(12);
+        for ( size_t j = 0; j < count; ++j )
+        {
+            const int32_t x      = static_cast<int32_t>(random.below(100)) - 10;
+            const int32_t y      = static_cast<int32_t>(random.below(80)) - 10;
+            const int32_t width  = static_cast<int32_t>(random.below(40));
+            const int32_t height = static_cast<int32_t>(random.below(30));
+            region.add(x, y, width, height);
+            requested.fill(x, y, width, height);
+        }
+
+        // the marks become 2 where a requested pixel is covered once, the others must stay 0
+        coverage covered = requested;
+        for ( const dirty_rect& rect : region.rects() )
+            mismatches += !covered.count(rect);
+        for ( size_t j = 0; j < covered.marks().size(); ++j )
+            mismatches += covered.marks()[j] != (requested.marks()[j] ? 2 : 0);
+
+        bool any = false;
+        for ( const uint8_t mark : requested.marks() )
+            any = any || mark != 0;
+        mismatches += region.empty() == any;
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+bool same(const dirty_rect& lhs, const dirty_rect& rhs)
+{ return lhs.x == rhs.x && lhs.y == rhs.y && lhs.width == rhs.width && lhs.height == rhs.height; }
+
+void test_merging()
+{
+    // a dialog redrawn row by row, in any order
+    nh3api::dirty_region region(screen);
+    for ( const int32_t row : { 3, 0, 4, 1, 2 } )
+        region.add(10, 20 + row * 5, 30, 5);
+    std::vector<dirty_rect> rects = region.rects();
+    NH3API_CHECK(rects.size() == 1 && same(rects[0], { 10, 20, 30, 25 }));
+
+    // side by side spans touching each other become one
+    region.clear();
+    region.add(0, 0, 10, 10);
+    region.add(10, 0, 10, 10);
+    rects = region.rects();
+    NH3API_CHECK(rects.size() == 1 && same(rects[0], { 0, 0, 20, 10 }));
+
+    // more rectangles than max_rects: the bounding box
+    nh3api::dirty_region limited(screen, 3);
+    for ( int32_t i = 0; i < 4; ++i )
+        limited.add(i * 10, i * 10, 5, 5);
+    rects = limited.rects();
+    NH3API_CHECK(rects.size() == 1 && same(rects[0], { 0, 0, 35, 35 }));
+    limited.clear();
+    for ( int32_t i = 0; i < 3; ++i )
+        limited.add(i * 10, i * 10, 5, 5);
+    NH3API_CHECK(limited.rects().size() == 3);
+
+    // the whole screen
+    region.clear();
+    region.add(5, 5, 5, 5);
+    region.add_all();
+    rects = region.rects();
+    NH3API_CHECK(rects.size() == 1 && same(rects[0], screen));
+}
+
+void test_flush()
+{
+    nh3api::dirty_region region(screen);
+    region.add(0, 0, 20, 10);
+    region.add(10, 0, 20, 10);
+    region.add(100, 100, 10, 10);
+    region.add(50, 40, 10, 10);
+
+    std::vector<dirty_rect> presented;
+    region.flush([&presented](const dirty_rect& rect) { presented.push_back(rect); });
+    NH3API_CHECK(presented.size() == 2 && same(presented[0], { 0, 0, 30, 10 }) && same(presented[1], { 50, 40, 10, 10 }));
+    NH3API_CHECK(region.empty() && region.rects().empty());
+
+    const nh3api::dirty_region_stats stats = region.stats();
+    NH3API_CHECK(stats.requests == 4 && stats.requested_pixels == 500 && stats.flushed_rects == 2 && stats.flushed_pixels == 400);
+    NH3API_CHECK(stats.flushes == 1 && stats.saved_pixels() == 100);
+
+    // an empty region presents nothing and does not count a flush
+    region.flush([&presented](const dirty_rect& rect) { presented.push_back(rect); });
+    NH3API_CHECK(presented.size() == 2 && region.stats().flushes == 1);
+    region.reset_stats();
+    NH3API_CHECK(region.stats().requests == 0 && region.stats().flushes == 0);
+}
+
+} // namespace
+
+int main()
+{
+    test_random(19);
+    test_merging();
+    test_flush();
+    return nh3api_test::result("dirty_region_test");
+}
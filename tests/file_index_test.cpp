@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// file_index: scan, save/load round trip, rescans and damaged index files
+
+#include <array>      // std::array
+#include <filesystem> // std::filesystem
+#include <fstream>    // std::ofstream, std::ifstream
+#include <string>     // std::string, std::to_string
+#include <vector>     // std::vector
+
+#include "nh3api/portable/file_index.hpp" // nh3api::file_index
+#include "test.hpp"
+
+namespace fs = std::filesystem;
+
+// the "header" of a file is its first byte, files starting with '!' can not be parsed
+struct first_byte_traits
+{
+    struct info_type
+    {
+        uint8_t first {0};
+    };
+
+    static inline constexpr std::array<char, 8> signature { 'N', 'H', '3', 'T', 'E', 'S', 'T', 'X' };
+    static inline constexpr uint32_t            version = 1;
+
+    [[nodiscard]] static std::vector<std::string> default_extensions()
+    { return { ".dat" }; }
+
+    static bool parse(const fs::path& path, info_type& info)
+    {
+        std::ifstream file(path, std::ios::binary);
+        char          first = 0;
+        if ( !file.get(first) || first == '!' )
+            return false;
+        info.first = static_cast<uint8_t>(first);
+        return true;
+    }
+
+    static void write(nh3api::byte_writer& writer, const info_type& info)
+    { writer.write(info.first); }
+
+    static void read(nh3api::byte_reader& reader, info_type& info)
+    { info.first = reader.read<uint8_t>(); }
+};
+
+using test_index = nh3api::file_index<first_byte_traits>;
+
+static void write_text(const fs::path& path, const std::string& text)
+{ std::ofstream(path, std::ios::binary) << text; }
+
+static std::vector<char> read_all(const fs::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+}
+
+static void write_all(const fs::path& path, const std::vector<char>& data)
+{ std::ofstream(path, std::ios::binary | std::ios::trunc).write(data.data(), static_cast<std::streamsize>(data.size())); }
+
+int main()
+{
+    const fs::path directory = fs::current_path() / "file_index_test_dir";
+    const fs::path saved     = fs::current_path() / "file_index_test.idx";
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    for ( int i = 0; i < 20; ++i )
+        write_text(directory / ("file" + std::to_string(i) + ".dat"), std::string(1, char('A' + i)) + "payload");
+    write_text(directory / "broken.dat", "!");
+    write_text(directory / "other.txt", "ignored");
+
+    nh3api::file_index_options options;
+    options.threads = 3;
+    test_index index(options);
+    nh3api::file_index_stats stats = index.scan(directory);
+    NH3API_CHECK(stats.files == 21 && stats.parsed == 20 && stats.failed == 1 && stats.reused == 0);
+    const test_index::record_type* const record = index.find(directory / "file3.dat");
+    NH3API_CHECK(record != nullptr && record->valid && record->info.first == 'D');
+    NH3API_CHECK(index.find(directory / "other.txt") == nullptr);
+    NH3API_CHECK(index.save(saved));
+
+    // the loaded index reuses every unchanged record
+    test_index loaded;
+    NH3API_CHECK(loaded.load(saved));
+    NH3API_CHECK(loaded.records().size() == 21);
+    stats = loaded.scan(directory);
+    NH3API_CHECK(stats.reused == 21 && stats.parsed == 0);
+
+    // a changed file is parsed again, a removed one is dropped
+    write_text(directory / "file3.dat", "Zlonger payload");
+    fs::remove(directory / "file4.dat");
+    stats = loaded.scan(directory);
+    NH3API_CHECK(stats.files == 20 && stats.parsed == 1 && stats.reused == 19);
+    NH3API_CHECK(loaded.find(directory / "file3.dat")->info.first == 'Z');
+    NH3API_CHECK(loaded.find(directory / "file4.dat") == nullptr);
+
+    // every truncation of the index file is rejected and leaves the index empty
+    const std::vector<char> full = read_all(saved);
+    for ( size_t size = 0; size < full.size(); ++size )
+    {
+        write_all(saved, std::vector<char>(full.begin(), full.begin() + static_cast<std::ptrdiff_t>(size)));
+        test_index truncated;
+        NH3API_CHECK(!truncated.load(saved) && truncated.records().empty());
+    }
+
+    // a huge path length is rejected without allocating it: signature, version, character size, count, length
+    std::vector<char> damaged(full.begin(), full.begin() + 20);
+    for ( int i = 0; i < 4; ++i )
+        damaged.push_back(char(0xFF));
+    damaged.insert(damaged.end(), 64, 'x');
+    write_all(saved, damaged);
+    test_index huge;
+    NH3API_CHECK(!huge.load(saved) && huge.records().empty());
+
+    fs::remove_all(directory);
+    fs::remove(saved);
+    return nh3api_test::result("file_index_test");
+}
@@ -0,0 +1,218 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// frame_cache: cached_frame::draw and mirrored() against decode_def_frame + blit_indices, clipped at every edge, and the LRU eviction order
+
+#include <algorithm> // std::reverse
+#include <cstdint>   // uint8_t, uint16_t, uint32_t, int32_t
+#include <memory>    // std::make_shared
+#include <vector>    // std::vector
+
+#include "nh3api/portable/frame_cache.hpp" // nh3api::frame_cache, nh3api::cached_frame
+#include "test.hpp"
+
+using nh3api::pixel_format;
+
+namespace
+{
+
+constexpr int32_t target_width  = 64;
+constexpr int32_t target_height = 48;
+// pixels past each row of the target, the draw must not touch them
+constexpr int32_t row_padding   = 8;
+
+// raw frame with runs of the special indices 0..7 and of colors, cropped inside a larger frame
+nh3api::def_frame make_frame(std::vector<uint8_t>& storage, nh3api_test::random& random)
+{
+    const int32_t width  = static_cast<int32_t>(1 + random.below(40));
+    const int32_t height = static_cast<int32_t>(1 + random.below(30));
+    storage.assign(size_t(width) * size_t(height), 0);
+    for ( size_t i = 0; i < storage.size(); )
+    {
+        const uint8_t index  = random.below(2) == 0 ? static_cast<uint8_t>(random.below(8)) : static_cast<uint8_t>(random.next());
+        const size_t  length = 1 + random.below(6);
+        for ( size_t end = i + length; i < end && i < storage.size(); ++i )
+            storage[i] = random.below(4) == 0 ? static_cast<uint8_t>(random.next()) : index;
+    }
+
+    nh3api::def_frame frame;
+    frame.header.encoding       = nh3api::def_encoding::raw;
+    frame.header.cropped_width  = width;
+    frame.header.cropped_height = height;
+    frame.header.cropped_x      = static_cast<int32_t>(random.below(10));
+    frame.header.cropped_y      = static_cast<int32_t>(random.below(10));
+    frame.header.width          = width + frame.header.cropped_x + static_cast<int32_t>(random.below(10));
+    frame.header.height         = height + frame.header.cropped_y + static_cast<int32_t>(random.below(10));
+    frame.header.data_size      = static_cast<uint32_t>(storage.size());
+    frame.data                  = { reinterpret_cast<const std::byte*>(storage.data()), storage.size() };
+    return frame;
+}
+
+// the whole frame as indices, transparent around the cropped image, mirrored if <hflip>
+std::vector<uint8_t> decode_whole(const nh3api::def_frame& frame, bool hflip)
+{
+    const nh3api::def_frame_header& header = frame.header;
+    std::vector<uint8_t> result(size_t(header.width) * size_t(header.height), 0);
+    nh3api::decode_def_frame(frame, result.data() + size_t(header.cropped_y) * size_t(header.width) + size_t(header.cropped_x),
+                             static_cast<size_t>(header.width));
+    if ( hflip )
+        for ( size_t row = 0; row < result.size(); row += size_t(header.width) )
+            std::reverse(result.begin() + static_cast<ptrdiff_t>(row), result.begin() + static_cast<ptrdiff_t>(row + size_t(header.width)));
+    return result;
+}
+
+template<class Pixel>
+void blit(const uint8_t* src, Pixel* dst, size_t count, const void* palette, pixel_format format)
+{
+    if constexpr ( sizeof(Pixel) == 2 )
+        nh3api::blit_indices(src, dst, count, static_cast<const uint16_t*>(palette), format);
+    else
+        nh3api::blit_indices(src, dst, count, static_cast<const uint32_t*>(palette));
+}
+
+// what CSpriteFrame::Draw does: the indices of the whole frame blitted row by row, clipped to the target
+template<class Pixel>
+void draw_reference(const std::vector<uint8_t>& indices, int32_t width, int32_t height, const void* palette, pixel_format format,
+                    const nh3api::surface_view<Pixel>& target, int32_t x, int32_t y)
+{
+    for ( int32_t row = 0; row < height; ++row )
+    {
+        if ( y + row < 0 || y + row >= target.height )
+            continue;
+        const int32_t begin = x < 0 ? -x : 0;
+        const int32_t end   = x + width > target.width ? target.width - x : width;
+        if ( begin < end )
+            blit(indices.data() + size_t(row) * size_t(width) + size_t(begin), target.row(y + row) + x + begin, size_t(end - begin), palette, format);
+    }
+}
+
+// the frame drawn at (x, y) of the same random background with <draw> and with draw_reference
+template<class Pixel, class Draw>
+bool same_draw(nh3api_test::random& random, const std::vector<uint8_t>& indices, const nh3api::def_frame_header& header,
+               const void* palette, pixel_format format, int32_t x, int32_t y, Draw&& draw)
+{
+    const int32_t      pitch = target_width + row_padding;
+    std::vector<Pixel> expected(size_t(pitch) * target_height);
+    for ( Pixel& pixel : expected )
+        pixel = static_cast<Pixel>(random.next());
+    std::vector<Pixel> actual = expected;
+
+    const nh3api::surface_view<Pixel> reference { expected.data(), target_width, target_height, pitch * static_cast<int32_t>(sizeof(Pixel)) };
+    const nh3api::surface_view<Pixel> target { actual.data(), target_width, target_height, pitch * static_cast<int32_t>(sizeof(Pixel)) };
+    draw_reference(indices, header.width, header.height, palette, format, reference, x, y);
+    draw(target);
+    return actual == expected;
+}
+
+template<class Pixel>
+void test_draw(pixel_format format, uint64_t seed)
+{
+    nh3api_test::random  random(seed);
+    std::vector<Pixel>   palette(256);
+    for ( Pixel& color : palette )
+        color = static_cast<Pixel>(random.next());
+
+    std::vector<uint8_t> storage;
+    size_t mismatches = 0;
+    for ( size_t i = 0; i < 200; ++i )
+    {
+        const nh3api::def_frame         frame   = make_frame(storage, random);
+        const nh3api::def_frame_header& header  = frame.header;
+        const std::vector<uint8_t>      forward = decode_whole(frame, false);
+        const std::vector<uint8_t>      flipped = decode_whole(frame, true);
+
+        const nh3api::frame_cache::frame_ptr decoded = nh3api::frame_cache::decode(frame, palette.data(), format);
+        const nh3api::frame_cache::frame_ptr hflip   = nh3api::frame_cache::decode(frame, palette.data(), format, {}, true);
+        if ( !NH3API_CHECK(decoded && hflip) )
+            return;
+        const nh3api::cached_frame mirrored = decoded->mirrored();
+        NH3API_CHECK(decoded->width() == header.width && decoded->height() == header.height && decoded->format() == format);
+        NH3API_CHECK(mirrored.width() == header.width && mirrored.height() == header.height);
+
+        // inside, across each edge and corner, fully outside and at random
+        const int32_t positions[][2] = {
+            { 2, 2 }, { -header.width / 2, 5 }, { target_width - header.width / 2, 5 }, { 5, -header.height / 2 },
+            { 5, target_height - header.height / 2 }, { -3, -3 }, { target_width - header.width + 3, target_height - header.height + 3 },
+            { -header.width, 0 }, { target_width, 0 }, { 0, target_height }, { -10, -header.height },
+            { static_cast<int32_t>(random.below(2 * target_width)) - target_width / 2,
+              static_cast<int32_t>(random.below(2 * target_height)) - target_height / 2 } };
+        for ( const auto& [x, y] : positions )
+        {
+            mismatches += !same_draw<Pixel>(random, forward, header, palette.data(), format, x, y,
+                                            [&](const nh3api::surface_view<Pixel>& target) { decoded->draw(target, x, y); });
+            mismatches += !same_draw<Pixel>(random, flipped, header, palette.data(), format, x, y,
+                                            [&](const nh3api::surface_view<Pixel>& target) { mirrored.draw(target, x, y); });
+            mismatches += !same_draw<Pixel>(random, flipped, header, palette.data(), format, x, y,
+                                            [&](const nh3api::surface_view<Pixel>& target) { hflip->draw(target, x, y); });
+        }
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+// frames of the same size under different keys, so that the budget counts frames
+void test_eviction_order()
+{
+    std::vector<uint16_t> palette(256, 0x1234);
+    std::vector<uint8_t>  indices(16 * 16, 0x40);
+    const nh3api::frame_cache::frame_ptr frame
+        = std::make_shared<const nh3api::cached_frame>(indices.data(), 0, 0, 16, 16, 16, 16, palette.data(), pixel_format::rgb565);
+
+    int a = 0, b = 0, c = 0;
+    const auto key = [&palette](const int& sprite, int32_t index) { return nh3api::frame_cache_key { &sprite, 0, index, palette.data(), 0 }; };
+
+    // four frames fit, the fifth evicts
+    nh3api::frame_cache cache({ frame->bytes() * 4 + frame->bytes() / 2 });
+    cache.insert(key(a, 0), frame);
+    cache.insert(key(a, 1), frame);
+    cache.insert(key(b, 0), frame);
+    cache.insert(key(b, 1), frame);
+    NH3API_CHECK(cache.stats().entries == 4 && cache.stats().evictions == 0);
+
+    // a is drawn last, but b is inserted after it: a gives up the frame it drew least recently
+    NH3API_CHECK(cache.find(key(a, 0)) == frame);
+    cache.insert(key(b, 2), frame);
+    NH3API_CHECK(cache.peek(key(a, 0)) && !cache.peek(key(a, 1)));
+
+    // a is now the least recently drawn sprite again and loses its last frame
+    cache.insert(key(c, 0), frame);
+    NH3API_CHECK(!cache.peek(key(a, 0)) && cache.stats().sprites == 2);
+
+    // b, then its least recently drawn frame
+    cache.insert(key(c, 1), frame);
+    NH3API_CHECK(!cache.peek(key(b, 0)) && cache.peek(key(b, 1)) && cache.peek(key(b, 2)));
+
+    // peek() does not make b recently used, find() does
+    NH3API_CHECK(cache.peek(key(b, 1)) == frame);
+    cache.insert(key(c, 2), frame);
+    NH3API_CHECK(!cache.peek(key(b, 1)) && cache.peek(key(b, 2)));
+    NH3API_CHECK(cache.find(key(b, 2)) == frame);
+    cache.insert(key(a, 2), frame);
+    NH3API_CHECK(cache.peek(key(b, 2)) && !cache.peek(key(c, 0)) && cache.peek(key(c, 1)));
+
+    const nh3api::frame_cache_stats stats = cache.stats();
+    NH3API_CHECK(stats.entries == 4 && stats.evictions == 5 && stats.insertions == 9 && stats.hits == 2 && stats.misses == 0);
+    NH3API_CHECK(stats.bytes == frame->bytes() * 4);
+
+    // a frame larger than the whole budget is returned, but not cached
+    cache.set_budget(frame->bytes() / 2);
+    NH3API_CHECK(cache.stats().entries == 0 && cache.stats().bytes == 0);
+    NH3API_CHECK(cache.insert(key(a, 0), frame) == frame && !cache.peek(key(a, 0)));
+}
+
+} // namespace
+
+int main()
+{
+    test_draw<uint16_t>(pixel_format::rgb565, 1);
+    test_draw<uint16_t>(pixel_format::rgb555, 2);
+    test_draw<uint32_t>(pixel_format::argb8888, 3);
+    test_eviction_order();
+    return nh3api_test::result("frame_cache_test");
+}
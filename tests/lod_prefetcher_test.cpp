@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// lod_prefetcher: prefetched, waited for and on-demand entries against the written data
+
+#include <cstdio>  // std::remove
+#include <string>  // std::string, std::to_string
+#include <thread>  // std::thread
+#include <vector>  // std::vector
+
+#include "nh3api/portable/lod_archive.hpp"    // nh3api::lod_archive
+#include "nh3api/portable/lod_prefetcher.hpp" // nh3api::lod_prefetcher
+#include "nh3api/portable/lod_writer.hpp"     // nh3api::lod_writer
+#include "test.hpp"
+
+using bytes = std::vector<std::byte>;
+
+int main()
+{
+    const char* const        path = "lod_prefetcher_test.lod";
+    nh3api_test::random      rng(3);
+    std::vector<std::string> names;
+    std::vector<bytes>       payloads;
+    {
+        nh3api::lod_writer writer;
+        for ( int i = 0; i < 64; ++i )
+        {
+            names.push_back("FRAME" + std::to_string(i) + ".DEF");
+            bytes payload(1000 + rng.below(50000));
+            for ( size_t k = 0; k < payload.size(); ++k )
+                payload[k] = std::byte((k / 8 + rng.below(2)) & 0xFF);
+            payloads.push_back(payload);
+            NH3API_CHECK(writer.add(names.back(), std::move(payload), 0, i % 5 != 0));
+        }
+        NH3API_CHECK(writer.write(path));
+    }
+
+    nh3api::lod_archive archive;
+    if ( !NH3API_CHECK(archive.open(path)) )
+        return nh3api_test::result("lod_prefetcher_test");
+
+    {
+        nh3api::lod_prefetcher prefetcher(archive, { 3 });
+
+        // the first half is prefetched, with an unknown name and a duplicate
+        std::vector<const char*> batch;
+        for ( size_t i = 0; i < names.size() / 2; ++i )
+            batch.push_back(names[i].c_str());
+        batch.push_back("MISSING.DEF");
+        batch.push_back(names[0].c_str());
+        NH3API_CHECK(prefetcher.prefetch({ batch.data(), batch.size() }) == names.size() / 2);
+
+        // get() right away either waits for the entry or finds it decoded
+        for ( size_t i = 0; i < names.size(); ++i )
+        {
+            const nh3api::lod_prefetcher::blob data = prefetcher.get(names[i]);
+            NH3API_CHECK(data != nullptr && *data == payloads[i]);
+        }
+        NH3API_CHECK(prefetcher.get("MISSING.DEF") == nullptr);
+
+        nh3api::lod_prefetcher_stats stats = prefetcher.stats();
+        NH3API_CHECK(stats.prefetched == names.size() / 2);
+        NH3API_CHECK(stats.hits + stats.waits >= names.size() / 2);
+        NH3API_CHECK(stats.misses == names.size() - names.size() / 2);
+
+        // everything is cached now: nothing to prefetch, concurrent gets are hits
+        NH3API_CHECK(prefetcher.prefetch({ batch.data(), batch.size() }) == 0);
+        std::vector<std::thread> readers;
+        for ( int t = 0; t < 4; ++t )
+            readers.emplace_back([&prefetcher, &names, &payloads]()
+            {
+                for ( size_t i = 0; i < names.size(); ++i )
+                {
+                    const nh3api::lod_prefetcher::blob data = prefetcher.get(names[i]);
+                    NH3API_CHECK(data != nullptr && *data == payloads[i]);
+                }
+            });
+        for ( std::thread& reader : readers )
+            reader.join();
+        NH3API_CHECK(prefetcher.stats().misses == stats.misses);
+
+        // a cleared archive is prefetched again
+        prefetcher.clear();
+        NH3API_CHECK(prefetcher.prefetch({ batch.data(), batch.size() }) == names.size() / 2);
+        prefetcher.wait();
+        NH3API_CHECK(*prefetcher.get(names[1]) == payloads[1]);
+    }
+
+    {
+        // two prefetchers sharing one cache
+        nh3api::lod_entry_cache cache;
+        nh3api::lod_prefetcher  first(archive, cache, { 2 });
+        nh3api::lod_prefetcher  second(archive, cache, { 2 });
+        const char* const       name = names[5].c_str();
+        NH3API_CHECK(first.prefetch({ &name, 1 }) == 1);
+        first.wait();
+        NH3API_CHECK(second.prefetch({ &name, 1 }) == 0);
+        NH3API_CHECK(*second.get(name) == payloads[5]);
+        NH3API_CHECK(second.stats().hits == 1);
+    }
+
+    archive.close();
+    std::remove(path);
+    return nh3api_test::result("lod_prefetcher_test");
+}
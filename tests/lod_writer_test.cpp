@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// lod_writer -> lod_archive round trip and thread_pool::parallel_for
+
+#include <atomic>    // std::atomic
+#include <cstdio>    // std::fopen, std::remove
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::string, std::to_string
+#include <thread>    // std::this_thread::yield
+#include <vector>    // std::vector
+
+#include "nh3api/portable/inflate.hpp"     // nh3api::zlib_uncompress
+#include "nh3api/portable/lod_archive.hpp" // nh3api::lod_archive
+#include "nh3api/portable/lod_writer.hpp"  // nh3api::lod_writer
+#include "nh3api/portable/thread_pool.hpp" // nh3api::thread_pool
+#include "test.hpp"
+
+using bytes = std::vector<std::byte>;
+
+static bytes make_payload(nh3api_test::random& rng, size_t size, bool compressible)
+{
+    bytes result(size);
+    for ( size_t i = 0; i < size; ++i )
+        result[i] = std::byte(compressible ? (i / 16 + rng.below(3)) & 0xFF : rng.next() & 0xFF);
+    return result;
+}
+
+static bytes read_file(const char* path)
+{
+    bytes result;
+    if ( std::FILE* file = std::fopen(path, "rb") )
+    {
+        std::byte buffer[4096];
+        for ( size_t count; (count = std::fread(buffer, 1, sizeof(buffer), file)) != 0; )
+            result.insert(result.end(), buffer, buffer + count);
+        std::fclose(file);
+    }
+    return result;
+}
+
+static bytes entry_data(const nh3api::lod_archive& archive, const LODEntry& entry)
+{
+    const nh3api::span<const std::byte> stored = archive.stored_data(entry);
+    if ( !nh3api::lod_archive::is_compressed(entry) )
+        return bytes(stored.begin(), stored.end());
+
+    bytes result;
+    if ( nh3api::zlib_uncompress(stored, result, entry.size, entry.size) != nh3api::inflate_status::ok )
+        result.clear();
+    return result;
+}
+
+static void test_round_trip()
+{
+    nh3api_test::random      rng(2);
+    std::vector<std::string> names;
+    std::vector<bytes>       payloads;
+    for ( int i = 0; i < 300; ++i )
+    {
+        names.push_back("ENTRY" + std::to_string(299 - i) + (i % 3 ? ".DEF" : ".PCX"));
+        payloads.push_back(make_payload(rng, rng.below(20000), i % 4 != 0));
+    }
+    payloads[7].clear();        // empty entry
+    payloads[11] = payloads[10]; // duplicate payload
+
+    const char* const paths[] = { "lod_writer_test_1.lod", "lod_writer_test_4.lod" };
+    const size_t      threads[] = { 1, 4 };
+    for ( size_t run = 0; run < 2; ++run )
+    {
+        nh3api::lod_writer writer({ LODHeader {}.version, threads[run], 6, true, 16 });
+        for ( size_t i = 0; i < names.size(); ++i )
+            NH3API_CHECK(writer.add(names[i], payloads[i], static_cast<int32_t>(i)));
+        NH3API_CHECK(!writer.add("entry0.def", {}));      // duplicate name, case-insensitive
+        NH3API_CHECK(!writer.add("", {}));                // empty name
+        NH3API_CHECK(!writer.add("SIXTEEN_CHARS.XX", {})); // too long
+        NH3API_CHECK(writer.write(paths[run]));
+        NH3API_CHECK(writer.stats().entries == names.size());
+        NH3API_CHECK(writer.stats().duplicate_entries >= 1);
+        NH3API_CHECK(writer.stats().compressed_entries > 0);
+    }
+
+    // the output does not depend on the thread count
+    const bytes single = read_file(paths[0]);
+    NH3API_CHECK(!single.empty() && single == read_file(paths[1]));
+
+    nh3api::lod_archive archive;
+    NH3API_CHECK(archive.open(paths[0]));
+    NH3API_CHECK(archive.size() == names.size());
+    for ( size_t i = 1; i < archive.entries().size(); ++i )
+        NH3API_CHECK(nh3api::lod_name_compare(nh3api::lod_entry_name(archive.entries()[i - 1]), nh3api::lod_entry_name(archive.entries()[i])) < 0);
+
+    for ( size_t i = 0; i < names.size(); ++i )
+    {
+        const LODEntry* const entry = archive.find(names[i]);
+        if ( !NH3API_CHECK(entry != nullptr) )
+            continue;
+        NH3API_CHECK(entry->attrib == static_cast<int32_t>(i));
+        NH3API_CHECK(entry->size == payloads[i].size());
+        NH3API_CHECK(entry_data(archive, *entry) == payloads[i]);
+    }
+    NH3API_CHECK(archive.find("entry10.def") == archive.find("ENTRY10.DEF"));
+    NH3API_CHECK(archive.find("MISSING.DEF") == nullptr);
+    archive.close();
+
+    for ( const char* const path : paths )
+        std::remove(path);
+}
+
+static void test_parallel_for()
+{
+    nh3api::thread_pool pool(2);
+
+    // an unrelated task does not hold parallel_for back
+    std::atomic<bool> release {false};
+    pool.submit([&release]() { while ( !release ) std::this_thread::yield(); });
+    std::atomic<size_t> sum {0};
+    pool.parallel_for(1000, [&sum](size_t i) { sum += i; });
+    NH3API_CHECK(sum == 999 * 1000 / 2);
+
+    // nested calls while every worker is busy
+    std::atomic<size_t> nested {0};
+    pool.parallel_for(4, [&pool, &nested](size_t) { pool.parallel_for(100, [&nested](size_t) { ++nested; }); });
+    NH3API_CHECK(nested == 400);
+    release = true;
+
+#if NH3API_PORTABLE_EXCEPTIONS
+    bool caught = false;
+    try
+    {
+        pool.parallel_for(1000, [](size_t i) { if ( i == 500 ) throw std::runtime_error("parallel_for"); });
+    }
+    catch ( const std::runtime_error& )
+    {
+        caught = true;
+    }
+    NH3API_CHECK(caught);
+#endif
+
+    sum = 0;
+    pool.parallel_for(10, [&sum](size_t i) { sum += i; });
+    NH3API_CHECK(sum == 45);
+    pool.wait();
+}
+
+int main()
+{
+    test_round_trip();
+    test_parallel_for();
+    return nh3api_test::result("lod_writer_test");
+}
@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// memory_reader and memory_writer, the state of t_memory_file_adapter and t_memory_write_adapter
+
+#include <cstring> // std::memcmp
+#include <vector>  // std::vector
+
+#include "nh3api/portable/memory_stream.hpp" // nh3api::memory_reader, nh3api::memory_writer
+#include "test.hpp"
+
+static void test_reader()
+{
+    std::vector<std::byte> data(100);
+    for ( size_t i = 0; i < data.size(); ++i )
+        data[i] = std::byte(i);
+
+    nh3api::memory_reader reader(data.data(), data.size());
+    NH3API_CHECK(reader.size() == 100 && reader.tell() == 0 && reader.remaining() == 100 && !reader.eof());
+
+    unsigned char buffer[64] {};
+    NH3API_CHECK(reader.read(buffer, 10) == 10);
+    NH3API_CHECK(buffer[0] == 0 && buffer[9] == 9 && reader.tell() == 10);
+
+    // zero-copy view into the data
+    const nh3api::span<const std::byte> view = reader.read_view(5);
+    NH3API_CHECK(view.size() == 5 && view.data() == data.data() + 10 && reader.tell() == 15);
+
+    // seek is clamped to the end, reads stop at the end
+    reader.seek(1000);
+    NH3API_CHECK(reader.tell() == 100 && reader.eof());
+    NH3API_CHECK(reader.read(buffer, 10) == 0 && reader.read_view(10).empty());
+    reader.seek(95);
+    NH3API_CHECK(reader.read(buffer, 64) == 5 && buffer[0] == 95 && buffer[4] == 99 && reader.eof());
+
+    // scatter: fills the buffers in order, stops at the first short one
+    reader.seek(0);
+    unsigned char first[30] {}, second[50] {}, third[40] {}, fourth[10] {};
+    const nh3api::scatter_buffer buffers[] = { { first, sizeof(first) }, { second, sizeof(second) }, { third, sizeof(third) }, { fourth, sizeof(fourth) } };
+    NH3API_CHECK(reader.read_scatter(buffers) == 100);
+    NH3API_CHECK(first[0] == 0 && first[29] == 29 && second[0] == 30 && second[49] == 79 && third[0] == 80 && third[19] == 99);
+    NH3API_CHECK(third[20] == 0 && fourth[0] == 0 && reader.eof());
+
+    NH3API_CHECK(reader.data().data() == data.data() && reader.data().size() == data.size());
+
+    nh3api::memory_reader empty;
+    NH3API_CHECK(empty.size() == 0 && empty.eof() && empty.read(buffer, 1) == 0);
+}
+
+static void test_writer()
+{
+    nh3api::memory_writer<> writer(16);
+    NH3API_CHECK(writer.size() == 0 && writer.buffer().capacity() >= 16);
+
+    const char text[] = "Heroes of Might and Magic III";
+    size_t     total  = 0;
+    for ( int i = 0; i < 1000; ++i )
+        total += writer.write(text, sizeof(text));
+    NH3API_CHECK(total == 1000 * sizeof(text) && writer.size() == total);
+    NH3API_CHECK(std::memcmp(writer.data().data() + 999 * sizeof(text), text, sizeof(text)) == 0);
+    NH3API_CHECK(writer.write(text, 0) == 0 && writer.size() == total);
+
+    // the written data is read back unchanged
+    nh3api::memory_reader reader(writer.data());
+    char                  check[sizeof(text)] {};
+    reader.seek(500 * sizeof(text));
+    NH3API_CHECK(reader.read(check, sizeof(check)) == sizeof(check) && std::memcmp(check, text, sizeof(text)) == 0);
+
+    const std::vector<std::byte> released = writer.release();
+    NH3API_CHECK(released.size() == total && writer.size() == 0);
+    writer.write(text, 4);
+    writer.clear();
+    NH3API_CHECK(writer.size() == 0);
+}
+
+int main()
+{
+    test_reader();
+    test_writer();
+    return nh3api_test::result("memory_stream_test");
+}
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// palette_animation: the precomputed phases, palette_at() and apply() against cycle_reference() rotating one tick at a time
+
+#include <cstdint>  // uint16_t, uint32_t, uint64_t
+#include <cstring>  // std::memcmp, std::memcpy
+#include <iterator> // std::begin, std::end
+#include <numeric>  // std::lcm
+#include <vector>   // std::vector
+
+#include "nh3api/portable/palette_animation.hpp" // nh3api::palette_animation
+#include "test.hpp"
+
+using nh3api::palette_cycle_range;
+
+namespace
+{
+
+template<class Pixel>
+bool same(const Pixel* lhs, const Pixel* rhs)
+{ return std::memcmp(lhs, rhs, 256 * sizeof(Pixel)) == 0; }
+
+template<class Pixel>
+void test_ranges(const std::vector<palette_cycle_range>& ranges, uint64_t seed)
+{
+    nh3api_test::random random(seed);
+    Pixel base[256];
+    for ( Pixel& entry : base )
+        entry = static_cast<Pixel>(random.next());
+
+    const nh3api::span<const palette_cycle_range> view { ranges.data(), ranges.size() };
+    const nh3api::palette_animation<Pixel> animation(base, view);
+    NH3API_CHECK(same(animation.base(), base) && animation.ranges() == ranges);
+
+    uint64_t period = 1;
+    for ( const palette_cycle_range& range : ranges )
+        period = std::lcm(period, static_cast<uint64_t>(range.period()));
+    const bool precomputed = period <= nh3api::palette_animation<Pixel>::max_phases;
+    NH3API_CHECK(animation.phases() == (precomputed ? period : 0));
+    NH3API_CHECK(animation.bytes() == animation.phases() * 256 * sizeof(Pixel));
+
+    // every phase, past the period and a few far ticks
+    std::vector<uint64_t> ticks;
+    for ( uint64_t tick = 0; tick < (precomputed ? 2 * period + 3 : 100); ++tick )
+        ticks.push_back(tick);
+    for ( size_t i = 0; i < 4; ++i )
+        ticks.push_back(1000 + random.below(5000));
+
+    size_t mismatches = 0;
+    for ( const uint64_t tick : ticks )
+    {
+        Pixel expected[256], actual[256];
+        nh3api::palette_animation<Pixel>::cycle_reference(base, view, tick, expected);
+        animation.palette_at(tick, actual);
+        mismatches += !same(actual, expected);
+        if ( precomputed )
+            mismatches += !same(animation.palette(tick), expected);
+        else
+            NH3API_CHECK(animation.palette(tick) == nullptr);
+
+        // apply() writes the cycled entries only: the rest keeps the values of the target
+        Pixel target[256];
+        for ( Pixel& entry : target )
+            entry = static_cast<Pixel>(random.next());
+        Pixel kept[256];
+        std::memcpy(kept, target, sizeof(target));
+        animation.apply(tick, target);
+        for ( size_t i = 0; i < 256; ++i )
+        {
+            bool cycled = false;
+            for ( const palette_cycle_range& range : ranges )
+                cycled = cycled || (i >= range.first && i <= range.last);
+            mismatches += target[i] != (cycled ? expected[i] : kept[i]);
+        }
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+template<class Pixel>
+void test_all(uint64_t seed)
+{
+    // the adventure map water and lava
+    test_ranges<Pixel>({ std::begin(nh3api::adventure_cycle_ranges), std::end(nh3api::adventure_cycle_ranges) }, seed);
+    // steps above 1, a step multiple of the size, a single entry and an empty range
+    test_ranges<Pixel>({ { 10, 19, 3 }, { 30, 35, 4 }, { 40, 43, 8 }, { 50, 50, 1 }, { 60, 59, 1 } }, seed + 1);
+    // the whole palette
+    test_ranges<Pixel>({ { 0, 255, 7 } }, seed + 2);
+    // coprime periods beyond max_phases: no phases, palette_at() and apply() rotate on every call
+    test_ranges<Pixel>({ { 0, 62, 1 }, { 64, 127, 1 }, { 128, 192, 1 } }, seed + 3);
+}
+
+} // namespace
+
+int main()
+{
+    test_all<uint16_t>(20);
+    test_all<uint32_t>(30);
+    return nh3api_test::result("palette_animation_test");
+}
@@ -0,0 +1,201 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// palette_kernels: expand_indices, blit_indices and blit_composite against the scalar references at unaligned starts,
+// convert_rgb24_to_16 against the runtime shifts of TPalette16::Convert24to16
+
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+#include <vector>  // std::vector
+
+#include "nh3api/portable/palette_kernels.hpp" // nh3api::blit_indices, nh3api::blit_composite, nh3api::convert_rgb24_to_16
+#include "test.hpp"
+
+using nh3api::composite_indices;
+using nh3api::composite_mode;
+using nh3api::pixel_format;
+using nh3api::special_indices;
+
+namespace
+{
+
+// the spans start at every offset of a 16-byte line and end anywhere, so both the vector and the tail loops run
+constexpr size_t max_offset = 16;
+constexpr size_t max_count  = 70;
+
+// half of the indices are the special ones below 8
+std::vector<uint8_t> make_indices(nh3api_test::random& random, size_t count)
+{
+    std::vector<uint8_t> result(count);
+    for ( uint8_t& index : result )
+        index = random.below(2) == 0 ? static_cast<uint8_t>(random.below(8)) : static_cast<uint8_t>(random.next());
+    return result;
+}
+
+template<class Pixel>
+std::vector<Pixel> make_pixels(nh3api_test::random& random, size_t count)
+{
+    std::vector<Pixel> result(count);
+    for ( Pixel& pixel : result )
+        pixel = static_cast<Pixel>(random.next());
+    return result;
+}
+
+// the game's order of the special indices: transparent, half, quarter, the rest are colors
+template<class Pixel>
+Pixel blit_reference(Pixel pixel, uint8_t index, const Pixel* palette, const special_indices& special, pixel_format format)
+{
+    const uint32_t bit = index < 8 ? 1U << index : 0;
+    if ( special.transparent & bit )
+        return pixel;
+    if constexpr ( sizeof(Pixel) == 2 )
+    {
+        const nh3api::shade_masks16 masks = nh3api::get_shade_masks16(format);
+        if ( special.shadow_half & bit )
+            return static_cast<Pixel>((pixel >> 1U) & masks.div2);
+        if ( special.shadow_quarter & bit )
+            return static_cast<Pixel>(pixel - ((pixel >> 2U) & masks.div4));
+    }
+    else
+    {
+        if ( special.shadow_half & bit )
+            return ((pixel >> 1U) & 0x007F7F7FU) | (pixel & 0xFF000000U);
+        if ( special.shadow_quarter & bit )
+            return pixel - ((pixel >> 2U) & 0x003F3F3FU);
+    }
+    return palette[index];
+}
+
+template<class Pixel>
+void test_blit_indices(pixel_format format, uint64_t seed)
+{
+    nh3api_test::random      random(seed);
+    const std::vector<Pixel> palette = make_pixels<Pixel>(random, 256);
+    // the default indices, none, all of them and overlapping masks
+    const special_indices specials[] = { {}, { 0, 0, 0 }, { 0xFF, 0xFF, 0xFF }, { 0x81, 0x12, 0x50 }, { 0x00, 0xF0, 0x3C } };
+
+    size_t mismatches = 0;
+    for ( size_t i = 0; i < 400; ++i )
+    {
+        const size_t               offset  = random.below(max_offset);
+        const size_t               count   = random.below(max_count);
+        const std::vector<uint8_t> indices = make_indices(random, offset + count);
+        const std::vector<Pixel>   source  = make_pixels<Pixel>(random, offset + count);
+        const special_indices&     special = specials[random.below(5)];
+
+        std::vector<Pixel> expected = source, actual = source, expanded = source;
+        for ( size_t j = offset; j < offset + count; ++j )
+            expected[j] = blit_reference(source[j], indices[j], palette.data(), special, format);
+        if constexpr ( sizeof(Pixel) == 2 )
+            nh3api::blit_indices(indices.data() + offset, actual.data() + offset, count, palette.data(), format, special);
+        else
+            nh3api::blit_indices(indices.data() + offset, actual.data() + offset, count, palette.data(), special);
+        mismatches += actual != expected;
+
+        nh3api::expand_indices(indices.data() + offset, expanded.data() + offset, count, palette.data());
+        for ( size_t j = 0; j < expanded.size(); ++j )
+            mismatches += expanded[j] != (j < offset ? source[j] : palette[indices[j]]);
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+template<composite_mode Mode, class Pixel>
+Pixel composite_reference(Pixel pixel, uint8_t index, const Pixel* palette, Pixel outline, const composite_indices& special, pixel_format format)
+{
+    const Pixel color = Mode == composite_mode::shadow ? Pixel(0) : palette[index];
+    if constexpr ( sizeof(Pixel) == 2 )
+        return nh3api::palette_detail::composite<Mode>(pixel, index, color, outline, special, nh3api::get_shade_masks16(format));
+    else
+        return nh3api::palette_detail::composite<Mode>(pixel, index, color, outline, special);
+}
+
+template<class Pixel, composite_mode Mode>
+void test_composite(pixel_format format, uint64_t seed)
+{
+    nh3api_test::random      random(seed);
+    const std::vector<Pixel> palette = make_pixels<Pixel>(random, 256);
+    const composite_indices  specials[] = { {}, { 0, 0, 0, 0 }, { 0xFF, 0xFF, 0xFF, 0xFF }, { 0x03, 0x0C, 0x30, 0xC0 }, { 0x00, 0x60, 0x06, 0x99 } };
+
+    size_t mismatches = 0;
+    for ( size_t i = 0; i < 400; ++i )
+    {
+        const size_t               offset  = random.below(max_offset);
+        const size_t               count   = random.below(max_count);
+        const std::vector<uint8_t> indices = make_indices(random, offset + count);
+        const std::vector<Pixel>   source  = make_pixels<Pixel>(random, offset + count);
+        const composite_indices&   special = specials[random.below(5)];
+        const Pixel                outline = static_cast<Pixel>(random.next());
+
+        std::vector<Pixel> expected = source, actual = source;
+        for ( size_t j = offset; j < offset + count; ++j )
+            expected[j] = composite_reference<Mode>(source[j], indices[j], palette.data(), outline, special, format);
+        // the shadow mode does not read the palette
+        const Pixel* const colors = Mode == composite_mode::shadow ? nullptr : palette.data();
+        if constexpr ( sizeof(Pixel) == 2 )
+            nh3api::blit_composite(indices.data() + offset, actual.data() + offset, count, colors, Mode, nh3api::get_shade_masks16(format), outline, special);
+        else
+            nh3api::blit_composite(indices.data() + offset, actual.data() + offset, count, colors, Mode, outline, special);
+        mismatches += actual != expected;
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+template<class Pixel>
+void test_composite_modes(pixel_format format, uint64_t seed)
+{
+    test_composite<Pixel, composite_mode::shadow>(format, seed);
+    test_composite<Pixel, composite_mode::opaque>(format, seed + 1);
+    test_composite<Pixel, composite_mode::alpha>(format, seed + 2);
+}
+
+// TPalette16::Convert24to16 with the shifts of the display mode
+uint16_t convert_reference(const uint8_t* rgb, uint32_t rbits, uint32_t rshift, uint32_t gbits, uint32_t gshift, uint32_t bbits, uint32_t bshift)
+{
+    const uint32_t red = rgb[0], green = rgb[1], blue = rgb[2];
+    return static_cast<uint16_t>(((blue >> (8 - bbits) << bshift) | (green >> (8 - gbits) << gshift) | (red >> (8 - rbits) << rshift)) & 0xFFFF);
+}
+
+template<class Layout>
+void test_convert(uint64_t seed)
+{
+    nh3api_test::random random(seed);
+    size_t mismatches = 0;
+    // short palettes for the tail loop, the whole palette, and unaligned sources
+    for ( size_t count = 0; count <= 257; count += count < 40 ? 1 : 217 )
+    {
+        const size_t         offset = random.below(max_offset);
+        std::vector<uint8_t> rgb(offset + count * 3);
+        for ( uint8_t& channel : rgb )
+            channel = static_cast<uint8_t>(random.next());
+        // a guard entry past the output
+        std::vector<uint16_t> output(count + 1, 0xA5A5);
+        nh3api::convert_rgb24_to_16<Layout>(rgb.data() + offset, output.data(), count);
+        for ( size_t i = 0; i < count; ++i )
+            mismatches += output[i] != convert_reference(rgb.data() + offset + i * 3, Layout::red_bits, Layout::red_shift, Layout::green_bits,
+                                                         Layout::green_shift, Layout::blue_bits, Layout::blue_shift);
+        mismatches += output[count] != 0xA5A5;
+    }
+    NH3API_CHECK(mismatches == 0);
+}
+
+} // namespace
+
+int main()
+{
+    test_blit_indices<uint16_t>(pixel_format::rgb565, 1);
+    test_blit_indices<uint16_t>(pixel_format::rgb555, 2);
+    test_blit_indices<uint32_t>(pixel_format::argb8888, 3);
+    test_composite_modes<uint16_t>(pixel_format::rgb565, 10);
+    test_composite_modes<uint16_t>(pixel_format::rgb555, 20);
+    test_composite_modes<uint32_t>(pixel_format::argb8888, 30);
+    test_convert<nh3api::rgb565_layout>(40);
+    test_convert<nh3api::rgb555_layout>(41);
+    test_convert<nh3api::bgr565_layout>(42);
+    return nh3api_test::result("palette_kernels_test");
+}
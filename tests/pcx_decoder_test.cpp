@@ -0,0 +1,286 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// pcx_decoder on synthetic images: LOD indexed and 24-bit, ZSoft 8-bit and 24-bit, encoded and raw, damaged files
+
+#include <algorithm> // std::equal
+#include <array>     // std::array
+#include <cstdint>   // uint8_t, uint16_t, uint32_t
+#include <vector>    // std::vector
+
+#include "nh3api/portable/pcx_decoder.hpp" // nh3api::pcx_decoder
+#include "test.hpp"
+
+using nh3api::pcx_container;
+using nh3api::pcx_kind;
+using nh3api::pixel_format;
+
+namespace
+{
+
+using palette24 = std::array<std::array<uint8_t, 3>, 256>;
+
+// the expected image: indices and palette or RGB triplets
+struct image
+{
+    pcx_kind             kind {pcx_kind::indexed};
+    uint32_t             width {0};
+    uint32_t             height {0};
+    palette24            palette {};
+    std::vector<uint8_t> pixels;
+
+    [[nodiscard]] std::array<uint8_t, 3> rgb(size_t x, size_t y) const
+    {
+        if ( kind == pcx_kind::indexed )
+            return palette[pixels[y * width + x]];
+        const uint8_t* const pixel = &pixels[(y * width + x) * 3];
+        return { pixel[0], pixel[1], pixel[2] };
+    }
+};
+
+void put_u16(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+{
+    data[offset]     = static_cast<uint8_t>(value);
+    data[offset + 1] = static_cast<uint8_t>(value >> 8U);
+}
+
+void push_u32(std::vector<uint8_t>& data, uint32_t value)
+{
+    for ( uint32_t shift = 0; shift < 32; shift += 8 )
+        data.push_back(static_cast<uint8_t>(value >> shift));
+}
+
+image random_image(nh3api_test::random& random, pcx_kind kind)
+{
+    image result;
+    result.kind   = kind;
+    result.width  = 1 + random.below(70);
+    result.height = 1 + random.below(20);
+    for ( auto& color : result.palette )
+        for ( uint8_t& channel : color )
+            channel = static_cast<uint8_t>(random.next());
+    // runs of the same byte, so that the RLE has something to compress, and bytes of 0xC0 and above
+    result.pixels.resize(size_t(result.width) * result.height * (kind == pcx_kind::indexed ? 1 : 3));
+    uint8_t value = 0;
+    for ( uint8_t& pixel : result.pixels )
+    {
+        if ( random.below(4) == 0 )
+            value = static_cast<uint8_t>(random.next());
+        pixel = value;
+    }
+    return result;
+}
+
+// size, width, height, the pixels(24-bit ones as blue, green, red), the palette of the indexed images
+std::vector<uint8_t> encode_h3(const image& source)
+{
+    std::vector<uint8_t> data;
+    push_u32(data, static_cast<uint32_t>(source.pixels.size()));
+    push_u32(data, source.width);
+    push_u32(data, source.height);
+    if ( source.kind == pcx_kind::indexed )
+    {
+        data.insert(data.end(), source.pixels.begin(), source.pixels.end());
+        for ( const auto& color : source.palette )
+            data.insert(data.end(), color.begin(), color.end());
+    }
+    else
+        for ( size_t i = 0; i < source.pixels.size(); i += 3 )
+            data.insert(data.end(), { source.pixels[i + 2], source.pixels[i + 1], source.pixels[i] });
+    return data;
+}
+
+// ZSoft PCX, <padding> bytes after each plane row; the encoded runs may cross the scanlines
+std::vector<uint8_t> encode_zsoft(nh3api_test::random& random, const image& source, bool encoded, uint32_t padding)
+{
+    const uint32_t planes         = source.kind == pcx_kind::indexed ? 1 : 3;
+    const uint32_t bytes_per_line = source.width + padding;
+    std::vector<uint8_t> data(128, 0);
+    data[0]  = 0x0A;
+    data[1]  = 5;
+    data[2]  = encoded ? 1 : 0;
+    data[3]  = 8;
+    // a non-zero origin, the size is the difference of the corners
+    put_u16(data, 4, 3);
+    put_u16(data, 6, 7);
+    put_u16(data, 8, 3 + source.width - 1);
+    put_u16(data, 10, 7 + source.height - 1);
+    data[65] = static_cast<uint8_t>(planes);
+    put_u16(data, 66, bytes_per_line);
+
+    std::vector<uint8_t> scanlines;
+    for ( uint32_t y = 0; y < source.height; ++y )
+        for ( uint32_t plane = 0; plane < planes; ++plane )
+            for ( uint32_t x = 0; x < bytes_per_line; ++x )
+                scanlines.push_back(x >= source.width ? static_cast<uint8_t>(random.next())
+                                    : planes == 1    ? source.pixels[size_t(y) * source.width + x]
+                                                     : source.pixels[(size_t(y) * source.width + x) * 3 + plane]);
+
+    if ( !encoded )
+        data.insert(data.end(), scanlines.begin(), scanlines.end());
+    else
+        for ( size_t i = 0; i < scanlines.size(); )
+        {
+            size_t count = 1;
+            while ( i + count < scanlines.size() && count < 63 && scanlines[i + count] == scanlines[i] )
+                ++count;
+            if ( count == 1 && scanlines[i] < 0xC0 )
+                data.push_back(scanlines[i]);
+            else
+                data.insert(data.end(), { static_cast<uint8_t>(0xC0 | count), scanlines[i] });
+            i += count;
+        }
+
+    if ( planes == 1 )
+    {
+        data.push_back(0x0C);
+        for ( const auto& color : source.palette )
+            data.insert(data.end(), color.begin(), color.end());
+    }
+    return data;
+}
+
+nh3api::span<const std::byte> as_bytes(const std::vector<uint8_t>& data)
+{ return { reinterpret_cast<const std::byte*>(data.data()), data.size() }; }
+
+// decode <data> with each of the read functions and compare with <expected>
+void check_decoded(const std::vector<uint8_t>& data, const image& expected, pcx_container container)
+{
+    {
+        nh3api::pcx_decoder decoder(as_bytes(data));
+        NH3API_CHECK(decoder.ok());
+        NH3API_CHECK(decoder.info().container == container && decoder.info().kind == expected.kind);
+        NH3API_CHECK(decoder.info().width == static_cast<int32_t>(expected.width) && decoder.info().height == static_cast<int32_t>(expected.height));
+        if ( expected.kind == pcx_kind::indexed )
+        {
+            NH3API_CHECK(decoder.info().palette == expected.palette);
+            std::vector<uint8_t> indices(expected.width);
+            bool same = true;
+            for ( uint32_t y = 0; y < expected.height; ++y )
+                same = same && decoder.read_row(indices.data())
+                       && std::equal(indices.begin(), indices.end(), expected.pixels.begin() + static_cast<std::ptrdiff_t>(size_t(y) * expected.width));
+            NH3API_CHECK(same);
+            NH3API_CHECK(!decoder.read_row(indices.data()));
+        }
+    }
+
+    {
+        nh3api::pcx_decoder  decoder(as_bytes(data));
+        std::vector<uint8_t> rgb(size_t(expected.width) * 3);
+        bool same = true;
+        for ( uint32_t y = 0; y < expected.height; ++y )
+        {
+            same = same && decoder.read_row_rgb(rgb.data());
+            for ( uint32_t x = 0; x < expected.width && same; ++x )
+                same = expected.rgb(x, y) == std::array<uint8_t, 3> { rgb[x * 3], rgb[x * 3 + 1], rgb[x * 3 + 2] };
+        }
+        NH3API_CHECK(same);
+        NH3API_CHECK(decoder.row() == static_cast<int32_t>(expected.height));
+    }
+
+    for ( const pixel_format format : { pixel_format::rgb565, pixel_format::rgb555 } )
+    {
+        std::array<uint16_t, 256> palette {};
+        for ( size_t i = 0; i < 256; ++i )
+            palette[i] = format == pixel_format::rgb555 ? nh3api::rgb555_layout::pack(expected.palette[i][0], expected.palette[i][1], expected.palette[i][2])
+                                                        : nh3api::rgb565_layout::pack(expected.palette[i][0], expected.palette[i][1], expected.palette[i][2]);
+        nh3api::pcx_decoder   decoder(as_bytes(data));
+        std::vector<uint16_t> pixels(expected.width);
+        bool same = true;
+        for ( uint32_t y = 0; y < expected.height; ++y )
+        {
+            same = same && decoder.read_row(pixels.data(), format, palette.data());
+            for ( uint32_t x = 0; x < expected.width && same; ++x )
+            {
+                const std::array<uint8_t, 3> color = expected.rgb(x, y);
+                same = pixels[x] == (format == pixel_format::rgb555 ? nh3api::rgb555_layout::pack(color[0], color[1], color[2])
+                                                                    : nh3api::rgb565_layout::pack(color[0], color[1], color[2]));
+            }
+        }
+        NH3API_CHECK(same);
+    }
+
+    {
+        std::array<uint32_t, 256> palette {};
+        nh3api::make_argb_palette(expected.palette, palette.data());
+        nh3api::pcx_decoder   decoder(as_bytes(data));
+        std::vector<uint32_t> pixels(expected.width);
+        bool same = true;
+        for ( uint32_t y = 0; y < expected.height; ++y )
+        {
+            same = same && decoder.read_row(pixels.data(), palette.data());
+            for ( uint32_t x = 0; x < expected.width && same; ++x )
+            {
+                const std::array<uint8_t, 3> color = expected.rgb(x, y);
+                same = pixels[x] == (0xFF000000U | (uint32_t(color[0]) << 16U) | (uint32_t(color[1]) << 8U) | color[2]);
+            }
+        }
+        NH3API_CHECK(same);
+    }
+}
+
+// every row a decoder of <data> gives, false if it stops early
+bool decode_all(const std::vector<uint8_t>& data)
+{
+    nh3api::pcx_decoder decoder(as_bytes(data));
+    if ( !decoder.ok() )
+        return false;
+    std::vector<uint8_t> rgb(size_t(decoder.info().width) * 3);
+    for ( int32_t y = 0; y < decoder.info().height; ++y )
+        if ( !decoder.read_row_rgb(rgb.data()) )
+            return false;
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_test::random random(0x4E48335043583137ULL);
+    for ( int iteration = 0; iteration < 200; ++iteration )
+    {
+        const pcx_kind kind  = iteration % 2 == 0 ? pcx_kind::indexed : pcx_kind::rgb;
+        const image    input = random_image(random, kind);
+
+        const std::vector<uint8_t> h3 = encode_h3(input);
+        check_decoded(h3, input, pcx_container::h3);
+        check_decoded(encode_zsoft(random, input, true, random.below(3)), input, pcx_container::zsoft);
+        check_decoded(encode_zsoft(random, input, false, random.below(3)), input, pcx_container::zsoft);
+
+        // the rows of a cut file are never read past its end
+        const std::vector<uint8_t> zsoft = encode_zsoft(random, input, true, 1);
+        for ( const std::vector<uint8_t>* file : { &h3, &zsoft } )
+            for ( size_t size = 0; size < file->size(); size += 1 + random.below(16) )
+            {
+                const std::vector<uint8_t> cut(file->begin(), file->begin() + static_cast<std::ptrdiff_t>(size));
+                const bool complete = decode_all(cut);
+                // without a palette at the end, a cut 24-bit file always lacks a part of the scanlines
+                if ( kind == pcx_kind::rgb )
+                    NH3API_CHECK(!complete);
+            }
+    }
+
+    // damaged headers
+    image small = random_image(random, pcx_kind::indexed);
+    std::vector<uint8_t> h3 = encode_h3(small);
+    h3[0] ^= 1; // the size is neither width * height nor width * height * 3
+    NH3API_CHECK(!nh3api::pcx_decoder(as_bytes(h3)).ok());
+    std::vector<uint8_t> zsoft = encode_zsoft(random, small, true, 0);
+    zsoft[zsoft.size() - 769] = 0; // no palette marker
+    NH3API_CHECK(!nh3api::pcx_decoder(as_bytes(zsoft)).ok());
+    zsoft = encode_zsoft(random, small, true, 0);
+    zsoft[65] = 2; // two planes
+    NH3API_CHECK(!nh3api::pcx_decoder(as_bytes(zsoft)).ok());
+    zsoft = encode_zsoft(random, small, true, 0);
+    put_u16(zsoft, 66, small.width - 1); // the scanline is shorter than the row
+    NH3API_CHECK(small.width == 1 || !nh3api::pcx_decoder(as_bytes(zsoft)).ok());
+
+    return nh3api_test::result("pcx_decoder_test");
+}
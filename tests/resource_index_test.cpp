@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// resource_index against std::map, the names cut to 12 characters like ResourceManager::TCacheMapKey
+
+#include <map>    // std::map
+#include <string> // std::string, std::to_string
+#include <vector> // std::vector
+
+#include "nh3api/portable/resource_index.hpp" // nh3api::resource_index
+#include "test.hpp"
+
+namespace
+{
+
+struct value
+{
+    int id;
+};
+
+// the key of the game's tree: the first 12 characters
+std::string key_of(const std::string& name)
+{ return name.substr(0, nh3api::resource_name().size() - 1); }
+
+} // namespace
+
+int main()
+{
+    // a name longer than 12 characters is the 12 character one, whichever way it is spelled
+    {
+        nh3api::resource_index<value> index;
+        value                         resource { 1 };
+        index.insert("ABCDEFGHIJKLMNOP.def", &resource);
+        NH3API_CHECK(index.size() == 1);
+        NH3API_CHECK(index.find("ABCDEFGHIJKL") == &resource);
+        NH3API_CHECK(index.find("ABCDEFGHIJKLM") == &resource);
+        NH3API_CHECK(index.find("ABCDEFGHIJK") == nullptr);
+        // erased by the name the resource stores, the alias does not stay behind
+        NH3API_CHECK(index.erase("ABCDEFGHIJKL", &resource));
+        NH3API_CHECK(index.empty() && index.find("ABCDEFGHIJKLMNOP.def") == nullptr);
+    }
+
+    // random inserts, lookups and erasures against std::map
+    nh3api_test::random           random(0x4E48335245534958ULL);
+    nh3api::resource_index<value> index(0, 0);
+    std::map<std::string, value*> expected;
+    std::vector<value>            values(512);
+    std::vector<std::string>      names;
+    for ( size_t i = 0; i < 300; ++i )
+    {
+        // short names, 12 character ones and longer ones sharing their first 12 characters
+        std::string name = "N" + std::to_string(random.below(100000));
+        if ( random.below(3) == 0 )
+            name += std::string(12, 'X') + std::to_string(random.below(4));
+        names.push_back(name);
+    }
+    for ( int step = 0; step < 20000; ++step )
+    {
+        const std::string& name = names[random.below(static_cast<uint32_t>(names.size()))];
+        const std::string  key  = key_of(name);
+        switch ( random.below(3) )
+        {
+            case 0:
+            {
+                value* const current = &values[random.below(static_cast<uint32_t>(values.size()))];
+                index.insert(name.c_str(), current);
+                expected[key] = current;
+                break;
+            }
+            case 1:
+            {
+                const auto it = expected.find(key);
+                NH3API_CHECK(index.find(name.c_str()) == (it != expected.end() ? it->second : nullptr));
+                break;
+            }
+            default:
+                NH3API_CHECK(index.erase(name.c_str()) == (expected.erase(key) != 0));
+                break;
+        }
+        if ( index.size() != expected.size() )
+        {
+            NH3API_CHECK(index.size() == expected.size());
+            break;
+        }
+    }
+    for ( const auto& [key, current] : expected )
+        NH3API_CHECK(index.find(key.c_str()) == current);
+
+    return nh3api_test::result("resource_index_test");
+}
@@ -0,0 +1,158 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// resource_preloader: handoff, duplicates, failures and cancel() with the loads in flight, with a loader the test holds back
+
+#include <condition_variable> // std::condition_variable
+#include <initializer_list>   // std::initializer_list
+#include <map>                // std::map
+#include <mutex>              // std::mutex
+#include <string>             // std::string
+
+#include "nh3api/portable/resource_preloader.hpp" // nh3api::resource_preloader
+#include "test.hpp"
+
+namespace
+{
+
+// A loader which blocks until the test opens it, counting its calls per name.
+// The staged object is the name and the number of the call
+class blocking_loader
+{
+    public:
+        bool load(const nh3api::preload_entry& entry, std::string& staged)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            const int call = ++m_calls[entry.c_str()];
+            ++m_started;
+            m_changed.notify_all();
+            m_changed.wait(lock, [this]() { return m_open; });
+            staged = std::string(entry.c_str()) + "#" + std::to_string(call);
+            return entry.c_str()[0] != '!';
+        }
+
+        void open()
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_open = true;
+            m_changed.notify_all();
+        }
+
+        void wait_started(int count)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_changed.wait(lock, [this, count]() { return m_started >= count; });
+        }
+
+        int calls(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_calls[name];
+        }
+
+    protected:
+        std::mutex                 m_mutex;
+        std::condition_variable    m_changed;
+        bool                       m_open {false};
+        int                        m_started {0};
+        std::map<std::string, int> m_calls;
+
+};
+
+using preloader = nh3api::resource_preloader<std::string>;
+
+nh3api::preload_manifest manifest(std::initializer_list<const char*> names)
+{
+    nh3api::preload_manifest result;
+    for ( const char* const name : names )
+        result.add(name, 0);
+    return result;
+}
+
+// the staged objects passed to the main thread, in order
+std::string finish(preloader& loader)
+{
+    std::string result;
+    loader.finish([&result](const nh3api::preload_entry&, std::string&& staged) { result += staged + " "; });
+    return result;
+}
+
+} // namespace
+
+int main()
+{
+    // request, cancel and request again while the load is in flight: the entry is handed off once, loaded once
+    {
+        blocking_loader blocking;
+        preloader       loader([&blocking](const nh3api::preload_entry& entry, std::string& staged) { return blocking.load(entry, staged); }, { 1 });
+        NH3API_CHECK(loader.request(manifest({ "A.def" })) == 1);
+        blocking.wait_started(1);
+        loader.cancel();
+        NH3API_CHECK(loader.request(manifest({ "A.def" })) == 1);
+        blocking.open();
+        NH3API_CHECK(finish(loader) == "A.def#1 ");
+        NH3API_CHECK(blocking.calls("A.def") == 1);
+        const nh3api::resource_preloader_stats stats = loader.stats();
+        NH3API_CHECK(stats.requested == 2 && stats.skipped == 0 && stats.loaded == 1 && stats.handed_off == 1 && stats.discarded == 0);
+    }
+
+    // the same with a queued load which had not started at cancel(): one thread, busy with the first entry
+    {
+        blocking_loader blocking;
+        preloader       loader([&blocking](const nh3api::preload_entry& entry, std::string& staged) { return blocking.load(entry, staged); }, { 1 });
+        NH3API_CHECK(loader.request(manifest({ "A.def", "B.def" })) == 2);
+        blocking.wait_started(1);
+        loader.cancel();
+        NH3API_CHECK(loader.request(manifest({ "B.def" })) == 1);
+        blocking.open();
+        NH3API_CHECK(finish(loader) == "B.def#1 ");
+        NH3API_CHECK(blocking.calls("A.def") == 1 && blocking.calls("B.def") == 1);
+        NH3API_CHECK(loader.stats().discarded == 1);
+    }
+
+    // cancel without a new request: the late result is dropped, a later request loads the entry again
+    {
+        blocking_loader blocking;
+        preloader       loader([&blocking](const nh3api::preload_entry& entry, std::string& staged) { return blocking.load(entry, staged); }, { 1 });
+        loader.request(manifest({ "A.def" }));
+        blocking.wait_started(1);
+        loader.cancel();
+        blocking.open();
+        NH3API_CHECK(finish(loader).empty());
+        NH3API_CHECK(loader.request(manifest({ "A.def" })) == 1);
+        NH3API_CHECK(finish(loader) == "A.def#2 ");
+        NH3API_CHECK(loader.stats().discarded == 1);
+    }
+
+    // duplicates are skipped while staged, failures are not staged and may be requested again
+    {
+        blocking_loader blocking;
+        blocking.open();
+        preloader loader([&blocking](const nh3api::preload_entry& entry, std::string& staged) { return blocking.load(entry, staged); }, { 2 });
+        NH3API_CHECK(loader.request(manifest({ "A.def", "B.def", "!C.def" })) == 3);
+        loader.wait();
+        NH3API_CHECK(loader.staged() == 2);
+        NH3API_CHECK(loader.request(manifest({ "A.def", "!C.def" })) == 1);
+        loader.wait();
+        const std::string handed_off = finish(loader);
+        NH3API_CHECK(handed_off == "A.def#1 B.def#1 " || handed_off == "B.def#1 A.def#1 ");
+        const nh3api::resource_preloader_stats stats = loader.stats();
+        NH3API_CHECK(stats.requested == 4 && stats.skipped == 1 && stats.loaded == 2 && stats.failed == 2 && stats.handed_off == 2);
+
+        // the staged entries dropped by cancel() are passed to the discard callback
+        loader.request(manifest({ "D.def" }));
+        loader.wait();
+        std::string discarded;
+        loader.cancel([&discarded](const nh3api::preload_entry&, std::string&& staged) { discarded += staged; });
+        NH3API_CHECK(discarded == "D.def#1" && loader.staged() == 0);
+    }
+
+    return nh3api_test::result("resource_preloader_test");
+}
@@ -0,0 +1,190 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// sprite_atlas_builder: the frame pixels in the pages, no overlaps, the page bounds, oversized and damaged frames, the offsets
+
+#include <cstdint> // uint8_t, uint16_t, int32_t
+#include <vector>  // std::vector
+
+#include "nh3api/portable/sprite_atlas.hpp" // nh3api::sprite_atlas_builder
+#include "test.hpp"
+
+using nh3api::atlas_frame;
+using nh3api::def_frame;
+
+namespace
+{
+
+constexpr uint32_t page_size = 256;
+constexpr uint32_t padding   = 1;
+
+// raw frame of <width> x <height> non-transparent indices placed at (x, y) of a larger frame
+def_frame make_frame(std::vector<std::vector<uint8_t>>& storage, nh3api_test::random& random, int32_t width, int32_t height)
+{
+    storage.emplace_back(size_t(width) * size_t(height));
+    for ( uint8_t& index : storage.back() )
+        index = static_cast<uint8_t>(1 + random.below(255));
+
+    def_frame frame;
+    frame.header.encoding       = nh3api::def_encoding::raw;
+    frame.header.cropped_width  = width;
+    frame.header.cropped_height = height;
+    frame.header.cropped_x      = static_cast<int32_t>(random.below(8));
+    frame.header.cropped_y      = static_cast<int32_t>(random.below(8));
+    frame.header.width          = width + frame.header.cropped_x + static_cast<int32_t>(random.below(8));
+    frame.header.height         = height + frame.header.cropped_y + static_cast<int32_t>(random.below(8));
+    frame.header.data_size      = static_cast<uint32_t>(storage.back().size());
+    frame.data                  = { reinterpret_cast<const std::byte*>(storage.back().data()), storage.back().size() };
+    return frame;
+}
+
+bool same_pixels(const nh3api::sprite_atlas& atlas, const atlas_frame& placed, const std::vector<uint8_t>& indices)
+{
+    const uint8_t* const pixels = atlas.pixels(placed);
+    for ( size_t y = 0; y < placed.height; ++y )
+        for ( size_t x = 0; x < placed.width; ++x )
+            if ( pixels[y * atlas.page_width + x] != indices[y * placed.width + x] )
+                return false;
+    return true;
+}
+
+// the rectangles with their padding stay in the page and cover each pixel at most once
+void check_layout(const nh3api::sprite_atlas& atlas)
+{
+    std::vector<std::vector<uint8_t>> covered(atlas.pages.size());
+    for ( size_t page = 0; page < atlas.pages.size(); ++page )
+    {
+        NH3API_CHECK(atlas.pages[page].pixels.size() == size_t(atlas.page_width) * atlas.pages[page].height);
+        covered[page].assign(atlas.pages[page].pixels.size(), 0);
+    }
+
+    size_t overlaps = 0;
+    for ( const atlas_frame& placed : atlas.frames )
+    {
+        if ( placed.width == 0 || placed.height == 0 )
+            continue;
+        if ( !NH3API_CHECK(placed.page < atlas.pages.size()) || !NH3API_CHECK(placed.x >= padding && placed.y >= padding)
+             || !NH3API_CHECK(placed.x + placed.width + padding <= atlas.page_width)
+             || !NH3API_CHECK(placed.y + placed.height + padding <= atlas.pages[placed.page].height) )
+            continue;
+
+        for ( size_t y = placed.y - padding; y < placed.y + placed.height + padding; ++y )
+            for ( size_t x = placed.x - padding; x < placed.x + placed.width + padding; ++x )
+                overlaps += covered[placed.page][y * atlas.page_width + x]++ != 0;
+    }
+    NH3API_CHECK(overlaps == 0);
+}
+
+void test_packing()
+{
+    nh3api_test::random               random(14);
+    std::vector<std::vector<uint8_t>> storage;
+    nh3api::def_file                  def;
+    // enough frames for several pages and the parallel decoding
+    for ( size_t i = 0; i < 300; ++i )
+        def.frames.push_back(make_frame(storage, random, static_cast<int32_t>(1 + random.below(80)), static_cast<int32_t>(1 + random.below(80))));
+
+    nh3api::sprite_atlas_builder builder({ page_size, page_size, padding, 0 });
+    NH3API_CHECK(builder.add(def.frames[0]) == 0);
+    const size_t first = builder.add(def);
+    NH3API_CHECK(first == 1 && builder.size() == def.frames.size() + 1);
+
+    nh3api::sprite_atlas        atlas;
+    nh3api::sprite_atlas_report report;
+    builder.build(atlas, &report);
+    NH3API_CHECK(atlas.page_width == page_size);
+    NH3API_CHECK(atlas.frames.size() == builder.size());
+    NH3API_CHECK(report.frames == builder.size() && report.pages == atlas.pages.size() && report.failed == 0);
+    NH3API_CHECK(atlas.pages.size() > 1);
+    NH3API_CHECK(report.efficiency() > 0.5 && report.efficiency() <= 1.0);
+    for ( const nh3api::sprite_atlas::page& page : atlas.pages )
+        NH3API_CHECK(page.height <= page_size);
+
+    check_layout(atlas);
+    NH3API_CHECK(same_pixels(atlas, atlas.frames[0], storage[0]));
+    for ( size_t i = 0; i < def.frames.size(); ++i )
+    {
+        const atlas_frame&              placed = atlas.frames[first + i];
+        const nh3api::def_frame_header& header = def.frames[i].header;
+        NH3API_CHECK(same_pixels(atlas, placed, storage[i]));
+        NH3API_CHECK(placed.frame_width == header.width && placed.frame_height == header.height);
+        NH3API_CHECK(placed.offset_x == header.cropped_x && placed.offset_y == header.cropped_y);
+        NH3API_CHECK(placed.hflip_offset_x + placed.width + placed.offset_x == header.width);
+        NH3API_CHECK(placed.bottom_margin + placed.height + placed.offset_y == header.height);
+    }
+}
+
+// a frame wider and taller than the page widens all the pages and fills a page of its own
+void test_oversized()
+{
+    nh3api_test::random               random(15);
+    std::vector<std::vector<uint8_t>> storage;
+    std::vector<def_frame>            frames;
+    for ( size_t i = 0; i < 20; ++i )
+        frames.push_back(make_frame(storage, random, static_cast<int32_t>(1 + random.below(60)), static_cast<int32_t>(1 + random.below(60))));
+    frames.push_back(make_frame(storage, random, 300, 400));
+    // taller than the page, but not wider
+    frames.push_back(make_frame(storage, random, 40, 350));
+
+    nh3api::sprite_atlas_builder builder({ page_size, page_size, padding, 1 });
+    for ( const def_frame& frame : frames )
+        builder.add(frame);
+    nh3api::sprite_atlas atlas;
+    builder.build(atlas);
+    check_layout(atlas);
+    NH3API_CHECK(atlas.page_width == 300 + padding * 2);
+
+    const atlas_frame& oversized = atlas.frames[20];
+    NH3API_CHECK(atlas.pages[oversized.page].height == 400 + padding * 2);
+    for ( size_t i = 0; i < atlas.frames.size(); ++i )
+        NH3API_CHECK(i == 20 || atlas.frames[i].page != oversized.page);
+
+    const atlas_frame& tall = atlas.frames[21];
+    NH3API_CHECK(atlas.pages[tall.page].height >= 350 + padding * 2);
+    for ( size_t i = 0; i < frames.size(); ++i )
+        NH3API_CHECK(same_pixels(atlas, atlas.frames[i], storage[i]));
+}
+
+// a frame with less data than its size is counted as failed and left transparent, an empty frame takes no space
+void test_damaged()
+{
+    nh3api_test::random               random(16);
+    std::vector<std::vector<uint8_t>> storage;
+    std::vector<def_frame>            frames;
+    for ( size_t i = 0; i < 3; ++i )
+        frames.push_back(make_frame(storage, random, 30, 30));
+    frames[1].data = frames[1].data.subspan(0, 100);
+    def_frame empty;
+    empty.header.width  = 10;
+    empty.header.height = 12;
+    frames.push_back(empty);
+
+    nh3api::sprite_atlas_builder builder({ page_size, page_size, padding, 1 });
+    for ( const def_frame& frame : frames )
+        builder.add(frame);
+    nh3api::sprite_atlas        atlas;
+    nh3api::sprite_atlas_report report;
+    builder.build(atlas, &report);
+    check_layout(atlas);
+    NH3API_CHECK(report.failed == 1 && report.frame_pixels == 3 * 30 * 30);
+    NH3API_CHECK(same_pixels(atlas, atlas.frames[0], storage[0]) && same_pixels(atlas, atlas.frames[2], storage[2]));
+    NH3API_CHECK(same_pixels(atlas, atlas.frames[1], std::vector<uint8_t>(30 * 30, 0)));
+    NH3API_CHECK(atlas.frames[3].width == 0 && atlas.frames[3].frame_width == 10 && atlas.frames[3].bottom_margin == 12);
+}
+
+} // namespace
+
+int main()
+{
+    test_packing();
+    test_oversized();
+    test_damaged();
+    return nh3api_test::result("sprite_atlas_test");
+}
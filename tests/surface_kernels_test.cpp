@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// darken() and colorize() must be bit-exact with darken_scalar() and colorize_scalar()
+
+#include <cstdint> // uint16_t, uint32_t, int32_t
+#include <vector>  // std::vector
+
+#include "nh3api/portable/surface_kernels.hpp" // nh3api::darken, nh3api::colorize
+#include "test.hpp"
+
+using nh3api::pixel_format;
+
+namespace
+{
+
+// a random bitmap with a random pitch, the bytes past the width of the rows are compared too
+template<class Pixel>
+struct test_surface
+{
+    std::vector<Pixel>         storage;
+    nh3api::surface_view<Pixel> view;
+
+    test_surface(nh3api_test::random& random, int32_t width, int32_t height)
+    {
+        const int32_t stride = width + static_cast<int32_t>(random.below(20));
+        storage.resize(static_cast<size_t>(stride) * static_cast<size_t>(height));
+        for ( Pixel& pixel : storage )
+            pixel = static_cast<Pixel>(random.next());
+        view = { storage.data(), width, height, stride * static_cast<int32_t>(sizeof(Pixel)) };
+    }
+
+    test_surface(const test_surface& other)
+        : storage { other.storage }, view { storage.data(), other.view.width, other.view.height, other.view.pitch }
+    {}
+};
+
+struct test_rect
+{
+    int32_t x, y, w, h;
+};
+
+// random rectangle, partially or completely outside of the surface now and then
+test_rect random_rect(nh3api_test::random& random, int32_t width, int32_t height)
+{
+    test_rect rect;
+    rect.x = static_cast<int32_t>(random.below(static_cast<uint32_t>(width) + 16)) - 8;
+    rect.y = static_cast<int32_t>(random.below(static_cast<uint32_t>(height) + 16)) - 8;
+    rect.w = static_cast<int32_t>(random.below(static_cast<uint32_t>(width) + 16)) - 2;
+    rect.h = static_cast<int32_t>(random.below(static_cast<uint32_t>(height) + 16)) - 2;
+    return rect;
+}
+
+template<class Pixel, class Vectorized, class Scalar>
+void compare(nh3api_test::random& random, Vectorized&& vectorized, Scalar&& scalar)
+{
+    const int32_t width  = 1 + static_cast<int32_t>(random.below(90));
+    const int32_t height = 1 + static_cast<int32_t>(random.below(12));
+    test_surface<Pixel> expected(random, width, height);
+    test_surface<Pixel> actual(expected);
+    const test_rect rect = random_rect(random, width, height);
+    vectorized(actual.view, rect);
+    scalar(expected.view, rect);
+    NH3API_CHECK(actual.storage == expected.storage);
+}
+
+} // namespace
+
+int main()
+{
+    nh3api_test::random random(0x4E48335355524631ULL);
+    constexpr pixel_format formats16[] = { pixel_format::rgb565, pixel_format::rgb555 };
+    for ( int iteration = 0; iteration < 1000; ++iteration )
+    {
+        const pixel_format format     = formats16[iteration % 2];
+        const float        hue        = static_cast<float>(random.below(3600)) / 10.0f;
+        const float        saturation = static_cast<float>(random.below(1001)) / 1000.0f;
+
+        compare<uint16_t>(random,
+            [format](const nh3api::surface16& surface, const test_rect& r) { nh3api::darken(surface, r.x, r.y, r.w, r.h, format); },
+            [format](const nh3api::surface16& surface, const test_rect& r) { nh3api::darken_scalar(surface, r.x, r.y, r.w, r.h, format); });
+        compare<uint32_t>(random,
+            [](const nh3api::surface32& surface, const test_rect& r) { nh3api::darken(surface, r.x, r.y, r.w, r.h); },
+            [](const nh3api::surface32& surface, const test_rect& r) { nh3api::darken_scalar(surface, r.x, r.y, r.w, r.h); });
+        compare<uint16_t>(random,
+            [=](const nh3api::surface16& surface, const test_rect& r) { nh3api::colorize(surface, r.x, r.y, r.w, r.h, hue, saturation, format); },
+            [=](const nh3api::surface16& surface, const test_rect& r) { nh3api::colorize_scalar(surface, r.x, r.y, r.w, r.h, hue, saturation, format); });
+        compare<uint32_t>(random,
+            [=](const nh3api::surface32& surface, const test_rect& r) { nh3api::colorize(surface, r.x, r.y, r.w, r.h, hue, saturation); },
+            [=](const nh3api::surface32& surface, const test_rect& r) { nh3api::colorize_scalar(surface, r.x, r.y, r.w, r.h, hue, saturation); });
+    }
+
+    return nh3api_test::result("surface_kernels_test");
+}
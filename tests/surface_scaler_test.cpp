@@ -0,0 +1,251 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// surface_scaler: small golden images of each filter, then random images against a per-pixel reference
+// for every thread count and band size, in 16 and 32 bits
+
+#include <algorithm> // std::min, std::max, std::clamp
+#include <array>     // std::array
+#include <cstdint>   // uint16_t, uint32_t, int32_t, int64_t
+#include <utility>   // std::move
+#include <vector>    // std::vector
+
+#include "nh3api/portable/surface_scaler.hpp" // nh3api::surface_scaler
+#include "test.hpp"
+
+using nh3api::pixel_format;
+using nh3api::scale_filter;
+
+namespace
+{
+
+template<class Pixel>
+struct image
+{
+    int32_t            width {0};
+    int32_t            height {0};
+    std::vector<Pixel> pixels;
+
+    image(int32_t image_width, int32_t image_height)
+        : width { image_width }, height { image_height }, pixels(static_cast<size_t>(image_width) * static_cast<size_t>(image_height))
+    {}
+
+    image(int32_t image_width, int32_t image_height, std::vector<Pixel> image_pixels)
+        : width { image_width }, height { image_height }, pixels { std::move(image_pixels) }
+    {}
+
+    [[nodiscard]] Pixel& at(int32_t x, int32_t y)
+    { return pixels[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)]; }
+
+    [[nodiscard]] Pixel at(int32_t x, int32_t y) const
+    { return pixels[static_cast<size_t>(y) * static_cast<size_t>(width) + static_cast<size_t>(x)]; }
+
+    [[nodiscard]] nh3api::surface_view<Pixel> view()
+    { return { pixels.data(), width, height, width * static_cast<int32_t>(sizeof(Pixel)) }; }
+};
+
+template<class Pixel>
+image<Pixel> scale(const image<Pixel>& source, int32_t width, int32_t height, scale_filter filter,
+                   pixel_format format = pixel_format::rgb565, size_t threads = 1, int32_t band_rows = 64)
+{
+    image<Pixel>           input(source);
+    image<Pixel>           output(width, height);
+    nh3api::surface_scaler scaler({ filter, threads, band_rows });
+    if constexpr ( sizeof(Pixel) == 2 )
+        scaler.scale(input.view(), output.view(), format);
+    else
+        scaler.scale(input.view(), output.view());
+    return output;
+}
+
+// the per-pixel reference of each filter, written from the definitions rather than from the band code
+
+int32_t nearest_position(int32_t i, int32_t source, int32_t target)
+{
+    // the center of target pixel i, (i + 0.5) * source / target, rounded down
+    return static_cast<int32_t>((int64_t(2 * i + 1) * source) / (int64_t(2) * target));
+}
+
+template<class Pixel>
+image<Pixel> reference_nearest(const image<Pixel>& source, int32_t width, int32_t height)
+{
+    image<Pixel> result(width, height);
+    for ( int32_t y = 0; y < height; ++y )
+        for ( int32_t x = 0; x < width; ++x )
+            result.at(x, y) = source.at(nearest_position(x, source.width, width), nearest_position(y, source.height, height));
+    return result;
+}
+
+// the source coordinate of the center of target pixel i in 1/256 units, the two pixels around it and the weight of the second one
+void bilinear_position(int32_t i, int32_t source, int32_t target, int32_t& first, int32_t& second, uint32_t& weight)
+{
+    const int64_t position = std::max<int64_t>(0, (int64_t(2 * i + 1) * source * 256) / (int64_t(2) * target) - 128);
+    first  = std::min<int32_t>(static_cast<int32_t>(position / 256), source - 1);
+    weight = first == source - 1 ? 0 : static_cast<uint32_t>(position % 256);
+    second = std::min(first + 1, source - 1);
+}
+
+uint32_t lerp(uint32_t a, uint32_t b, uint32_t weight)
+{ return (a * (256 - weight) + b * weight + 128) / 256; }
+
+// the channels of a pixel: shift and mask of each one
+struct channel
+{
+    uint32_t shift;
+    uint32_t mask;
+};
+
+template<class Pixel>
+image<Pixel> reference_bilinear(const image<Pixel>& source, int32_t width, int32_t height, pixel_format format)
+{
+    static constexpr std::array<channel, 4> argb8888 { { { 0, 0xFF }, { 8, 0xFF }, { 16, 0xFF }, { 24, 0xFF } } };
+    static constexpr std::array<channel, 3> rgb555 { { { 0, 0x1F }, { 5, 0x1F }, { 10, 0x1F } } };
+    static constexpr std::array<channel, 3> rgb565 { { { 0, 0x1F }, { 5, 0x3F }, { 11, 0x1F } } };
+    const channel* begin = argb8888.data();
+    const channel* end   = argb8888.data() + argb8888.size();
+    if constexpr ( sizeof(Pixel) == 2 )
+    {
+        begin = format == pixel_format::rgb555 ? rgb555.data() : rgb565.data();
+        end   = begin + 3;
+    }
+
+    image<Pixel> result(width, height);
+    for ( int32_t y = 0; y < height; ++y )
+        for ( int32_t x = 0; x < width; ++x )
+        {
+            int32_t  left, right, top, bottom;
+            uint32_t wx, wy;
+            bilinear_position(x, source.width, width, left, right, wx);
+            bilinear_position(y, source.height, height, top, bottom, wy);
+            uint32_t pixel = 0;
+            for ( const channel* it = begin; it != end; ++it )
+            {
+                const channel& c = *it;
+                const auto value = [&](int32_t sx, int32_t sy) { return (uint32_t(source.at(sx, sy)) >> c.shift) & c.mask; };
+                // horizontally first, then vertically
+                const uint32_t upper = lerp(value(left, top), value(right, top), wx);
+                const uint32_t lower = lerp(value(left, bottom), value(right, bottom), wx);
+                pixel |= lerp(upper, lower, wy) << c.shift;
+            }
+            result.at(x, y) = static_cast<Pixel>(pixel);
+        }
+    return result;
+}
+
+// Scale2x(AdvMAME2x) with the edges clamped, repeated while it fits, then nearest neighbour
+template<class Pixel>
+image<Pixel> reference_scale2x(image<Pixel> current, int32_t width, int32_t height)
+{
+    while ( 2 * current.width <= width && 2 * current.height <= height )
+    {
+        image<Pixel> next(2 * current.width, 2 * current.height);
+        const auto   clamped = [&current](int32_t x, int32_t y)
+        { return current.at(std::clamp(x, 0, current.width - 1), std::clamp(y, 0, current.height - 1)); };
+        for ( int32_t y = 0; y < current.height; ++y )
+            for ( int32_t x = 0; x < current.width; ++x )
+            {
+                const Pixel b = clamped(x, y - 1), d = clamped(x - 1, y), e = clamped(x, y), f = clamped(x + 1, y), h = clamped(x, y + 1);
+                const bool  edge = b != h && d != f;
+                next.at(2 * x, 2 * y)         = edge && d == b ? d : e;
+                next.at(2 * x + 1, 2 * y)     = edge && b == f ? f : e;
+                next.at(2 * x, 2 * y + 1)     = edge && d == h ? d : e;
+                next.at(2 * x + 1, 2 * y + 1) = edge && h == f ? f : e;
+            }
+        current = std::move(next);
+    }
+    return current.width == width && current.height == height ? current : reference_nearest(current, width, height);
+}
+
+template<class Pixel>
+image<Pixel> random_image(nh3api_test::random& random, int32_t width, int32_t height)
+{
+    // a few colors, so that Scale2x finds edges, and some noise for the bilinear filter
+    const Pixel  colors[4] = { static_cast<Pixel>(random.next()), static_cast<Pixel>(random.next()), static_cast<Pixel>(random.next()), static_cast<Pixel>(random.next()) };
+    image<Pixel> result(width, height);
+    for ( Pixel& pixel : result.pixels )
+        pixel = random.below(8) == 0 ? static_cast<Pixel>(random.next()) : colors[random.below(4)];
+    return result;
+}
+
+void golden_images()
+{
+    constexpr uint16_t a = 0x1234, b = 0xFEDC;
+
+    // nearest, integer factor: exact blocks
+    NH3API_CHECK(scale(image<uint16_t>(2, 1, { a, b }), 4, 2, scale_filter::nearest).pixels
+                 == std::vector<uint16_t> { a, a, b, b, a, a, b, b });
+    // nearest, 3 to 2 columns: the centers 0.75 and 2.25
+    NH3API_CHECK(scale(image<uint32_t>(3, 1, { 1, 2, 3 }), 2, 1, scale_filter::nearest).pixels == std::vector<uint32_t> { 1, 3 });
+
+    // bilinear, 2 to 4 columns: the centers 0.25, 0.75, 1.25 and 1.75 of the source pixels, the edges clamped
+    NH3API_CHECK(scale(image<uint32_t>(2, 1, { 0xFF000000, 0xFF0000FF }), 4, 1, scale_filter::bilinear).pixels
+                 == std::vector<uint32_t> { 0xFF000000, 0xFF000040, 0xFF0000BF, 0xFF0000FF });
+    // bilinear, RGB565 green(6 bits) and RGB555 red(5 bits) at the same positions
+    NH3API_CHECK(scale(image<uint16_t>(2, 1, { 0, 0x07E0 }), 4, 1, scale_filter::bilinear, pixel_format::rgb565).pixels
+                 == std::vector<uint16_t> { 0, 0x0200, 0x05E0, 0x07E0 });
+    NH3API_CHECK(scale(image<uint16_t>(1, 2, { 0, 0x7C00 }), 1, 4, scale_filter::bilinear, pixel_format::rgb555).pixels
+                 == std::vector<uint16_t> { 0, 0x2000, 0x5C00, 0x7C00 });
+
+    // Scale2x: the corner of <a> is rounded, the rest is <b>
+    NH3API_CHECK(scale(image<uint16_t>(2, 2, { a, b, b, b }), 4, 4, scale_filter::scale2x).pixels
+                 == std::vector<uint16_t> { a, a, b, b,
+                                            a, b, b, b,
+                                            b, b, b, b,
+                                            b, b, b, b });
+    // Scale2x: the pixels of a checkerboard are joined along the diagonals
+    NH3API_CHECK(scale(image<uint32_t>(2, 2, { 1, 0, 0, 1 }), 4, 4, scale_filter::scale2x).pixels
+                 == std::vector<uint32_t> { 1, 1, 0, 0,
+                                            1, 0, 1, 0,
+                                            0, 1, 0, 1,
+                                            0, 0, 1, 1 });
+}
+
+template<class Pixel>
+void compare_with_reference(nh3api_test::random& random)
+{
+    struct size
+    {
+        int32_t source_width, source_height, width, height;
+    };
+    // upscaling by integer and fractional factors, downscaling, Scale2x with one and two passes and a nearest rest, single pixels
+    constexpr size sizes[] = { { 40, 30, 80, 60 }, { 40, 30, 160, 120 }, { 37, 23, 100, 77 }, { 40, 30, 90, 70 },
+                               { 100, 80, 33, 27 }, { 1, 1, 5, 3 }, { 9, 1, 31, 2 }, { 64, 48, 64, 48 } };
+    constexpr scale_filter  filters[] = { scale_filter::nearest, scale_filter::bilinear, scale_filter::scale2x };
+    constexpr pixel_format  formats[] = { pixel_format::rgb565, pixel_format::rgb555 };
+    for ( const size& current : sizes )
+        for ( const scale_filter filter : filters )
+            for ( const pixel_format format : formats )
+            {
+                if ( sizeof(Pixel) == 4 && format == pixel_format::rgb555 )
+                    continue;
+
+                const image<Pixel> source   = random_image<Pixel>(random, current.source_width, current.source_height);
+                const image<Pixel> expected = filter == scale_filter::nearest  ? reference_nearest(source, current.width, current.height)
+                                            : filter == scale_filter::bilinear ? reference_bilinear(source, current.width, current.height, format)
+                                                                               : reference_scale2x(source, current.width, current.height);
+                // the result must not depend on the threads nor on the band size
+                bool same = true;
+                for ( const size_t threads : { size_t(1), size_t(2), size_t(4) } )
+                    for ( const int32_t band_rows : { 1, 7, 64 } )
+                        same = same && scale(source, current.width, current.height, filter, format, threads, band_rows).pixels == expected.pixels;
+                NH3API_CHECK(same);
+            }
+}
+
+} // namespace
+
+int main()
+{
+    golden_images();
+    nh3api_test::random random(0x4E48335343414C45ULL);
+    compare_with_reference<uint16_t>(random);
+    compare_with_reference<uint32_t>(random);
+    return nh3api_test::result("surface_scaler_test");
+}
@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+// Minimal checks for the tests of the host-portable headers: no dependencies, one executable per test
+
+#include <cstdint> // uint32_t, uint64_t
+#include <cstdio>  // std::fprintf, std::printf
+
+namespace nh3api_test
+{
+
+inline int failures = 0;
+
+inline bool check(bool passed, const char* expression, const char* file, int line) noexcept
+{
+    if ( !passed )
+    {
+        ++failures;
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+    }
+    return passed;
+}
+
+// the exit code of the test
+[[nodiscard]] inline int result(const char* name) noexcept
+{
+    if ( failures == 0 )
+        std::printf("%s: passed\n", name);
+    else
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, failures);
+    return failures == 0 ? 0 : 1;
+}
+
+// deterministic pseudo-random numbers(xorshift64*), the same on every platform
+class random
+{
+    public:
+        explicit random(uint64_t seed) noexcept
+            : m_state { seed ? seed : 1 }
+        {}
+
+        uint32_t next() noexcept
+        {
+            m_state ^= m_state >> 12U;
+            m_state ^= m_state << 25U;
+            m_state ^= m_state >> 27U;
+            return static_cast<uint32_t>((m_state * 0x2545F4914F6CDD1DULL) >> 32U);
+        }
+
+        // [0, bound)
+        uint32_t below(uint32_t bound) noexcept
+        { return bound ? next() % bound : 0; }
+
+    protected:
+        uint64_t m_state;
+
+};
+
+} // namespace nh3api_test
+
+#define NH3API_CHECK(...) ::nh3api_test::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// text_layout: wrapping, alignment and highlighting of layout_text, read_font_file, glyph_atlas drawing and the layout cache
+
+#include <cstdint>     // uint8_t, uint16_t, int32_t, uint32_t
+#include <string>      // std::string
+#include <string_view> // std::string_view
+#include <vector>      // std::vector
+
+#include "nh3api/portable/text_layout.hpp" // nh3api::layout_text, nh3api::glyph_atlas, nh3api::text_layout_cache
+#include "test.hpp"
+
+using nh3api::text_align;
+
+namespace
+{
+
+constexpr int32_t font_height = 4;
+
+// the letters are 1 + 4 + 1 pixels wide, the space 4 pixels without a glyph, the digits 2 + 3 + 0.
+// The glyph pixels count up: 0 transparent, 1 shadow, the rest text
+std::vector<std::byte> make_pixels(nh3api::bitmap_font& font)
+{
+    std::vector<std::byte> pixels;
+    for ( size_t character = 0; character < 256; ++character )
+    {
+        nh3api::bitmap_font::glyph& glyph = font.glyphs[character];
+        if ( character == ' ' )
+            glyph = { 0, 0, 4, 0 };
+        else if ( character >= 'a' && character <= 'z' )
+            glyph = { 1, 4, 1, 0 };
+        else if ( character >= '0' && character <= '9' )
+            glyph = { 2, 3, 0, 0 };
+        else
+            continue;
+
+        glyph.offset = static_cast<uint32_t>(pixels.size());
+        for ( int32_t i = 0; i < glyph.b * font_height; ++i )
+            pixels.push_back(std::byte(static_cast<uint8_t>((character + static_cast<size_t>(i)) % 4)));
+    }
+    font.height   = font_height;
+    font.baseline = 3;
+    return pixels;
+}
+
+struct line
+{
+    std::string text;
+    int32_t     x;
+    int32_t     width;
+};
+
+bool same_lines(const nh3api::text_layout& layout, std::string_view text, const std::vector<line>& expected)
+{
+    if ( layout.lines.size() != expected.size() )
+        return false;
+    for ( size_t i = 0; i < expected.size(); ++i )
+    {
+        const nh3api::text_line& actual = layout.lines[i];
+        if ( text.substr(actual.begin, actual.end - actual.begin) != expected[i].text || actual.x != expected[i].x || actual.width != expected[i].width )
+            return false;
+    }
+    return layout.height == static_cast<int32_t>(expected.size()) * font_height;
+}
+
+void test_layout(const nh3api::bitmap_font& font)
+{
+    nh3api::text_layout layout;
+    const auto check = [&](std::string_view text, int32_t box_width, text_align align, const std::vector<line>& expected)
+    {
+        nh3api::layout_text(font, text, box_width, align, layout);
+        return same_lines(layout, text, expected);
+    };
+
+    NH3API_CHECK(check("ab cd", 100, text_align::left, { { "ab cd", 0, 28 } }));
+    // "aaa bbb" is exactly 40 pixels, the spaces at the wrap are dropped
+    NH3API_CHECK(check("aaa bbb   ccc", 40, text_align::left, { { "aaa bbb", 0, 40 }, { "ccc", 0, 18 } }));
+    NH3API_CHECK(check("aaa bbb ccc", 39, text_align::left, { { "aaa", 0, 18 }, { "bbb", 0, 18 }, { "ccc", 0, 18 } }));
+    // '\n' ends a line, the empty lines are kept
+    NH3API_CHECK(check("ab\n\ncd\n", 100, text_align::left, { { "ab", 0, 12 }, { "", 0, 0 }, { "cd", 0, 12 }, { "", 0, 0 } }));
+    // a word wider than the box is broken between the characters, at least one per line
+    NH3API_CHECK(check("aaaaaaa", 20, text_align::left, { { "aaa", 0, 18 }, { "aaa", 0, 18 }, { "a", 0, 6 } }));
+    NH3API_CHECK(check("ab", 3, text_align::left, { { "a", 0, 6 }, { "b", 0, 6 } }));
+    // the braces take no space
+    NH3API_CHECK(check("a{b}c 1", 100, text_align::left, { { "a{b}c 1", 0, 27 } }));
+    // alignment in the box, or to the widest line without wrapping
+    NH3API_CHECK(check("ab\nabcd", 40, text_align::center, { { "ab", 14, 12 }, { "abcd", 8, 24 } }));
+    NH3API_CHECK(check("ab\nabcd", 40, text_align::right, { { "ab", 28, 12 }, { "abcd", 16, 24 } }));
+    NH3API_CHECK(check("ab\nabcd", 0, text_align::right, { { "ab", 12, 12 }, { "abcd", 0, 24 } }));
+    NH3API_CHECK(layout.width == 24);
+
+    // the glyphs: a + pen, one row per line, the highlighting goes on across the lines, the space has no glyph
+    nh3api::layout_text(font, "{a 1\nb}c", 100, text_align::left, layout);
+    const nh3api::text_glyph expected[] = { { 1, 0, 'a', true }, { 12, 0, '1', true }, { 1, 4, 'b', true }, { 7, 4, 'c', false } };
+    NH3API_CHECK(layout.glyphs.size() == 4);
+    for ( size_t i = 0; i < 4 && i < layout.glyphs.size(); ++i )
+    {
+        const nh3api::text_glyph& glyph = layout.glyphs[i];
+        NH3API_CHECK(glyph.x == expected[i].x && glyph.y == expected[i].y && glyph.character == expected[i].character
+                     && glyph.highlighted == expected[i].highlighted);
+    }
+}
+
+void put_u32(std::vector<std::byte>& data, size_t offset, uint32_t value)
+{
+    for ( size_t i = 0; i < 4; ++i )
+        data[offset + i] = std::byte(static_cast<uint8_t>(value >> (i * 8)));
+}
+
+// the .fnt header(font::TFontSpec) with the glyphs of <font>, then the pixels
+void test_read_font(const nh3api::bitmap_font& font, const std::vector<std::byte>& pixels)
+{
+    std::vector<std::byte> file(0x1020, std::byte { 0 });
+    file[5] = std::byte(static_cast<uint8_t>(font.height));
+    file[6] = std::byte(static_cast<uint8_t>(font.baseline));
+    for ( size_t i = 0; i < 256; ++i )
+    {
+        put_u32(file, 32 + i * 12, static_cast<uint32_t>(font.glyphs[i].a));
+        put_u32(file, 36 + i * 12, static_cast<uint32_t>(font.glyphs[i].b));
+        put_u32(file, 40 + i * 12, static_cast<uint32_t>(font.glyphs[i].c));
+        put_u32(file, 3104 + i * 4, font.glyphs[i].offset);
+    }
+    file.insert(file.end(), pixels.begin(), pixels.end());
+
+    nh3api::bitmap_font read;
+    NH3API_CHECK(nh3api::read_font_file({ file.data(), file.size() }, read));
+    NH3API_CHECK(read.height == font.height && read.baseline == font.baseline && read.pixels.size() == pixels.size());
+    for ( size_t i = 0; i < 256; ++i )
+        NH3API_CHECK(read.glyphs[i].a == font.glyphs[i].a && read.glyphs[i].b == font.glyphs[i].b
+                     && read.glyphs[i].c == font.glyphs[i].c && read.glyphs[i].offset == font.glyphs[i].offset);
+    NH3API_CHECK(!nh3api::read_font_file({ file.data(), 0x1000 }, read));
+}
+
+// the glyph pixels drawn one by one: 0 keeps the target, 1 is the shadow, the rest the text color
+void draw_reference(const nh3api::bitmap_font& font, const nh3api::surface_view<uint16_t>& target, int32_t x, int32_t y,
+                    uint8_t character, uint16_t text, uint16_t shadow)
+{
+    const nh3api::bitmap_font::glyph& glyph = font.glyphs[character];
+    if ( !font.has_pixels(character) )
+        return;
+    for ( int32_t row = 0; row < font.height; ++row )
+        for ( int32_t column = 0; column < glyph.b; ++column )
+        {
+            const uint8_t value = static_cast<uint8_t>(font.pixels[glyph.offset + static_cast<size_t>(row * glyph.b + column)]);
+            if ( value != 0 && x + column >= 0 && x + column < target.width && y + row >= 0 && y + row < target.height )
+                target.row(y + row)[x + column] = value == 1 ? shadow : text;
+        }
+}
+
+void test_atlas(const nh3api::bitmap_font& font)
+{
+    constexpr int32_t width = 20, height = 10, pitch = 24;
+    const nh3api::glyph_atlas<uint16_t> white(font, 0xFFFF, 0x0000), gold(font, 0xEF4B, 0x0001);
+    NH3API_CHECK(white.height() == font_height);
+
+    // one glyph inside, across each edge and outside
+    const int32_t positions[][2] = { { 3, 3 }, { -2, 3 }, { width - 2, 3 }, { 3, -2 }, { 3, height - 2 }, { -3, -3 }, { width, 0 }, { 0, -font_height } };
+    size_t mismatches = 0;
+    for ( const auto& [x, y] : positions )
+        for ( const uint8_t character : { uint8_t('a'), uint8_t('7'), uint8_t(' '), uint8_t('A') } )
+        {
+            std::vector<uint16_t> expected(size_t(pitch) * height, 0x5555), actual = expected;
+            draw_reference(font, { expected.data(), width, height, pitch * 2 }, x, y, character, 0xFFFF, 0x0000);
+            white.draw({ actual.data(), width, height, pitch * 2 }, x, y, character);
+            mismatches += actual != expected;
+        }
+
+    // a layout: the highlighted glyphs from the second atlas
+    nh3api::text_layout layout;
+    nh3api::layout_text(font, "a{b}\n{1}2", 0, text_align::left, layout);
+    std::vector<uint16_t> expected(size_t(pitch) * height, 0x5555), actual = expected;
+    const nh3api::surface_view<uint16_t> reference { expected.data(), width, height, pitch * 2 }, target { actual.data(), width, height, pitch * 2 };
+    for ( const nh3api::text_glyph& glyph : layout.glyphs )
+        draw_reference(font, reference, 1 + glyph.x, 1 + glyph.y, glyph.character, glyph.highlighted ? 0xEF4B : 0xFFFF, glyph.highlighted ? 0x0001 : 0x0000);
+    white.draw(target, 1, 1, layout, &gold);
+    mismatches += actual != expected;
+    NH3API_CHECK(mismatches == 0);
+}
+
+void test_cache(const nh3api::bitmap_font& font)
+{
+    nh3api::bitmap_font other = font;
+    nh3api::text_layout_cache cache(3);
+    const auto first = cache.get(font, "ab cd", 100);
+    NH3API_CHECK(cache.get(font, std::string("ab cd"), 100) == first);
+    // the box, the alignment and the font are parts of the key
+    NH3API_CHECK(cache.get(font, "ab cd", 10) != first);
+    NH3API_CHECK(cache.get(font, "ab cd", 100, text_align::center) != first);
+    NH3API_CHECK(cache.stats().hits == 1 && cache.stats().misses == 3 && cache.stats().entries == 3);
+
+    // the least recently used layout goes: "ab cd" at 10
+    NH3API_CHECK(cache.get(font, "ab cd", 100) == first);
+    const auto other_layout = cache.get(other, "ab cd", 100);
+    NH3API_CHECK(other_layout != first && cache.stats().evictions == 1);
+    NH3API_CHECK(cache.get(font, "ab cd", 100) == first && cache.stats().misses == 4);
+    cache.get(font, "ab cd", 10);
+    NH3API_CHECK(cache.stats().misses == 5 && cache.stats().evictions == 2);
+
+    cache.erase_font(font);
+    NH3API_CHECK(cache.stats().entries == 1);
+    NH3API_CHECK(cache.get(other, "ab cd", 100) == other_layout);
+    cache.clear();
+    NH3API_CHECK(cache.stats().entries == 0);
+}
+
+} // namespace
+
+int main()
+{
+    nh3api::bitmap_font          font;
+    const std::vector<std::byte> pixels = make_pixels(font);
+    font.pixels = { pixels.data(), pixels.size() };
+
+    test_layout(font);
+    test_read_font(font, pixels);
+    test_atlas(font);
+    test_cache(font);
+    return nh3api_test::result("text_layout_test");
+}
@@ -0,0 +1,261 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the NH3API, under the Apache License v2.0.
+// Copyright (C) devoider17 (aka void_17), 2024-2026
+// You may use this file freely as long as you list the author and the license
+// In the source code files of your project
+// SPDX-License-Identifier: Apache-2.0
+//
+//===----------------------------------------------------------------------===//
+
+// vfs: layer priorities, overrides, removed layers and refresh() against LODs written by lod_writer
+
+#include <chrono>       // std::chrono::seconds
+#include <filesystem>   // std::filesystem
+#include <fstream>      // std::ofstream
+#include <string>       // std::string
+#include <system_error> // std::error_code
+#include <vector>       // std::vector
+
+#include "nh3api/portable/lod_writer.hpp" // nh3api::lod_writer
+#include "nh3api/portable/vfs.hpp"        // nh3api::vfs
+#include "test.hpp"
+
+namespace fs = std::filesystem;
+using bytes  = std::vector<std::byte>;
+
+namespace
+{
+
+bytes payload_of(const std::string& text)
+{
+    bytes result(text.size());
+    for ( size_t i = 0; i < text.size(); ++i )
+        result[i] = std::byte(text[i]);
+    return result;
+}
+
+// write the archive next to <path> and move it over, so that a mapped previous version stays valid
+bool write_lod(const fs::path& path, const std::vector<std::pair<std::string, bytes>>& entries, bool compress = true)
+{
+    nh3api::lod_writer writer;
+    for ( const auto& [name, data] : entries )
+        if ( !writer.add(name, data, 0, compress) )
+            return false;
+
+    const fs::path temporary = path.string() + ".tmp";
+    if ( !writer.write(temporary.string().c_str()) )
+        return false;
+
+    std::error_code error;
+    fs::rename(temporary, path, error);
+    return !error;
+}
+
+// move the modification time forward, the file system may not tell apart two writes in the same second
+void touch(const fs::path& path, int seconds)
+{
+    std::error_code error;
+    fs::last_write_time(path, fs::last_write_time(path, error) + std::chrono::seconds(seconds), error);
+}
+
+bool write_file(const fs::path& path, const std::string& text)
+{
+    std::ofstream file(path, std::ios::binary);
+    file << text;
+    return static_cast<bool>(file);
+}
+
+bytes read(const nh3api::vfs& files, const char* name)
+{
+    bytes result;
+    files.read(name, result);
+    return result;
+}
+
+// the archive layer keeps its lod_archive object when it is rescanned:
+// an entry at the same offset with the same size must not be served from the cache of the previous file
+void test_refresh_through_cache(const fs::path& root)
+{
+    const fs::path path = root / "cached.lod";
+    NH3API_CHECK(write_lod(path, { { "A.TXT", payload_of("first version") } }, false));
+
+    nh3api::vfs             files;
+    nh3api::lod_entry_cache cache;
+    NH3API_CHECK(files.add_archive(path) != nh3api::vfs::invalid_layer);
+
+    nh3api::lod_entry_cache::blob cached = files.read("a.txt", cache);
+    NH3API_CHECK(cached != nullptr && *cached == payload_of("first version"));
+
+    NH3API_CHECK(write_lod(path, { { "A.TXT", payload_of("other version") } }, false));
+    touch(path, 10);
+    NH3API_CHECK(files.refresh());
+
+    cached = files.read("A.TXT", cache);
+    NH3API_CHECK(cached != nullptr && *cached == payload_of("other version"));
+    NH3API_CHECK(read(files, "A.TXT") == payload_of("other version"));
+}
+
+// equal priorities: the layer added later wins, a higher priority wins regardless of the order
+void test_priorities(const fs::path& root)
+{
+    const fs::path first  = root / "first.lod";
+    const fs::path second = root / "second.lod";
+    const fs::path loose  = root / "loose";
+    fs::create_directories(loose);
+    NH3API_CHECK(write_lod(first, { { "SHARED.TXT", payload_of("first") }, { "FIRST.TXT", payload_of("only first") } }));
+    NH3API_CHECK(write_lod(second, { { "shared.txt", payload_of("second") } }));
+    NH3API_CHECK(write_file(loose / "Shared.txt", "loose"));
+
+    nh3api::vfs    files;
+    const uint32_t first_id  = files.add_archive(first);
+    const uint32_t second_id = files.add_archive(second);
+    NH3API_CHECK(first_id != nh3api::vfs::invalid_layer && second_id != nh3api::vfs::invalid_layer);
+    NH3API_CHECK(files.size() == 2);
+    NH3API_CHECK(read(files, "SHARED.TXT") == payload_of("second"));
+    NH3API_CHECK(read(files, "first.txt") == payload_of("only first"));
+
+    nh3api::vfs_entry entry {};
+    NH3API_CHECK(files.find("Shared.Txt", entry));
+    NH3API_CHECK(entry.source == nh3api::vfs_source::archive && entry.layer == second_id && entry.lod_entry != nullptr);
+    NH3API_CHECK(entry.path == second.string());
+
+    // a lower priority added later does not win
+    const uint32_t loose_id = files.add_directory(loose, -1);
+    NH3API_CHECK(read(files, "SHARED.TXT") == payload_of("second"));
+
+    // the first archive re-added with a higher priority wins over both
+    const uint32_t again_id = files.add_archive(first, 1);
+    NH3API_CHECK(read(files, "SHARED.TXT") == payload_of("first"));
+    NH3API_CHECK(files.find("shared.txt", entry) && entry.layer == again_id);
+
+    NH3API_CHECK(files.add_directory(root / "missing") == nh3api::vfs::invalid_layer);
+    NH3API_CHECK(files.add_archive(root / "missing.lod") == nh3api::vfs::invalid_layer);
+    NH3API_CHECK(files.find("SHARED.TXT", entry) && entry.layer == again_id);
+    NH3API_CHECK(loose_id < again_id);
+}
+
+// overrides win over the archives of the same priority added earlier, duplicates inside the overrides: the first one wins
+void test_overrides(const fs::path& root)
+{
+    const fs::path archive = root / "base.lod";
+    NH3API_CHECK(write_lod(archive, { { "BUTTON.DEF", payload_of("archive button") }, { "OTHER.DEF", payload_of("other") } }));
+    NH3API_CHECK(write_file(root / "button_a.def", "override a"));
+    NH3API_CHECK(write_file(root / "button_b.def", "override b"));
+
+    nh3api::vfs files;
+    NH3API_CHECK(files.add_archive(archive) != nh3api::vfs::invalid_layer);
+    const uint32_t id = files.add_overrides({ { "button.def", (root / "button_a.def").string() },
+                                              { "BUTTON.DEF", (root / "button_b.def").string() },
+                                              { "NEW.DEF", (root / "button_b.def").string() } });
+    NH3API_CHECK(files.size() == 3);
+    NH3API_CHECK(read(files, "Button.def") == payload_of("override a"));
+    NH3API_CHECK(read(files, "new.def") == payload_of("override b"));
+    NH3API_CHECK(read(files, "OTHER.DEF") == payload_of("other"));
+
+    nh3api::vfs_entry entry {};
+    NH3API_CHECK(files.find("BUTTON.DEF", entry));
+    NH3API_CHECK(entry.source == nh3api::vfs_source::overrides && entry.layer == id && entry.archive == nullptr);
+    NH3API_CHECK(entry.path == (root / "button_a.def").string());
+
+    // the overrides are not on disk, refresh(id) has nothing to rescan
+    NH3API_CHECK(!files.refresh(id));
+}
+
+// removing a layer falls back to the next layer which has the name, names of no other layer disappear
+void test_remove_layer(const fs::path& root)
+{
+    const fs::path low  = root / "low.lod";
+    const fs::path mid  = root / "mid.lod";
+    const fs::path high = root / "high.lod";
+    NH3API_CHECK(write_lod(low, { { "X.TXT", payload_of("low") } }));
+    NH3API_CHECK(write_lod(mid, { { "X.TXT", payload_of("mid") } }));
+    NH3API_CHECK(write_lod(high, { { "X.TXT", payload_of("high") }, { "Y.TXT", payload_of("only high") } }));
+
+    nh3api::vfs    files;
+    const uint32_t low_id  = files.add_archive(low, 0);
+    const uint32_t high_id = files.add_archive(high, 2);
+    const uint32_t mid_id  = files.add_archive(mid, 1);
+    NH3API_CHECK(read(files, "X.TXT") == payload_of("high"));
+
+    NH3API_CHECK(files.remove_layer(high_id));
+    NH3API_CHECK(!files.remove_layer(high_id));
+    NH3API_CHECK(read(files, "X.TXT") == payload_of("mid"));
+    NH3API_CHECK(!files.exist("Y.TXT") && files.size() == 1);
+
+    NH3API_CHECK(files.remove_layer(mid_id));
+    NH3API_CHECK(read(files, "X.TXT") == payload_of("low"));
+
+    NH3API_CHECK(files.remove_layer(low_id));
+    NH3API_CHECK(!files.exist("X.TXT") && files.size() == 0);
+    NH3API_CHECK(!files.remove_layer(100));
+
+    // a layer added after the removals is indexed as usual
+    NH3API_CHECK(files.add_archive(mid) != nh3api::vfs::invalid_layer);
+    NH3API_CHECK(read(files, "x.txt") == payload_of("mid"));
+}
+
+// refresh() picks up the files added to and removed from a directory, and a rewritten archive
+void test_refresh(const fs::path& root)
+{
+    const fs::path directory = root / "data";
+    const fs::path nested    = directory / "nested";
+    const fs::path archive   = root / "refresh.lod";
+    fs::create_directories(nested);
+    NH3API_CHECK(write_file(directory / "KEEP.TXT", "keep"));
+    NH3API_CHECK(write_file(directory / "GONE.TXT", "gone"));
+    NH3API_CHECK(write_lod(archive, { { "LOD.TXT", payload_of("lod") }, { "KEEP.TXT", payload_of("lod keep") } }));
+
+    nh3api::vfs    files;
+    const uint32_t archive_id = files.add_archive(archive);
+    NH3API_CHECK(files.add_directory(directory, 0, true) != nh3api::vfs::invalid_layer);
+    NH3API_CHECK(read(files, "KEEP.TXT") == payload_of("keep"));
+    NH3API_CHECK(files.exist("GONE.TXT") && !files.exist("NEW.TXT"));
+    NH3API_CHECK(!files.refresh());
+
+    // directory change: one file removed, one added in a subdirectory
+    fs::remove(directory / "GONE.TXT");
+    NH3API_CHECK(write_file(nested / "NEW.TXT", "new"));
+    touch(directory, 10);
+    touch(nested, 10);
+    NH3API_CHECK(files.refresh());
+    NH3API_CHECK(!files.exist("GONE.TXT"));
+    NH3API_CHECK(read(files, "NEW.TXT") == payload_of("new"));
+    NH3API_CHECK(read(files, "KEEP.TXT") == payload_of("keep"));
+    NH3API_CHECK(!files.refresh());
+
+    // archive change: the directory still outranks it, the entry it dropped is gone
+    NH3API_CHECK(write_lod(archive, { { "KEEP.TXT", payload_of("lod keep 2") }, { "ADDED.TXT", payload_of("added") } }));
+    touch(archive, 20);
+    NH3API_CHECK(files.refresh());
+    NH3API_CHECK(!files.exist("LOD.TXT"));
+    NH3API_CHECK(read(files, "ADDED.TXT") == payload_of("added"));
+    NH3API_CHECK(read(files, "KEEP.TXT") == payload_of("keep"));
+
+    // the directory gone: its names fall back to the archive
+    fs::remove_all(directory);
+    NH3API_CHECK(files.refresh());
+    NH3API_CHECK(read(files, "KEEP.TXT") == payload_of("lod keep 2"));
+    NH3API_CHECK(!files.exist("NEW.TXT"));
+    NH3API_CHECK(files.refresh(archive_id));
+    NH3API_CHECK(files.size() == 2);
+}
+
+} // namespace
+
+int main()
+{
+    std::error_code error;
+    const fs::path  root = fs::temp_directory_path(error) / "nh3api_vfs_test";
+    fs::remove_all(root, error);
+    fs::create_directories(root, error);
+
+    test_priorities(root);
+    test_overrides(root);
+    test_remove_layer(root);
+    test_refresh(root);
+    test_refresh_through_cache(root);
+
+    fs::remove_all(root, error);
+    return nh3api_test::result("vfs_test");
+}